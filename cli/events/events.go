@@ -10,10 +10,11 @@ import (
 	"github.com/rs/zerolog/log"
 )
 
-// Reader reads a newline delimited JSON documents and sends parsed documents
-// to the passed out channel. It exits the process on error.
+// Reader reads a newline delimited JSON documents (or binary records, see
+// msgpack.go) and sends parsed documents to the passed out channel. It exits
+// the process on error.
 func Reader(r io.Reader, initOffset int64, match func(string) bool, out chan map[string]interface{}) (int, error) {
-	br, err := util.NewlineReader(r, match, func(idx int, Offset int64, b []byte) error {
+	br, err := RecordReader(r, match, func(idx int, Offset int64, b []byte) error {
 		event, err := ParseEvent(b)
 		if err != nil {
 			if err.Error() == "config event" {
@@ -63,7 +64,15 @@ func (em EventMatch) Events(file io.ReadSeeker, in chan map[string]interface{})
 	var err error
 	if !em.AllEvents && em.Offset == 0 {
 		var err error
-		em.Offset, err = util.FindReverseLineMatchOffset(em.LastN, file, em.Filter())
+		binary, err := IsBinary(file)
+		if err != nil {
+			return fmt.Errorf("Error reading events file: %v", err)
+		}
+		if binary {
+			em.Offset, err = findReverseRecordMatchOffset(em.LastN, file, em.Filter())
+		} else {
+			em.Offset, err = util.FindReverseLineMatchOffset(em.LastN, file, em.Filter())
+		}
 		if err != nil {
 			return fmt.Errorf("Error searching for Offset: %v", err)
 		}
@@ -84,6 +93,33 @@ func (em EventMatch) Events(file io.ReadSeeker, in chan map[string]interface{})
 	return nil
 }
 
+// findReverseRecordMatchOffset is FindReverseLineMatchOffset for files with
+// binary records, which can't be read backwards. It returns the offset of
+// the nth matching record from the end, or -1 if there are fewer than n.
+func findReverseRecordMatchOffset(n int, r io.ReadSeeker, match func(string) bool) (int64, error) {
+	if n <= 0 {
+		return -1, nil
+	}
+	if _, err := r.Seek(0, io.SeekStart); err != nil {
+		return -1, err
+	}
+	offsets := make([]int64, 0, n)
+	_, err := RecordReader(r, match, func(idx int, offset int64, b []byte) error {
+		if len(offsets) == n {
+			offsets = offsets[1:]
+		}
+		offsets = append(offsets, offset)
+		return nil
+	})
+	if err != nil {
+		return -1, err
+	}
+	if len(offsets) < n {
+		return -1, nil
+	}
+	return offsets[0], nil
+}
+
 func (em EventMatch) Filter() func(string) bool {
 	all := []util.MatchFunc{}
 	if !em.AllEvents && em.SkipEvents > 0 {
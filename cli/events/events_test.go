@@ -2,6 +2,7 @@ package events
 
 import (
 	"bytes"
+	"encoding/hex"
 	"testing"
 
 	"github.com/criblio/scope/util"
@@ -60,3 +61,91 @@ func TestReaderWithFilter(t *testing.T) {
 	testFilter(util.MatchAll([]util.MatchFunc{util.MatchField("pid", 10118), util.MatchString("foo")}...), 0)
 	testFilter(util.MatchAll([]util.MatchFunc{util.MatchField("pid", 10117), util.MatchString("foo")}...), 1)
 }
+
+// Two events as written by libscope with SCOPE_EVENT_FORMAT=msgpack,
+// sources "first" and "second"
+const msgpackEvents = "000000c084a474797065a3657674a26964b2686f73742d63746c746573742d636d642d34a85f6368616e6e656ca53132333435a4626f647988aa736f7572636574797065a66d6574726963a55f74696d65cb41dab595c1a7ef9ea6736f75726365a56669727374a4686f7374a4686f7374a470726f63a763746c74657374a3636d64a5636d642d34a3706964cd12f0a464617461df00000003a75f6d6574726963a56669727374ac5f6d65747269635f74797065a7636f756e746572a65f76616c756501000000b383a474797065a3657674a26964b2686f73742d63746c746573742d636d642d34a4626f647988aa736f7572636574797065a66d6574726963a55f74696d65cb41dab595c1a7ef9ea6736f75726365a67365636f6e64a4686f7374a4686f7374a470726f63a763746c74657374a3636d64a5636d642d34a3706964cd12f0a464617461df00000003a75f6d6574726963a67365636f6e64ac5f6d65747269635f74797065a7636f756e746572a65f76616c756502"
+
+func msgpackFile(t *testing.T) []byte {
+	b, err := hex.DecodeString(msgpackEvents)
+	assert.NoError(t, err)
+	start := `{"format":"msgpack","info":{"process":{"pid":4848}}}` + "\n"
+	return append([]byte(start), b...)
+}
+
+func TestReaderMsgpack(t *testing.T) {
+	in := make(chan map[string]interface{})
+	r := bytes.NewReader(msgpackFile(t))
+	go Reader(r, 0, util.MatchAlways, in)
+
+	events := []map[string]interface{}{}
+	for e := range in {
+		events = append(events, e)
+	}
+	assert.Len(t, events, 2)
+	assert.Equal(t, "metric", events[0]["sourcetype"])
+	assert.Equal(t, "first", events[0]["source"])
+	assert.Equal(t, "ctltest", events[0]["proc"])
+	assert.Equal(t, float64(4848), events[0]["pid"])
+	assert.Equal(t, float64(1), events[0]["data"].(map[string]interface{})["_value"])
+	assert.Equal(t, "second", events[1]["source"])
+
+	// Filters see the events as json
+	in = make(chan map[string]interface{})
+	r = bytes.NewReader(msgpackFile(t))
+	go Reader(r, 0, util.MatchField("source", "second"), in)
+	events = []map[string]interface{}{}
+	for e := range in {
+		events = append(events, e)
+	}
+	assert.Len(t, events, 1)
+}
+
+func TestIsBinary(t *testing.T) {
+	binary, err := IsBinary(bytes.NewReader(msgpackFile(t)))
+	assert.NoError(t, err)
+	assert.True(t, binary)
+
+	b, _ := hex.DecodeString(msgpackEvents)
+	binary, err = IsBinary(bytes.NewReader(b))
+	assert.NoError(t, err)
+	assert.True(t, binary)
+
+	binary, err = IsBinary(bytes.NewReader([]byte(`{"format":"ndjson","info":{}}` + "\n")))
+	assert.NoError(t, err)
+	assert.False(t, binary)
+}
+
+func TestFindReverseRecordMatchOffset(t *testing.T) {
+	file := msgpackFile(t)
+	secondOffset := int64(bytes.Index(file, []byte{0, 0, 0, 0xb3}))
+
+	offset, err := findReverseRecordMatchOffset(1, bytes.NewReader(file), util.MatchAlways)
+	assert.NoError(t, err)
+	assert.Equal(t, secondOffset, offset)
+
+	offset, err = findReverseRecordMatchOffset(1, bytes.NewReader(file), util.MatchString("first"))
+	assert.NoError(t, err)
+	assert.Equal(t, int64(bytes.IndexByte(file, 0)), offset)
+
+	offset, err = findReverseRecordMatchOffset(4, bytes.NewReader(file), util.MatchAlways)
+	assert.NoError(t, err)
+	assert.Equal(t, int64(-1), offset)
+}
+
+func TestDecodeMsgpack(t *testing.T) {
+	// {"a":[-1,200,-40000,1.5,null,true],"b":"hey"}
+	b := []byte{0x82, 0xa1, 'a', 0x96, 0xff, 0xcc, 0xc8, 0xd2, 0xff, 0xff, 0x63, 0xc0,
+		0xcb, 0x3f, 0xf8, 0, 0, 0, 0, 0, 0, 0xc0, 0xc3, 0xa1, 'b', 0xa3, 'h', 'e', 'y'}
+	v, err := DecodeMsgpack(b)
+	assert.NoError(t, err)
+	assert.Equal(t, map[string]interface{}{
+		"a": []interface{}{float64(-1), float64(200), float64(-40000), 1.5, nil, true},
+		"b": "hey",
+	}, v)
+
+	_, err = DecodeMsgpack(b[:len(b)-1])
+	assert.Error(t, err)
+	_, err = DecodeMsgpack(append(b, 0))
+	assert.Error(t, err)
+}
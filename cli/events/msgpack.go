@@ -0,0 +1,290 @@
+package events
+
+import (
+	"bufio"
+	"bytes"
+	"encoding/binary"
+	"encoding/json"
+	"fmt"
+	"io"
+	"math"
+)
+
+// libscope can send events as length-prefixed msgpack instead of ndjson
+// (SCOPE_EVENT_FORMAT=msgpack). Each binary record is a 4 byte big-endian
+// length followed by one msgpack map with the same structure as the json
+// event. The process start message stays a json line (with
+// "format":"msgpack"), so a file may contain both kinds of record. Json
+// records always start with '{', binary records (which are never 16MB or
+// more) always start with a zero byte.
+
+const msgpackHdrLen = 4
+
+// maxRecordLen guards against reading garbage as a huge length
+const maxRecordLen = 16 * 1024 * 1024
+
+// isBinaryRecord returns true if a record starting with b is binary
+func isBinaryRecord(b byte) bool {
+	return b == 0
+}
+
+// IsBinary returns true if the events in r are in the binary format. The
+// reader is left positioned at the start.
+func IsBinary(r io.ReadSeeker) (bool, error) {
+	if _, err := r.Seek(0, io.SeekStart); err != nil {
+		return false, err
+	}
+	defer r.Seek(0, io.SeekStart)
+
+	br := bufio.NewReader(r)
+	b, err := br.Peek(1)
+	if err == io.EOF {
+		return false, nil
+	} else if err != nil {
+		return false, err
+	}
+	if isBinaryRecord(b[0]) {
+		return true, nil
+	}
+	line, err := br.ReadBytes('\n')
+	if err != nil && err != io.EOF {
+		return false, err
+	}
+	return bytes.Contains(line, []byte(`"format":"msgpack"`)), nil
+}
+
+// RecordReader is like util.NewlineReader, but also understands binary
+// records. Binary records are converted to json before they're matched and
+// passed to the callback, so callers only ever see json.
+func RecordReader(r io.Reader, match func(string) bool, callback func(idx int, offset int64, b []byte) error) (int, error) {
+	br := bufio.NewReader(r)
+	idx := 0
+	offset := int64(0)
+	for {
+		b, n, err := readRecord(br)
+		if err == io.EOF {
+			return int(offset), nil
+		} else if err != nil {
+			return int(offset), err
+		}
+		idx++
+		if match(string(b)) {
+			if err := callback(idx, offset, b); err != nil {
+				return int(offset + int64(n)), err
+			}
+		}
+		offset += int64(n)
+	}
+}
+
+// readRecord returns the next record as json, and the number of bytes it
+// took up in the input
+func readRecord(br *bufio.Reader) ([]byte, int, error) {
+	first, err := br.Peek(1)
+	if err != nil {
+		return nil, 0, err
+	}
+
+	if !isBinaryRecord(first[0]) {
+		line, err := br.ReadBytes('\n')
+		if err == io.EOF && len(line) > 0 {
+			err = nil
+		}
+		if err != nil {
+			return nil, 0, err
+		}
+		return bytes.TrimRight(line, "\r\n"), len(line), nil
+	}
+
+	hdr := make([]byte, msgpackHdrLen)
+	if _, err := io.ReadFull(br, hdr); err != nil {
+		return nil, 0, unexpectedEOF(err)
+	}
+	l := binary.BigEndian.Uint32(hdr)
+	if l > maxRecordLen {
+		return nil, 0, fmt.Errorf("msgpack record too long: %d", l)
+	}
+	body := make([]byte, l)
+	if _, err := io.ReadFull(br, body); err != nil {
+		return nil, 0, unexpectedEOF(err)
+	}
+	b, err := MsgpackToJSON(body)
+	if err != nil {
+		return nil, 0, err
+	}
+	return b, msgpackHdrLen + int(l), nil
+}
+
+func unexpectedEOF(err error) error {
+	if err == io.EOF {
+		return io.ErrUnexpectedEOF
+	}
+	return err
+}
+
+// MsgpackToJSON converts one msgpack value to json
+func MsgpackToJSON(b []byte) ([]byte, error) {
+	v, err := DecodeMsgpack(b)
+	if err != nil {
+		return nil, err
+	}
+	var buf bytes.Buffer
+	enc := json.NewEncoder(&buf)
+	enc.SetEscapeHTML(false)
+	if err := enc.Encode(v); err != nil {
+		return nil, err
+	}
+	return bytes.TrimRight(buf.Bytes(), "\n"), nil
+}
+
+// DecodeMsgpack decodes one msgpack value. Values are returned as the same
+// types encoding/json would use; in particular all numbers are float64.
+func DecodeMsgpack(b []byte) (interface{}, error) {
+	d := msgpackDecoder{b: b}
+	v, err := d.value()
+	if err != nil {
+		return nil, err
+	}
+	if d.off != len(b) {
+		return nil, fmt.Errorf("msgpack: %d trailing bytes", len(b)-d.off)
+	}
+	return v, nil
+}
+
+type msgpackDecoder struct {
+	b   []byte
+	off int
+}
+
+func (d *msgpackDecoder) next(n int) ([]byte, error) {
+	if n < 0 || len(d.b)-d.off < n {
+		return nil, io.ErrUnexpectedEOF
+	}
+	b := d.b[d.off : d.off+n]
+	d.off += n
+	return b, nil
+}
+
+func (d *msgpackDecoder) uint(n int) (uint64, error) {
+	b, err := d.next(n)
+	if err != nil {
+		return 0, err
+	}
+	var v uint64
+	for _, c := range b {
+		v = v<<8 | uint64(c)
+	}
+	return v, nil
+}
+
+func (d *msgpackDecoder) value() (interface{}, error) {
+	tb, err := d.next(1)
+	if err != nil {
+		return nil, err
+	}
+	t := tb[0]
+
+	switch {
+	case t <= 0x7f:
+		return float64(t), nil
+	case t >= 0xe0:
+		return float64(int8(t)), nil
+	case t&0xe0 == 0xa0:
+		return d.str(int(t & 0x1f))
+	case t&0xf0 == 0x90:
+		return d.array(int(t & 0x0f))
+	case t&0xf0 == 0x80:
+		return d.mapping(int(t & 0x0f))
+	}
+
+	var n uint64
+	switch t {
+	case 0xc0:
+		return nil, nil
+	case 0xc2:
+		return false, nil
+	case 0xc3:
+		return true, nil
+	case 0xcc, 0xcd, 0xce, 0xcf:
+		n, err = d.uint(1 << (t - 0xcc))
+		return float64(n), err
+	case 0xd0:
+		n, err = d.uint(1)
+		return float64(int8(n)), err
+	case 0xd1:
+		n, err = d.uint(2)
+		return float64(int16(n)), err
+	case 0xd2:
+		n, err = d.uint(4)
+		return float64(int32(n)), err
+	case 0xd3:
+		n, err = d.uint(8)
+		return float64(int64(n)), err
+	case 0xca:
+		n, err = d.uint(4)
+		return float64(math.Float32frombits(uint32(n))), err
+	case 0xcb:
+		n, err = d.uint(8)
+		return math.Float64frombits(n), err
+	case 0xd9, 0xda, 0xdb:
+		if n, err = d.uint(1 << (t - 0xd9)); err != nil {
+			return nil, err
+		}
+		return d.str(int(n))
+	case 0xdc, 0xdd:
+		if n, err = d.uint(2 << (t - 0xdc)); err != nil {
+			return nil, err
+		}
+		return d.array(int(n))
+	case 0xde, 0xdf:
+		if n, err = d.uint(2 << (t - 0xde)); err != nil {
+			return nil, err
+		}
+		return d.mapping(int(n))
+	}
+	return nil, fmt.Errorf("msgpack: unsupported type 0x%02x", t)
+}
+
+func (d *msgpackDecoder) str(n int) (interface{}, error) {
+	b, err := d.next(n)
+	if err != nil {
+		return nil, err
+	}
+	return string(b), nil
+}
+
+func (d *msgpackDecoder) array(n int) (interface{}, error) {
+	if n > len(d.b)-d.off {
+		return nil, io.ErrUnexpectedEOF
+	}
+	a := make([]interface{}, 0, n)
+	for i := 0; i < n; i++ {
+		v, err := d.value()
+		if err != nil {
+			return nil, err
+		}
+		a = append(a, v)
+	}
+	return a, nil
+}
+
+func (d *msgpackDecoder) mapping(n int) (interface{}, error) {
+	if n > len(d.b)-d.off {
+		return nil, io.ErrUnexpectedEOF
+	}
+	m := make(map[string]interface{}, n)
+	for i := 0; i < n; i++ {
+		k, err := d.value()
+		if err != nil {
+			return nil, err
+		}
+		ks, ok := k.(string)
+		if !ok {
+			return nil, fmt.Errorf("msgpack: map key is not a string")
+		}
+		if m[ks], err = d.value(); err != nil {
+			return nil, err
+		}
+	}
+	return m, nil
+}
@@ -0,0 +1,27 @@
+
+# Consider dependencies only in project.
+set(CMAKE_DEPENDS_IN_PROJECT_ONLY OFF)
+
+# The set of languages for which implicit dependencies are needed:
+set(CMAKE_DEPENDS_LANGUAGES
+  )
+
+# The set of dependency files which are needed:
+set(CMAKE_DEPENDS_DEPENDENCY_FILES
+  "/root/repo/contrib/funchook/distorm/src/decoder.c" "CMakeFiles/distorm.dir/distorm/src/decoder.c.o" "gcc" "CMakeFiles/distorm.dir/distorm/src/decoder.c.o.d"
+  "/root/repo/contrib/funchook/distorm/src/distorm.c" "CMakeFiles/distorm.dir/distorm/src/distorm.c.o" "gcc" "CMakeFiles/distorm.dir/distorm/src/distorm.c.o.d"
+  "/root/repo/contrib/funchook/distorm/src/instructions.c" "CMakeFiles/distorm.dir/distorm/src/instructions.c.o" "gcc" "CMakeFiles/distorm.dir/distorm/src/instructions.c.o.d"
+  "/root/repo/contrib/funchook/distorm/src/insts.c" "CMakeFiles/distorm.dir/distorm/src/insts.c.o" "gcc" "CMakeFiles/distorm.dir/distorm/src/insts.c.o.d"
+  "/root/repo/contrib/funchook/distorm/src/mnemonics.c" "CMakeFiles/distorm.dir/distorm/src/mnemonics.c.o" "gcc" "CMakeFiles/distorm.dir/distorm/src/mnemonics.c.o.d"
+  "/root/repo/contrib/funchook/distorm/src/operands.c" "CMakeFiles/distorm.dir/distorm/src/operands.c.o" "gcc" "CMakeFiles/distorm.dir/distorm/src/operands.c.o.d"
+  "/root/repo/contrib/funchook/distorm/src/prefix.c" "CMakeFiles/distorm.dir/distorm/src/prefix.c.o" "gcc" "CMakeFiles/distorm.dir/distorm/src/prefix.c.o.d"
+  "/root/repo/contrib/funchook/distorm/src/textdefs.c" "CMakeFiles/distorm.dir/distorm/src/textdefs.c.o" "gcc" "CMakeFiles/distorm.dir/distorm/src/textdefs.c.o.d"
+  "/root/repo/contrib/funchook/distorm/src/wstring.c" "CMakeFiles/distorm.dir/distorm/src/wstring.c.o" "gcc" "CMakeFiles/distorm.dir/distorm/src/wstring.c.o.d"
+  )
+
+# Targets to which this target links.
+set(CMAKE_TARGET_LINKED_INFO_FILES
+  )
+
+# Fortran module output directory.
+set(CMAKE_Fortran_TARGET_MODULE_DIR "")
@@ -0,0 +1,27 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/distorm.dir/distorm/src/decoder.c.o"
+  "CMakeFiles/distorm.dir/distorm/src/decoder.c.o.d"
+  "CMakeFiles/distorm.dir/distorm/src/distorm.c.o"
+  "CMakeFiles/distorm.dir/distorm/src/distorm.c.o.d"
+  "CMakeFiles/distorm.dir/distorm/src/instructions.c.o"
+  "CMakeFiles/distorm.dir/distorm/src/instructions.c.o.d"
+  "CMakeFiles/distorm.dir/distorm/src/insts.c.o"
+  "CMakeFiles/distorm.dir/distorm/src/insts.c.o.d"
+  "CMakeFiles/distorm.dir/distorm/src/mnemonics.c.o"
+  "CMakeFiles/distorm.dir/distorm/src/mnemonics.c.o.d"
+  "CMakeFiles/distorm.dir/distorm/src/operands.c.o"
+  "CMakeFiles/distorm.dir/distorm/src/operands.c.o.d"
+  "CMakeFiles/distorm.dir/distorm/src/prefix.c.o"
+  "CMakeFiles/distorm.dir/distorm/src/prefix.c.o.d"
+  "CMakeFiles/distorm.dir/distorm/src/textdefs.c.o"
+  "CMakeFiles/distorm.dir/distorm/src/textdefs.c.o.d"
+  "CMakeFiles/distorm.dir/distorm/src/wstring.c.o"
+  "CMakeFiles/distorm.dir/distorm/src/wstring.c.o.d"
+  "libdistorm.a"
+  "libdistorm.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang C)
+  include(CMakeFiles/distorm.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,19 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/funchook-shared.dir/src/disasm_distorm.c.o"
+  "CMakeFiles/funchook-shared.dir/src/disasm_distorm.c.o.d"
+  "CMakeFiles/funchook-shared.dir/src/funchook.c.o"
+  "CMakeFiles/funchook-shared.dir/src/funchook.c.o.d"
+  "CMakeFiles/funchook-shared.dir/src/funchook_unix.c.o"
+  "CMakeFiles/funchook-shared.dir/src/funchook_unix.c.o.d"
+  "CMakeFiles/funchook-shared.dir/src/funchook_x86.c.o"
+  "CMakeFiles/funchook-shared.dir/src/funchook_x86.c.o.d"
+  "libfunchook.pdb"
+  "libfunchook.so"
+  "libfunchook.so.1"
+  "libfunchook.so.1.1.0"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang C)
+  include(CMakeFiles/funchook-shared.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
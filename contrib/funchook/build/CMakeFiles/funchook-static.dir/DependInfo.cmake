@@ -0,0 +1,23 @@
+
+# Consider dependencies only in project.
+set(CMAKE_DEPENDS_IN_PROJECT_ONLY OFF)
+
+# The set of languages for which implicit dependencies are needed:
+set(CMAKE_DEPENDS_LANGUAGES
+  )
+
+# The set of dependency files which are needed:
+set(CMAKE_DEPENDS_DEPENDENCY_FILES
+  "/root/repo/contrib/funchook/src/disasm_distorm.c" "CMakeFiles/funchook-static.dir/src/disasm_distorm.c.o" "gcc" "CMakeFiles/funchook-static.dir/src/disasm_distorm.c.o.d"
+  "/root/repo/contrib/funchook/src/funchook.c" "CMakeFiles/funchook-static.dir/src/funchook.c.o" "gcc" "CMakeFiles/funchook-static.dir/src/funchook.c.o.d"
+  "/root/repo/contrib/funchook/src/funchook_unix.c" "CMakeFiles/funchook-static.dir/src/funchook_unix.c.o" "gcc" "CMakeFiles/funchook-static.dir/src/funchook_unix.c.o.d"
+  "/root/repo/contrib/funchook/src/funchook_x86.c" "CMakeFiles/funchook-static.dir/src/funchook_x86.c.o" "gcc" "CMakeFiles/funchook-static.dir/src/funchook_x86.c.o.d"
+  )
+
+# Targets to which this target links.
+set(CMAKE_TARGET_LINKED_INFO_FILES
+  "/root/repo/contrib/funchook/build/CMakeFiles/distorm.dir/DependInfo.cmake"
+  )
+
+# Fortran module output directory.
+set(CMAKE_Fortran_TARGET_MODULE_DIR "")
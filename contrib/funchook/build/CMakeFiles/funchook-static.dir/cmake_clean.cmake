@@ -0,0 +1,17 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/funchook-static.dir/src/disasm_distorm.c.o"
+  "CMakeFiles/funchook-static.dir/src/disasm_distorm.c.o.d"
+  "CMakeFiles/funchook-static.dir/src/funchook.c.o"
+  "CMakeFiles/funchook-static.dir/src/funchook.c.o.d"
+  "CMakeFiles/funchook-static.dir/src/funchook_unix.c.o"
+  "CMakeFiles/funchook-static.dir/src/funchook_unix.c.o.d"
+  "CMakeFiles/funchook-static.dir/src/funchook_x86.c.o"
+  "CMakeFiles/funchook-static.dir/src/funchook_x86.c.o.d"
+  "libfunchook.a"
+  "libfunchook.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang C)
+  include(CMakeFiles/funchook-static.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,12 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/funchook_test.dir/libfunchook_test.c.o"
+  "CMakeFiles/funchook_test.dir/libfunchook_test.c.o.d"
+  "CMakeFiles/funchook_test.dir/libfunchook_test_x86_64_gas.S.o"
+  "libfunchook_test.pdb"
+  "libfunchook_test.so"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang ASM C)
+  include(CMakeFiles/funchook_test.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/funchook_test_shared.dir/test_main.c.o"
+  "CMakeFiles/funchook_test_shared.dir/test_main.c.o.d"
+  "funchook_test_shared"
+  "funchook_test_shared.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang C)
+  include(CMakeFiles/funchook_test_shared.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,22 @@
+
+# Consider dependencies only in project.
+set(CMAKE_DEPENDS_IN_PROJECT_ONLY OFF)
+
+# The set of languages for which implicit dependencies are needed:
+set(CMAKE_DEPENDS_LANGUAGES
+  )
+
+# The set of dependency files which are needed:
+set(CMAKE_DEPENDS_DEPENDENCY_FILES
+  "/root/repo/contrib/funchook/test/test_main.c" "test/CMakeFiles/funchook_test_static.dir/test_main.c.o" "gcc" "test/CMakeFiles/funchook_test_static.dir/test_main.c.o.d"
+  )
+
+# Targets to which this target links.
+set(CMAKE_TARGET_LINKED_INFO_FILES
+  "/root/repo/contrib/funchook/build/CMakeFiles/funchook-static.dir/DependInfo.cmake"
+  "/root/repo/contrib/funchook/build/test/CMakeFiles/funchook_test.dir/DependInfo.cmake"
+  "/root/repo/contrib/funchook/build/CMakeFiles/distorm.dir/DependInfo.cmake"
+  )
+
+# Fortran module output directory.
+set(CMAKE_Fortran_TARGET_MODULE_DIR "")
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/funchook_test_static.dir/test_main.c.o"
+  "CMakeFiles/funchook_test_static.dir/test_main.c.o.d"
+  "funchook_test_static"
+  "funchook_test_static.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang C)
+  include(CMakeFiles/funchook_test_static.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
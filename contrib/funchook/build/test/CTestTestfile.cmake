@@ -0,0 +1,10 @@
+# CMake generated Testfile for 
+# Source directory: /root/repo/contrib/funchook/test
+# Build directory: /root/repo/contrib/funchook/build/test
+# 
+# This file includes the relevant testing commands required for 
+# testing this directory and lists subdirectories to be tested as well.
+add_test(funchook_test_shared "/root/repo/contrib/funchook/build/test/funchook_test_shared")
+set_tests_properties(funchook_test_shared PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/contrib/funchook/test/CMakeLists.txt;57;add_test;/root/repo/contrib/funchook/test/CMakeLists.txt;0;")
+add_test(funchook_test_static "/root/repo/contrib/funchook/build/test/funchook_test_static")
+set_tests_properties(funchook_test_static PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/contrib/funchook/test/CMakeLists.txt;66;add_test;/root/repo/contrib/funchook/test/CMakeLists.txt;0;")
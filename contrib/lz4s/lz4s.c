@@ -0,0 +1,427 @@
+/*
+ * lz4s - a small, dependency free, streaming LZ4 frame encoder.
+ * See lz4s.h for a description.
+ *
+ * Format references:
+ *     https://github.com/lz4/lz4/blob/dev/doc/lz4_Frame_format.md
+ *     https://github.com/lz4/lz4/blob/dev/doc/lz4_Block_format.md
+ */
+#include <stdlib.h>
+#include <string.h>
+
+#include "lz4s.h"
+
+#define LZ4S_MAGIC        0x184D2204U
+#define LZ4S_WINDOW       (64 * 1024)
+#define LZ4S_HASH_LOG     12
+#define LZ4S_HASH_SIZE    (1 << LZ4S_HASH_LOG)
+
+// Block format constraints
+#define MINMATCH          4
+#define LASTLITERALS      5     // the last 5 bytes are always literals
+#define MFLIMIT           12    // a match can't start within 12 bytes of the end
+#define MAX_DISTANCE      65535
+#define ML_MASK           0x0F
+#define RUN_MASK          0x0F
+
+// Frame descriptor: version 01, linked blocks, no checksums, 64KB blocks
+#define LZ4S_FLG          0x40
+#define LZ4S_BD           0x40
+
+#define LZ4S_UNCOMPRESSED 0x80000000U
+
+// The window holds up to LZ4S_WINDOW bytes of history followed by the
+// block being compressed.  Hash table entries are absolute stream
+// positions; base is the absolute position of window[0].
+struct lz4s_stream {
+    uint8_t window[LZ4S_WINDOW + LZ4S_BLOCK_MAX];
+    size_t len;
+    uint32_t base;
+    uint32_t table[LZ4S_HASH_SIZE];
+};
+
+static inline uint32_t
+read32(const uint8_t *p)
+{
+    uint32_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+static inline void
+writeLE16(uint8_t *p, uint16_t v)
+{
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+}
+
+static inline void
+writeLE32(uint8_t *p, uint32_t v)
+{
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+    p[2] = (uint8_t)(v >> 16);
+    p[3] = (uint8_t)(v >> 24);
+}
+
+static inline uint32_t
+readLE32(const uint8_t *p)
+{
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) |
+           ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static inline uint32_t
+hash4(uint32_t seq)
+{
+    return (seq * 2654435761U) >> (32 - LZ4S_HASH_LOG);
+}
+
+/*
+ * xxHash32, used only for the frame header checksum.
+ */
+#define PRIME32_1 2654435761U
+#define PRIME32_2 2246822519U
+#define PRIME32_3 3266489917U
+#define PRIME32_4  668265263U
+#define PRIME32_5  374761393U
+
+static inline uint32_t
+rotl32(uint32_t x, int r)
+{
+    return (x << r) | (x >> (32 - r));
+}
+
+static inline uint32_t
+xxh32Round(uint32_t acc, uint32_t input)
+{
+    acc += input * PRIME32_2;
+    acc = rotl32(acc, 13);
+    return acc * PRIME32_1;
+}
+
+static uint32_t
+xxh32(const uint8_t *p, size_t len, uint32_t seed)
+{
+    const uint8_t *end = p + len;
+    uint32_t h;
+
+    if (len >= 16) {
+        const uint8_t *limit = end - 16;
+        uint32_t v1 = seed + PRIME32_1 + PRIME32_2;
+        uint32_t v2 = seed + PRIME32_2;
+        uint32_t v3 = seed;
+        uint32_t v4 = seed - PRIME32_1;
+        do {
+            v1 = xxh32Round(v1, readLE32(p)); p += 4;
+            v2 = xxh32Round(v2, readLE32(p)); p += 4;
+            v3 = xxh32Round(v3, readLE32(p)); p += 4;
+            v4 = xxh32Round(v4, readLE32(p)); p += 4;
+        } while (p <= limit);
+        h = rotl32(v1, 1) + rotl32(v2, 7) + rotl32(v3, 12) + rotl32(v4, 18);
+    } else {
+        h = seed + PRIME32_5;
+    }
+
+    h += (uint32_t)len;
+
+    while (p + 4 <= end) {
+        h += readLE32(p) * PRIME32_3;
+        h = rotl32(h, 17) * PRIME32_4;
+        p += 4;
+    }
+    while (p < end) {
+        h += (*p) * PRIME32_5;
+        h = rotl32(h, 11) * PRIME32_1;
+        p++;
+    }
+
+    h ^= h >> 15;
+    h *= PRIME32_2;
+    h ^= h >> 13;
+    h *= PRIME32_3;
+    h ^= h >> 16;
+    return h;
+}
+
+lz4s_stream_t *
+lz4s_create(void)
+{
+    lz4s_stream_t *s = malloc(sizeof(*s));
+    if (!s) return NULL;
+    lz4s_reset(s);
+    return s;
+}
+
+void
+lz4s_destroy(lz4s_stream_t **s)
+{
+    if (!s || !*s) return;
+    free(*s);
+    *s = NULL;
+}
+
+void
+lz4s_reset(lz4s_stream_t *s)
+{
+    if (!s) return;
+    s->len = 0;
+    // Start past MAX_DISTANCE so that a zeroed table entry never matches
+    s->base = LZ4S_WINDOW + 1;
+    memset(s->table, 0, sizeof(s->table));
+}
+
+size_t
+lz4s_frame_header(uint8_t *dst)
+{
+    if (!dst) return 0;
+    writeLE32(dst, LZ4S_MAGIC);
+    dst[4] = LZ4S_FLG;
+    dst[5] = LZ4S_BD;
+    dst[6] = (uint8_t)(xxh32(&dst[4], 2, 0) >> 8);
+    return LZ4S_FRAME_HEADER_LEN;
+}
+
+size_t
+lz4s_end_mark(uint8_t *dst)
+{
+    if (!dst) return 0;
+    writeLE32(dst, 0);
+    return LZ4S_END_MARK_LEN;
+}
+
+static uint8_t *
+writeLength(uint8_t *op, size_t len)
+{
+    while (len >= 255) {
+        *op++ = 255;
+        len -= 255;
+    }
+    *op++ = (uint8_t)len;
+    return op;
+}
+
+static uint8_t *
+writeSequence(uint8_t *op, const uint8_t *anchor, size_t lit_len,
+              uint16_t offset, size_t match_len)
+{
+    uint8_t *token = op++;
+    *token = (uint8_t)(((lit_len >= RUN_MASK) ? RUN_MASK : lit_len) << 4);
+    if (lit_len >= RUN_MASK) op = writeLength(op, lit_len - RUN_MASK);
+    memcpy(op, anchor, lit_len);
+    op += lit_len;
+
+    // The last sequence has literals only
+    if (!match_len) return op;
+
+    writeLE16(op, offset);
+    op += 2;
+
+    size_t ml = match_len - MINMATCH;
+    *token |= (uint8_t)((ml >= ML_MASK) ? ML_MASK : ml);
+    if (ml >= ML_MASK) op = writeLength(op, ml - ML_MASK);
+    return op;
+}
+
+// Make room for a block of len bytes after the history in the window
+static void
+slideWindow(lz4s_stream_t *s, size_t len)
+{
+    if (s->len + len <= sizeof(s->window)) return;
+
+    size_t keep = (s->len < LZ4S_WINDOW) ? s->len : LZ4S_WINDOW;
+    size_t drop = s->len - keep;
+    memmove(s->window, &s->window[drop], keep);
+    s->len = keep;
+    s->base += (uint32_t)drop;
+
+    // Absolute positions wrap after 4GB; start over well before that.
+    // Losing the table only costs some matches at the start of a block.
+    if (s->base > 0x80000000U) {
+        uint32_t new_base = LZ4S_WINDOW + 1;
+        uint32_t delta = s->base - new_base;
+        int i;
+        for (i = 0; i < LZ4S_HASH_SIZE; i++) {
+            s->table[i] = (s->table[i] > delta) ? s->table[i] - delta : 0;
+        }
+        s->base = new_base;
+    }
+}
+
+size_t
+lz4s_compress_block(lz4s_stream_t *s, const uint8_t *src, size_t srclen,
+                    uint8_t *dst, size_t dstcap)
+{
+    if (!s || !src || !dst || !srclen || srclen > LZ4S_BLOCK_MAX) return 0;
+    if (dstcap < LZ4S_BLOCK_BOUND(srclen)) return 0;
+
+    slideWindow(s, srclen);
+
+    uint8_t *const win = s->window;
+    const uint8_t *const istart = &win[s->len];
+    memcpy(&win[s->len], src, srclen);
+
+    const uint8_t *ip = istart;
+    const uint8_t *anchor = istart;
+    const uint8_t *const iend = istart + srclen;
+    const uint8_t *const mflimit = iend - MFLIMIT;
+    const uint8_t *const matchlimit = iend - LASTLITERALS;
+    uint8_t *const ostart = dst + 4;
+    uint8_t *op = ostart;
+
+    if (srclen >= MFLIMIT + 1) {
+        while (ip < mflimit) {
+            uint32_t seq = read32(ip);
+            uint32_t h = hash4(seq);
+            uint32_t pos = s->base + (uint32_t)(ip - win);
+            uint32_t ref = s->table[h];
+            s->table[h] = pos;
+
+            if ((ref < s->base) || (pos - ref > MAX_DISTANCE) ||
+                (read32(&win[ref - s->base]) != seq)) {
+                ip++;
+                continue;
+            }
+
+            const uint8_t *match = &win[ref - s->base];
+
+            // Extend backwards over literals we haven't emitted yet
+            while ((ip > anchor) && (match > win) && (ip[-1] == match[-1])) {
+                ip--;
+                match--;
+            }
+
+            // Then forwards
+            const uint8_t *mp = ip + MINMATCH;
+            const uint8_t *rp = match + MINMATCH;
+            while ((mp < matchlimit) && (*mp == *rp)) {
+                mp++;
+                rp++;
+            }
+
+            op = writeSequence(op, anchor, (size_t)(ip - anchor),
+                               (uint16_t)(ip - match), (size_t)(mp - ip));
+
+            // Index a position inside the match to improve the next search
+            if (mp - 2 > ip) {
+                uint32_t p2 = s->base + (uint32_t)(mp - 2 - win);
+                s->table[hash4(read32(mp - 2))] = p2;
+            }
+
+            ip = anchor = mp;
+        }
+    }
+
+    op = writeSequence(op, anchor, (size_t)(iend - anchor), 0, 0);
+
+    size_t clen = (size_t)(op - ostart);
+    s->len += srclen;
+
+    if (clen >= srclen) {
+        // Not worth it; store the block as is
+        writeLE32(dst, (uint32_t)srclen | LZ4S_UNCOMPRESSED);
+        memcpy(ostart, src, srclen);
+        return srclen + 4;
+    }
+
+    writeLE32(dst, (uint32_t)clen);
+    return clen + 4;
+}
+
+static long
+decodeBlock(const uint8_t *ip, size_t len, uint8_t *dst, uint8_t *op,
+            uint8_t *oend)
+{
+    const uint8_t *const iend = ip + len;
+    uint8_t *const ostart = op;
+
+    while (ip < iend) {
+        uint8_t token = *ip++;
+
+        size_t lit_len = token >> 4;
+        if (lit_len == RUN_MASK) {
+            uint8_t b;
+            do {
+                if (ip >= iend) return -1;
+                b = *ip++;
+                lit_len += b;
+            } while (b == 255);
+        }
+        if ((lit_len > (size_t)(iend - ip)) ||
+            (lit_len > (size_t)(oend - op))) return -1;
+        memcpy(op, ip, lit_len);
+        op += lit_len;
+        ip += lit_len;
+
+        // The last sequence has no match
+        if (ip >= iend) break;
+
+        if (iend - ip < 2) return -1;
+        size_t offset = ip[0] | (ip[1] << 8);
+        ip += 2;
+        if (!offset || (offset > (size_t)(op - dst))) return -1;
+
+        size_t match_len = token & ML_MASK;
+        if (match_len == ML_MASK) {
+            uint8_t b;
+            do {
+                if (ip >= iend) return -1;
+                b = *ip++;
+                match_len += b;
+            } while (b == 255);
+        }
+        match_len += MINMATCH;
+        if (match_len > (size_t)(oend - op)) return -1;
+
+        // Overlapping copies are how runs are encoded; copy bytewise
+        const uint8_t *match = op - offset;
+        while (match_len--) *op++ = *match++;
+    }
+
+    return op - ostart;
+}
+
+long
+lz4s_decode(const uint8_t *src, size_t srclen, uint8_t *dst, size_t dstcap)
+{
+    if (!src || !dst) return -1;
+
+    const uint8_t *ip = src;
+    const uint8_t *const iend = src + srclen;
+    uint8_t *op = dst;
+    uint8_t *const oend = dst + dstcap;
+
+    while (ip < iend) {
+        if ((iend - ip < LZ4S_FRAME_HEADER_LEN) ||
+            (readLE32(ip) != LZ4S_MAGIC)) return -1;
+
+        // Only the subset we write is understood
+        uint8_t flg = ip[4];
+        if (((flg >> 6) != 1) || (flg & 0x1D)) return -1;
+        if ((uint8_t)(xxh32(&ip[4], 2, 0) >> 8) != ip[6]) return -1;
+        ip += LZ4S_FRAME_HEADER_LEN;
+
+        // Blocks, until the end mark or the end of the input
+        while (iend - ip >= 4) {
+            uint32_t bhdr = readLE32(ip);
+            ip += 4;
+            if (!bhdr) break;
+
+            size_t blen = bhdr & ~LZ4S_UNCOMPRESSED;
+            if (blen > (size_t)(iend - ip)) return -1;
+
+            if (bhdr & LZ4S_UNCOMPRESSED) {
+                if (blen > (size_t)(oend - op)) return -1;
+                memcpy(op, ip, blen);
+                op += blen;
+            } else {
+                long rc = decodeBlock(ip, blen, dst, op, oend);
+                if (rc < 0) return -1;
+                op += rc;
+            }
+            ip += blen;
+        }
+    }
+
+    return op - dst;
+}
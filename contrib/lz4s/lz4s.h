@@ -0,0 +1,61 @@
+/*
+ * lz4s - a small, dependency free, streaming LZ4 frame encoder.
+ *
+ * The output is a standard LZ4 frame (see lz4_Frame_format.md in the
+ * upstream LZ4 project) and can be decoded by any conforming LZ4 decoder,
+ * e.g. `lz4 -d`.  Frames are written with linked blocks, so each block
+ * may reference up to 64KB of data from the blocks before it.  This keeps
+ * the compression ratio high when a stream is flushed often in small
+ * blocks, which is the common case for a telemetry connection.
+ *
+ * Only what's needed to produce a frame is implemented: no block or
+ * content checksums, no content size, no dictionaries.  A simple
+ * decoder for the same subset is included for testing.
+ *
+ * Typical use:
+ *
+ *     lz4s_stream_t *s = lz4s_create();
+ *     n = lz4s_frame_header(out);                     // once per frame
+ *     n = lz4s_compress_block(s, in, inlen, out, cap); // any number
+ *     n = lz4s_end_mark(out);                         // ends the frame
+ *     lz4s_reset(s);                                  // before a new frame
+ *     lz4s_destroy(&s);
+ */
+#ifndef __LZ4S_H__
+#define __LZ4S_H__
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define LZ4S_BLOCK_MAX        (64 * 1024)
+#define LZ4S_FRAME_HEADER_LEN 7
+#define LZ4S_END_MARK_LEN     4
+
+// Worst case output of lz4s_compress_block() for an input of n bytes,
+// including the 4 byte block header.
+#define LZ4S_BLOCK_BOUND(n)   ((n) + ((n) / 255) + 16 + 4)
+
+typedef struct lz4s_stream lz4s_stream_t;
+
+lz4s_stream_t *lz4s_create(void);
+void           lz4s_destroy(lz4s_stream_t **);
+
+// Forget history; call this before starting a new frame
+void           lz4s_reset(lz4s_stream_t *);
+
+// Each of these write to dst and return the number of bytes written.
+size_t         lz4s_frame_header(uint8_t *);
+size_t         lz4s_end_mark(uint8_t *);
+
+// Compresses up to LZ4S_BLOCK_MAX bytes of src into one block.  dst must
+// have room for LZ4S_BLOCK_BOUND(srclen) bytes.  Returns the number of
+// bytes written to dst, or 0 on error.
+size_t         lz4s_compress_block(lz4s_stream_t *, const uint8_t *, size_t,
+                                   uint8_t *, size_t);
+
+// Decodes a buffer holding one or more complete frames, as written above.
+// Returns the number of bytes written to dst, or -1 if the input is
+// malformed or dst is too small.
+long           lz4s_decode(const uint8_t *, size_t, uint8_t *, size_t);
+
+#endif // __LZ4S_H__
@@ -0,0 +1,45 @@
+
+# Consider dependencies only in project.
+set(CMAKE_DEPENDS_IN_PROJECT_ONLY OFF)
+
+# The set of languages for which implicit dependencies are needed:
+set(CMAKE_DEPENDS_LANGUAGES
+  )
+
+# The set of dependency files which are needed:
+set(CMAKE_DEPENDS_DEPENDENCY_FILES
+  "/root/repo/contrib/pcre2/build/pcre2_chartables.c" "CMakeFiles/pcre2-8.dir/pcre2_chartables.c.o" "gcc" "CMakeFiles/pcre2-8.dir/pcre2_chartables.c.o.d"
+  "/root/repo/contrib/pcre2/src/pcre2_auto_possess.c" "CMakeFiles/pcre2-8.dir/src/pcre2_auto_possess.c.o" "gcc" "CMakeFiles/pcre2-8.dir/src/pcre2_auto_possess.c.o.d"
+  "/root/repo/contrib/pcre2/src/pcre2_compile.c" "CMakeFiles/pcre2-8.dir/src/pcre2_compile.c.o" "gcc" "CMakeFiles/pcre2-8.dir/src/pcre2_compile.c.o.d"
+  "/root/repo/contrib/pcre2/src/pcre2_config.c" "CMakeFiles/pcre2-8.dir/src/pcre2_config.c.o" "gcc" "CMakeFiles/pcre2-8.dir/src/pcre2_config.c.o.d"
+  "/root/repo/contrib/pcre2/src/pcre2_context.c" "CMakeFiles/pcre2-8.dir/src/pcre2_context.c.o" "gcc" "CMakeFiles/pcre2-8.dir/src/pcre2_context.c.o.d"
+  "/root/repo/contrib/pcre2/src/pcre2_convert.c" "CMakeFiles/pcre2-8.dir/src/pcre2_convert.c.o" "gcc" "CMakeFiles/pcre2-8.dir/src/pcre2_convert.c.o.d"
+  "/root/repo/contrib/pcre2/src/pcre2_dfa_match.c" "CMakeFiles/pcre2-8.dir/src/pcre2_dfa_match.c.o" "gcc" "CMakeFiles/pcre2-8.dir/src/pcre2_dfa_match.c.o.d"
+  "/root/repo/contrib/pcre2/src/pcre2_error.c" "CMakeFiles/pcre2-8.dir/src/pcre2_error.c.o" "gcc" "CMakeFiles/pcre2-8.dir/src/pcre2_error.c.o.d"
+  "/root/repo/contrib/pcre2/src/pcre2_extuni.c" "CMakeFiles/pcre2-8.dir/src/pcre2_extuni.c.o" "gcc" "CMakeFiles/pcre2-8.dir/src/pcre2_extuni.c.o.d"
+  "/root/repo/contrib/pcre2/src/pcre2_find_bracket.c" "CMakeFiles/pcre2-8.dir/src/pcre2_find_bracket.c.o" "gcc" "CMakeFiles/pcre2-8.dir/src/pcre2_find_bracket.c.o.d"
+  "/root/repo/contrib/pcre2/src/pcre2_jit_compile.c" "CMakeFiles/pcre2-8.dir/src/pcre2_jit_compile.c.o" "gcc" "CMakeFiles/pcre2-8.dir/src/pcre2_jit_compile.c.o.d"
+  "/root/repo/contrib/pcre2/src/pcre2_maketables.c" "CMakeFiles/pcre2-8.dir/src/pcre2_maketables.c.o" "gcc" "CMakeFiles/pcre2-8.dir/src/pcre2_maketables.c.o.d"
+  "/root/repo/contrib/pcre2/src/pcre2_match.c" "CMakeFiles/pcre2-8.dir/src/pcre2_match.c.o" "gcc" "CMakeFiles/pcre2-8.dir/src/pcre2_match.c.o.d"
+  "/root/repo/contrib/pcre2/src/pcre2_match_data.c" "CMakeFiles/pcre2-8.dir/src/pcre2_match_data.c.o" "gcc" "CMakeFiles/pcre2-8.dir/src/pcre2_match_data.c.o.d"
+  "/root/repo/contrib/pcre2/src/pcre2_newline.c" "CMakeFiles/pcre2-8.dir/src/pcre2_newline.c.o" "gcc" "CMakeFiles/pcre2-8.dir/src/pcre2_newline.c.o.d"
+  "/root/repo/contrib/pcre2/src/pcre2_ord2utf.c" "CMakeFiles/pcre2-8.dir/src/pcre2_ord2utf.c.o" "gcc" "CMakeFiles/pcre2-8.dir/src/pcre2_ord2utf.c.o.d"
+  "/root/repo/contrib/pcre2/src/pcre2_pattern_info.c" "CMakeFiles/pcre2-8.dir/src/pcre2_pattern_info.c.o" "gcc" "CMakeFiles/pcre2-8.dir/src/pcre2_pattern_info.c.o.d"
+  "/root/repo/contrib/pcre2/src/pcre2_script_run.c" "CMakeFiles/pcre2-8.dir/src/pcre2_script_run.c.o" "gcc" "CMakeFiles/pcre2-8.dir/src/pcre2_script_run.c.o.d"
+  "/root/repo/contrib/pcre2/src/pcre2_serialize.c" "CMakeFiles/pcre2-8.dir/src/pcre2_serialize.c.o" "gcc" "CMakeFiles/pcre2-8.dir/src/pcre2_serialize.c.o.d"
+  "/root/repo/contrib/pcre2/src/pcre2_string_utils.c" "CMakeFiles/pcre2-8.dir/src/pcre2_string_utils.c.o" "gcc" "CMakeFiles/pcre2-8.dir/src/pcre2_string_utils.c.o.d"
+  "/root/repo/contrib/pcre2/src/pcre2_study.c" "CMakeFiles/pcre2-8.dir/src/pcre2_study.c.o" "gcc" "CMakeFiles/pcre2-8.dir/src/pcre2_study.c.o.d"
+  "/root/repo/contrib/pcre2/src/pcre2_substitute.c" "CMakeFiles/pcre2-8.dir/src/pcre2_substitute.c.o" "gcc" "CMakeFiles/pcre2-8.dir/src/pcre2_substitute.c.o.d"
+  "/root/repo/contrib/pcre2/src/pcre2_substring.c" "CMakeFiles/pcre2-8.dir/src/pcre2_substring.c.o" "gcc" "CMakeFiles/pcre2-8.dir/src/pcre2_substring.c.o.d"
+  "/root/repo/contrib/pcre2/src/pcre2_tables.c" "CMakeFiles/pcre2-8.dir/src/pcre2_tables.c.o" "gcc" "CMakeFiles/pcre2-8.dir/src/pcre2_tables.c.o.d"
+  "/root/repo/contrib/pcre2/src/pcre2_ucd.c" "CMakeFiles/pcre2-8.dir/src/pcre2_ucd.c.o" "gcc" "CMakeFiles/pcre2-8.dir/src/pcre2_ucd.c.o.d"
+  "/root/repo/contrib/pcre2/src/pcre2_valid_utf.c" "CMakeFiles/pcre2-8.dir/src/pcre2_valid_utf.c.o" "gcc" "CMakeFiles/pcre2-8.dir/src/pcre2_valid_utf.c.o.d"
+  "/root/repo/contrib/pcre2/src/pcre2_xclass.c" "CMakeFiles/pcre2-8.dir/src/pcre2_xclass.c.o" "gcc" "CMakeFiles/pcre2-8.dir/src/pcre2_xclass.c.o.d"
+  )
+
+# Targets to which this target links.
+set(CMAKE_TARGET_LINKED_INFO_FILES
+  )
+
+# Fortran module output directory.
+set(CMAKE_Fortran_TARGET_MODULE_DIR "")
@@ -0,0 +1,63 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/pcre2-8.dir/pcre2_chartables.c.o"
+  "CMakeFiles/pcre2-8.dir/pcre2_chartables.c.o.d"
+  "CMakeFiles/pcre2-8.dir/src/pcre2_auto_possess.c.o"
+  "CMakeFiles/pcre2-8.dir/src/pcre2_auto_possess.c.o.d"
+  "CMakeFiles/pcre2-8.dir/src/pcre2_compile.c.o"
+  "CMakeFiles/pcre2-8.dir/src/pcre2_compile.c.o.d"
+  "CMakeFiles/pcre2-8.dir/src/pcre2_config.c.o"
+  "CMakeFiles/pcre2-8.dir/src/pcre2_config.c.o.d"
+  "CMakeFiles/pcre2-8.dir/src/pcre2_context.c.o"
+  "CMakeFiles/pcre2-8.dir/src/pcre2_context.c.o.d"
+  "CMakeFiles/pcre2-8.dir/src/pcre2_convert.c.o"
+  "CMakeFiles/pcre2-8.dir/src/pcre2_convert.c.o.d"
+  "CMakeFiles/pcre2-8.dir/src/pcre2_dfa_match.c.o"
+  "CMakeFiles/pcre2-8.dir/src/pcre2_dfa_match.c.o.d"
+  "CMakeFiles/pcre2-8.dir/src/pcre2_error.c.o"
+  "CMakeFiles/pcre2-8.dir/src/pcre2_error.c.o.d"
+  "CMakeFiles/pcre2-8.dir/src/pcre2_extuni.c.o"
+  "CMakeFiles/pcre2-8.dir/src/pcre2_extuni.c.o.d"
+  "CMakeFiles/pcre2-8.dir/src/pcre2_find_bracket.c.o"
+  "CMakeFiles/pcre2-8.dir/src/pcre2_find_bracket.c.o.d"
+  "CMakeFiles/pcre2-8.dir/src/pcre2_jit_compile.c.o"
+  "CMakeFiles/pcre2-8.dir/src/pcre2_jit_compile.c.o.d"
+  "CMakeFiles/pcre2-8.dir/src/pcre2_maketables.c.o"
+  "CMakeFiles/pcre2-8.dir/src/pcre2_maketables.c.o.d"
+  "CMakeFiles/pcre2-8.dir/src/pcre2_match.c.o"
+  "CMakeFiles/pcre2-8.dir/src/pcre2_match.c.o.d"
+  "CMakeFiles/pcre2-8.dir/src/pcre2_match_data.c.o"
+  "CMakeFiles/pcre2-8.dir/src/pcre2_match_data.c.o.d"
+  "CMakeFiles/pcre2-8.dir/src/pcre2_newline.c.o"
+  "CMakeFiles/pcre2-8.dir/src/pcre2_newline.c.o.d"
+  "CMakeFiles/pcre2-8.dir/src/pcre2_ord2utf.c.o"
+  "CMakeFiles/pcre2-8.dir/src/pcre2_ord2utf.c.o.d"
+  "CMakeFiles/pcre2-8.dir/src/pcre2_pattern_info.c.o"
+  "CMakeFiles/pcre2-8.dir/src/pcre2_pattern_info.c.o.d"
+  "CMakeFiles/pcre2-8.dir/src/pcre2_script_run.c.o"
+  "CMakeFiles/pcre2-8.dir/src/pcre2_script_run.c.o.d"
+  "CMakeFiles/pcre2-8.dir/src/pcre2_serialize.c.o"
+  "CMakeFiles/pcre2-8.dir/src/pcre2_serialize.c.o.d"
+  "CMakeFiles/pcre2-8.dir/src/pcre2_string_utils.c.o"
+  "CMakeFiles/pcre2-8.dir/src/pcre2_string_utils.c.o.d"
+  "CMakeFiles/pcre2-8.dir/src/pcre2_study.c.o"
+  "CMakeFiles/pcre2-8.dir/src/pcre2_study.c.o.d"
+  "CMakeFiles/pcre2-8.dir/src/pcre2_substitute.c.o"
+  "CMakeFiles/pcre2-8.dir/src/pcre2_substitute.c.o.d"
+  "CMakeFiles/pcre2-8.dir/src/pcre2_substring.c.o"
+  "CMakeFiles/pcre2-8.dir/src/pcre2_substring.c.o.d"
+  "CMakeFiles/pcre2-8.dir/src/pcre2_tables.c.o"
+  "CMakeFiles/pcre2-8.dir/src/pcre2_tables.c.o.d"
+  "CMakeFiles/pcre2-8.dir/src/pcre2_ucd.c.o"
+  "CMakeFiles/pcre2-8.dir/src/pcre2_ucd.c.o.d"
+  "CMakeFiles/pcre2-8.dir/src/pcre2_valid_utf.c.o"
+  "CMakeFiles/pcre2-8.dir/src/pcre2_valid_utf.c.o.d"
+  "CMakeFiles/pcre2-8.dir/src/pcre2_xclass.c.o"
+  "CMakeFiles/pcre2-8.dir/src/pcre2_xclass.c.o.d"
+  "libpcre2-8.a"
+  "libpcre2-8.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang C)
+  include(CMakeFiles/pcre2-8.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
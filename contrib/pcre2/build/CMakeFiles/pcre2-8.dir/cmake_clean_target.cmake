@@ -0,0 +1,3 @@
+file(REMOVE_RECURSE
+  "libpcre2-8.a"
+)
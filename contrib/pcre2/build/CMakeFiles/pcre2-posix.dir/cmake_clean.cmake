@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/pcre2-posix.dir/src/pcre2posix.c.o"
+  "CMakeFiles/pcre2-posix.dir/src/pcre2posix.c.o.d"
+  "libpcre2-posix.a"
+  "libpcre2-posix.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang C)
+  include(CMakeFiles/pcre2-posix.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
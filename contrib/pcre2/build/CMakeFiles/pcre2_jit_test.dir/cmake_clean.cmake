@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/pcre2_jit_test.dir/src/pcre2_jit_test.c.o"
+  "CMakeFiles/pcre2_jit_test.dir/src/pcre2_jit_test.c.o.d"
+  "pcre2_jit_test"
+  "pcre2_jit_test.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang C)
+  include(CMakeFiles/pcre2_jit_test.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
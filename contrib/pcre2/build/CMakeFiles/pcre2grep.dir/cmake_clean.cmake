@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/pcre2grep.dir/src/pcre2grep.c.o"
+  "CMakeFiles/pcre2grep.dir/src/pcre2grep.c.o.d"
+  "pcre2grep"
+  "pcre2grep.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang C)
+  include(CMakeFiles/pcre2grep.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,21 @@
+
+# Consider dependencies only in project.
+set(CMAKE_DEPENDS_IN_PROJECT_ONLY OFF)
+
+# The set of languages for which implicit dependencies are needed:
+set(CMAKE_DEPENDS_LANGUAGES
+  )
+
+# The set of dependency files which are needed:
+set(CMAKE_DEPENDS_DEPENDENCY_FILES
+  "/root/repo/contrib/pcre2/src/pcre2test.c" "CMakeFiles/pcre2test.dir/src/pcre2test.c.o" "gcc" "CMakeFiles/pcre2test.dir/src/pcre2test.c.o.d"
+  )
+
+# Targets to which this target links.
+set(CMAKE_TARGET_LINKED_INFO_FILES
+  "/root/repo/contrib/pcre2/build/CMakeFiles/pcre2-posix.dir/DependInfo.cmake"
+  "/root/repo/contrib/pcre2/build/CMakeFiles/pcre2-8.dir/DependInfo.cmake"
+  )
+
+# Fortran module output directory.
+set(CMAKE_Fortran_TARGET_MODULE_DIR "")
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/pcre2test.dir/src/pcre2test.c.o"
+  "CMakeFiles/pcre2test.dir/src/pcre2test.c.o.d"
+  "pcre2test"
+  "pcre2test.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang C)
+  include(CMakeFiles/pcre2test.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
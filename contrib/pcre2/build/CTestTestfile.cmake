@@ -0,0 +1,12 @@
+# CMake generated Testfile for 
+# Source directory: /root/repo/contrib/pcre2
+# Build directory: /root/repo/contrib/pcre2/build
+# 
+# This file includes the relevant testing commands required for 
+# testing this directory and lists subdirectories to be tested as well.
+add_test(pcre2_test "sh" "/root/repo/contrib/pcre2/build/pcre2_test.sh")
+set_tests_properties(pcre2_test PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/contrib/pcre2/CMakeLists.txt;697;ADD_TEST;/root/repo/contrib/pcre2/CMakeLists.txt;0;")
+add_test(pcre2_grep_test "sh" "/root/repo/contrib/pcre2/build/pcre2_grep_test.sh")
+set_tests_properties(pcre2_grep_test PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/contrib/pcre2/CMakeLists.txt;710;ADD_TEST;/root/repo/contrib/pcre2/CMakeLists.txt;0;")
+add_test(pcre2_jit_test "pcre2_jit_test")
+set_tests_properties(pcre2_jit_test PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/contrib/pcre2/CMakeLists.txt;750;ADD_TEST;/root/repo/contrib/pcre2/CMakeLists.txt;0;")
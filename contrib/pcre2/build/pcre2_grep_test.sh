@@ -0,0 +1,5 @@
+#! /bin/sh
+# This is a generated file.
+. /root/repo/contrib/pcre2/RunGrepTest
+if test "$?" != "0"; then exit 1; fi
+# End
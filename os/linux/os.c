@@ -770,6 +770,27 @@ static const char scope_help_configuration[] =
 "    SCOPE_METRIC_FORMAT\n"
 "        statsd, ndjson\n"
 "        Default is statsd.\n"
+"    SCOPE_METRIC_SCRAPE_ENABLE\n"
+"        Flag that enables a local endpoint that serves metric totals in\n"
+"        the OpenMetrics text format, for Prometheus to scrape.\n"
+"        true,false  Default is false.\n"
+"    SCOPE_METRIC_SCRAPE_LISTEN\n"
+"        Where the scrape endpoint listens.  Only loopback addresses and\n"
+"        unix sockets are allowed.  Scrapes are answered at /metrics.\n"
+"        Default is tcp://127.0.0.1:9190\n"
+"        Format is one of:\n"
+"            tcp://127.0.0.1:<123>\n"
+"            unix:///var/run/scope.sock\n"
+"    SCOPE_METRIC_HTTP_NORMALIZE\n"
+"        Flag that normalizes the targets of http metrics before they're\n"
+"        aggregated.  Path segments of digits, UUIDs and hex become {int},\n"
+"        {uuid} and {hex}.\n"
+"        true,false  Default is true.\n"
+"    SCOPE_METRIC_HTTP_TEMPLATES\n"
+"        A comma separated list of paths that targets of http metrics\n"
+"        are normalized to, where a segment in braces matches any\n"
+"        segment.  e.g. /users/{id},/users/{id}/orders/{order}\n"
+"        Default is none.\n"
 "    SCOPE_STATSD_PREFIX\n"
 "        Specify a string to be prepended to every scope metric.\n"
 "    SCOPE_STATSD_MAXLEN\n"
@@ -783,7 +804,9 @@ static const char scope_help_configuration[] =
 "        Same format as SCOPE_METRIC_DEST above.\n"
 "        Default is tcp://localhost:9109\n"
 "    SCOPE_EVENT_FORMAT\n"
-"        ndjson\n"
+"        ndjson, msgpack\n"
+"        msgpack sends each event as a 4 byte big-endian length followed\n"
+"        by a msgpack map with the same contents as the ndjson event.\n"
 "        Default is ndjson.\n"
 "    SCOPE_EVENT_LOGFILE\n"
 "        Create events from writes to log files.\n"
@@ -872,6 +895,10 @@ static const char scope_help_configuration[] =
 "    SCOPE_ENHANCE_FS\n"
 "        Controls whether uid, gid, and mode are captured for each open.\n"
 "        Used only if SCOPE_EVENT_FS is true. true,false Default is true.\n"
+"    SCOPE_EVENT_CAPTURE_TIME\n"
+"        Controls whether the _time of net, fs, dns and http events is\n"
+"        when the activity happened rather than when it was reported.\n"
+"        true,false Default is false.\n"
 "    SCOPE_LOG_LEVEL\n"
 "        debug, info, warning, error, none. Default is error.\n"
 "    SCOPE_LOG_DEST\n"
@@ -890,6 +917,10 @@ static const char scope_help_configuration[] =
 "    SCOPE_PAYLOAD_DIR\n"
 "        Specifies a directory where payload capture files can be written.\n"
 "        Default is /tmp\n"
+"    SCOPE_PAYLOAD_FORMAT\n"
+"        Format of payload capture files.  raw writes one file per connection\n"
+"        and direction.  pcapng writes one <pid>.pcapng file per process,\n"
+"        which can be opened with wireshark.  raw, pcapng  Default is raw.\n"
 "    SCOPE_CRIBL\n"
 "        Defines a connection with Cribl LogStream\n"
 "        Default is NULL\n"
@@ -995,7 +1026,9 @@ static const char scope_help_protocol[] =
 "     Scope can detect any defined network protocol. You provide protocol\n"
 "     definitions in a separate YAML config file (which should be named \n"
 "     scope_protocol.yml). You describe protocol specifics in one or more regex \n"
-"     definitions. PCRE2 regular expressions are supported. You can find a \n"
+"     definitions. PCRE2 regular expressions are supported. Binary protocols\n"
+"     can instead be described with a byte signature, e.g. \"16 03 00-03\",\n"
+"     which is matched without converting the payload to hex. You can find a\n"
 "     sample config file at\n"
 "     https://github.com/criblio/appscope/blob/master/conf/scope_protocol.yml.\n"
 "\n"
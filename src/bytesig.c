@@ -0,0 +1,288 @@
+#define _GNU_SOURCE
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include "bytesig.h"
+#include "dbg.h"
+
+// The bytes that can be at an offset, one bit each
+typedef struct {
+    uint16_t off;
+    uint8_t set[32];
+} sigtest_t;
+
+struct _bytesig_t {
+    size_t len;                     // bytes needed for every test
+    int num;
+    sigtest_t test[BYTESIG_MAX_TESTS];
+};
+
+static int
+hexValue(char c)
+{
+    if ((c >= '0') && (c <= '9')) return c - '0';
+    if ((c >= 'a') && (c <= 'f')) return c - 'a' + 10;
+    if ((c >= 'A') && (c <= 'F')) return c - 'A' + 10;
+    return -1;
+}
+
+// Only lowercase is in the hex that regexes are matched against
+static int
+lowerHexValue(char c)
+{
+    return ((c >= 'A') && (c <= 'F')) ? -1 : hexValue(c);
+}
+
+// Adds a test of the byte at off, unless any byte would pass it.
+// Returns FALSE if there are too many tests.
+static int
+addTest(bytesig_t *sig, size_t off, const uint8_t set[32])
+{
+    if (off >= sig->len) sig->len = off + 1;
+
+    int i;
+    for (i = 0; (i < 32) && (set[i] == 0xff); i++);
+    if (i == 32) return TRUE;
+
+    if (sig->num >= BYTESIG_MAX_TESTS) return FALSE;
+    sigtest_t *test = &sig->test[sig->num++];
+    test->off = off;
+    memcpy(test->set, set, sizeof(test->set));
+    return TRUE;
+}
+
+// The bytes from lo to hi, once they're and'ed with mask
+static void
+setOfRange(uint8_t set[32], int lo, int hi, int mask)
+{
+    memset(set, 0, 32);
+    int b;
+    for (b = 0; b < 256; b++) {
+        int val = b & mask;
+        if ((val >= lo) && (val <= hi)) set[b >> 3] |= 1 << (b & 7);
+    }
+}
+
+// The bytes whose high nibble is in hi and whose low nibble is in lo
+static void
+setOfNibbles(uint8_t set[32], uint16_t hi, uint16_t lo)
+{
+    memset(set, 0, 32);
+    int b;
+    for (b = 0; b < 256; b++) {
+        if (((hi >> (b >> 4)) & 1) && ((lo >> (b & 0xf)) & 1)) {
+            set[b >> 3] |= 1 << (b & 7);
+        }
+    }
+}
+
+// Parses a byte that can have '?' for either nibble, e.g. "1?".  Sets the
+// bits that aren't '?' in mask.  Returns FALSE if it's not a byte.
+static int
+parseByte(const char *str, int *val, int *mask)
+{
+    *val = 0;
+    *mask = 0;
+    int i;
+    for (i = 0; i < 2; i++) {
+        int shift = (i) ? 0 : 4;
+        int nibble = hexValue(str[i]);
+        if (nibble >= 0) {
+            *val |= nibble << shift;
+            *mask |= 0xf << shift;
+        } else if (str[i] != '?') {
+            return FALSE;
+        }
+    }
+    return TRUE;
+}
+
+// Parses one test, e.g. "16", "??", "1?", "00-03" or "40&f0"
+static int
+parseTest(const char *tok, size_t len, uint8_t set[32])
+{
+    int val, mask, hi, himask;
+
+    if ((len < 2) || !parseByte(tok, &val, &mask)) return FALSE;
+
+    if (len == 2) {
+        setOfRange(set, val, val, mask);
+        return TRUE;
+    }
+
+    if ((len != 5) || (mask != 0xff) || !parseByte(&tok[3], &hi, &himask) ||
+        (himask != 0xff)) return FALSE;
+
+    if (tok[2] == '-') {
+        if (val > hi) return FALSE;
+        setOfRange(set, val, hi, 0xff);
+        return TRUE;
+    }
+
+    // A value with bits outside of its mask can't be matched
+    if ((tok[2] == '&') && !(val & ~hi)) {
+        setOfRange(set, val, val, hi);
+        return TRUE;
+    }
+    return FALSE;
+}
+
+bytesig_t *
+bytesigCreate(const char *str)
+{
+    if (!str) return NULL;
+
+    bytesig_t *sig = calloc(1, sizeof(*sig));
+    if (!sig) {
+        DBG(NULL);
+        return NULL;
+    }
+
+    size_t off = 0;
+    const char *tok = str;
+    while (*tok) {
+        size_t len = strcspn(tok, " \t");
+        if (!len) {
+            tok++;
+            continue;
+        }
+
+        if (tok[0] == '@') {
+            char *end;
+            unsigned long val = strtoul(&tok[1], &end, 10);
+            if ((len < 2) || (end != &tok[len]) || (val > BYTESIG_MAX_OFFSET)) goto err;
+            off = val;
+        } else {
+            uint8_t set[32];
+            if ((off > BYTESIG_MAX_OFFSET) || !parseTest(tok, len, set) ||
+                !addTest(sig, off, set)) goto err;
+            off++;
+        }
+        tok += len;
+    }
+
+    // Nothing to match
+    if (!sig->len) goto err;
+    return sig;
+
+err:
+    free(sig);
+    return NULL;
+}
+
+// Parses one character of a regex over hex, e.g. "a", "." or "[0-3]", and
+// its repeat count, e.g. "{4}".  Returns where it ends, or NULL if the
+// regex can't be turned into a signature.
+static const char *
+parseHexAtom(const char *p, uint16_t *set, size_t *rep)
+{
+    int val;
+
+    if (*p == '.') {
+        *set = 0xffff;
+        p++;
+    } else if (*p == '[') {
+        *set = 0;
+        p++;
+        while (*p != ']') {
+            if ((val = lowerHexValue(*p)) < 0) return NULL;
+            int hi = val;
+            if ((p[1] == '-') && (p[2] != ']')) {
+                if (((hi = lowerHexValue(p[2])) < 0) || (hi < val)) return NULL;
+                p += 2;
+            }
+            for (; val <= hi; val++) *set |= 1 << val;
+            p++;
+        }
+        if (!*set) return NULL;
+        p++;
+    } else if ((val = lowerHexValue(*p)) >= 0) {
+        *set = 1 << val;
+        p++;
+    } else {
+        return NULL;
+    }
+
+    *rep = 1;
+    if (*p == '{') {
+        char *end;
+        unsigned long val = strtoul(&p[1], &end, 10);
+        if ((end == &p[1]) || (*end != '}') || (val > 2 * (BYTESIG_MAX_OFFSET + 1))) {
+            return NULL;
+        }
+        *rep = val;
+        p = end + 1;
+    }
+    return p;
+}
+
+bytesig_t *
+bytesigFromHexRegex(const char *regex)
+{
+    if (!regex || (regex[0] != '^')) return NULL;
+
+    bytesig_t *sig = calloc(1, sizeof(*sig));
+    if (!sig) {
+        DBG(NULL);
+        return NULL;
+    }
+
+    // Every two characters of the hex are a byte, high nibble first
+    size_t nibbles = 0;
+    uint16_t hi = 0;
+    const char *p = &regex[1];
+    while (*p) {
+        uint16_t set;
+        size_t rep;
+        if (!(p = parseHexAtom(p, &set, &rep))) goto err;
+
+        while (rep--) {
+            if (nibbles / 2 > BYTESIG_MAX_OFFSET) goto err;
+            if (nibbles & 1) {
+                uint8_t bytes[32];
+                setOfNibbles(bytes, hi, set);
+                if (!addTest(sig, nibbles / 2, bytes)) goto err;
+            } else {
+                hi = set;
+            }
+            nibbles++;
+        }
+    }
+
+    // A last high nibble on its own
+    if (nibbles & 1) {
+        uint8_t bytes[32];
+        setOfNibbles(bytes, hi, 0xffff);
+        if (!addTest(sig, nibbles / 2, bytes)) goto err;
+    }
+
+    if (!sig->len) goto err;
+    return sig;
+
+err:
+    free(sig);
+    return NULL;
+}
+
+void
+bytesigDestroy(bytesig_t **sig)
+{
+    if (!sig || !*sig) return;
+    free(*sig);
+    *sig = NULL;
+}
+
+int
+bytesigMatch(const bytesig_t *sig, const void *buf, size_t len)
+{
+    if (!sig || !buf || (len < sig->len)) return 0;
+
+    const uint8_t *data = buf;
+    int i;
+    for (i = 0; i < sig->num; i++) {
+        const sigtest_t *test = &sig->test[i];
+        uint8_t c = data[test->off];
+        if (!(test->set[c >> 3] & (1 << (c & 7)))) return 0;
+    }
+    return 1;
+}
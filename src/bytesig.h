@@ -0,0 +1,45 @@
+#ifndef __BYTESIG_H__
+#define __BYTESIG_H__
+
+#include <stddef.h>
+
+/*
+ * Matches the start of a buffer against a byte signature, to detect
+ * binary protocols without converting the buffer to hex first.
+ *
+ * A signature is a list of byte tests, separated by spaces.  Each test is
+ * of the byte after the one before it, starting at offset 0:
+ *
+ *   16        the byte 0x16
+ *   ??        any byte
+ *   1? or ?f  any byte with that high (or low) nibble
+ *   00-03     any byte from 0x00 to 0x03
+ *   40&f0     any byte that's 0x40 once it's and'ed with 0xf0
+ *   @12       not a test; the next test is of the byte at offset 12
+ *
+ * e.g. "16 03 00-03 ?? ?? 01-02" is the start of a TLS ClientHello or
+ * ServerHello.  Hex digits can be upper or lower case.  A buffer that's
+ * too short for every test doesn't match.
+ *
+ * Protocol definitions that predate signatures match a regex against the
+ * buffer in hex.  The simple ones, which only test nibbles at fixed
+ * offsets from the start, can be turned into signatures too.
+ */
+
+#define BYTESIG_MAX_TESTS 64
+#define BYTESIG_MAX_OFFSET 4095
+
+typedef struct _bytesig_t bytesig_t;
+
+// Constructors Destructors
+// Returns NULL if sig isn't a valid signature.
+bytesig_t *         bytesigCreate(const char *sig);
+// Returns NULL if regex isn't anchored with '^', or uses anything other
+// than lowercase hex digits, '.', classes of those like [0-3], and {n}.
+bytesig_t *         bytesigFromHexRegex(const char *regex);
+void                bytesigDestroy(bytesig_t **);
+
+// Returns 1 if buf starts with the signature, 0 if it doesn't.
+int                 bytesigMatch(const bytesig_t *, const void *buf, size_t len);
+
+#endif // __BYTESIG_H__
@@ -17,6 +17,7 @@ typedef struct {
             unsigned validateserver;
             char *cacertpath;
         } tls;
+        cfg_compress_t compression;
     } net;
     struct {
         char* path;                      // For type CFG_FILE
@@ -41,18 +42,31 @@ struct _config_t
         } statsd;
         unsigned period;
         unsigned verbosity;
+        struct {
+            unsigned enable;
+            char *listen;
+        } scrape;
+        struct {
+            unsigned normalize;
+            char *templates;
+        } http;
     } mtc;
 
     struct {
         unsigned enable;
         cfg_mtc_format_t format;
         unsigned ratelimit;
+        unsigned capturetime;
         char *valuefilter[CFG_SRC_MAX];
         char *fieldfilter[CFG_SRC_MAX];
         char *namefilter[CFG_SRC_MAX];
         unsigned src[CFG_SRC_MAX];
         size_t numHeaders;
         header_extract_t **hextract;
+        struct {
+            char *dir;
+            unsigned long maxsize;
+        } spill;
     } evt;
 
     struct {
@@ -62,6 +76,7 @@ struct _config_t
     struct {
         unsigned int enable;
         char *dir;
+        cfg_pay_format_t format;
     } pay;
 
     // CFG_MTC, CFG_CTL, or CFG_LOG
@@ -173,9 +188,14 @@ cfgCreateDefault()
     c->mtc.statsd.maxlen = DEFAULT_STATSD_MAX_LEN;
     c->mtc.period = DEFAULT_SUMMARY_PERIOD;
     c->mtc.verbosity = DEFAULT_MTC_VERBOSITY;
+    c->mtc.scrape.enable = DEFAULT_MTC_SCRAPE_ENABLE;
+    c->mtc.scrape.listen = (DEFAULT_MTC_SCRAPE_LISTEN) ? strdup(DEFAULT_MTC_SCRAPE_LISTEN) : NULL;
+    c->mtc.http.normalize = DEFAULT_MTC_HTTP_NORMALIZE;
+    c->mtc.http.templates = (DEFAULT_MTC_HTTP_TEMPLATES) ? strdup(DEFAULT_MTC_HTTP_TEMPLATES) : NULL;
     c->evt.enable = DEFAULT_EVT_ENABLE;
     c->evt.format = DEFAULT_CTL_FORMAT;
     c->evt.ratelimit = DEFAULT_MAXEVENTSPERSEC;
+    c->evt.capturetime = DEFAULT_EVT_CAPTURE_TIME;
 
     watch_t src;
     for (src=CFG_SRC_FILE; src<CFG_SRC_MAX; src++) {
@@ -191,6 +211,9 @@ cfgCreateDefault()
     c->evt.hextract = DEFAULT_SRC_HTTP_HEADER;
     c->evt.numHeaders = 0;
 
+    c->evt.spill.dir = (DEFAULT_EVT_SPILL_DIR) ? strdup(DEFAULT_EVT_SPILL_DIR) : NULL;
+    c->evt.spill.maxsize = DEFAULT_EVT_SPILL_MAXSIZE;
+
     which_transport_t tp;
     for (tp=CFG_MTC; tp<CFG_WHICH_MAX; tp++) {
         c->transport[tp].type = typeDefault[tp];
@@ -204,12 +227,14 @@ cfgCreateDefault()
         c->transport[tp].net.tls.enable = DEFAULT_TLS_ENABLE;
         c->transport[tp].net.tls.validateserver = DEFAULT_TLS_VALIDATE_SERVER;
         c->transport[tp].net.tls.cacertpath = (DEFAULT_TLS_CA_CERT) ? strdup(DEFAULT_TLS_CA_CERT) : NULL;
+        c->transport[tp].net.compression = DEFAULT_COMPRESSION;
     }
 
     c->log.level = DEFAULT_LOG_LEVEL;
 
     c->pay.enable = DEFAULT_PAYLOAD_ENABLE;
     c->pay.dir = (DEFAULT_PAYLOAD_DIR) ? strdup(DEFAULT_PAYLOAD_DIR) : NULL;
+    c->pay.format = DEFAULT_PAYLOAD_FORMAT;
 
     c->tags = DEFAULT_CUSTOM_TAGS;
     c->max_tags = DEFAULT_NUM_TAGS;
@@ -228,6 +253,8 @@ cfgDestroy(config_t **cfg)
     if (!cfg || !*cfg) return;
     config_t *c = *cfg;
     if (c->mtc.statsd.prefix) free(c->mtc.statsd.prefix);
+    if (c->mtc.scrape.listen) free(c->mtc.scrape.listen);
+    if (c->mtc.http.templates) free(c->mtc.http.templates);
     if (c->commanddir) free(c->commanddir);
 
     watch_t src;
@@ -248,6 +275,7 @@ cfgDestroy(config_t **cfg)
     }
 
     if (c->evt.hextract) free(c->evt.hextract);
+    if (c->evt.spill.dir) free(c->evt.spill.dir);
 
     which_transport_t t;
     for (t=CFG_MTC; t<CFG_WHICH_MAX; t++) {
@@ -305,6 +333,30 @@ cfgMtcPeriod(config_t* cfg)
     return (cfg) ? cfg->mtc.period : DEFAULT_SUMMARY_PERIOD;
 }
 
+unsigned
+cfgMtcScrapeEnable(config_t* cfg)
+{
+    return (cfg) ? cfg->mtc.scrape.enable : DEFAULT_MTC_SCRAPE_ENABLE;
+}
+
+const char *
+cfgMtcScrapeListen(config_t* cfg)
+{
+    return (cfg) ? cfg->mtc.scrape.listen : DEFAULT_MTC_SCRAPE_LISTEN;
+}
+
+unsigned
+cfgMtcHttpNormalize(config_t* cfg)
+{
+    return (cfg) ? cfg->mtc.http.normalize : DEFAULT_MTC_HTTP_NORMALIZE;
+}
+
+const char *
+cfgMtcHttpTemplates(config_t* cfg)
+{
+    return (cfg) ? cfg->mtc.http.templates : DEFAULT_MTC_HTTP_TEMPLATES;
+}
+
 const char *
 cfgCmdDir(config_t* cfg)
 {
@@ -335,12 +387,30 @@ cfgEvtRateLimit(config_t* cfg)
     return (cfg) ? cfg->evt.ratelimit : DEFAULT_MAXEVENTSPERSEC;
 }
 
+unsigned
+cfgEvtCaptureTime(config_t* cfg)
+{
+    return (cfg) ? cfg->evt.capturetime : DEFAULT_EVT_CAPTURE_TIME;
+}
+
 unsigned
 cfgEnhanceFs(config_t* cfg)
 {
     return (cfg) ? cfg->enhancefs : DEFAULT_ENHANCE_FS;
 }
 
+const char *
+cfgEvtSpillDir(config_t *cfg)
+{
+    return (cfg) ? cfg->evt.spill.dir : DEFAULT_EVT_SPILL_DIR;
+}
+
+unsigned long
+cfgEvtSpillMaxSize(config_t *cfg)
+{
+    return (cfg) ? cfg->evt.spill.maxsize : DEFAULT_EVT_SPILL_MAXSIZE;
+}
+
 const char*
 cfgEvtFormatValueFilter(config_t* cfg, watch_t src)
 {
@@ -522,6 +592,17 @@ cfgTransportTlsCACertPath(config_t *cfg, which_transport_t t)
     return DEFAULT_TLS_CA_CERT;
 }
 
+cfg_compress_t
+cfgTransportCompression(config_t *cfg, which_transport_t t)
+{
+    if (t >= 0 && t < CFG_WHICH_MAX) {
+        if (cfg) return cfg->transport[t].net.compression;
+        return DEFAULT_COMPRESSION;
+    }
+    DBG("%d", t);
+    return DEFAULT_COMPRESSION;
+}
+
 custom_tag_t**
 cfgCustomTags(config_t* cfg)
 {
@@ -572,6 +653,12 @@ cfgPayDir(config_t *cfg)
     return (cfg) ? cfg->pay.dir : DEFAULT_PAYLOAD_DIR;
 }
 
+cfg_pay_format_t
+cfgPayFormat(config_t *cfg)
+{
+    return (cfg) ? cfg->pay.format : DEFAULT_PAYLOAD_FORMAT;
+}
+
 bool
 cfgLogStream(config_t *cfg)
 {
@@ -592,6 +679,8 @@ void
 cfgMtcFormatSet(config_t* cfg, cfg_mtc_format_t fmt)
 {
     if (!cfg || fmt < 0 || fmt >= CFG_FORMAT_MAX) return;
+    // msgpack is only supported for events
+    if (fmt == CFG_FMT_MSGPACK) return;
     cfg->mtc.format = fmt;
 }
 
@@ -636,6 +725,46 @@ cfgMtcPeriodSet(config_t* cfg, unsigned val)
     cfg->mtc.period = val;
 }
 
+void
+cfgMtcScrapeEnableSet(config_t* cfg, unsigned val)
+{
+    if (!cfg || val > 1) return;
+    cfg->mtc.scrape.enable = val;
+}
+
+void
+cfgMtcScrapeListenSet(config_t* cfg, const char* listen)
+{
+    if (!cfg) return;
+    if (cfg->mtc.scrape.listen) free(cfg->mtc.scrape.listen);
+    if (!listen || (listen[0] == '\0')) {
+        cfg->mtc.scrape.listen = (DEFAULT_MTC_SCRAPE_LISTEN) ? strdup(DEFAULT_MTC_SCRAPE_LISTEN) : NULL;
+        return;
+    }
+
+    cfg->mtc.scrape.listen = strdup(listen);
+}
+
+void
+cfgMtcHttpNormalizeSet(config_t* cfg, unsigned val)
+{
+    if (!cfg || val > 1) return;
+    cfg->mtc.http.normalize = val;
+}
+
+void
+cfgMtcHttpTemplatesSet(config_t* cfg, const char* templates)
+{
+    if (!cfg) return;
+    if (cfg->mtc.http.templates) free(cfg->mtc.http.templates);
+    if (!templates || (templates[0] == '\0')) {
+        cfg->mtc.http.templates = (DEFAULT_MTC_HTTP_TEMPLATES) ? strdup(DEFAULT_MTC_HTTP_TEMPLATES) : NULL;
+        return;
+    }
+
+    cfg->mtc.http.templates = strdup(templates);
+}
+
 void
 cfgCmdDirSet(config_t* cfg, const char* path)
 {
@@ -685,6 +814,13 @@ cfgEvtRateLimitSet(config_t* cfg, unsigned val)
     cfg->evt.ratelimit = val;
 }
 
+void
+cfgEvtCaptureTimeSet(config_t* cfg, unsigned val)
+{
+    if (!cfg || val > 1) return;
+    cfg->evt.capturetime = val;
+}
+
 void
 cfgEnhanceFsSet(config_t* cfg, unsigned val)
 {
@@ -692,6 +828,26 @@ cfgEnhanceFsSet(config_t* cfg, unsigned val)
     cfg->enhancefs = val;
 }
 
+void
+cfgEvtSpillDirSet(config_t *cfg, const char *dir)
+{
+    if (!cfg) return;
+    if (cfg->evt.spill.dir) free(cfg->evt.spill.dir);
+    if (!dir || (dir[0] == '\0')) {
+        cfg->evt.spill.dir = (DEFAULT_EVT_SPILL_DIR) ? strdup(DEFAULT_EVT_SPILL_DIR) : NULL;
+        return;
+    }
+
+    cfg->evt.spill.dir = strdup(dir);
+}
+
+void
+cfgEvtSpillMaxSizeSet(config_t *cfg, unsigned long val)
+{
+    if (!cfg) return;
+    cfg->evt.spill.maxsize = val;
+}
+
 void
 cfgEvtFormatValueFilterSet(config_t* cfg, watch_t src, const char* filter)
 {
@@ -835,6 +991,14 @@ cfgTransportTlsCACertPathSet(config_t *cfg, which_transport_t t, const char *pat
     cfg->transport[t].net.tls.cacertpath = strdup(path);
 }
 
+void
+cfgTransportCompressionSet(config_t *cfg, which_transport_t t, cfg_compress_t val)
+{
+    if (!cfg || t < 0 || t >= CFG_WHICH_MAX) return;
+    if (val < CFG_COMPRESS_NONE || val > CFG_COMPRESS_LZ4) return;
+    cfg->transport[t].net.compression = val;
+}
+
 void
 cfgCustomTagAdd(config_t* c, const char* name, const char* value)
 {
@@ -925,6 +1089,13 @@ cfgPayDirSet(config_t *cfg, const char *dir)
     cfg->pay.dir = strdup(dir);
 }
 
+void
+cfgPayFormatSet(config_t *cfg, cfg_pay_format_t fmt)
+{
+    if (!cfg || fmt < CFG_PAY_RAW || fmt > CFG_PAY_PCAPNG) return;
+    cfg->pay.format = fmt;
+}
+
 void
 cfgLogStreamSet(config_t *cfg, bool value)
 {
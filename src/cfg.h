@@ -21,13 +21,20 @@ cfg_mtc_format_t    cfgMtcFormat(config_t*);
 const char*         cfgMtcStatsDPrefix(config_t*);
 unsigned            cfgMtcStatsDMaxLen(config_t*);
 unsigned            cfgMtcPeriod(config_t*);
+unsigned            cfgMtcScrapeEnable(config_t*);
+const char*         cfgMtcScrapeListen(config_t*);
+unsigned            cfgMtcHttpNormalize(config_t*);
+const char*         cfgMtcHttpTemplates(config_t*);
 const char*         cfgCmdDir(config_t*);
 unsigned            cfgSendProcessStartMsg(config_t*);
 unsigned            cfgMtcVerbosity(config_t*);
 unsigned            cfgEvtEnable(config_t*);
 cfg_mtc_format_t    cfgEventFormat(config_t*);
 unsigned            cfgEvtRateLimit(config_t*);
+unsigned            cfgEvtCaptureTime(config_t*);
 unsigned            cfgEnhanceFs(config_t*);
+const char*         cfgEvtSpillDir(config_t*);
+unsigned long       cfgEvtSpillMaxSize(config_t*);
 const char*         cfgEvtFormatValueFilter(config_t*, watch_t);
 const char*         cfgEvtFormatFieldFilter(config_t*, watch_t);
 const char*         cfgEvtFormatNameFilter(config_t*, watch_t);
@@ -40,11 +47,13 @@ cfg_buffer_t        cfgTransportBuf(config_t*, which_transport_t);
 unsigned            cfgTransportTlsEnable(config_t *, which_transport_t);
 unsigned            cfgTransportTlsValidateServer(config_t *, which_transport_t);
 const char*         cfgTransportTlsCACertPath(config_t *, which_transport_t);
+cfg_compress_t      cfgTransportCompression(config_t *, which_transport_t);
 custom_tag_t**      cfgCustomTags(config_t*);
 const char*         cfgCustomTagValue(config_t*, const char*);
 cfg_log_level_t     cfgLogLevel(config_t*);
 unsigned int        cfgPayEnable(config_t*);
 const char *        cfgPayDir(config_t*);
+cfg_pay_format_t    cfgPayFormat(config_t*);
 const char *        cfgEvtFormatHeader(config_t *, int);
 bool                cfgLogStream(config_t *);
 size_t              cfgEvtFormatNumHeaders(config_t *);
@@ -56,13 +65,20 @@ void                cfgMtcFormatSet(config_t*, cfg_mtc_format_t);
 void                cfgMtcStatsDPrefixSet(config_t*, const char*);
 void                cfgMtcStatsDMaxLenSet(config_t*, unsigned);
 void                cfgMtcPeriodSet(config_t*, unsigned);
+void                cfgMtcScrapeEnableSet(config_t*, unsigned);
+void                cfgMtcScrapeListenSet(config_t*, const char*);
+void                cfgMtcHttpNormalizeSet(config_t*, unsigned);
+void                cfgMtcHttpTemplatesSet(config_t*, const char*);
 void                cfgCmdDirSet(config_t*, const char*);
 void                cfgSendProcessStartMsgSet(config_t*, unsigned);
 void                cfgMtcVerbositySet(config_t*, unsigned);
 void                cfgEvtEnableSet(config_t*, unsigned);
 void                cfgEventFormatSet(config_t*, cfg_mtc_format_t);
 void                cfgEvtRateLimitSet(config_t*, unsigned);
+void                cfgEvtCaptureTimeSet(config_t*, unsigned);
 void                cfgEnhanceFsSet(config_t*, unsigned);
+void                cfgEvtSpillDirSet(config_t*, const char*);
+void                cfgEvtSpillMaxSizeSet(config_t*, unsigned long);
 void                cfgEvtFormatValueFilterSet(config_t*, watch_t, const char*);
 void                cfgEvtFormatFieldFilterSet(config_t*, watch_t, const char*);
 void                cfgEvtFormatNameFilterSet(config_t*, watch_t, const char*);
@@ -75,10 +91,12 @@ void                cfgTransportBufSet(config_t*, which_transport_t, cfg_buffer_
 void                cfgTransportTlsEnableSet(config_t *, which_transport_t, unsigned);
 void                cfgTransportTlsValidateServerSet(config_t *, which_transport_t, unsigned);
 void                cfgTransportTlsCACertPathSet(config_t *, which_transport_t, const char *);
+void                cfgTransportCompressionSet(config_t *, which_transport_t, cfg_compress_t);
 void                cfgCustomTagAdd(config_t*, const char*, const char*);
 void                cfgLogLevelSet(config_t*, cfg_log_level_t);
 void                cfgPayEnableSet(config_t*, unsigned int);
 void                cfgPayDirSet(config_t*, const char *);
+void                cfgPayFormatSet(config_t*, cfg_pay_format_t);
 void                cfgEvtFormatHeaderSet(config_t *, const char *);
 void                cfgLogStreamSet(config_t *, bool);
 
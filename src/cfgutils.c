@@ -38,6 +38,13 @@
 #define ENABLE_NODE                      "enable"
 #define VALIDATE_NODE                    "validateserver"
 #define CACERT_NODE                      "cacertpath"
+#define COMPRESSION_NODE             "compression"
+#define SCRAPE_NODE              "scrape"
+#define ENABLE_NODE                  "enable"
+#define LISTEN_NODE                  "listen"
+#define HTTP_NODE                "http"
+#define NORMALIZE_NODE               "normalize"
+#define TEMPLATES_NODE               "templates"
 
 #define LIBSCOPE_NODE        "libscope"
 #define LOG_NODE                 "log"
@@ -53,6 +60,10 @@
 #define TYPE_NODE                    "type"
 #define MAXEPS_NODE                  "maxeventpersec"
 #define ENHANCEFS_NODE               "enhancefs"
+#define CAPTURETIME_NODE             "capturetime"
+#define SPILL_NODE               "spill"
+#define DIR_NODE                     "dir"
+#define MAXSIZE_NODE                 "maxsize"
 #define WATCH_NODE               "watch"
 #define TYPE_NODE                    "type"
 #define NAME_NODE                    "name"
@@ -63,6 +74,7 @@
 #define PAYLOAD_NODE          "payload"
 #define ENABLE_NODE              "enable"
 #define DIR_NODE                 "dir"
+#define FORMAT_NODE              "format"
 
 #define CRIBL_NODE          "cribl"
 #define ENABLE_NODE              "enable"
@@ -72,6 +84,7 @@
 enum_map_t formatMap[] = {
     {"statsd",                CFG_FMT_STATSD},
     {"ndjson",                CFG_FMT_NDJSON},
+    {"msgpack",               CFG_FMT_MSGPACK},
     {NULL,                    -1}
 };
 
@@ -101,6 +114,18 @@ enum_map_t bufferMap[] = {
     {NULL,                    -1}
 };
 
+enum_map_t compressionMap[] = {
+    {"none",                  CFG_COMPRESS_NONE},
+    {"lz4",                   CFG_COMPRESS_LZ4},
+    {NULL,                    -1}
+};
+
+enum_map_t payFormatMap[] = {
+    {"raw",                   CFG_PAY_RAW},
+    {"pcapng",                CFG_PAY_PCAPNG},
+    {NULL,                    -1}
+};
+
 enum_map_t watchTypeMap[] = {
     {"file",                  CFG_SRC_FILE},
     {"console",               CFG_SRC_CONSOLE},
@@ -125,12 +150,19 @@ void cfgMtcFormatSetFromStr(config_t*, const char*);
 void cfgMtcStatsDPrefixSetFromStr(config_t*, const char*);
 void cfgMtcStatsDMaxLenSetFromStr(config_t*, const char*);
 void cfgMtcPeriodSetFromStr(config_t*, const char*);
+void cfgMtcScrapeEnableSetFromStr(config_t*, const char*);
+void cfgMtcScrapeListenSetFromStr(config_t*, const char*);
+void cfgMtcHttpNormalizeSetFromStr(config_t*, const char*);
+void cfgMtcHttpTemplatesSetFromStr(config_t*, const char*);
 void cfgCmdDirSetFromStr(config_t*, const char*);
 void cfgConfigEventSetFromStr(config_t*, const char*);
 void cfgEvtEnableSetFromStr(config_t*, const char*);
 void cfgEventFormatSetFromStr(config_t*, const char*);
 void cfgEvtRateLimitSetFromStr(config_t*, const char*);
 void cfgEnhanceFsSetFromStr(config_t*, const char*);
+void cfgEvtCaptureTimeSetFromStr(config_t*, const char*);
+void cfgEvtSpillDirSetFromStr(config_t*, const char*);
+void cfgEvtSpillMaxSizeSetFromStr(config_t*, const char*);
 void cfgEvtFormatValueFilterSetFromStr(config_t*, watch_t, const char*);
 void cfgEvtFormatFieldFilterSetFromStr(config_t*, watch_t, const char*);
 void cfgEvtFormatNameFilterSetFromStr(config_t*, watch_t, const char*);
@@ -141,6 +173,7 @@ void cfgCustomTagAddFromStr(config_t*, const char*, const char*);
 void cfgLogLevelSetFromStr(config_t*, const char*);
 void cfgPayEnableSetFromStr(config_t*, const char*);
 void cfgPayDirSetFromStr(config_t*, const char*);
+void cfgPayFormatSetFromStr(config_t*, const char*);
 void cfgEvtFormatHeaderSetFromStr(config_t *, const char *);
 static void cfgSetFromFile(config_t *, const char *);
 static void cfgEvtFormatLogStreamSetFromStr(config_t *, const char *);
@@ -424,6 +457,14 @@ processEnvStyleInput(config_t *cfg, const char *env_line)
         cfgConfigEventSetFromStr(cfg, value);
     } else if (startsWith(env_line, "SCOPE_METRIC_VERBOSITY")) {
         cfgMtcVerbositySetFromStr(cfg, value);
+    } else if (startsWith(env_line, "SCOPE_METRIC_SCRAPE_ENABLE")) {
+        cfgMtcScrapeEnableSetFromStr(cfg, value);
+    } else if (startsWith(env_line, "SCOPE_METRIC_SCRAPE_LISTEN")) {
+        cfgMtcScrapeListenSetFromStr(cfg, value);
+    } else if (startsWith(env_line, "SCOPE_METRIC_HTTP_NORMALIZE")) {
+        cfgMtcHttpNormalizeSetFromStr(cfg, value);
+    } else if (startsWith(env_line, "SCOPE_METRIC_HTTP_TEMPLATES")) {
+        cfgMtcHttpTemplatesSetFromStr(cfg, value);
     } else if (startsWith(env_line, "SCOPE_LOG_LEVEL")) {
         cfgLogLevelSetFromStr(cfg, value);
     } else if (startsWith(env_line, "SCOPE_METRIC_DEST")) {
@@ -436,6 +477,8 @@ processEnvStyleInput(config_t *cfg, const char *env_line)
         cfgPayEnableSetFromStr(cfg, value);
     } else if (startsWith(env_line, "SCOPE_PAYLOAD_DIR")) {
         cfgPayDirSetFromStr(cfg, value);
+    } else if (startsWith(env_line, "SCOPE_PAYLOAD_FORMAT")) {
+        cfgPayFormatSetFromStr(cfg, value);
     } else if (startsWith(env_line, "SCOPE_CMD_DBG_PATH")) {
         processCmdDebug(value);
     } else if (startsWith(env_line, "SCOPE_CONF_RELOAD")) {
@@ -450,6 +493,12 @@ processEnvStyleInput(config_t *cfg, const char *env_line)
         cfgEvtRateLimitSetFromStr(cfg, value);
     } else if (startsWith(env_line, "SCOPE_ENHANCE_FS")) {
         cfgEnhanceFsSetFromStr(cfg, value);
+    } else if (startsWith(env_line, "SCOPE_EVENT_CAPTURE_TIME")) {
+        cfgEvtCaptureTimeSetFromStr(cfg, value);
+    } else if (startsWith(env_line, "SCOPE_EVENT_SPILL_DIR")) {
+        cfgEvtSpillDirSetFromStr(cfg, value);
+    } else if (startsWith(env_line, "SCOPE_EVENT_SPILL_MAXSIZE")) {
+        cfgEvtSpillMaxSizeSetFromStr(cfg, value);
     } else if (startsWith(env_line, "SCOPE_EVENT_LOGFILE_NAME")) {
         cfgEvtFormatNameFilterSetFromStr(cfg, CFG_SRC_FILE, value);
     } else if (startsWith(env_line, "SCOPE_EVENT_CONSOLE_NAME")) {
@@ -640,9 +689,11 @@ void
 cfgEventFormatSetFromStr(config_t* cfg, const char* value)
 {
     if (!cfg || !value) return;
-    // only ndjson is valid
-    cfgEventFormatSet(cfg, CFG_FMT_NDJSON);
-    //cfgEventFormatSet(cfg, strToVal(formatMap, value));
+    // only ndjson and msgpack are valid
+    unsigned int fmt = strToVal(formatMap, value);
+    if (fmt == -1) return;
+    if (fmt != CFG_FMT_MSGPACK) fmt = CFG_FMT_NDJSON;
+    cfgEventFormatSet(cfg, fmt);
 }
 
 void
@@ -664,6 +715,60 @@ cfgEnhanceFsSetFromStr(config_t* cfg, const char* value)
     cfgEnhanceFsSet(cfg, strToVal(boolMap, value));
 }
 
+void
+cfgEvtCaptureTimeSetFromStr(config_t* cfg, const char* value)
+{
+    if (!cfg || !value) return;
+    cfgEvtCaptureTimeSet(cfg, strToVal(boolMap, value));
+}
+
+void
+cfgMtcScrapeEnableSetFromStr(config_t* cfg, const char* value)
+{
+    if (!cfg || !value) return;
+    cfgMtcScrapeEnableSet(cfg, strToVal(boolMap, value));
+}
+
+void
+cfgMtcScrapeListenSetFromStr(config_t* cfg, const char* value)
+{
+    if (!cfg || !value) return;
+    cfgMtcScrapeListenSet(cfg, value);
+}
+
+void
+cfgMtcHttpNormalizeSetFromStr(config_t* cfg, const char* value)
+{
+    if (!cfg || !value) return;
+    cfgMtcHttpNormalizeSet(cfg, strToVal(boolMap, value));
+}
+
+void
+cfgMtcHttpTemplatesSetFromStr(config_t* cfg, const char* value)
+{
+    if (!cfg || !value) return;
+    cfgMtcHttpTemplatesSet(cfg, value);
+}
+
+void
+cfgEvtSpillDirSetFromStr(config_t *cfg, const char *value)
+{
+    if (!cfg || !value) return;
+    cfgEvtSpillDirSet(cfg, value);
+}
+
+void
+cfgEvtSpillMaxSizeSetFromStr(config_t *cfg, const char *value)
+{
+    if (!cfg || !value) return;
+    errno = 0;
+    char* endptr = NULL;
+    unsigned long x = strtoul(value, &endptr, 10);
+    if (errno || *endptr) return;
+
+    cfgEvtSpillMaxSizeSet(cfg, x);
+}
+
 void
 cfgEvtFormatValueFilterSetFromStr(config_t* cfg, watch_t src, const char* value)
 {
@@ -791,6 +896,13 @@ cfgPayDirSetFromStr(config_t *cfg, const char *value)
     cfgPayDirSet(cfg, value);
 }
 
+void
+cfgPayFormatSetFromStr(config_t *cfg, const char *value)
+{
+    if (!cfg || !value) return;
+    cfgPayFormatSet(cfg, strToVal(payFormatMap, value));
+}
+
 void
 cfgCriblEnableSetFromStr(config_t *cfg, const char *value)
 {
@@ -902,6 +1014,15 @@ processBuf(config_t* config, yaml_document_t* doc, yaml_node_t* node)
     if (value) free(value);
 }
 
+static void
+processCompression(config_t* config, yaml_document_t* doc, yaml_node_t* node)
+{
+    char* value = stringVal(node);
+    which_transport_t c = transport_context;
+    cfgTransportCompressionSet(config, c, strToVal(compressionMap, value));
+    if (value) free(value);
+}
+
 static void
 processTlsEnable(config_t *config, yaml_document_t *doc, yaml_node_t *node)
 {
@@ -959,6 +1080,7 @@ processTransport(config_t* config, yaml_document_t* doc, yaml_node_t* node)
         {YAML_SCALAR_NODE,    PATH_NODE,            processPath},
         {YAML_SCALAR_NODE,    BUFFERING_NODE,       processBuf},
         {YAML_MAPPING_NODE,   TLS_NODE,             processTls},
+        {YAML_SCALAR_NODE,    COMPRESSION_NODE,     processCompression},
         {YAML_NO_NODE,        NULL,                 NULL}
     };
 
@@ -1059,6 +1181,14 @@ processEnhanceFs(config_t* config, yaml_document_t* doc, yaml_node_t* node)
     if (value) free(value);
 }
 
+static void
+processCaptureTime(config_t* config, yaml_document_t* doc, yaml_node_t* node)
+{
+    char* value = stringVal(node);
+    cfgEvtCaptureTimeSetFromStr(config, value);
+    if (value) free(value);
+}
+
 static void
 processStatsDPrefix(config_t* config, yaml_document_t* doc, yaml_node_t* node)
 {
@@ -1091,6 +1221,72 @@ processMetricEnable(config_t* config, yaml_document_t* doc, yaml_node_t* node)
     if (value) free(value);
 }
 
+static void
+processScrapeEnable(config_t* config, yaml_document_t* doc, yaml_node_t* node)
+{
+    char* value = stringVal(node);
+    cfgMtcScrapeEnableSetFromStr(config, value);
+    if (value) free(value);
+}
+
+static void
+processScrapeListen(config_t* config, yaml_document_t* doc, yaml_node_t* node)
+{
+    char* value = stringVal(node);
+    cfgMtcScrapeListenSetFromStr(config, value);
+    if (value) free(value);
+}
+
+static void
+processScrape(config_t* config, yaml_document_t* doc, yaml_node_t* node)
+{
+    if (node->type != YAML_MAPPING_NODE) return;
+
+    parse_table_t t[] = {
+        {YAML_SCALAR_NODE,    ENABLE_NODE,          processScrapeEnable},
+        {YAML_SCALAR_NODE,    LISTEN_NODE,          processScrapeListen},
+        {YAML_NO_NODE,        NULL,                 NULL}
+    };
+
+    yaml_node_pair_t* pair;
+    foreach(pair, node->data.mapping.pairs) {
+        processKeyValuePair(t, pair, config, doc);
+    }
+}
+
+static void
+processHttpNormalize(config_t* config, yaml_document_t* doc, yaml_node_t* node)
+{
+    char* value = stringVal(node);
+    cfgMtcHttpNormalizeSetFromStr(config, value);
+    if (value) free(value);
+}
+
+static void
+processHttpTemplates(config_t* config, yaml_document_t* doc, yaml_node_t* node)
+{
+    char* value = stringVal(node);
+    cfgMtcHttpTemplatesSetFromStr(config, value);
+    if (value) free(value);
+}
+
+static void
+processMetricHttp(config_t* config, yaml_document_t* doc, yaml_node_t* node)
+{
+    if (node->type != YAML_MAPPING_NODE) return;
+
+    parse_table_t t[] = {
+        {YAML_SCALAR_NODE,    NORMALIZE_NODE,       processHttpNormalize},
+        {YAML_SCALAR_NODE,    TEMPLATES_NODE,       processHttpTemplates},
+        {YAML_NO_NODE,        NULL,                 NULL}
+    };
+
+    yaml_node_pair_t* pair;
+    foreach(pair, node->data.mapping.pairs) {
+        processKeyValuePair(t, pair, config, doc);
+    }
+}
+
 static void
 processFormat(config_t* config, yaml_document_t* doc, yaml_node_t* node)
 {
@@ -1144,6 +1340,8 @@ processMetric(config_t* config, yaml_document_t* doc, yaml_node_t* node)
         {YAML_SCALAR_NODE,    ENABLE_NODE,          processMetricEnable},
         {YAML_MAPPING_NODE,   FORMAT_NODE,          processFormat},
         {YAML_MAPPING_NODE,   TRANSPORT_NODE,       processTransportMetric},
+        {YAML_MAPPING_NODE,   SCRAPE_NODE,          processScrape},
+        {YAML_MAPPING_NODE,   HTTP_NODE,            processMetricHttp},
         {YAML_NO_NODE,        NULL,                 NULL}
     };
 
@@ -1170,6 +1368,40 @@ processEvtFormat(config_t* config, yaml_document_t* doc, yaml_node_t* node)
         {YAML_SCALAR_NODE,    TYPE_NODE,            processFormatTypeEvent},
         {YAML_SCALAR_NODE,    MAXEPS_NODE,          processFormatMaxEps},
         {YAML_SCALAR_NODE,    ENHANCEFS_NODE,       processEnhanceFs},
+        {YAML_SCALAR_NODE,    CAPTURETIME_NODE,     processCaptureTime},
+        {YAML_NO_NODE,        NULL,                 NULL}
+    };
+
+    yaml_node_pair_t* pair;
+    foreach(pair, node->data.mapping.pairs) {
+        processKeyValuePair(t, pair, config, doc);
+    }
+}
+
+static void
+processSpillDir(config_t* config, yaml_document_t* doc, yaml_node_t* node)
+{
+    char* value = stringVal(node);
+    cfgEvtSpillDirSetFromStr(config, value);
+    if (value) free(value);
+}
+
+static void
+processSpillMaxSize(config_t* config, yaml_document_t* doc, yaml_node_t* node)
+{
+    char* value = stringVal(node);
+    cfgEvtSpillMaxSizeSetFromStr(config, value);
+    if (value) free(value);
+}
+
+static void
+processEvtSpill(config_t* config, yaml_document_t* doc, yaml_node_t* node)
+{
+    if (node->type != YAML_MAPPING_NODE) return;
+
+    parse_table_t t[] = {
+        {YAML_SCALAR_NODE,    DIR_NODE,             processSpillDir},
+        {YAML_SCALAR_NODE,    MAXSIZE_NODE,         processSpillMaxSize},
         {YAML_NO_NODE,        NULL,                 NULL}
     };
 
@@ -1310,6 +1542,7 @@ processEvent(config_t* config, yaml_document_t* doc, yaml_node_t* node)
         {YAML_SCALAR_NODE,    ENABLE_NODE,          processEvtEnable},
         {YAML_MAPPING_NODE,   TRANSPORT_NODE,       processTransportCtl},
         {YAML_MAPPING_NODE,   FORMAT_NODE,          processEvtFormat},
+        {YAML_MAPPING_NODE,   SPILL_NODE,           processEvtSpill},
         {YAML_SEQUENCE_NODE,  WATCH_NODE,           processWatch},
         {YAML_SCALAR_NODE,    WATCH_NODE,           processWatch},
         {YAML_NO_NODE,        NULL,                 NULL}
@@ -1356,6 +1589,14 @@ processPayloadDir(config_t *config, yaml_document_t *doc, yaml_node_t *node)
     if (value) free(value);
 }
 
+static void
+processPayloadFormat(config_t *config, yaml_document_t *doc, yaml_node_t *node)
+{
+    char* value = stringVal(node);
+    cfgPayFormatSetFromStr(config, value);
+    if (value) free(value);
+}
+
 static void
 processPayload(config_t *config, yaml_document_t *doc, yaml_node_t *node)
 {
@@ -1364,6 +1605,7 @@ processPayload(config_t *config, yaml_document_t *doc, yaml_node_t *node)
     parse_table_t t[] = {
         {YAML_SCALAR_NODE,    ENABLE_NODE,          processPayloadEnable},
         {YAML_SCALAR_NODE,    DIR_NODE,             processPayloadDir},
+        {YAML_SCALAR_NODE,    FORMAT_NODE,          processPayloadFormat},
         {YAML_NO_NODE,        NULL,                 NULL}
     };
 
@@ -1563,6 +1805,9 @@ createTransportJson(config_t* cfg, which_transport_t trans)
 
             if (!(tls = createTlsJson(cfg, trans))) goto err;
             cJSON_AddItemToObjectCS(root, TLS_NODE, tls);
+
+            if (!cJSON_AddStringToObjLN(root, COMPRESSION_NODE,
+                 valToStr(compressionMap, cfgTransportCompression(cfg, trans)))) goto err;
             break;
         case CFG_UNIX:
             if (!cJSON_AddStringToObjLN(root, PATH_NODE,
@@ -1654,11 +1899,48 @@ err:
     return NULL;
 }
 
+static cJSON*
+createMetricScrapeJson(config_t* cfg)
+{
+    cJSON* root = NULL;
+
+    if (!(root = cJSON_CreateObject())) goto err;
+
+    if (!cJSON_AddStringToObjLN(root, ENABLE_NODE,
+                    valToStr(boolMap, cfgMtcScrapeEnable(cfg)))) goto err;
+    if (!cJSON_AddStringToObjLN(root, LISTEN_NODE,
+                                    cfgMtcScrapeListen(cfg))) goto err;
+
+    return root;
+err:
+    if (root) cJSON_Delete(root);
+    return NULL;
+}
+
+static cJSON*
+createMetricHttpJson(config_t* cfg)
+{
+    cJSON* root = NULL;
+
+    if (!(root = cJSON_CreateObject())) goto err;
+
+    if (!cJSON_AddStringToObjLN(root, NORMALIZE_NODE,
+                    valToStr(boolMap, cfgMtcHttpNormalize(cfg)))) goto err;
+    const char *templates = cfgMtcHttpTemplates(cfg);
+    if (!cJSON_AddStringToObjLN(root, TEMPLATES_NODE,
+                                    (templates) ? templates : "")) goto err;
+
+    return root;
+err:
+    if (root) cJSON_Delete(root);
+    return NULL;
+}
+
 static cJSON*
 createMetricJson(config_t* cfg)
 {
     cJSON* root = NULL;
-    cJSON* transport, *format;
+    cJSON* transport, *format, *scrape, *http;
 
     if (!(root = cJSON_CreateObject())) goto err;
 
@@ -1671,6 +1953,12 @@ createMetricJson(config_t* cfg)
     if (!(format = createMetricFormatJson(cfg))) goto err;
     cJSON_AddItemToObjectCS(root, FORMAT_NODE, format);
 
+    if (!(scrape = createMetricScrapeJson(cfg))) goto err;
+    cJSON_AddItemToObjectCS(root, SCRAPE_NODE, scrape);
+
+    if (!(http = createMetricHttpJson(cfg))) goto err;
+    cJSON_AddItemToObjectCS(root, HTTP_NODE, http);
+
     return root;
 err:
     if (root) cJSON_Delete(root);
@@ -1750,6 +2038,28 @@ createEventFormatJson(config_t* cfg)
                       cfgEvtRateLimit(cfg))) goto err;
     if (!cJSON_AddStringToObjLN(root, ENHANCEFS_NODE,
                       valToStr(boolMap, cfgEnhanceFs(cfg)))) goto err;
+    if (!cJSON_AddStringToObjLN(root, CAPTURETIME_NODE,
+                      valToStr(boolMap, cfgEvtCaptureTime(cfg)))) goto err;
+
+    return root;
+err:
+    if (root) cJSON_Delete(root);
+    return NULL;
+}
+
+static cJSON*
+createEventSpillJson(config_t* cfg)
+{
+    cJSON* root = NULL;
+
+    if (!(root = cJSON_CreateObject())) goto err;
+
+    // Represent NULL as an empty string
+    const char *dir = cfgEvtSpillDir(cfg);
+    dir = (dir) ? dir : "";
+    if (!cJSON_AddStringToObjLN(root, DIR_NODE, dir)) goto err;
+    if (!cJSON_AddNumberToObjLN(root, MAXSIZE_NODE,
+                      cfgEvtSpillMaxSize(cfg))) goto err;
 
     return root;
 err:
@@ -1761,7 +2071,7 @@ static cJSON*
 createEventJson(config_t* cfg)
 {
     cJSON* root = NULL;
-    cJSON* format, *watch, *transport;
+    cJSON* format, *spill, *watch, *transport;
 
     if (!(root = cJSON_CreateObject())) goto err;
 
@@ -1774,6 +2084,9 @@ createEventJson(config_t* cfg)
     if (!(format = createEventFormatJson(cfg))) goto err;
     cJSON_AddItemToObjectCS(root, FORMAT_NODE, format);
 
+    if (!(spill = createEventSpillJson(cfg))) goto err;
+    cJSON_AddItemToObjectCS(root, SPILL_NODE, spill);
+
     if (!(watch = createWatchArrayJson(cfg))) goto err;
     cJSON_AddItemToObjectCS(root, WATCH_NODE, watch);
 
@@ -1794,6 +2107,8 @@ createPayloadJson(config_t *cfg)
                          valToStr(boolMap, cfgPayEnable(cfg)))) goto err;
     if (!cJSON_AddStringToObjLN(root, DIR_NODE,
                          cfgPayDir(cfg))) goto err;
+    if (!cJSON_AddStringToObjLN(root, FORMAT_NODE,
+                         valToStr(payFormatMap, cfgPayFormat(cfg)))) goto err;
 
     return root;
 err:
@@ -1890,6 +2205,7 @@ initTransport(config_t* cfg, which_transport_t t)
             transportConfigureTls(transport, cfgTransportTlsEnable(cfg, t),
                                              cfgTransportTlsValidateServer(cfg, t),
                                              cfgTransportTlsCACertPath(cfg, t));
+            transportConfigureCompression(transport, cfgTransportCompression(cfg, t));
             break;
         case CFG_SHM:
             transport = transportCreateShm();
@@ -1971,6 +2287,7 @@ initEvtFormat(config_t *cfg)
     }
 
     evtFormatRateLimitSet(evt, cfgEvtRateLimit(cfg));
+    evtFormatCaptureTimeSet(evt, cfgEvtCaptureTime(cfg));
     evtFormatCustomTagsSet(evt, cfgCustomTags(cfg));
 
     return evt;
@@ -2014,8 +2331,11 @@ initCtl(config_t *cfg)
     ctlEvtSet(ctl, evt);
 
     ctlEnhanceFsSet(ctl, cfgEnhanceFs(cfg));
+    ctlFormatSet(ctl, cfgEventFormat(cfg));
+    ctlSpillSet(ctl, spillCreate(cfgEvtSpillDir(cfg), cfgEvtSpillMaxSize(cfg)));
     ctlPayEnableSet(ctl, cfgPayEnable(cfg));
     ctlPayDirSet(ctl,    cfgPayDir(cfg));
+    ctlPayFormatSet(ctl, cfgPayFormat(cfg));
 
     return ctl;
 }
@@ -2189,6 +2509,9 @@ protocolRead(const char *path, list_t *plist)
                 } else if (!strcmp((char *)prot_key->data.scalar.value, "regex")) {
                     if (prot->regex) free(prot->regex);
                     prot->regex = strdup((char *)prot_value->data.scalar.value);
+                } else if (!strcmp((char *)prot_key->data.scalar.value, "signature")) {
+                    if (prot->signature) free(prot->signature);
+                    prot->signature = strdup((char *)prot_value->data.scalar.value);
                 } else if (!strcmp((char *)prot_key->data.scalar.value, "binary")) {
                     prot->binary = (!strcmp((char *)prot_value->data.scalar.value, "false")) ?
                         FALSE : TRUE; // seems like it should default to true
@@ -2226,6 +2549,8 @@ destroyProtEntry(void *data)
     protocol_def_t *pre = data;
     if (pre->re) pcre2_code_free(pre->re);
     if (pre->regex) free(pre->regex);
+    if (pre->signature) free(pre->signature);
+    bytesigDestroy(&pre->sig);
     if (pre->protname) free(pre->protname);
     free(pre);
 }
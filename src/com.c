@@ -1,4 +1,5 @@
 #define _GNU_SOURCE
+#include <pthread.h>
 #include <string.h>
 
 #include "com.h"
@@ -255,6 +256,10 @@ msgStart(proc_id_t *proc, config_t *cfg, which_transport_t who)
 
     if (who == CFG_LS) {
         if (!cJSON_AddStringToObjLN(json_root, "format", "scope")) goto err;
+    } else if (cfgEventFormat(cfg) == CFG_FMT_MSGPACK) {
+        // This message itself is always ndjson; what follows it is
+        // length-prefixed msgpack.
+        if (!cJSON_AddStringToObjLN(json_root, "format", "msgpack")) goto err;
     } else {
         if (!cJSON_AddStringToObjLN(json_root, "format", "ndjson")) goto err;
     }
@@ -284,6 +289,45 @@ msgEventGet(ctl_t *ctl)
     return ctlGetEvent(ctl);
 }
 
+// Each thread has its own match data, shared by every pattern.  Callers
+// only need to know whether there's a match, so one ovector pair is enough.
+static pthread_once_t g_match_data_once = PTHREAD_ONCE_INIT;
+static pthread_key_t g_match_data_key;
+static int g_match_data_key_ok = FALSE;
+
+static void
+matchDataFree(void *match_data)
+{
+    pcre2_match_data_free(match_data);
+}
+
+static void
+matchDataKeyCreate(void)
+{
+    g_match_data_key_ok = !pthread_key_create(&g_match_data_key, matchDataFree);
+}
+
+pcre2_match_data *
+pcre2ThreadMatchData(void)
+{
+    pthread_once(&g_match_data_once, matchDataKeyCreate);
+    if (!g_match_data_key_ok) return NULL;
+
+    pcre2_match_data *match_data = pthread_getspecific(g_match_data_key);
+    if (match_data) return match_data;
+
+    if (!(match_data = pcre2_match_data_create(1, NULL))) {
+        DBG(NULL);
+        return NULL;
+    }
+    if (pthread_setspecific(g_match_data_key, match_data)) {
+        DBG(NULL);
+        pcre2_match_data_free(match_data);
+        return NULL;
+    }
+    return match_data;
+}
+
 int
 pcre2_match_wrapper(pcre2_code *re, PCRE2_SPTR data, PCRE2_SIZE size,
                     PCRE2_SIZE startoffset, uint32_t options,
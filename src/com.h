@@ -55,6 +55,10 @@ int pcre2_match_wrapper(pcre2_code *, PCRE2_SPTR, PCRE2_SIZE, PCRE2_SIZE,
                         uint32_t, pcre2_match_data *, pcre2_match_context *);
 int regexec_wrapper(const regex_t *, const char *, size_t, regmatch_t *, int);
 
+// This thread's match data, with room for the whole match only.  NULL if
+// it can't be had.
+pcre2_match_data *pcre2ThreadMatchData(void);
+
 bool cmdCbufEmpty(ctl_t *);
 
 // payloads
@@ -2,7 +2,6 @@
 #include <limits.h>
 #include <stdlib.h>
 #include <string.h>
-#include <sys/timeb.h>
 
 #include "circbuf.h"
 #include "cfgutils.h"
@@ -11,6 +10,7 @@
 #include "dbg.h"
 #include "com.h"
 #include "fn.h"
+#include "plattime.h"
 
 #define FS_ENTRIES 1024
 #define DEFAULT_LOG_MAX_AGG_BYTES 32768
@@ -34,6 +34,13 @@ struct _ctl_t
     evt_fmt_t *evt;
     cbuf_handle_t events;
     unsigned enhancefs;
+    cfg_mtc_format_t format;   // CFG_FMT_NDJSON or CFG_FMT_MSGPACK
+
+    // Optional on-disk queue for events while the transport is down
+    spill_t *spill;
+
+    // Events are formatted here, one at a time; see ctlSendEventJson()
+    jsbuf_t evtjs;
 
     // Used to buffer (aggregate) log and console data
     struct {
@@ -53,6 +60,7 @@ struct _ctl_t
     struct {
         unsigned int enable;
         char * dir;
+        cfg_pay_format_t format;
         cbuf_handle_t ringbuf;
     } payload;
 
@@ -223,10 +231,18 @@ grab_supplemental_for_def_protocol(cJSON * json_root, request_t *req)
         prot->len = json->valueint;
     }
 
+    // signature is optional, and can take the place of regex
+    json = cJSON_GetObjectItem(body, "signature");
+    if (json && (str = cJSON_GetStringValue(json))) {
+        prot->signature = strdup(str);
+    }
+
     json = cJSON_GetObjectItem(body, "regex");
-    if (!json) goto err;
-    if (!(str = cJSON_GetStringValue(json))) goto err;
-    prot->regex = strdup(str);
+    if (json && (str = cJSON_GetStringValue(json))) {
+        prot->regex = strdup(str);
+    } else if (!prot->signature) {
+        goto err;
+    }
 
     json = cJSON_GetObjectItem(body, "pname");
     if (!json) goto err;
@@ -238,6 +254,7 @@ grab_supplemental_for_def_protocol(cJSON * json_root, request_t *req)
 err:
     if (req) req->cmd=REQ_PARAM_ERR;
     if (prot && prot->regex) free(prot->regex);
+    if (prot && prot->signature) free(prot->signature);
     if (prot && prot->protname) free(prot->protname);
     if (prot) free(prot);
 }
@@ -498,64 +515,142 @@ err:
     return NULL;
 }
 
+static cJSON *
+ctlCreateTxJson(upload_t *upld)
+{
+    if (!upld) return NULL;
+
+    switch (upld->type) {
+        case UPLD_INFO:
+            return create_info_json(upld);
+        case UPLD_RESP:
+            return create_resp_json(upld);
+        case UPLD_EVT:
+            return create_evt_json(upld);
+        default:
+            DBG(NULL);
+            return NULL;
+    }
+}
+
+char *
+ctlCreateTxMsg(upload_t *upld)
+{
+    char *msg = NULL;
+
+    cJSON *json = ctlCreateTxJson(upld);
+    if (!json) return NULL;
+
+    msg = cJSON_PrintUnformatted(json);
+
+    cJSON_Delete(json);
+    return msg;
+}
+
 static char *
 prepMessage(upload_t *upld)
 {
-    char *streamMsg;
-
     if (!upld) return NULL;
 
-    streamMsg = ctlCreateTxMsg(upld);
-    if (!streamMsg) return NULL;
+    cJSON *json = ctlCreateTxJson(upld);
+    if (!json) return NULL;
 
-    // Add the newline delimiter to the msg.
-    int strsize = strlen(streamMsg);
-    char *temp = realloc(streamMsg, strsize+2); // room for "\n\0"
-    if (!temp) {
+    // Print the msg along with its newline delimiter
+    jsbuf_t js;
+    jsBufInit(&js, NULL, 0);
+    jsJson(&js, json);
+    jsNewline(&js);
+    cJSON_Delete(json);
+
+    char *streamMsg = jsBufDetach(&js, NULL);
+    if (!streamMsg) {
         DBG(NULL);
-        scopeLog("CTL realloc error", -1, CFG_LOG_INFO);
-        free(streamMsg);
-        return NULL;
+        scopeLog("CTL print error", -1, CFG_LOG_INFO);
     }
+    return streamMsg;
+}
 
-    streamMsg = temp;
-    streamMsg[strsize] = '\n';
-    streamMsg[strsize+1] = '\0';
+/*
+ * The msgpack counterpart of prepMessage().  Returns a length-prefixed
+ * message (see msgpack.h) and its length.
+ */
+static char *
+prepMessageMsgpack(upload_t *upld, size_t *len)
+{
+    cJSON *json = ctlCreateTxJson(upld);
+    if (!json) return NULL;
+
+    mpbuf_t mp;
+    mpBufInit(&mp);
+    size_t msg = mpMsgStart(&mp);
+    mpJson(&mp, json);
+    mpMsgEnd(&mp, msg);
+    cJSON_Delete(json);
 
-    return streamMsg;
+    return mpBufDetach(&mp, len);
 }
 
-char *
-ctlCreateTxMsg(upload_t *upld)
+// Returns a message in the ctl's format, ready to be sent
+static char *
+ctlPrepMessage(ctl_t *ctl, upload_t *upld, size_t *len)
 {
-    cJSON *json = NULL;
-    char *msg = NULL;
+    if (ctl->format == CFG_FMT_MSGPACK) return prepMessageMsgpack(upld, len);
 
-    if (!upld) goto out;
+    char *msg = prepMessage(upld);
+    *len = (msg) ? strlen(msg) : 0;
+    return msg;
+}
 
-    switch (upld->type) {
-        case UPLD_INFO:
-            json = create_info_json(upld);
-            break;
-        case UPLD_RESP:
-            json = create_resp_json(upld);
-            break;
-        case UPLD_EVT:
-            json = create_evt_json(upld);
-            break;
-        default:
-            DBG(NULL);
-            goto out;
+/*
+ * Writes the same envelope that create_evt_json() does, leaving the value
+ * of the body to be written by the caller.
+ */
+static size_t
+ctlMsgpackEvtHead(mpbuf_t *mp, uint64_t uid, proc_id_t *proc)
+{
+    size_t msg = mpMsgStart(mp);
+
+    mpMap(mp, 2 + ((proc) ? 1 : 0) + ((uid) ? 1 : 0));
+    mpStr(mp, "type");
+    mpStr(mp, "evt");
+    if (proc) {
+        mpStr(mp, ID);
+        mpStr(mp, proc->id);
     }
-    if (!json) goto out;
-
-    msg = cJSON_PrintUnformatted(json);
+    if (uid) {
+        char numbuf[32];
+        snprintf(numbuf, sizeof(numbuf), "%llu", (unsigned long long)uid);
+        mpStr(mp, CHANNEL);
+        mpStr(mp, numbuf);
+    }
+    mpStr(mp, "body");
 
-out:
-    if (json) cJSON_Delete(json);
     return msg;
 }
 
+/*
+ * The json counterpart of ctlMsgpackEvtHead().  Opens the envelope; the
+ * caller writes the value of the body and closes it.
+ */
+static void
+ctlJsonEvtHead(jsbuf_t *js, uint64_t uid, proc_id_t *proc)
+{
+    jsObjStart(js);
+    jsKey(js, "type");
+    jsStr(js, "evt");
+    if (proc) {
+        jsKey(js, ID);
+        jsStr(js, proc->id);
+    }
+    if (uid) {
+        char numbuf[32];
+        snprintf(numbuf, sizeof(numbuf), "%llu", (unsigned long long)uid);
+        jsKey(js, CHANNEL);
+        jsStr(js, numbuf);
+    }
+    jsKey(js, "body");
+}
+
 ctl_t *
 ctlCreate()
 {
@@ -580,9 +675,11 @@ ctlCreate()
     }
 
     ctl->enhancefs = DEFAULT_ENHANCE_FS;
+    ctl->format = DEFAULT_CTL_FORMAT;
 
     ctl->payload.enable = DEFAULT_PAYLOAD_ENABLE;
     ctl->payload.dir = (DEFAULT_PAYLOAD_DIR) ? strdup(DEFAULT_PAYLOAD_DIR) : NULL;
+    ctl->payload.format = DEFAULT_PAYLOAD_FORMAT;
     ctl->payload.ringbuf = cbufInit(DEFAULT_PAYLOAD_RING_SIZE);
     if (!ctl->payload.ringbuf) {
         DBG(NULL);
@@ -618,11 +715,50 @@ ctlDestroy(ctl_t **ctl)
     transportDestroy(&(*ctl)->transport);
     transportDestroy(&(*ctl)->paytrans);
     evtFormatDestroy(&(*ctl)->evt);
+    spillDestroy(&(*ctl)->spill);
+    jsBufFree(&(*ctl)->evtjs);
 
     free(*ctl);
     *ctl = NULL;
 }
 
+static int
+spillSendFn(void *ctx, const char *msg, size_t len)
+{
+    ctl_t *ctl = ctx;
+    if (transportNeedsConnection(ctl->transport)) return -1;
+    return transportSend(ctl->transport, msg, len);
+}
+
+/*
+ * All event data sent over ctl->transport goes through here.
+ * Without a spill queue this is just transportSend().  With one,
+ * messages go to disk whenever the transport isn't connected, and
+ * continue to go to disk until everything spilled has been replayed,
+ * so that the order of events is preserved.
+ */
+static int
+ctlSendEvtMsg(ctl_t *ctl, const char *msg, size_t len)
+{
+    if (!ctl->spill) return transportSend(ctl->transport, msg, len);
+
+    if (transportNeedsConnection(ctl->transport) || !spillEmpty(ctl->spill)) {
+        return spillWrite(ctl->spill, msg, len);
+    }
+
+    int rc = transportSend(ctl->transport, msg, len);
+    if (rc) rc = spillWrite(ctl->spill, msg, len);
+    return rc;
+}
+
+static void
+ctlReplaySpill(ctl_t *ctl)
+{
+    if (!ctl->spill || transportNeedsConnection(ctl->transport)) return;
+
+    spillReplay(ctl->spill, spillSendFn, ctl, DEFAULT_EVT_SPILL_REPLAY_RATE);
+}
+
 void
 ctlSendMsg(ctl_t *ctl, char *msg)
 {
@@ -690,7 +826,12 @@ ctlPostMsg(ctl_t *ctl, cJSON *body, upload_type_t type, request_t *req, bool now
     upld.req = req;
     upld.proc = NULL;
     upld.uid = 0;
-    streamMsg = ctlCreateTxMsg(&upld);
+    if (ctl->format == CFG_FMT_MSGPACK) {
+        size_t len;
+        streamMsg = prepMessageMsgpack(&upld, &len);
+    } else {
+        streamMsg = ctlCreateTxMsg(&upld);
+    }
 
     if (streamMsg) {
         // on the ring buffer
@@ -704,57 +845,85 @@ ctlPostMsg(ctl_t *ctl, cJSON *body, upload_type_t type, request_t *req, bool now
     return rc;
 }
 
-int
-ctlSendHttp(ctl_t *ctl, event_t *evt, uint64_t uid, proc_id_t *proc)
+typedef int (*evt_msgpack_fn_t)(evt_fmt_t *, event_t *, uint64_t, proc_id_t *, mpbuf_t *);
+
+static int
+ctlSendEventMsgpack(ctl_t *ctl, evt_msgpack_fn_t fmtfn, event_t *evt, uint64_t uid, proc_id_t *proc)
 {
-    int rc;
-    char *streamMsg;
-    cJSON *json;
-    upload_t upld;
+    int rc = -1;
+    mpbuf_t mp;
 
-    if (!ctl || !evt || !proc) return -1;
+    mpBufInit(&mp);
+    size_t msg = ctlMsgpackEvtHead(&mp, uid, proc);
+    if (!fmtfn(ctl->evt, evt, uid, proc, &mp) && !mpMsgEnd(&mp, msg)) {
+        rc = ctlSendEvtMsg(ctl, mp.data, mp.len);
+    }
+    mpBufFree(&mp);
+    return rc;
+}
 
-    // get a cJSON object for the given event
-    if ((json = evtFormatHttp(ctl->evt, evt, uid, proc)) == NULL) return -1;
+typedef int (*evt_json_fn_t)(evt_fmt_t *, event_t *, uint64_t, proc_id_t *, jsbuf_t *);
 
-    // send it
-    upld.type = UPLD_EVT;
-    upld.body = json;
-    upld.req = NULL;
-    upld.uid = uid;
-    upld.proc = proc;
-    streamMsg = prepMessage(&upld);
+/*
+ * Events are sent from the periodic thread, as it drains the event queue
+ * (or at exit, once the periodic thread is done), so one buffer in the
+ * ctl is reused for all of them.  Once it's grown to fit the events seen
+ * so far, formatting one costs no allocation.  An unusually big event
+ * doesn't get to keep more than this, though.
+ */
+#define CTL_EVT_JSON_KEEP (256 * 1024)
 
-    rc = transportSend(ctl->transport, streamMsg, strlen(streamMsg));
-    if (streamMsg) free(streamMsg);
+static jsbuf_t *
+ctlEvtJsonStart(ctl_t *ctl)
+{
+    jsBufReset(&ctl->evtjs);
+    return &ctl->evtjs;
+}
+
+static void
+ctlEvtJsonDone(ctl_t *ctl)
+{
+    if (ctl->evtjs.size > CTL_EVT_JSON_KEEP) jsBufFree(&ctl->evtjs);
+}
+
+static int
+ctlSendEventJson(ctl_t *ctl, evt_json_fn_t fmtfn, event_t *evt, uint64_t uid, proc_id_t *proc)
+{
+    int rc = -1;
+    jsbuf_t *js = ctlEvtJsonStart(ctl);
+
+    ctlJsonEvtHead(js, uid, proc);
+    if (!fmtfn(ctl->evt, evt, uid, proc, js)) {
+        jsObjEnd(js);
+        jsNewline(js);
+        if (!jsBufErr(js)) rc = ctlSendEvtMsg(ctl, js->data, js->len);
+    }
+    ctlEvtJsonDone(ctl);
     return rc;
 }
 
 int
-ctlSendEvent(ctl_t *ctl, event_t *evt, uint64_t uid, proc_id_t *proc)
+ctlSendHttp(ctl_t *ctl, event_t *evt, uint64_t uid, proc_id_t *proc)
 {
-    int rc;
-    char *streamMsg;
-    cJSON *json;
-    upload_t upld;
-
     if (!ctl || !evt || !proc) return -1;
 
-    // get a cJSON object for the given event
-    if ((json = evtFormatMetric(ctl->evt, evt, uid, proc)) == NULL) return -1;
+    if (ctl->format == CFG_FMT_MSGPACK) {
+        return ctlSendEventMsgpack(ctl, evtFormatHttpMsgpack, evt, uid, proc);
+    }
 
-    // send it
-    upld.type = UPLD_EVT;
-    upld.body = json;
-    upld.req = NULL;
-    upld.uid = uid;
-    upld.proc = proc;
-    streamMsg = prepMessage(&upld);
+    return ctlSendEventJson(ctl, evtFormatHttpJsonBuf, evt, uid, proc);
+}
 
-    rc = transportSend(ctl->transport, streamMsg, strlen(streamMsg));
-    if (streamMsg) free(streamMsg);
-    return rc;
+int
+ctlSendEvent(ctl_t *ctl, event_t *evt, uint64_t uid, proc_id_t *proc)
+{
+    if (!ctl || !evt || !proc) return -1;
 
+    if (ctl->format == CFG_FMT_MSGPACK) {
+        return ctlSendEventMsgpack(ctl, evtFormatMetricMsgpack, evt, uid, proc);
+    }
+
+    return ctlSendEventJson(ctl, evtFormatMetricJsonBuf, evt, uid, proc);
 }
 
 int
@@ -776,7 +945,7 @@ ctlPostEvent(ctl_t *ctl, char *event)
 }
 
 log_event_t *
-createInternalLogEvent(int fd, const char *path, const void *buf, size_t count, uint64_t uid, proc_id_t *proc, watch_t logType, regex_t *valfilter)
+createInternalLogEvent(int fd, const char *path, const void *buf, size_t count, uint64_t uid, proc_id_t *proc, watch_t logType, filter_t *valfilter)
 {
     log_event_t *event = calloc(1, sizeof(*event));
     char *data = malloc(count);
@@ -792,11 +961,9 @@ createInternalLogEvent(int fd, const char *path, const void *buf, size_t count,
 
     memcpy(data, buf, count);
 
-    struct timeb tb;
-    ftime(&tb);
     event->fd = fd;
     event->id.uid = uid;
-    event->id.timestamp = tb.time + (double)tb.millitm/1000;
+    event->id.timestamp = wallClockSecs();
     event->id.path = src;
     event->id.proc = proc;
     event->id.sourcetype = logType;
@@ -824,15 +991,15 @@ ctlSendLog(ctl_t *ctl, int fd, const char *path, const void *buf, size_t count,
 {
     if (!ctl || !path || !buf || !proc) return -1;
 
-    regex_t *filter;
+    filter_t *filter;
     watch_t logType;
     if (evtFormatSourceEnabled(ctl->evt, CFG_SRC_CONSOLE) &&
        (filter = evtFormatNameFilter(ctl->evt, CFG_SRC_CONSOLE)) &&
-       (!regexec_wrapper(filter, path, 0, NULL, 0))) {
+       filterMatchName(filter, path)) {
         logType = CFG_SRC_CONSOLE;
     } else if (evtFormatSourceEnabled(ctl->evt, CFG_SRC_FILE) &&
        (filter = evtFormatNameFilter(ctl->evt, CFG_SRC_FILE)) &&
-       (!regexec_wrapper(filter, path, 0, NULL, 0))) {
+       filterMatchName(filter, path)) {
         logType = CFG_SRC_FILE;
     } else {
         return 0;
@@ -855,6 +1022,19 @@ ctlSendLog(ctl_t *ctl, int fd, const char *path, const void *buf, size_t count,
     return 0;
 }
 
+// Fills in the event_format_t a log or console event is formatted from
+static void
+logEventFormat(streambuf_t *stmbuf, event_format_t *event)
+{
+    event->timestamp = stmbuf->id.timestamp;
+    event->src = stmbuf->id.path;
+    event->proc = stmbuf->id.proc;
+    event->uid = stmbuf->id.uid;
+    event->sourcetype = stmbuf->id.sourcetype;
+    event->data = NULL;
+}
+
+// Used for msgpack, which is converted from a cJSON tree
 static cJSON *
 createLogEventJson(ctl_t *ctl, streambuf_t *stmbuf)
 {
@@ -863,14 +1043,7 @@ createLogEventJson(ctl_t *ctl, streambuf_t *stmbuf)
     int successful = FALSE;
 
     event_format_t event;
-    event.timestamp = stmbuf->id.timestamp;
-    event.src = stmbuf->id.path;
-    event.proc = stmbuf->id.proc;
-    event.uid = stmbuf->id.uid;
-    event.sourcetype = stmbuf->id.sourcetype;
-
-    g_fn.fclose(stmbuf->stream);  // updates stmbuf->buf, stmbuf->bufsize
-    stmbuf->stream = NULL;
+    logEventFormat(stmbuf, &event);
 
     if (!(root = cJSON_CreateObject())) goto out;
     if (!(data = cJSON_CreateStringFromBuffer(stmbuf->buf, stmbuf->bufsize))) goto out;
@@ -878,8 +1051,8 @@ createLogEventJson(ctl_t *ctl, streambuf_t *stmbuf)
     event.data = root;
 
     if (data && data->valuestring) {
-        regex_t *filter = stmbuf->id.valuefilter;
-        if (filter && regexec_wrapper(filter, data->valuestring, 0, NULL, 0)) {
+        filter_t *filter = stmbuf->id.valuefilter;
+        if (filter && !filterMatch(filter, data->valuestring)) {
             // This event doesn't match.  Drop it on the floor.
             goto out;
         }
@@ -893,9 +1066,6 @@ out:
         cJSON_Delete(root);
         root = NULL;
     }
-    free(stmbuf->buf);
-    free(stmbuf->id.path);
-
     return root;
 }
 
@@ -907,6 +1077,13 @@ sendBufferedMessages(ctl_t *ctl)
         if (data) {
             char *msg = (char*) data;
 
+            // msgpack messages carry their own length; see ctlPostMsg()
+            if (ctl->format == CFG_FMT_MSGPACK) {
+                transportSend(ctl->transport, msg, mpMsgLen(msg));
+                free(msg);
+                continue;
+            }
+
             // Add the newline delimiter to the msg.
             {
                 int strsize = strlen(msg);
@@ -928,7 +1105,7 @@ sendBufferedMessages(ctl_t *ctl)
 }
 
 static void
-sendAggregatedLogData(ctl_t *ctl, streambuf_t *stmbuf)
+sendLogEventMsgpack(ctl_t *ctl, streambuf_t *stmbuf)
 {
     // Create json for log/console event and run the regex valuefilter
     cJSON *json = createLogEventJson(ctl, stmbuf);
@@ -941,14 +1118,60 @@ sendAggregatedLogData(ctl_t *ctl, streambuf_t *stmbuf)
     upld.req = NULL;
     upld.proc = NULL;
     upld.uid = 0;
-    char *msg = prepMessage(&upld);
+    size_t len;
+    char *msg = ctlPrepMessage(ctl, &upld, &len);
     if (!msg) return;
 
     // Send it.
-    transportSend(ctl->transport, msg, strlen(msg));
+    ctlSendEvtMsg(ctl, msg, len);
     free(msg);
 }
 
+// Writes a log or console event the way createLogEventJson() and
+// create_evt_json() would, without building the tree, then sends it.
+static void
+sendLogEventJson(ctl_t *ctl, streambuf_t *stmbuf)
+{
+    event_format_t event;
+    logEventFormat(stmbuf, &event);
+
+    jsbuf_t *js = ctlEvtJsonStart(ctl);
+    ctlJsonEvtHead(js, 0, NULL);
+    fmtEventJsonHead(ctl->evt, &event, js);
+    jsObjStart(js);
+    jsKey(js, "message");
+    size_t message = js->len;
+    jsStrLen(js, (stmbuf->buf) ? stmbuf->buf : "", stmbuf->bufsize);
+
+    // The value filter sees the message as json, quotes and all, which
+    // runs to the end of the buffer for now
+    filter_t *filter = stmbuf->id.valuefilter;
+    if (!jsBufErr(js) && (!filter || filterMatch(filter, &js->data[message]))) {
+        jsObjEnd(js);
+        jsObjEnd(js);
+        jsObjEnd(js);
+        jsNewline(js);
+        if (!jsBufErr(js)) ctlSendEvtMsg(ctl, js->data, js->len);
+    }
+    ctlEvtJsonDone(ctl);
+}
+
+static void
+sendAggregatedLogData(ctl_t *ctl, streambuf_t *stmbuf)
+{
+    g_fn.fclose(stmbuf->stream);  // updates stmbuf->buf, stmbuf->bufsize
+    stmbuf->stream = NULL;
+
+    if (ctl->format == CFG_FMT_MSGPACK) {
+        sendLogEventMsgpack(ctl, stmbuf);
+    } else {
+        sendLogEventJson(ctl, stmbuf);
+    }
+
+    free(stmbuf->buf);
+    free(stmbuf->id.path);
+}
+
 static void
 ctlSendAllAggregatedLogData(ctl_t *ctl)
 {
@@ -1049,6 +1272,7 @@ void
 ctlFlush(ctl_t *ctl)
 {
     if (!ctl) return;
+    ctlReplaySpill(ctl);
     sendBufferedMessages(ctl);
     ctlSendAllAggregatedLogData(ctl);
     transportFlush(ctl->transport);
@@ -1148,6 +1372,77 @@ ctlEvtSet(ctl_t *ctl, evt_fmt_t *evt)
     ctl->evt = evt;
 }
 
+void
+ctlEvtProcChanged(ctl_t *ctl)
+{
+    if (!ctl) return;
+    evtFormatProcChanged(ctl->evt);
+}
+
+void
+ctlSpillSet(ctl_t *ctl, spill_t *spill)
+{
+    if (!ctl) {
+        spillDestroy(&spill);
+        return;
+    }
+
+    // Don't leak if ctlSpillSet is called repeatedly
+    spillDestroy(&ctl->spill);
+    ctl->spill = spill;
+}
+
+static int
+spillMoveFn(void *ctx, const char *msg, size_t len)
+{
+    // Anything the new spill can't hold is counted as dropped there
+    spillWrite(ctx, msg, len);
+    return 0;
+}
+
+/*
+ * On a config change, what the previous ctl spilled hasn't been replayed
+ * yet.  Keep its segments if the spill config is unchanged, otherwise
+ * move its messages into the new spill, ahead of anything newer.
+ */
+void
+ctlSpillInherit(ctl_t *ctl, ctl_t *prev)
+{
+    if (!ctl || !prev || !prev->spill || (ctl == prev)) return;
+
+    const char *dir = spillDir(ctl->spill);
+    if (dir && !strcmp(dir, spillDir(prev->spill)) &&
+        (spillMaxBytes(ctl->spill) == spillMaxBytes(prev->spill))) {
+        spillDestroy(&ctl->spill);
+        ctl->spill = prev->spill;
+        prev->spill = NULL;
+        return;
+    }
+
+    if (ctl->spill) {
+        spillReplay(prev->spill, spillMoveFn, ctl->spill, UINT_MAX);
+    }
+}
+
+void
+ctlSpillReset(ctl_t *ctl)
+{
+    if (!ctl) return;
+    spillReset(ctl->spill);
+}
+
+void
+ctlSpillCounters(ctl_t *ctl, spill_counters_t *ctrs)
+{
+    spillCountersGet((ctl) ? ctl->spill : NULL, ctrs);
+}
+
+int
+ctlSpillEnabled(ctl_t *ctl)
+{
+    return (ctl && ctl->spill);
+}
+
 bool
 ctlEvtSourceEnabled(ctl_t *ctl, watch_t src)
 {
@@ -1173,6 +1468,20 @@ ctlEnhanceFsSet(ctl_t *ctl, unsigned val)
     ctl->enhancefs = val;
 }
 
+cfg_mtc_format_t
+ctlFormat(ctl_t *ctl)
+{
+    return (ctl) ? ctl->format : DEFAULT_CTL_FORMAT;
+}
+
+void
+ctlFormatSet(ctl_t *ctl, cfg_mtc_format_t fmt)
+{
+    if (!ctl) return;
+    if ((fmt != CFG_FMT_NDJSON) && (fmt != CFG_FMT_MSGPACK)) return;
+    ctl->format = fmt;
+}
+
 unsigned int
 ctlPayEnable(ctl_t *ctl)
 {
@@ -1205,6 +1514,19 @@ ctlPayDirSet(ctl_t *ctl, const char *dir)
     ctl->payload.dir = strdup(dir);
 }
 
+cfg_pay_format_t
+ctlPayFormat(ctl_t *ctl)
+{
+    return (ctl) ? ctl->payload.format : DEFAULT_PAYLOAD_FORMAT;
+}
+
+void
+ctlPayFormatSet(ctl_t *ctl, cfg_pay_format_t fmt)
+{
+    if (!ctl || fmt < CFG_PAY_RAW || fmt > CFG_PAY_PCAPNG) return;
+    ctl->payload.format = fmt;
+}
+
 
 uint64_t
 ctlGetEvent(ctl_t *ctl)
@@ -1,10 +1,12 @@
 #ifndef __CTL_H__
 #define __CTL_H__
 
+#include "bytesig.h"
 #include "cfg.h"
 #include "cJSON.h"
 #include "transport.h"
 #include "evtformat.h"
+#include "spill.h"
 
 #define PCRE2_CODE_UNIT_WIDTH 8
 #include "pcre2.h"
@@ -38,10 +40,11 @@ typedef struct {
     bool binary;
     char *regex;
     pcre2_code *re;
+    char *signature;           // takes the place of a binary regex
+    bytesig_t *sig;            // from signature, or a simple binary regex
     unsigned int len;
     unsigned int type;
     char *protname;
-    pcre2_match_data *match_data;
 } protocol_def_t;
 
 typedef struct {
@@ -118,16 +121,26 @@ void             ctlTransportSet(ctl_t *, transport_t *, which_transport_t);
 cfg_transport_t  ctlTransportType(ctl_t *, which_transport_t);
 transport_t *    ctlTransport(ctl_t *, which_transport_t);
 void             ctlEvtSet(ctl_t *, evt_fmt_t *);
+void             ctlEvtProcChanged(ctl_t *);
+void             ctlSpillSet(ctl_t *, spill_t *);
+void             ctlSpillInherit(ctl_t *, ctl_t *);
+void             ctlSpillReset(ctl_t *);
+int              ctlSpillEnabled(ctl_t *);
+void             ctlSpillCounters(ctl_t *, spill_counters_t *);
 
 // Accessor for performance
 bool            ctlEvtSourceEnabled(ctl_t *, watch_t);
 
 unsigned        ctlEnhanceFs(ctl_t *);
 void            ctlEnhanceFsSet(ctl_t *, unsigned);
+cfg_mtc_format_t ctlFormat(ctl_t *);
+void            ctlFormatSet(ctl_t *, cfg_mtc_format_t);
 unsigned int    ctlPayEnable(ctl_t *);
 void            ctlPayEnableSet(ctl_t *, unsigned int);
 const char *    ctlPayDir(ctl_t *);
 void            ctlPayDirSet(ctl_t *, const char *);
+cfg_pay_format_t ctlPayFormat(ctl_t *);
+void            ctlPayFormatSet(ctl_t *, cfg_pay_format_t);
 
 // Retreive events
 uint64_t   ctlGetEvent(ctl_t *);
@@ -2,12 +2,12 @@
 #include <stddef.h>
 #include <stdlib.h>
 #include <string.h>
-#include <sys/timeb.h>
 #include <time.h>
 
 #include "dbg.h"
 #include "evtformat.h"
 #include "com.h"
+#include "plattime.h"
 
 
 // This is ugly, but...
@@ -69,16 +69,20 @@ valToStr(enum_map_t map[], unsigned val)
     return NULL;
 }
 
+// The members of an event body that only depend on the process and the
+// config ("host" through "pid", then the custom tags), serialized once.
 typedef struct {
-    int valid;
-    regex_t re;
-} local_re_t;
+    const proc_id_t *proc;      // what it was built from
+    pid_t pid;
+    size_t len;
+    char data[];
+} envelope_t;
 
 struct _evt_fmt_t
 {
-    local_re_t value_re[CFG_SRC_MAX];
-    local_re_t field_re[CFG_SRC_MAX];
-    local_re_t name_re[CFG_SRC_MAX];
+    filter_t *value_re[CFG_SRC_MAX];
+    filter_t *field_re[CFG_SRC_MAX];
+    filter_t *name_re[CFG_SRC_MAX];
     unsigned enabled[CFG_SRC_MAX];
 
     struct {
@@ -91,6 +95,10 @@ struct _evt_fmt_t
     } ratelimit;
 
     custom_tag_t** tags;
+
+    unsigned capturetime;       // TRUE to timestamp events when captured
+
+    envelope_t *envelope;
 };
 
 static const char *valueFilterDefault[] = {
@@ -139,20 +147,19 @@ static unsigned srcEnabledDefault[] = {
 
 
 static void
-filterSet(local_re_t *re, const char *str, const char *default_val)
+filterSet(filter_t **re, const char *str, const char *default_val)
 {
     if (!re) return;
 
-    local_re_t temp;
-    temp.valid = str && !regcomp(&temp.re, str, REG_EXTENDED | REG_NOSUB);
-    if (!temp.valid && default_val) {
-        // regcomp failed on str.  Try the default.
-        temp.valid = !regcomp(&temp.re, default_val, REG_EXTENDED | REG_NOSUB);
+    filter_t *temp = filterCreate(str);
+    if (!temp && default_val) {
+        // str didn't compile.  Try the default.
+        temp = filterCreate(default_val);
     }
 
-    if (temp.valid) {
+    if (temp) {
         // Out with the old
-        if (re->valid) regfree(&re->re);
+        filterDestroy(re);
         // In with the new
         *re = temp;
     } else {
@@ -160,6 +167,19 @@ filterSet(local_re_t *re, const char *str, const char *default_val)
     }
 }
 
+// The filter to use without an evt_fmt_t, created on first use
+static filter_t *
+defaultFilter(filter_t **defaults, watch_t src, const char *default_val)
+{
+    if (!defaults[src]) {
+        filter_t *temp = filterCreate(default_val);
+        if (temp && !__sync_bool_compare_and_swap(&defaults[src], NULL, temp)) {
+            filterDestroy(&temp);
+        }
+    }
+    return defaults[src];
+}
+
 evt_fmt_t *
 evtFormatCreate()
 {
@@ -178,6 +198,7 @@ evtFormatCreate()
     }
 
     evt->ratelimit.maxEvtPerSec = DEFAULT_MAXEVENTSPERSEC;
+    evt->capturetime = DEFAULT_EVT_CAPTURE_TIME;
 
     evt->tags = DEFAULT_CUSTOM_TAGS;
 
@@ -209,57 +230,52 @@ evtFormatDestroy(evt_fmt_t **evt)
 
     watch_t src;
     for (src=CFG_SRC_FILE; src<CFG_SRC_MAX; src++) {
-        if (edestroy->value_re[src].valid) regfree(&edestroy->value_re[src].re);
-        if (edestroy->field_re[src].valid) regfree(&edestroy->field_re[src].re);
-        if (edestroy->name_re[src].valid) regfree(&edestroy->name_re[src].re);
+        filterDestroy(&edestroy->value_re[src]);
+        filterDestroy(&edestroy->field_re[src]);
+        filterDestroy(&edestroy->name_re[src]);
     }
 
     evtFormatDestroyTags(&edestroy->tags);
+    if (edestroy->envelope) free(edestroy->envelope);
 
     free(edestroy);
     *evt = NULL;
 }
 
-regex_t *
+filter_t *
 evtFormatValueFilter(evt_fmt_t *evt, watch_t src)
 {
     if (src < CFG_SRC_MAX) {
-        if (evt && evt->value_re[src].valid) return &evt->value_re[src].re;
-        static local_re_t default_re[CFG_SRC_MAX];
-        if (!default_re[src].valid) {
-            filterSet(&default_re[src], NULL, valueFilterDefault[src]);
-        }
-        if (default_re[src].valid) return &default_re[src].re;
+        if (evt && evt->value_re[src]) return evt->value_re[src];
+        static filter_t *default_re[CFG_SRC_MAX];
+        filter_t *re = defaultFilter(default_re, src, valueFilterDefault[src]);
+        if (re) return re;
     }
     DBG("%d", src);
     return NULL;
 }
 
-regex_t *
+filter_t *
 evtFormatFieldFilter(evt_fmt_t *evt, watch_t src)
 {
     if (src < CFG_SRC_MAX) {
-        if (evt && evt->field_re[src].valid) return &evt->field_re[src].re;
-        static local_re_t default_re[CFG_SRC_MAX];
-        if (!default_re[src].valid) {
-            filterSet(&default_re[src], NULL, fieldFilterDefault[src]);
-        }
-        if (default_re[src].valid) return &default_re[src].re;
+        if (evt && evt->field_re[src]) return evt->field_re[src];
+        static filter_t *default_re[CFG_SRC_MAX];
+        filter_t *re = defaultFilter(default_re, src, fieldFilterDefault[src]);
+        if (re) return re;
     }
     DBG("%d", src);
     return NULL;
 }
 
-regex_t *
+filter_t *
 evtFormatNameFilter(evt_fmt_t *evt, watch_t src)
 {
     if (src < CFG_SRC_MAX) {
-        if (evt && evt->name_re[src].valid) return &evt->name_re[src].re;
-        static local_re_t default_re[CFG_SRC_MAX];
-        if (!default_re[src].valid) {
-            filterSet(&default_re[src], NULL, nameFilterDefault[src]);
-        }
-        if (default_re[src].valid) return &default_re[src].re;
+        if (evt && evt->name_re[src]) return evt->name_re[src];
+        static filter_t *default_re[CFG_SRC_MAX];
+        filter_t *re = defaultFilter(default_re, src, nameFilterDefault[src]);
+        if (re) return re;
     }
     DBG("%d", src);
     return NULL;
@@ -284,6 +300,12 @@ evtFormatRateLimit(evt_fmt_t *evt)
     return (evt) ? evt->ratelimit.maxEvtPerSec : DEFAULT_MAXEVENTSPERSEC;
 }
 
+unsigned
+evtFormatCaptureTime(evt_fmt_t *evt)
+{
+    return (evt) ? evt->capturetime : DEFAULT_EVT_CAPTURE_TIME;
+}
+
 custom_tag_t**
 evtFormatCustomTags(evt_fmt_t* fmt)
 {
@@ -325,6 +347,13 @@ evtFormatRateLimitSet(evt_fmt_t *evt, unsigned val)
     evt->ratelimit.maxEvtPerSec = val;
 }
 
+void
+evtFormatCaptureTimeSet(evt_fmt_t *evt, unsigned val)
+{
+    if (!evt || val > 1) return;
+    evt->capturetime = val;
+}
+
 void
 evtFormatCustomTagsSet(evt_fmt_t* fmt, custom_tag_t** tags)
 {
@@ -332,6 +361,7 @@ evtFormatCustomTagsSet(evt_fmt_t* fmt, custom_tag_t** tags)
 
     // Don't leak with multiple set operations
     evtFormatDestroyTags(&fmt->tags);
+    evtFormatProcChanged(fmt);
 
     if (!tags || !*tags) return;
 
@@ -363,11 +393,19 @@ evtFormatCustomTagsSet(evt_fmt_t* fmt, custom_tag_t** tags)
     }
 }
 
+void
+evtFormatProcChanged(evt_fmt_t *evt)
+{
+    if (!evt || !evt->envelope) return;
+    free(evt->envelope);
+    evt->envelope = NULL;
+}
+
 #define MATCH_FOUND 1
 #define NO_MATCH_FOUND 0
 
 static int
-anyValueFieldMatches(regex_t *filter, event_t *metric)
+anyValueFieldMatches(filter_t *filter, event_t *metric)
 {
     if (!filter || !metric) return MATCH_FOUND;
 
@@ -385,7 +423,7 @@ anyValueFieldMatches(regex_t *filter, event_t *metric)
             DBG(NULL);
     }
     if (valbuf[0]) {
-        if (!regexec_wrapper(filter, valbuf, 0, NULL, 0)) return MATCH_FOUND;
+        if (filterMatch(filter, valbuf)) return MATCH_FOUND;
     }
 
     // Handle the case where there are no fields...
@@ -403,7 +441,7 @@ anyValueFieldMatches(regex_t *filter, event_t *metric)
             }
         }
 
-        if (str && !regexec_wrapper(filter, str, 0, NULL, 0)) return MATCH_FOUND;
+        if (str && filterMatch(filter, str)) return MATCH_FOUND;
     }
 
     return NO_MATCH_FOUND;
@@ -457,9 +495,7 @@ rateLimitMessage(proc_id_t *proc, watch_t src, unsigned maxEvtPerSec)
 {
     event_format_t event;
 
-    struct timeb tb;
-    ftime(&tb);
-    event.timestamp = tb.time + (double)tb.millitm/1000;
+    event.timestamp = wallClockSecs();
     event.src = "notice";
     event.proc = proc;
     event.uid = 0ULL;
@@ -495,7 +531,7 @@ metricTypeStr(data_type_t type)
 }
 
 static int
-addJsonFields(event_field_t *fields, regex_t *fieldFilter, cJSON *json)
+addJsonFields(event_field_t *fields, filter_t *fieldFilter, cJSON *json)
 {
     if (!fields) return TRUE;
 
@@ -505,7 +541,7 @@ addJsonFields(event_field_t *fields, regex_t *fieldFilter, cJSON *json)
     for (fld = fields; fld->value_type != FMT_END; fld++) {
 
         // skip outputting anything that doesn't match fieldFilter
-        if (fieldFilter && regexec_wrapper(fieldFilter, fld->name, 0, NULL, 0)) continue;
+        if (fieldFilter && !filterMatchName(fieldFilter, fld->name)) continue;
 
         // skip if this field is not used in events
         if (fld->event_usage == FALSE) continue;
@@ -523,7 +559,7 @@ addJsonFields(event_field_t *fields, regex_t *fieldFilter, cJSON *json)
 }
 
 cJSON *
-fmtMetricJson(event_t *metric, regex_t *fieldFilter, watch_t src)
+fmtMetricJson(event_t *metric, filter_t *fieldFilter, watch_t src)
 {
     const char *metric_type = NULL;
 
@@ -560,37 +596,34 @@ err:
     return NULL;
 }
 
-static cJSON *
-evtFormatHelper(evt_fmt_t *evt, event_t *metric, uint64_t uid, proc_id_t *proc, watch_t src)
+typedef enum {
+    EVT_DROP,           // filtered out; nothing to send
+    EVT_NOTICE,         // send a rate limit notice in place of the event
+    EVT_SEND,
+} evt_disposition_t;
+
+static evt_disposition_t
+evtFormatDisposition(evt_fmt_t *evt, event_t *metric, watch_t src)
 {
-    event_format_t event;
-    struct timeb tb;
     time_t now;
-    
-    regex_t *filter;
-
-    if (!evt || !metric || !proc) return NULL;
+    filter_t *filter;
 
     // Test for a name field match.  No match, no metric output
     if (!evtFormatSourceEnabled(evt, src) ||
         !(filter = evtFormatNameFilter(evt, src)) ||
-        (regexec_wrapper(filter, metric->name, 0, NULL, 0))) {
-        return NULL;
+        !filterMatchName(filter, metric->name)) {
+        return EVT_DROP;
     }
 
     // rate limited to maxEvtPerSec
     if (evt->ratelimit.maxEvtPerSec == 0) {
         ; // no rate limiting.
-    } else if (time(&now) != evt->ratelimit.time) {
+    } else if ((now = (time_t)wallClockSecs()) != evt->ratelimit.time) {
         evt->ratelimit.time = now;
         evt->ratelimit.evtCount = evt->ratelimit.notified = 0;
     } else if (++evt->ratelimit.evtCount >= evt->ratelimit.maxEvtPerSec) {
         // one notice per truncate
-        if (evt->ratelimit.notified == 0) {
-            cJSON *notice = rateLimitMessage(proc, src, evt->ratelimit.maxEvtPerSec);
-            evt->ratelimit.notified = (notice)?1:0;
-            return notice;
-        }
+        if (evt->ratelimit.notified == 0) return EVT_NOTICE;
     }
 
     /*
@@ -598,11 +631,43 @@ evtFormatHelper(evt_fmt_t *evt, event_t *metric, uint64_t uid, proc_id_t *proc,
      * No match, no metric output
      */
     if (!anyValueFieldMatches(evtFormatValueFilter(evt, src), metric)) {
-        return NULL;
+        return EVT_DROP;
+    }
+
+    return EVT_SEND;
+}
+
+// When the event happened if that's known and wanted, otherwise now
+static double
+evtFormatTimestamp(evt_fmt_t *evt, event_t *metric)
+{
+    if (evt->capturetime && metric->captured) {
+        return wallClockSecsAt(metric->captured);
+    }
+    return wallClockSecs();
+}
+
+static cJSON *
+evtFormatHelper(evt_fmt_t *evt, event_t *metric, uint64_t uid, proc_id_t *proc, watch_t src)
+{
+    event_format_t event;
+
+    if (!evt || !metric || !proc) return NULL;
+
+    switch (evtFormatDisposition(evt, metric, src)) {
+        case EVT_DROP:
+            return NULL;
+        case EVT_NOTICE:
+        {
+            cJSON *notice = rateLimitMessage(proc, src, evt->ratelimit.maxEvtPerSec);
+            evt->ratelimit.notified = (notice)?1:0;
+            return notice;
+        }
+        case EVT_SEND:
+            break;
     }
 
-    ftime(&tb);
-    event.timestamp = tb.time + (double)tb.millitm/1000;
+    event.timestamp = evtFormatTimestamp(evt, metric);
     event.src = metric->name;
     event.proc = proc;
     event.uid = uid;
@@ -631,3 +696,385 @@ evtFormatHttp(evt_fmt_t *evt, event_t *metric, uint64_t uid, proc_id_t *proc)
 {
     return evtFormatHelper(evt, metric, uid, proc, CFG_SRC_HTTP);
 }
+
+/*
+ * The jsbuf functions below produce exactly the json that the functions
+ * above do, but write it straight from the event_t into a buffer, without
+ * building (and then printing) a cJSON tree.
+ */
+
+// Writes the members of the event body that come from the process and
+// the config
+static void
+fmtEnvelopeJson(evt_fmt_t *efmt, proc_id_t *proc, jsbuf_t *js)
+{
+    jsKey(js, HOST);
+    jsStr(js, proc->hostname);
+    jsKey(js, PROCNAME);
+    jsStr(js, proc->procname);
+    jsKey(js, CMDNAME);
+    jsStr(js, proc->cmd);
+    jsKey(js, PID);
+    jsInt(js, proc->pid);
+
+    custom_tag_t **tags = (efmt) ? evtFormatCustomTags(efmt) : NULL;
+    custom_tag_t *tag;
+    int i = 0;
+    while (tags && (tag = tags[i++])) {
+        // addCustomJsonFields() quietly skips incomplete tags
+        if (!tag->name || !tag->value) continue;
+        jsKey(js, tag->name);
+        jsStr(js, tag->value);
+    }
+}
+
+/*
+ * Returns the serialized envelope for proc, building it the first time.
+ * It stays until evtFormatProcChanged().  Events are only formatted on
+ * the periodic thread (or at exit, once it's done), so nothing else can
+ * be building or reading it.  Returns NULL if the envelope isn't for proc;
+ * the caller is expected to write the members itself then.
+ */
+static const envelope_t *
+evtFormatEnvelope(evt_fmt_t *evt, proc_id_t *proc)
+{
+    envelope_t *env = evt->envelope;
+
+    if (!env) {
+        jsbuf_t js;
+        jsBufInit(&js, NULL, 0);
+        fmtEnvelopeJson(evt, proc, &js);
+        if (jsBufErr(&js) || !(env = malloc(sizeof(*env) + js.len + 1))) {
+            jsBufFree(&js);
+            return NULL;
+        }
+        env->proc = proc;
+        env->pid = proc->pid;
+        env->len = js.len;
+        memcpy(env->data, js.data, js.len + 1);
+        jsBufFree(&js);
+
+        evt->envelope = env;
+    }
+
+    return (env->proc == proc && env->pid == proc->pid) ? env : NULL;
+}
+
+// Opens the event body and writes everything in it except the value of the
+// data field, which the caller is expected to write next (and then close
+// the object).
+void
+fmtEventJsonHead(evt_fmt_t *efmt, event_format_t *sev, jsbuf_t *js)
+{
+    jsObjStart(js);
+    jsKey(js, SOURCETYPE);
+    jsStr(js, valToStr(watchTypeMap, sev->sourcetype));
+    jsKey(js, TIME);
+    jsNum(js, sev->timestamp);
+    jsKey(js, SOURCE);
+    jsStr(js, sev->src);
+
+    const envelope_t *env = (efmt) ? evtFormatEnvelope(efmt, sev->proc) : NULL;
+    if (env) {
+        jsMembers(js, env->data, env->len);
+    } else {
+        fmtEnvelopeJson(efmt, sev->proc, js);
+    }
+
+    jsKey(js, DATA);
+}
+
+int
+fmtMetricJsonBuf(event_t *metric, filter_t *fieldFilter, watch_t src, jsbuf_t *js)
+{
+    if (!metric || !js) return -1;
+
+    jsObjStart(js);
+
+    if (src == CFG_SRC_METRIC) {
+        jsKey(js, "_metric");
+        jsStr(js, metric->name);
+        jsKey(js, "_metric_type");
+        jsStr(js, metricTypeStr(metric->type));
+        switch ( metric->value.type ) {
+            case FMT_INT:
+                jsKey(js, "_value");
+                jsInt(js, metric->value.integer);
+                break;
+            case FMT_FLT:
+                jsKey(js, "_value");
+                jsNum(js, metric->value.floating);
+                break;
+            default:
+                DBG(NULL);
+        }
+    }
+
+    event_field_t *fld;
+    for (fld = metric->fields; fld && fld->value_type != FMT_END; fld++) {
+
+        // skip outputting anything that doesn't match fieldFilter
+        if (fieldFilter && !filterMatchName(fieldFilter, fld->name)) continue;
+
+        // skip if this field is not used in events
+        if (fld->event_usage == FALSE) continue;
+
+        if (fld->value_type == FMT_STR) {
+            jsKey(js, fld->name);
+            jsStr(js, fld->value.str);
+        } else if (fld->value_type == FMT_NUM) {
+            jsKey(js, fld->name);
+            jsInt(js, fld->value.num);
+        } else {
+            DBG("bad field type");
+        }
+    }
+
+    jsObjEnd(js);
+    return (jsBufErr(js)) ? -1 : 0;
+}
+
+static int
+rateLimitMessageJsonBuf(proc_id_t *proc, watch_t src, unsigned maxEvtPerSec, jsbuf_t *js)
+{
+    event_format_t event;
+
+    event.timestamp = wallClockSecs();
+    event.src = "notice";
+    event.proc = proc;
+    event.uid = 0ULL;
+    event.sourcetype = src;
+    event.data = NULL;
+
+    char string[128];
+    if (snprintf(string, sizeof(string), "Truncated metrics. Your rate exceeded %u metrics per second", maxEvtPerSec) == -1) {
+        return -1;
+    }
+
+    fmtEventJsonHead(NULL, &event, js);
+    jsStr(js, string);
+    jsObjEnd(js);
+    return (jsBufErr(js)) ? -1 : 0;
+}
+
+static int
+evtFormatJsonBufHelper(evt_fmt_t *evt, event_t *metric, uint64_t uid, proc_id_t *proc, watch_t src, jsbuf_t *js)
+{
+    event_format_t event;
+
+    if (!evt || !metric || !proc || !js) return -1;
+
+    switch (evtFormatDisposition(evt, metric, src)) {
+        case EVT_DROP:
+            return -1;
+        case EVT_NOTICE:
+        {
+            int rv = rateLimitMessageJsonBuf(proc, src, evt->ratelimit.maxEvtPerSec, js);
+            evt->ratelimit.notified = (rv == 0)?1:0;
+            return rv;
+        }
+        case EVT_SEND:
+            break;
+    }
+
+    event.timestamp = evtFormatTimestamp(evt, metric);
+    event.src = metric->name;
+    event.proc = proc;
+    event.uid = uid;
+    event.sourcetype = src;
+    event.data = NULL;
+
+    fmtEventJsonHead(evt, &event, js);
+
+    if (!metric->data) {
+        fmtMetricJsonBuf(metric, evtFormatFieldFilter(evt, src), src, js);
+    } else {
+        // Some events arrive with their data already in json form
+        jsJson(js, metric->data);
+        cJSON_Delete(metric->data);
+    }
+
+    jsObjEnd(js);
+    return (jsBufErr(js)) ? -1 : 0;
+}
+
+int
+evtFormatMetricJsonBuf(evt_fmt_t *efmt, event_t *metric, uint64_t uid, proc_id_t *proc, jsbuf_t *js)
+{
+    return evtFormatJsonBufHelper(efmt, metric, uid, proc, metric->src, js);
+}
+
+int
+evtFormatHttpJsonBuf(evt_fmt_t *evt, event_t *metric, uint64_t uid, proc_id_t *proc, jsbuf_t *js)
+{
+    return evtFormatJsonBufHelper(evt, metric, uid, proc, CFG_SRC_HTTP, js);
+}
+
+/*
+ * The msgpack functions below write the same structure as their json
+ * counterparts above, but straight from the event_t into a buffer, without
+ * building (and then printing) a cJSON tree.
+ */
+
+// Writes everything in the event body except the value of the data field,
+// which the caller is expected to write next.
+void
+fmtEventMsgpackHead(evt_fmt_t *efmt, event_format_t *sev, mpbuf_t *mp)
+{
+    custom_tag_t **tags = (efmt) ? evtFormatCustomTags(efmt) : NULL;
+    uint32_t numtags = 0;
+    while (tags && tags[numtags]) numtags++;
+
+    mpMap(mp, 8 + numtags);
+    mpStr(mp, SOURCETYPE);
+    mpStr(mp, valToStr(watchTypeMap, sev->sourcetype));
+    mpStr(mp, TIME);
+    mpDouble(mp, sev->timestamp);
+    mpStr(mp, SOURCE);
+    mpStr(mp, sev->src);
+    mpStr(mp, HOST);
+    mpStr(mp, sev->proc->hostname);
+    mpStr(mp, PROCNAME);
+    mpStr(mp, sev->proc->procname);
+    mpStr(mp, CMDNAME);
+    mpStr(mp, sev->proc->cmd);
+    mpStr(mp, PID);
+    mpInt(mp, sev->proc->pid);
+
+    uint32_t i;
+    for (i = 0; i < numtags; i++) {
+        mpStr(mp, tags[i]->name);
+        mpStr(mp, tags[i]->value);
+    }
+
+    mpStr(mp, DATA);
+}
+
+int
+fmtMetricMsgpack(event_t *metric, filter_t *fieldFilter, watch_t src, mpbuf_t *mp)
+{
+    if (!metric || !mp) return -1;
+
+    uint32_t count = 0;
+    size_t map = mpMapStart(mp);
+
+    if (src == CFG_SRC_METRIC) {
+        mpStr(mp, "_metric");
+        mpStr(mp, metric->name);
+        mpStr(mp, "_metric_type");
+        mpStr(mp, metricTypeStr(metric->type));
+        count += 2;
+        switch ( metric->value.type ) {
+            case FMT_INT:
+                mpStr(mp, "_value");
+                mpInt(mp, metric->value.integer);
+                count++;
+                break;
+            case FMT_FLT:
+                mpStr(mp, "_value");
+                mpDouble(mp, metric->value.floating);
+                count++;
+                break;
+            default:
+                DBG(NULL);
+        }
+    }
+
+    event_field_t *fld;
+    for (fld = metric->fields; fld && fld->value_type != FMT_END; fld++) {
+
+        // skip outputting anything that doesn't match fieldFilter
+        if (fieldFilter && !filterMatchName(fieldFilter, fld->name)) continue;
+
+        // skip if this field is not used in events
+        if (fld->event_usage == FALSE) continue;
+
+        if (fld->value_type == FMT_STR) {
+            mpStr(mp, fld->name);
+            mpStr(mp, fld->value.str);
+        } else if (fld->value_type == FMT_NUM) {
+            mpStr(mp, fld->name);
+            mpInt(mp, fld->value.num);
+        } else {
+            DBG("bad field type");
+            continue;
+        }
+        count++;
+    }
+
+    mpMapEnd(mp, map, count);
+    return (mpBufErr(mp)) ? -1 : 0;
+}
+
+static int
+rateLimitMessageMsgpack(proc_id_t *proc, watch_t src, unsigned maxEvtPerSec, mpbuf_t *mp)
+{
+    event_format_t event;
+
+    event.timestamp = wallClockSecs();
+    event.src = "notice";
+    event.proc = proc;
+    event.uid = 0ULL;
+    event.sourcetype = src;
+    event.data = NULL;
+
+    char string[128];
+    if (snprintf(string, sizeof(string), "Truncated metrics. Your rate exceeded %u metrics per second", maxEvtPerSec) == -1) {
+        return -1;
+    }
+
+    fmtEventMsgpackHead(NULL, &event, mp);
+    mpStr(mp, string);
+    return (mpBufErr(mp)) ? -1 : 0;
+}
+
+static int
+evtFormatMsgpackHelper(evt_fmt_t *evt, event_t *metric, uint64_t uid, proc_id_t *proc, watch_t src, mpbuf_t *mp)
+{
+    event_format_t event;
+
+    if (!evt || !metric || !proc || !mp) return -1;
+
+    switch (evtFormatDisposition(evt, metric, src)) {
+        case EVT_DROP:
+            return -1;
+        case EVT_NOTICE:
+        {
+            int rv = rateLimitMessageMsgpack(proc, src, evt->ratelimit.maxEvtPerSec, mp);
+            evt->ratelimit.notified = (rv == 0)?1:0;
+            return rv;
+        }
+        case EVT_SEND:
+            break;
+    }
+
+    event.timestamp = evtFormatTimestamp(evt, metric);
+    event.src = metric->name;
+    event.proc = proc;
+    event.uid = uid;
+    event.sourcetype = src;
+    event.data = NULL;
+
+    fmtEventMsgpackHead(evt, &event, mp);
+
+    if (!metric->data) {
+        return fmtMetricMsgpack(metric, evtFormatFieldFilter(evt, src), src, mp);
+    }
+
+    // Some events arrive with their data already in json form
+    mpJson(mp, metric->data);
+    cJSON_Delete(metric->data);
+    return (mpBufErr(mp)) ? -1 : 0;
+}
+
+int
+evtFormatMetricMsgpack(evt_fmt_t *efmt, event_t *metric, uint64_t uid, proc_id_t *proc, mpbuf_t *mp)
+{
+    return evtFormatMsgpackHelper(efmt, metric, uid, proc, metric->src, mp);
+}
+
+int
+evtFormatHttpMsgpack(evt_fmt_t *evt, event_t *metric, uint64_t uid, proc_id_t *proc, mpbuf_t *mp)
+{
+    return evtFormatMsgpackHelper(evt, metric, uid, proc, CFG_SRC_HTTP, mp);
+}
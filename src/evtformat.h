@@ -3,7 +3,10 @@
 #include "pcre2posix.h"
 #include <stdint.h>
 #include "cJSON.h"
+#include "filter.h"
 #include "mtcformat.h"
+#include "jsonbuf.h"
+#include "msgpack.h"
 
 typedef struct _evt_fmt_t evt_fmt_t;
 
@@ -12,20 +15,35 @@ evt_fmt_t *         evtFormatCreate();
 void                evtFormatDestroy(evt_fmt_t **);
 
 // Accessors
-regex_t *           evtFormatValueFilter(evt_fmt_t *, watch_t);
-regex_t *           evtFormatFieldFilter(evt_fmt_t *, watch_t);
-regex_t *           evtFormatNameFilter(evt_fmt_t *, watch_t);
+filter_t *          evtFormatValueFilter(evt_fmt_t *, watch_t);
+filter_t *          evtFormatFieldFilter(evt_fmt_t *, watch_t);
+filter_t *          evtFormatNameFilter(evt_fmt_t *, watch_t);
 unsigned            evtFormatSourceEnabled(evt_fmt_t *, watch_t);
 unsigned            evtFormatRateLimit(evt_fmt_t *);
+unsigned            evtFormatCaptureTime(evt_fmt_t *);
 custom_tag_t **     evtFormatCustomTags(evt_fmt_t *);
 
 // These are the exposed functions that are expected to be used externally
 cJSON *             evtFormatMetric(evt_fmt_t *, event_t *, uint64_t, proc_id_t *);
 cJSON *             evtFormatHttp(evt_fmt_t *, event_t *, uint64_t, proc_id_t *);
 
+// Streaming equivalents of the above.  These append the event body to the
+// jsbuf_t, returning 0 on success or -1 if the event was filtered out.
+int                 evtFormatMetricJsonBuf(evt_fmt_t *, event_t *, uint64_t, proc_id_t *, jsbuf_t *);
+int                 evtFormatHttpJsonBuf(evt_fmt_t *, event_t *, uint64_t, proc_id_t *, jsbuf_t *);
+
+// Binary equivalents of the above.  These append the event body to the
+// mpbuf_t, returning 0 on success or -1 if the event was filtered out.
+int                 evtFormatMetricMsgpack(evt_fmt_t *, event_t *, uint64_t, proc_id_t *, mpbuf_t *);
+int                 evtFormatHttpMsgpack(evt_fmt_t *, event_t *, uint64_t, proc_id_t *, mpbuf_t *);
+
 // Could be static; these are lower level funcs only exposed for testing
-cJSON *             fmtMetricJson(event_t *, regex_t *, watch_t);
+cJSON *             fmtMetricJson(event_t *, filter_t *, watch_t);
 cJSON *             fmtEventJson(evt_fmt_t *, event_format_t *);
+int                 fmtMetricJsonBuf(event_t *, filter_t *, watch_t, jsbuf_t *);
+void                fmtEventJsonHead(evt_fmt_t *, event_format_t *, jsbuf_t *);
+int                 fmtMetricMsgpack(event_t *, filter_t *, watch_t, mpbuf_t *);
+void                fmtEventMsgpackHead(evt_fmt_t *, event_format_t *, mpbuf_t *);
 
 // Setters (modifies evt_fmt_t, but does not persist modifications)
 void                evtFormatValueFilterSet(evt_fmt_t *, watch_t, const char *);
@@ -33,7 +51,13 @@ void                evtFormatFieldFilterSet(evt_fmt_t *, watch_t, const char *);
 void                evtFormatNameFilterSet(evt_fmt_t *, watch_t, const char *);
 void                evtFormatSourceEnabledSet(evt_fmt_t *, watch_t, unsigned);
 void                evtFormatRateLimitSet(evt_fmt_t *, unsigned);
+void                evtFormatCaptureTimeSet(evt_fmt_t *, unsigned);
 void                evtFormatCustomTagsSet(evt_fmt_t *, custom_tag_t **);
 
+// The host, proc, cmd, pid and custom tags of events are serialized once
+// and reused.  Call this when the proc_id_t they came from changes.  Like
+// the formatting itself, it's meant for the periodic thread (or exit).
+void                evtFormatProcChanged(evt_fmt_t *);
+
 #endif // __EVT_FORMAT_H__
 
@@ -0,0 +1,461 @@
+#define _GNU_SOURCE
+#include <ctype.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+#include "com.h"
+#include "dbg.h"
+#include "filter.h"
+#include "scopetypes.h"
+
+// The number of decisions that can be remembered.  Must be a power of two.
+#define MEMO_SLOTS 256
+// How many slots are tried before giving up on remembering a name
+#define MEMO_PROBES 8
+// Names longer than this aren't remembered
+#define MEMO_MAX_NAME 256
+// Patterns with more alternatives than this aren't prefiltered
+#define MAX_LITERALS 8
+// Only this much of each literal is looked for
+#define MAX_LITERAL_LEN 16
+// Escapes that match one of a set of characters, or assert something.
+// Any other escape of a letter or digit isn't understood by the literal
+// extraction, and the pattern isn't prefiltered.
+#define SIMPLE_ESCAPES "dDsSwWbBhHvVRXAzZGKntrfea"
+
+// Written once, before it's published in a slot; never modified after
+typedef struct {
+    int match;
+    char name[];
+} memo_t;
+
+struct _filter_t {
+    pcre2_code *re;
+    // One literal from each alternative that any match has to contain
+    char *literal[MAX_LITERALS];
+    size_t literal_len[MAX_LITERALS];
+    int nliterals;
+    // Every alternative is just its literal, so finding one is a match
+    int exact;
+    memo_t *volatile memo[MEMO_SLOTS];
+};
+
+static void
+literalsFree(filter_t *filter)
+{
+    int i;
+    for (i = 0; i < filter->nliterals; i++) free(filter->literal[i]);
+    filter->nliterals = 0;
+    filter->exact = FALSE;
+}
+
+// Keeps the longer of the current run of literal characters and the best
+// one found so far in this alternative, then starts a new run.
+static void
+runEnd(char *run, size_t *runlen, char *best, size_t *bestlen)
+{
+    if (*runlen > *bestlen) {
+        memcpy(best, run, *runlen);
+        *bestlen = *runlen;
+    }
+    *runlen = 0;
+}
+
+// Returns a pointer past a {n}, {n,} or {n,m} quantifier, or NULL if p
+// isn't one (in which case the brace is just a literal character)
+static const char *
+quantifierEnd(const char *p)
+{
+    const char *q = p + 1;
+    if (!isdigit((unsigned char)*q)) return NULL;
+    while (isdigit((unsigned char)*q)) q++;
+    if (*q == ',') {
+        q++;
+        while (isdigit((unsigned char)*q)) q++;
+    }
+    return (*q == '}') ? q + 1 : NULL;
+}
+
+// Returns a pointer past the character class that starts at p, or NULL
+static const char *
+classEnd(const char *p)
+{
+    const char *q = p + 1;
+    if (*q == '^') q++;
+    if (*q == ']') q++;    // a leading ] is part of the class
+    while (*q && (*q != ']')) {
+        if ((*q == '\\') && q[1]) {
+            q += 2;
+        } else if ((q[0] == '[') && (q[1] == ':')) {
+            if (!(q = strstr(q + 2, ":]"))) return NULL;
+            q += 2;
+        } else {
+            q++;
+        }
+    }
+    return (*q) ? q + 1 : NULL;
+}
+
+/*
+ * Finds, for each top level alternative of the pattern, the longest run
+ * of literal characters that any match of that alternative must contain.
+ * If every alternative has one, a string that contains none of them can't
+ * match, and that's cheaper to find out than running the regex.  This is
+ * deliberately conservative; anything it doesn't understand (options,
+ * most escapes, too many alternatives) means no prefilter at all.
+ */
+static void
+literalsExtract(filter_t *filter, const char *pattern)
+{
+    if (strstr(pattern, "(?") || strstr(pattern, "(*") ||
+        strstr(pattern, "\\Q")) return;
+
+    size_t size = strlen(pattern) + 1;
+    char *run = malloc(size);
+    char *best = malloc(size);
+    if (!run || !best) {
+        DBG(NULL);
+        goto out;
+    }
+
+    const char *p = pattern;
+    const char *q;
+    size_t runlen = 0, bestlen = 0;
+    int depth = 0;
+    int pure = TRUE;       // this alternative is only literal characters
+    int exact = TRUE;
+
+    while (TRUE) {
+        char c = *p;
+
+        if ((c == '\0') || ((c == '|') && (depth == 0))) {
+            runEnd(run, &runlen, best, &bestlen);
+            if (!bestlen || (filter->nliterals == MAX_LITERALS)) goto fail;
+            if (bestlen > MAX_LITERAL_LEN) {
+                bestlen = MAX_LITERAL_LEN;
+                pure = FALSE;
+            }
+            if (!(filter->literal[filter->nliterals] = strndup(best, bestlen))) goto fail;
+            filter->literal_len[filter->nliterals++] = bestlen;
+            exact = exact && pure;
+
+            if (c == '\0') break;
+            bestlen = 0;
+            pure = TRUE;
+            p++;
+            continue;
+        }
+
+        if (c == '\\') {
+            unsigned char e = p[1];
+            if (!e) goto fail;
+            if (isalnum(e)) {
+                if (!strchr(SIMPLE_ESCAPES, e)) goto fail;
+                if (depth == 0) {
+                    runEnd(run, &runlen, best, &bestlen);
+                    pure = FALSE;
+                }
+            } else if (depth == 0) {
+                // an escaped metacharacter (or anything else) is literal
+                run[runlen++] = e;
+            }
+            p += 2;
+            continue;
+        }
+
+        if (c == '[') {
+            if (!(q = classEnd(p))) goto fail;
+            p = q;
+        } else if (c == '(') {
+            depth++;
+            p++;
+        } else if (c == ')') {
+            if (--depth < 0) goto fail;
+            p++;
+        } else {
+            p++;
+            if (depth) continue;
+
+            switch (c) {
+                case '?':
+                case '*':
+                    // the character before is optional
+                    if (runlen) runlen--;
+                    break;
+                case '{':
+                    if ((q = quantifierEnd(p - 1))) {
+                        if (runlen) runlen--;
+                        p = q;
+                    }
+                    break;
+                case '+':
+                case '^':
+                case '$':
+                case '.':
+                case '}':
+                case ']':
+                    break;
+                default:
+                    run[runlen++] = c;
+                    continue;
+            }
+        }
+
+        // Whatever this was, it isn't part of a run of literal characters
+        runEnd(run, &runlen, best, &bestlen);
+        pure = FALSE;
+    }
+
+    filter->exact = exact;
+    goto out;
+
+fail:
+    literalsFree(filter);
+out:
+    if (run) free(run);
+    if (best) free(best);
+}
+
+// JIT compiled patterns already skip ahead quickly to where a match can
+// start, if it can only start with one or two different characters.
+// The literal prefilter isn't any faster than that.
+static int
+jitSkipsAhead(pcre2_code *re)
+{
+    uint32_t type = 0;
+    const uint8_t *bitmap = NULL;
+
+    if (pcre2_pattern_info(re, PCRE2_INFO_FIRSTCODETYPE, &type)) return FALSE;
+    if (type == 1) return TRUE;
+    if (pcre2_pattern_info(re, PCRE2_INFO_FIRSTBITMAP, &bitmap) || !bitmap) return FALSE;
+
+    int i, chars = 0;
+    for (i = 0; i < 32; i++) chars += __builtin_popcount(bitmap[i]);
+    return (chars <= 2);
+}
+
+filter_t *
+filterCreate(const char *pattern)
+{
+    if (!pattern) return NULL;
+
+    filter_t *filter = calloc(1, sizeof(*filter));
+    if (!filter) {
+        DBG(NULL);
+        return NULL;
+    }
+
+    int errornumber;
+    PCRE2_SIZE erroroffset;
+    filter->re = pcre2_compile((PCRE2_SPTR)pattern, PCRE2_ZERO_TERMINATED,
+                               0, &errornumber, &erroroffset, NULL);
+    if (!filter->re) {
+        free(filter);
+        return NULL;
+    }
+
+    // If there's no JIT support (or no executable memory to be had),
+    // pcre2_match() just interprets the pattern instead.
+    int jit = !pcre2_jit_compile(filter->re, PCRE2_JIT_COMPLETE);
+
+    if (!jit || !jitSkipsAhead(filter->re)) literalsExtract(filter, pattern);
+
+    return filter;
+}
+
+void
+filterDestroy(filter_t **filter)
+{
+    if (!filter || !*filter) return;
+    filter_t *f = *filter;
+
+    int i;
+    for (i = 0; i < MEMO_SLOTS; i++) {
+        if (f->memo[i]) free(f->memo[i]);
+    }
+    literalsFree(f);
+    pcre2_code_free(f->re);
+    free(f);
+    *filter = NULL;
+}
+
+// TRUE if any of the literals starts at str[pos]
+static int
+literalAt(filter_t *filter, const char *str, size_t len, size_t pos)
+{
+    int i;
+    for (i = 0; i < filter->nliterals; i++) {
+        size_t n = filter->literal_len[i];
+        if ((pos + n <= len) && !memcmp(&str[pos], filter->literal[i], n)) return TRUE;
+    }
+    return FALSE;
+}
+
+#ifdef __SSE2__
+typedef struct {
+    __m128i first[MAX_LITERALS];
+    __m128i last[MAX_LITERALS];
+    size_t off[MAX_LITERALS];
+    int n;
+} literal_set_t;
+
+// Returns a bit for each of the 16 positions from p where one of the
+// literals' first and last characters are both where they should be
+static inline unsigned
+blockCandidates(literal_set_t *set, const char *p)
+{
+    __m128i block = _mm_loadu_si128((const __m128i *)p);
+    __m128i hits = _mm_setzero_si128();
+
+    int i;
+    for (i = 0; i < set->n; i++) {
+        __m128i end = _mm_loadu_si128((const __m128i *)&p[set->off[i]]);
+        hits = _mm_or_si128(hits,
+                            _mm_and_si128(_mm_cmpeq_epi8(block, set->first[i]),
+                                          _mm_cmpeq_epi8(end, set->last[i])));
+    }
+    return _mm_movemask_epi8(hits);
+}
+#endif
+
+/*
+ * Looks for all of the literals in one pass.  16 positions at a time are
+ * compared against the first and last characters of every literal, and
+ * only where both agree is the whole literal compared.  Log data rarely
+ * gets that far, so most of it is rejected at close to memory speed.
+ */
+static int
+literalsFound(filter_t *filter, const char *str, size_t len)
+{
+#ifdef __SSE2__
+    literal_set_t set;
+    int i;
+    set.n = filter->nliterals;
+    for (i = 0; i < set.n; i++) {
+        set.off[i] = filter->literal_len[i] - 1;
+        set.first[i] = _mm_set1_epi8(filter->literal[i][0]);
+        set.last[i] = _mm_set1_epi8(filter->literal[i][set.off[i]]);
+    }
+
+    // Every load has to stay within the string
+    size_t pos = 0;
+    unsigned mask;
+    for (; pos + 16 + MAX_LITERAL_LEN - 1 <= len; pos += 16) {
+        mask = blockCandidates(&set, &str[pos]);
+        for (; mask; mask &= mask - 1) {
+            if (literalAt(filter, str, len, pos + __builtin_ctz(mask))) return TRUE;
+        }
+    }
+
+    // What's left is copied somewhere it's safe to read past.  The
+    // literals have no nuls, so the padding can't look like a candidate.
+    char tail[2 * 16 + MAX_LITERAL_LEN] = {0};
+    size_t rest = len - pos;
+    memcpy(tail, &str[pos], rest);
+    size_t at;
+    for (at = 0; at < rest; at += 16) {
+        mask = blockCandidates(&set, &tail[at]);
+        for (; mask; mask &= mask - 1) {
+            if (literalAt(filter, str, len, pos + at + __builtin_ctz(mask))) return TRUE;
+        }
+    }
+    return FALSE;
+#else
+    size_t pos;
+    for (pos = 0; pos < len; pos++) {
+        if (literalAt(filter, str, len, pos)) return TRUE;
+    }
+    return FALSE;
+#endif
+}
+
+// Returns 1 for a match, 0 for no match, and -1 if it couldn't tell
+static int
+filterExec(filter_t *filter, const char *str, size_t len)
+{
+    if (filter->nliterals) {
+        if (!literalsFound(filter, str, len)) return 0;
+        if (filter->exact) return 1;
+    }
+
+    pcre2_match_data *match_data = pcre2ThreadMatchData();
+    pcre2_match_data *temp = NULL;
+
+    // Not much else to do if this thread's match data can't be had
+    if (!match_data) {
+        if (!(match_data = temp = pcre2_match_data_create(1, NULL))) return -1;
+    }
+
+    int rc = pcre2_match_wrapper(filter->re, (PCRE2_SPTR)str, len, 0, 0,
+                                 match_data, NULL);
+    if (temp) pcre2_match_data_free(temp);
+
+    // 0 means it matched, but the ovector was too small for the captures
+    if (rc >= 0) return 1;
+    if (rc == PCRE2_ERROR_NOMATCH) return 0;
+    return -1;
+}
+
+int
+filterMatch(filter_t *filter, const char *str)
+{
+    if (!filter || !str) return FALSE;
+    return (filterExec(filter, str, strlen(str)) == 1);
+}
+
+// FNV-1a; also returns the length of the name
+static uint32_t
+memoHash(const char *name, size_t *len)
+{
+    const unsigned char *p = (const unsigned char *)name;
+    uint32_t hash = 2166136261U;
+
+    while (*p) {
+        hash ^= *p++;
+        hash *= 16777619U;
+    }
+    *len = (const char *)p - name;
+    return hash;
+}
+
+int
+filterMatchName(filter_t *filter, const char *name)
+{
+    if (!filter || !name) return FALSE;
+
+    size_t len;
+    uint32_t hash = memoHash(name, &len);
+    if (len > MEMO_MAX_NAME) return filterMatch(filter, name);
+
+    int i;
+    for (i = 0; i < MEMO_PROBES; i++) {
+        memo_t *volatile *slot = &filter->memo[(hash + i) & (MEMO_SLOTS - 1)];
+        memo_t *memo = *slot;
+
+        if (memo) {
+            if (!strcmp(memo->name, name)) return memo->match;
+            continue;
+        }
+
+        // First time we've seen this name.  Only remember a definite answer.
+        int rc = filterExec(filter, name, len);
+        if (rc < 0) return FALSE;
+
+        if ((memo = malloc(sizeof(*memo) + len + 1))) {
+            memo->match = rc;
+            memcpy(memo->name, name, len + 1);
+
+            // If another thread beat us to the slot, forget this one.
+            // It'll be remembered the next time the name is seen.
+            if (!__sync_bool_compare_and_swap(slot, NULL, memo)) free(memo);
+        }
+        return rc;
+    }
+
+    // Nowhere to remember it
+    return filterMatch(filter, name);
+}
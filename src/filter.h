@@ -0,0 +1,35 @@
+#ifndef __FILTER_H__
+#define __FILTER_H__
+
+/*
+ * The name, field and value filters that are configured for events.
+ * Patterns are PCRE2 regular expressions.  They're JIT compiled where
+ * that's supported, and each thread matches with its own match data, so
+ * a filter can be used from any number of threads at once.
+ *
+ * Names (event names, field names, and the paths of log files) come from
+ * a small set, and the same ones are filtered over and over.  So
+ * filterMatchName() remembers what it decided for each name it's seen,
+ * and after the first time a name costs a hash lookup instead of a regex
+ * match.  Memory for this is bounded; names that don't fit (or are very
+ * long) are just matched every time.  Decisions are only forgotten when
+ * the filter is destroyed, which happens when the config changes.
+ *
+ * filterMatch() is for everything else, e.g. field values and log data.
+ * Where every alternative of a pattern has to contain some literal text
+ * (e.g. "ERROR|WARN|timeout"), strings are scanned for those literals
+ * first, and only run through the regex if one's found.
+ */
+
+typedef struct _filter_t filter_t;
+
+// Returns NULL if the pattern doesn't compile
+filter_t *          filterCreate(const char *);
+void                filterDestroy(filter_t **);
+
+// These return TRUE if the string matches, FALSE if it doesn't (or if
+// either argument is NULL)
+int                 filterMatch(filter_t *, const char *);
+int                 filterMatchName(filter_t *, const char *);
+
+#endif // __FILTER_H__
@@ -0,0 +1,113 @@
+#define _GNU_SOURCE
+#include <string.h>
+#include "atomic.h"
+#include "histo.h"
+
+#define HISTO_SUB (1 << HISTO_SUB_BITS)
+
+static inline int
+bucketIndex(uint64_t val)
+{
+    if (val < HISTO_SUB) return val;
+    if (val >> HISTO_MAX_BITS) return HISTO_BUCKETS - 1;
+
+    // The highest bit set picks the power of 2; the next bits down pick
+    // the bucket in it
+    int exp = 63 - __builtin_clzll(val);
+    int shift = exp - HISTO_SUB_BITS;
+    return ((shift + 1) << HISTO_SUB_BITS) + ((val >> shift) & (HISTO_SUB - 1));
+}
+
+// The middle of the values a bucket counts
+static uint64_t
+bucketValue(int index)
+{
+    if (index < HISTO_SUB) return index;
+
+    int shift = (index >> HISTO_SUB_BITS) - 1;
+    uint64_t low = (uint64_t)(HISTO_SUB + (index & (HISTO_SUB - 1))) << shift;
+    return low + ((1ULL << shift) >> 1);
+}
+
+void
+histoRecord(histo_t *histo, uint64_t val)
+{
+    if (!histo) return;
+
+    __atomic_fetch_add(&histo->bucket[bucketIndex(val)], 1, __ATOMIC_RELAXED);
+
+    uint64_t max = __atomic_load_n(&histo->max, __ATOMIC_RELAXED);
+    while ((val > max) &&
+           !__atomic_compare_exchange_n(&histo->max, &max, val, 0,
+                                        __ATOMIC_RELAXED, __ATOMIC_RELAXED));
+}
+
+void
+histoTake(histo_t *from, histo_t *to)
+{
+    if (!from || !to) return;
+
+    to->max = atomicSwapU64(&from->max, 0);
+    int i;
+    for (i = 0; i < HISTO_BUCKETS; i++) {
+        // Most buckets are empty; don't write to those
+        to->bucket[i] = (from->bucket[i]) ? atomicSwapU64(&from->bucket[i], 0) : 0;
+    }
+}
+
+void
+histoMerge(histo_t *to, const histo_t *from)
+{
+    if (!to || !from) return;
+
+    if (from->max > to->max) to->max = from->max;
+    int i;
+    for (i = 0; i < HISTO_BUCKETS; i++) {
+        to->bucket[i] += from->bucket[i];
+    }
+}
+
+uint64_t
+histoCount(const histo_t *histo)
+{
+    if (!histo) return 0;
+
+    uint64_t count = 0;
+    int i;
+    for (i = 0; i < HISTO_BUCKETS; i++) {
+        count += histo->bucket[i];
+    }
+    return count;
+}
+
+uint64_t
+histoMax(const histo_t *histo)
+{
+    return (histo) ? histo->max : 0;
+}
+
+uint64_t
+histoQuantile(const histo_t *histo, double q)
+{
+    uint64_t count = histoCount(histo);
+    if (!count) return 0;
+
+    if (q < 0.0) q = 0.0;
+    if (q > 1.0) q = 1.0;
+    // The rank of the value, counting from 1, rounded up
+    uint64_t rank = q * count;
+    if (rank < q * count) rank++;
+    if (rank < 1) rank = 1;
+
+    uint64_t seen = 0;
+    int i;
+    for (i = 0; i < HISTO_BUCKETS; i++) {
+        seen += histo->bucket[i];
+        if (seen >= rank) break;
+    }
+    if (i == HISTO_BUCKETS) i--;
+
+    // The max is exact; nothing's over it
+    uint64_t val = bucketValue(i);
+    return (val > histo->max) ? histo->max : val;
+}
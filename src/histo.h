@@ -0,0 +1,50 @@
+#ifndef __HISTO_H__
+#define __HISTO_H__
+
+#include <stdint.h>
+
+/*
+ * A histogram of durations (or any other non-negative values), so that
+ * percentiles can be reported instead of just an average.
+ *
+ * Buckets are log-linear, like an HDR histogram: each power of 2 is split
+ * into 8 buckets of the same width.  Values under 8 are counted exactly,
+ * and a percentile is never off by more than 1/16 of its value.  Values
+ * of 2^40 and over (about 18 minutes in ns) are counted in the last bucket.
+ * That's 304 buckets in a fixed 2.4K, with no allocation.
+ *
+ * Recording is lock free, and costs an atomic add (and an atomic
+ * compare and swap, when it's a new max).  Any number of threads can
+ * record into a histogram while another one moves its counts out with
+ * histoTake().  Histograms with the same layout can be merged.
+ *
+ * A histo_t that's all zeros is empty, so a static one needs no setup.
+ */
+
+#define HISTO_SUB_BITS 3
+#define HISTO_MAX_BITS 40
+#define HISTO_BUCKETS ((HISTO_MAX_BITS - HISTO_SUB_BITS + 1) << HISTO_SUB_BITS)
+
+typedef struct {
+    uint64_t max;
+    uint64_t bucket[HISTO_BUCKETS];
+} histo_t;
+
+void                histoRecord(histo_t *, uint64_t);
+
+// Moves everything recorded in the first histogram to the second, which
+// is overwritten.  The first is left empty.
+void                histoTake(histo_t *, histo_t *);
+
+// Adds everything recorded in the second histogram to the first.  Neither
+// should be recorded to while this is done.
+void                histoMerge(histo_t *, const histo_t *);
+
+uint64_t            histoCount(const histo_t *);
+uint64_t            histoMax(const histo_t *);
+
+// Returns the value that q (0.0 to 1.0) of the recorded values are at or
+// under, e.g. 0.99 for the 99th percentile.  0 if nothing's recorded.
+uint64_t            histoQuantile(const histo_t *, double q);
+
+#endif // __HISTO_H__
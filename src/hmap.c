@@ -0,0 +1,207 @@
+#define _GNU_SOURCE
+#include <stdlib.h>
+#include "atomic.h"
+#include "hmap.h"
+
+#define TRUE 1
+#define FALSE 0
+
+// How far past the slot a key hashes to it can be
+#define MAX_PROBES 64
+
+typedef enum {
+    SLOT_EMPTY,         // never used; ends every search
+    SLOT_BUSY,          // being filled or emptied by one thread
+    SLOT_FULL,
+    SLOT_DELETED,       // was used; searches continue past it
+} slot_state_t;
+
+typedef struct {
+    uint64_t state;
+    list_key_t key;
+    void *data;
+    time_t time;
+} hmap_slot_t;
+
+struct _hmap_t {
+    delete_fn_t delete_fn;
+    size_t mask;
+    hmap_slot_t *slots;
+};
+
+static inline uint64_t
+slotState(hmap_slot_t *slot)
+{
+    return __atomic_load_n(&slot->state, __ATOMIC_SEQ_CST);
+}
+
+static inline void
+slotStateSet(hmap_slot_t *slot, uint64_t state)
+{
+    __atomic_store_n(&slot->state, state, __ATOMIC_SEQ_CST);
+}
+
+// Keys are often sequential (uids) or aligned pointers, so mix all of the
+// bits in.  This is the finalizer from splitmix64.
+static inline size_t
+hashKey(hmap_t *map, list_key_t key)
+{
+    key ^= key >> 30;
+    key *= 0xbf58476d1ce4e5b9ULL;
+    key ^= key >> 27;
+    key *= 0x94d049bb133111ebULL;
+    key ^= key >> 31;
+    return key & map->mask;
+}
+
+static size_t
+probeLimit(hmap_t *map)
+{
+    return (map->mask < MAX_PROBES) ? map->mask + 1 : MAX_PROBES;
+}
+
+// Returns the full slot with key, or NULL.  If skip isn't NULL, that
+// slot doesn't count.
+static hmap_slot_t *
+findSlot(hmap_t *map, list_key_t key, hmap_slot_t *skip)
+{
+    size_t home = hashKey(map, key);
+    size_t limit = probeLimit(map);
+    size_t i;
+
+    for (i = 0; i < limit; i++) {
+        hmap_slot_t *slot = &map->slots[(home + i) & map->mask];
+        uint64_t state = slotState(slot);
+        if (state == SLOT_EMPTY) break;
+        if ((state == SLOT_FULL) && (slot->key == key) && (slot != skip)) {
+            return slot;
+        }
+    }
+    return NULL;
+}
+
+// Empties a full slot.  Returns FALSE if another thread got to it first.
+static int
+releaseSlot(hmap_t *map, hmap_slot_t *slot)
+{
+    if (!atomicCasU64(&slot->state, SLOT_FULL, SLOT_BUSY)) return FALSE;
+
+    void *data = slot->data;
+    slot->data = NULL;
+    // Not SLOT_EMPTY; searches for other keys may need to pass this one
+    slotStateSet(slot, SLOT_DELETED);
+
+    if (map->delete_fn && data) map->delete_fn(data);
+    return TRUE;
+}
+
+hmap_t *
+hmapCreate(size_t size, delete_fn_t delete_fn)
+{
+    size_t slots = 1;
+    while ((slots < size) && (slots < (SIZE_MAX >> 1))) slots <<= 1;
+
+    hmap_t *map = calloc(1, sizeof(hmap_t));
+    if (!map) return NULL;
+    map->slots = calloc(slots, sizeof(hmap_slot_t));
+    if (!map->slots) {
+        free(map);
+        return NULL;
+    }
+    map->mask = slots - 1;
+    map->delete_fn = delete_fn;
+    return map;
+}
+
+void
+hmapDestroy(hmap_t **map_ptr)
+{
+    if (!map_ptr || !*map_ptr) return;
+    hmap_t *map = *map_ptr;
+
+    size_t i;
+    for (i = 0; i <= map->mask; i++) {
+        if (slotState(&map->slots[i]) == SLOT_FULL) {
+            releaseSlot(map, &map->slots[i]);
+        }
+    }
+
+    free(map->slots);
+    free(map);
+    *map_ptr = NULL;
+}
+
+int
+hmapInsert(hmap_t *map, list_key_t key, void *data)
+{
+    if (!map) return FALSE;
+
+    if (findSlot(map, key, NULL)) return FALSE;
+
+    size_t home = hashKey(map, key);
+    size_t limit = probeLimit(map);
+    size_t i;
+
+    for (i = 0; i < limit; i++) {
+        hmap_slot_t *slot = &map->slots[(home + i) & map->mask];
+        uint64_t state = slotState(slot);
+        if ((state != SLOT_EMPTY) && (state != SLOT_DELETED)) continue;
+        if (!atomicCasU64(&slot->state, state, SLOT_BUSY)) continue;
+
+        slot->key = key;
+        slot->data = data;
+        slot->time = time(NULL);
+        slotStateSet(slot, SLOT_FULL);
+
+        // Another thread could have inserted the same key in another
+        // slot since we looked.  Whichever of us looks second sees the
+        // other, so backing out here leaves at most one of them.
+        if (findSlot(map, key, slot)) {
+            // If we can't back out, it's been deleted (and data with it)
+            if (!atomicCasU64(&slot->state, SLOT_FULL, SLOT_BUSY)) return TRUE;
+            slot->data = NULL;
+            slotStateSet(slot, SLOT_DELETED);
+            return FALSE;
+        }
+        return TRUE;
+    }
+
+    // No room within reach of where key hashes to
+    return FALSE;
+}
+
+int
+hmapDelete(hmap_t *map, list_key_t key)
+{
+    if (!map) return FALSE;
+
+    hmap_slot_t *slot = findSlot(map, key, NULL);
+    if (!slot) return FALSE;
+
+    return releaseSlot(map, slot);
+}
+
+void *
+hmapFind(hmap_t *map, list_key_t key)
+{
+    if (!map) return NULL;
+
+    hmap_slot_t *slot = findSlot(map, key, NULL);
+    return (slot) ? slot->data : NULL;
+}
+
+int
+hmapExpire(hmap_t *map, time_t before)
+{
+    if (!map) return 0;
+
+    int expired = 0;
+    size_t i;
+    for (i = 0; i <= map->mask; i++) {
+        hmap_slot_t *slot = &map->slots[i];
+        if ((slotState(slot) == SLOT_FULL) && (slot->time < before)) {
+            expired += releaseSlot(map, slot);
+        }
+    }
+    return expired;
+}
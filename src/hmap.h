@@ -0,0 +1,50 @@
+#ifndef __HMAP_H__
+#define __HMAP_H__
+
+#include <stddef.h>
+#include <time.h>
+#include "linklist.h"
+
+/*
+ * A hash map of (key, data) elements, with the same interface as a list_t
+ * (see linklist.h), for when finding an element by walking a list costs
+ * too much.  It's open addressing in a fixed number of slots, with no
+ * locks; slots are claimed and released with compare and swap, so any
+ * number of threads can use it at once.  As with a list_t, the data an
+ * element points to isn't protected from being deleted while another
+ * thread is using what hmapFind() returned.
+ *
+ * The size is fixed when it's created, and an element is only looked for
+ * in the few dozen slots after where its key hashes to.  So hmapInsert()
+ * can fail when the map is nearly full, and a lookup never costs more
+ * than a short scan.  If the same key is inserted by two threads at
+ * once, at most one of the inserts succeeds.
+ *
+ * Each element remembers when it was inserted, so that elements that
+ * are never deleted (e.g. a request whose response is never seen) can
+ * be expired instead of staying forever.
+ */
+
+typedef struct _hmap_t hmap_t;
+
+// Constructors Destructors
+// size is rounded up to a power of 2.  delete_fn is optional, and is
+// called with data whenever an element is deleted, expired or destroyed.
+hmap_t *            hmapCreate(size_t size, delete_fn_t delete_fn);
+void                hmapDestroy(hmap_t **);
+
+// Returns TRUE if (key, data) was inserted.  FALSE if key is already in
+// the map, or there's no room for it.
+int                 hmapInsert(hmap_t *, list_key_t key, void *data);
+
+// Returns TRUE if an element with key was found and deleted
+int                 hmapDelete(hmap_t *, list_key_t key);
+
+// Returns data if an element with key is found, otherwise NULL
+void *              hmapFind(hmap_t *, list_key_t key);
+
+// Deletes every element inserted before the time given, as from time(),
+// and returns how many were deleted.
+int                 hmapExpire(hmap_t *, time_t before);
+
+#endif // __HMAP_H__
@@ -0,0 +1,436 @@
+#define _GNU_SOURCE
+#include <stdlib.h>
+#include <string.h>
+#include "dbg.h"
+#include "hpack.h"
+
+// RFC 7541 Section 4.1: each entry counts 32 bytes more than its strings
+#define ENTRY_OVERHEAD 32
+#define MAX_STRING (64 * 1024)
+
+#define HUFF_MAX_BITS 30
+#define HUFF_SYMBOLS 257
+#define HUFF_EOS 256
+
+typedef struct {
+    const char *name;
+    const char *value;
+} static_entry_t;
+
+// RFC 7541 Appendix A, indexed from 1
+static const static_entry_t staticTable[] = {
+    {":authority", ""},
+    {":method", "GET"},
+    {":method", "POST"},
+    {":path", "/"},
+    {":path", "/index.html"},
+    {":scheme", "http"},
+    {":scheme", "https"},
+    {":status", "200"},
+    {":status", "204"},
+    {":status", "206"},
+    {":status", "304"},
+    {":status", "400"},
+    {":status", "404"},
+    {":status", "500"},
+    {"accept-charset", ""},
+    {"accept-encoding", "gzip, deflate"},
+    {"accept-language", ""},
+    {"accept-ranges", ""},
+    {"accept", ""},
+    {"access-control-allow-origin", ""},
+    {"age", ""},
+    {"allow", ""},
+    {"authorization", ""},
+    {"cache-control", ""},
+    {"content-disposition", ""},
+    {"content-encoding", ""},
+    {"content-language", ""},
+    {"content-length", ""},
+    {"content-location", ""},
+    {"content-range", ""},
+    {"content-type", ""},
+    {"cookie", ""},
+    {"date", ""},
+    {"etag", ""},
+    {"expect", ""},
+    {"expires", ""},
+    {"from", ""},
+    {"host", ""},
+    {"if-match", ""},
+    {"if-modified-since", ""},
+    {"if-none-match", ""},
+    {"if-range", ""},
+    {"if-unmodified-since", ""},
+    {"last-modified", ""},
+    {"link", ""},
+    {"location", ""},
+    {"max-forwards", ""},
+    {"proxy-authenticate", ""},
+    {"proxy-authorization", ""},
+    {"range", ""},
+    {"referer", ""},
+    {"refresh", ""},
+    {"retry-after", ""},
+    {"server", ""},
+    {"set-cookie", ""},
+    {"strict-transport-security", ""},
+    {"transfer-encoding", ""},
+    {"user-agent", ""},
+    {"vary", ""},
+    {"via", ""},
+    {"www-authenticate", ""},
+};
+#define STATIC_ENTRIES (sizeof(staticTable) / sizeof(staticTable[0]))
+
+/*
+ * The Huffman code of RFC 7541 Appendix B is canonical: codes of the same
+ * length are consecutive, in symbol order, so it's decoded from the
+ * number of codes of each length and the symbols in code order.
+ */
+static const uint16_t huffCount[HUFF_MAX_BITS + 1] = {
+    0, 0, 0, 0, 0, 10, 26, 32, 6, 0, 5, 3, 2, 6, 2, 3,
+    0, 0, 0, 3, 8, 13, 26, 29, 12, 4, 15, 19, 29, 0, 4,
+};
+static const uint16_t huffSymbol[HUFF_SYMBOLS] = {
+    48, 49, 50, 97, 99, 101, 105, 111, 115, 116,
+    32, 37, 45, 46, 47, 51, 52, 53, 54, 55, 56, 57,
+    61, 65, 95, 98, 100, 102, 103, 104, 108, 109, 110, 112,
+    114, 117,
+    58, 66, 67, 68, 69, 70, 71, 72, 73, 74, 75, 76,
+    77, 78, 79, 80, 81, 82, 83, 84, 85, 86, 87, 89,
+    106, 107, 113, 118, 119, 120, 121, 122,
+    38, 42, 44, 59, 88, 90,
+    33, 34, 40, 41, 63,
+    39, 43, 124,
+    35, 62,
+    0, 36, 64, 91, 93, 126,
+    94, 125,
+    60, 96, 123,
+    92, 195, 208,
+    128, 130, 131, 162, 184, 194, 224, 226,
+    153, 161, 167, 172, 176, 177, 179, 209, 216, 217, 227, 229,
+    230,
+    129, 132, 133, 134, 136, 146, 154, 156, 160, 163, 164, 169,
+    170, 173, 178, 181, 185, 186, 187, 189, 190, 196, 198, 228,
+    232, 233,
+    1, 135, 137, 138, 139, 140, 141, 143, 147, 149, 150, 151,
+    152, 155, 157, 158, 165, 166, 168, 174, 175, 180, 182, 183,
+    188, 191, 197, 231, 239,
+    9, 142, 144, 145, 148, 159, 171, 206, 215, 225, 236, 237,
+    199, 207, 234, 235,
+    192, 193, 200, 201, 202, 205, 210, 213, 218, 219, 238, 240,
+    242, 243, 255,
+    203, 204, 211, 212, 214, 221, 222, 223, 241, 244, 245, 246,
+    247, 248, 250, 251, 252, 253, 254,
+    2, 3, 4, 5, 6, 7, 8, 11, 12, 14, 15, 16,
+    17, 18, 19, 20, 21, 23, 24, 25, 26, 27, 28, 29,
+    30, 31, 127, 220, 249,
+    10, 13, 22, 256,
+};
+
+typedef struct {
+    size_t nlen;
+    size_t vlen;
+    char str[];                     // name, then value
+} entry_t;
+
+struct _hpack_t {
+    entry_t **ent;                  // ring of dynamic entries, oldest first
+    size_t cap;
+    size_t first;
+    size_t count;
+    size_t size;                    // RFC 7541 size of the entries
+    size_t max_size;                // from the last size update
+    size_t limit;                   // what a size update can ask for
+    char *str[2];                   // decoded name and value strings
+    size_t stralloc[2];
+    int broken;
+};
+
+hpack_t *
+hpackCreate(size_t max_table)
+{
+    hpack_t *hpack = calloc(1, sizeof(*hpack));
+    if (!hpack) {
+        DBG(NULL);
+        return NULL;
+    }
+    hpack->limit = max_table;
+    hpack->max_size = (max_table < 4096) ? max_table : 4096;
+    return hpack;
+}
+
+void
+hpackDestroy(hpack_t **hpack_ptr)
+{
+    if (!hpack_ptr || !*hpack_ptr) return;
+    hpack_t *hpack = *hpack_ptr;
+
+    size_t i;
+    for (i = 0; i < hpack->count; i++) {
+        free(hpack->ent[(hpack->first + i) % hpack->cap]);
+    }
+    free(hpack->ent);
+    free(hpack->str[0]);
+    free(hpack->str[1]);
+    free(hpack);
+    *hpack_ptr = NULL;
+}
+
+static void
+evictOldest(hpack_t *hpack)
+{
+    entry_t *ent = hpack->ent[hpack->first];
+    hpack->size -= ent->nlen + ent->vlen + ENTRY_OVERHEAD;
+    free(ent);
+    hpack->first = (hpack->first + 1) % hpack->cap;
+    hpack->count--;
+}
+
+static void
+evictToFit(hpack_t *hpack, size_t max_size)
+{
+    while (hpack->count && (hpack->size > max_size)) {
+        evictOldest(hpack);
+    }
+}
+
+// RFC 7541 Section 4.4.  An entry bigger than the table empties it.
+static int
+insertEntry(hpack_t *hpack, const char *name, size_t nlen,
+            const char *value, size_t vlen)
+{
+    size_t size = nlen + vlen + ENTRY_OVERHEAD;
+    if (size > hpack->max_size) {
+        evictToFit(hpack, 0);
+        return 0;
+    }
+
+    // Copied before anything's evicted; name can be in an evicted entry
+    entry_t *ent = malloc(sizeof(*ent) + nlen + vlen);
+    if (!ent) {
+        DBG(NULL);
+        return -1;
+    }
+    ent->nlen = nlen;
+    ent->vlen = vlen;
+    memcpy(ent->str, name, nlen);
+    memcpy(&ent->str[nlen], value, vlen);
+
+    evictToFit(hpack, hpack->max_size - size);
+
+    if (hpack->count == hpack->cap) {
+        size_t cap = (hpack->cap) ? hpack->cap * 2 : 16;
+        entry_t **temp = malloc(cap * sizeof(*temp));
+        if (!temp) {
+            DBG(NULL);
+            free(ent);
+            return -1;
+        }
+        size_t i;
+        for (i = 0; i < hpack->count; i++) {
+            temp[i] = hpack->ent[(hpack->first + i) % hpack->cap];
+        }
+        free(hpack->ent);
+        hpack->ent = temp;
+        hpack->cap = cap;
+        hpack->first = 0;
+    }
+
+    hpack->ent[(hpack->first + hpack->count) % hpack->cap] = ent;
+    hpack->count++;
+    hpack->size += size;
+    return 0;
+}
+
+// Finds an entry by its index; static entries are first, then dynamic
+// ones from newest to oldest (RFC 7541 Section 2.3.3)
+static int
+lookup(hpack_t *hpack, size_t index, const char **name, size_t *nlen,
+       const char **value, size_t *vlen)
+{
+    if (!index) return -1;
+    if (index <= STATIC_ENTRIES) {
+        const static_entry_t *ent = &staticTable[index - 1];
+        *name = ent->name;
+        *nlen = strlen(ent->name);
+        *value = ent->value;
+        *vlen = strlen(ent->value);
+        return 0;
+    }
+
+    index -= STATIC_ENTRIES + 1;
+    if (index >= hpack->count) return -1;
+    entry_t *ent = hpack->ent[(hpack->first + hpack->count - 1 - index) % hpack->cap];
+    *name = ent->str;
+    *nlen = ent->nlen;
+    *value = &ent->str[ent->nlen];
+    *vlen = ent->vlen;
+    return 0;
+}
+
+// RFC 7541 Section 5.1
+static int
+decodeInt(const uint8_t **pos, const uint8_t *end, int prefix, size_t *val)
+{
+    if (*pos >= end) return -1;
+    size_t max = (1 << prefix) - 1;
+    size_t v = *(*pos)++ & max;
+    if (v < max) {
+        *val = v;
+        return 0;
+    }
+
+    int shift = 0;
+    while (*pos < end) {
+        uint8_t byte = *(*pos)++;
+        // Nothing we'd accept needs more than 4 more bytes
+        if (shift > 21) return -1;
+        v += (size_t)(byte & 0x7f) << shift;
+        shift += 7;
+        if (!(byte & 0x80)) {
+            *val = v;
+            return 0;
+        }
+    }
+    return -1;
+}
+
+// Decodes len bytes of src into dst, which has room for len * 8 / 5.
+// Returns the length decoded, or -1.
+static size_t
+huffDecode(const uint8_t *src, size_t len, char *dst)
+{
+    size_t out = 0;
+    int code = 0;                   // bits of a code so far
+    int first = 0;                  // first code of the length so far
+    int index = 0;                  // of that code in huffSymbol
+    int bits = 0;
+    int ones = TRUE;                // every bit of the code so far was 1
+
+    size_t i;
+    for (i = 0; i < len; i++) {
+        int b;
+        for (b = 7; b >= 0; b--) {
+            int bit = (src[i] >> b) & 1;
+            code |= bit;
+            ones &= bit;
+            bits++;
+
+            int count = huffCount[bits];
+            if (code - count < first) {
+                int sym = huffSymbol[index + (code - first)];
+                if (sym == HUFF_EOS) return -1;
+                dst[out++] = sym;
+                code = first = index = bits = 0;
+                ones = TRUE;
+                continue;
+            }
+            if (bits == HUFF_MAX_BITS) return -1;
+            index += count;
+            first = (first + count) << 1;
+            code <<= 1;
+        }
+    }
+
+    // The end is padded with up to 7 bits of the EOS code, all 1s
+    if ((bits > 7) || !ones) return -1;
+    return out;
+}
+
+// RFC 7541 Section 5.2.  which picks the buffer it's decoded into.
+static int
+decodeString(hpack_t *hpack, const uint8_t **pos, const uint8_t *end,
+             int which, const char **str, size_t *slen)
+{
+    if (*pos >= end) return -1;
+    int huff = (**pos & 0x80);
+    size_t len;
+    if (decodeInt(pos, end, 7, &len) || (len > end - *pos)) return -1;
+
+    if (!huff) {
+        *str = (const char *)*pos;
+        *slen = len;
+        *pos += len;
+        return 0;
+    }
+
+    size_t need = len * 8 / 5 + 1;
+    if (need > MAX_STRING) return -1;
+    if (need > hpack->stralloc[which]) {
+        size_t alloc = (need < 256) ? 256 : need;
+        char *temp = realloc(hpack->str[which], alloc);
+        if (!temp) {
+            DBG(NULL);
+            return -1;
+        }
+        hpack->str[which] = temp;
+        hpack->stralloc[which] = alloc;
+    }
+
+    size_t out = huffDecode(*pos, len, hpack->str[which]);
+    if (out == -1) return -1;
+    *str = hpack->str[which];
+    *slen = out;
+    *pos += len;
+    return 0;
+}
+
+static int
+decodeField(hpack_t *hpack, const uint8_t **pos, const uint8_t *end,
+            hpack_field_fn fn, void *arg)
+{
+    const char *name, *value;
+    size_t nlen, vlen, index;
+    uint8_t first = **pos;
+
+    // Indexed Header Field
+    if (first & 0x80) {
+        if (decodeInt(pos, end, 7, &index) ||
+            lookup(hpack, index, &name, &nlen, &value, &vlen)) return -1;
+        if (fn) fn(arg, name, nlen, value, vlen);
+        return 0;
+    }
+
+    // Dynamic Table Size Update
+    if ((first & 0xe0) == 0x20) {
+        size_t max_size;
+        if (decodeInt(pos, end, 5, &max_size) || (max_size > hpack->limit)) return -1;
+        hpack->max_size = max_size;
+        evictToFit(hpack, max_size);
+        return 0;
+    }
+
+    // Literal Header Field, with Incremental Indexing, without Indexing,
+    // or Never Indexed
+    int indexing = ((first & 0xc0) == 0x40);
+    if (decodeInt(pos, end, (indexing) ? 6 : 4, &index)) return -1;
+    if (index) {
+        const char *unused;
+        if (lookup(hpack, index, &name, &nlen, &unused, &vlen)) return -1;
+    } else if (decodeString(hpack, pos, end, 0, &name, &nlen)) {
+        return -1;
+    }
+    if (decodeString(hpack, pos, end, 1, &value, &vlen)) return -1;
+
+    if (fn) fn(arg, name, nlen, value, vlen);
+    return (indexing) ? insertEntry(hpack, name, nlen, value, vlen) : 0;
+}
+
+int
+hpackDecode(hpack_t *hpack, const uint8_t *block, size_t len,
+            hpack_field_fn fn, void *arg)
+{
+    if (!hpack || (!block && len) || hpack->broken) return -1;
+
+    const uint8_t *pos = block;
+    const uint8_t *end = block + len;
+    while (pos < end) {
+        if (decodeField(hpack, &pos, end, fn, arg)) {
+            hpack->broken = TRUE;
+            return -1;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,40 @@
+#ifndef __HPACK_H__
+#define __HPACK_H__
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * Decodes HPACK (RFC 7541), the compressed form of the header fields in
+ * HTTP/2 HEADERS, PUSH_PROMISE and CONTINUATION frames.
+ *
+ * An hpack_t holds the dynamic table for one direction of a connection.
+ * Every header block sent that way adds to or evicts from it, so every
+ * block has to be decoded, in order, for the ones after it to make sense.
+ * Once a block can't be decoded, neither can any that follow; the
+ * hpack_t stays broken and should be destroyed.
+ *
+ * The static table and the Huffman code are fixed tables; nothing is
+ * built at runtime.  The dynamic table can grow to the size given when
+ * it's created, which should be at least the 4096 bytes that HTTP/2
+ * starts with.
+ */
+
+typedef struct _hpack_t hpack_t;
+
+// Called for each field of a block, in order.  name and value aren't nul
+// terminated, and are only valid until this returns.
+typedef void (*hpack_field_fn)(void *arg, const char *name, size_t nlen,
+                               const char *value, size_t vlen);
+
+// Constructors Destructors
+hpack_t *           hpackCreate(size_t max_table);
+void                hpackDestroy(hpack_t **);
+
+// Decodes one whole header block.  Returns 0 on success, or -1 if it
+// can't be decoded (fields before the problem have already been passed
+// to fn).
+int                 hpackDecode(hpack_t *, const uint8_t *block, size_t len,
+                                hpack_field_fn fn, void *arg);
+
+#endif // __HPACK_H__
@@ -1,15 +1,27 @@
 #define _GNU_SOURCE
 #include <limits.h>
 #include <stdint.h>
+#include <stdio.h>
 #include <string.h>
 #include "com.h"
 #include "dbg.h"
+#include "histo.h"
 #include "httpagg.h"
 #include "utils.h"
 
 
-#define DEFAULT_TARGET_LEN ( 128 )
-#define MAX_CODE_ENTRIES ( 64 )
+// The most (method, target) pairs kept between resets.  Requests for any
+// others are counted together, with a target of OTHER_TARGET.
+#define MAX_TARGETS ( 1024 )
+#define INDEX_SIZE ( 2 * MAX_TARGETS )   // a power of 2
+#define OTHER_TARGET "other"
+
+// Normalized targets longer than this are cut off
+#define MAX_NORM_TARGET ( 1024 )
+
+// Status codes are counted in arrays of 100, one per hundreds digit
+#define STATUS_CLASSES ( 10 )
+#define STATUS_PER_CLASS ( 100 )
 
 typedef enum {
     SERVER_DURATION,
@@ -35,44 +47,56 @@ enum_map_t fieldMapOut[] = {
     {NULL,                    -1}
 };
 
-typedef struct {
-    int code;             // example status code values: 200, 404, 503, etc.
-    uint64_t count;       // the number of this code seen
-} status_code_t;
-
 typedef struct {
     uint64_t total;       // cumulative total
     uint64_t num_entries; // number of entries, to support average calculation
 } agg_counter_t;
 
+static const char *quantileName[][4] = {
+    [SERVER_DURATION] = {"http.server.duration.p50", "http.server.duration.p90",
+                         "http.server.duration.p99", "http.server.duration.max"},
+    [CLIENT_DURATION] = {"http.client.duration.p50", "http.client.duration.p90",
+                         "http.client.duration.p99", "http.client.duration.max"},
+};
+
 typedef struct {
-    char * uri;           // the key that comes from http_target
-    status_code_t status[MAX_CODE_ENTRIES];
+    char * method;        // the key that comes from http_method, or ""
+    char * uri;           //   and from http_target, without a query string
+    uint64_t hash;
+    uint64_t *status[STATUS_CLASSES]; // allocated when a code is first seen
     agg_counter_t field[FIELD_MAX];
+    histo_t *histo[FIELD_MAX];  // durations only; allocated when first seen
 } target_agg_t;
 
 struct _http_agg_t {
-    target_agg_t** target;
+    target_agg_t** target;  // in the order they were first seen
     uint64_t count;
-    uint64_t alloc;
+    int *index;             // open addressed by hash; -1 or a target
+    target_agg_t *other;
+    urinorm_t *norm;        // not owned; can be NULL
+    unsigned quantiles;     // TRUE to keep histograms of the durations
 };
 
 
 http_agg_t *
-httpAggCreate()
+httpAggCreate(unsigned quantiles)
 {
     http_agg_t* agg = calloc(1, sizeof(*agg));
-    target_agg_t** target_lst = calloc(1, sizeof(*target_lst) * DEFAULT_TARGET_LEN);
-    if (!agg || !target_lst) {
+    target_agg_t** target_lst = calloc(MAX_TARGETS, sizeof(*target_lst));
+    int *index = malloc(INDEX_SIZE * sizeof(*index));
+    if (!agg || !target_lst || !index) {
         if (agg) free(agg);
         if (target_lst) free(target_lst);
-        DBG("agg = %p, target_lst = %p", agg, target_lst);
+        if (index) free(index);
+        DBG("agg = %p, target_lst = %p, index = %p", agg, target_lst, index);
         return NULL;
     }
 
+    memset(index, 0xff, INDEX_SIZE * sizeof(*index));
     agg->target = target_lst;
+    agg->index = index;
     agg->count = 0;
-    agg->alloc = DEFAULT_TARGET_LEN;
+    agg->quantiles = quantiles;
 
     return agg;
 }
@@ -87,6 +111,7 @@ httpAggDestroy(http_agg_t **http_agg_ptr)
     httpAggReset(http_agg);
 
     free(http_agg->target);
+    free(http_agg->index);
     free(http_agg);
 
     *http_agg_ptr = NULL;
@@ -124,62 +149,93 @@ num_value(event_t *evt, const char *name)
     return LLONG_MIN;
 }
 
+// FNV-1a, over the method and the uri, with a separator between
+static uint64_t
+hash_target(const char *method, const char *uri, size_t uri_len)
+{
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    const char *c;
+    for (c = method; *c; c++) {
+        hash = (hash ^ (unsigned char)*c) * 0x100000001b3ULL;
+    }
+    hash = (hash ^ ' ') * 0x100000001b3ULL;
+    size_t i;
+    for (i = 0; i < uri_len; i++) {
+        hash = (hash ^ (unsigned char)uri[i]) * 0x100000001b3ULL;
+    }
+    return hash;
+}
+
 static target_agg_t *
-get_target_entry(http_agg_t *http_agg, const char* target_val)
+new_target_entry(const char *method, const char *uri, size_t uri_len)
 {
-    if (!http_agg || !target_val) return NULL;
+    target_agg_t *entry = calloc(1, sizeof(*entry));
+    if (!entry) {
+        DBG(NULL);
+        return NULL;
+    }
+    entry->method = strdup(method);
+    entry->uri = strndup(uri, uri_len);
+    if (!entry->method || !entry->uri) {
+        if (entry->method) free(entry->method);
+        if (entry->uri) free(entry->uri);
+        free(entry);
+        DBG(NULL);
+        return NULL;
+    }
+    return entry;
+}
+
+static target_agg_t *
+get_target_entry(http_agg_t *http_agg, const char *method, const char *target_val)
+{
+    if (!http_agg || !method || !target_val) return NULL;
+
+    char norm_val[MAX_NORM_TARGET];
+    if (http_agg->norm) {
+        urinormApply(http_agg->norm, target_val, norm_val, sizeof(norm_val));
+        target_val = norm_val;
+    }
 
     // per rfc3986: query strings start with a '?'
     // https://example.com/over/there?name=ferret
     // if a target_val has a query string ignore that part of the uri.
     // This is done as just one small way to manage the cardiality.
-    char *temp_uri = strdup(target_val);
-    if (!temp_uri) {
-        DBG(NULL);
-        return NULL;
-    }
-    char *query_ptr = strchr(temp_uri, '?');
-    if (query_ptr) *query_ptr = '\0';
+    size_t uri_len = strcspn(target_val, "?");
+    uint64_t hash = hash_target(method, target_val, uri_len);
 
-
-    // look to see if target already exists in list
+    // look to see if target already exists
     // if so, return a pointer to it.
-    int i;
-    for (i=0; i<http_agg->count; i++) {
-        if (!strcmp(http_agg->target[i]->uri, temp_uri)) {
-            free(temp_uri);
-            return http_agg->target[i];
+    size_t slot = hash & (INDEX_SIZE - 1);
+    while (http_agg->index[slot] != -1) {
+        target_agg_t *entry = http_agg->target[http_agg->index[slot]];
+        if ((entry->hash == hash) &&
+            !strncmp(entry->uri, target_val, uri_len) &&
+            (entry->uri[uri_len] == '\0') &&
+            !strcmp(entry->method, method)) {
+            return entry;
         }
+        slot = (slot + 1) & (INDEX_SIZE - 1);
     }
 
-    // if not, and we're out of room, realloc
-    if (http_agg->count >= http_agg->alloc) {
-        uint64_t new_size = http_agg->alloc << 2; // same as multiplying by 4
-        target_agg_t **temp_target = realloc(http_agg->target, sizeof(*temp_target) * new_size);
-        if (!temp_target) {
-            free(temp_uri);
-            DBG(NULL);
-            return NULL;
+    // Past the limit, everything new is counted together
+    if (http_agg->count >= MAX_TARGETS) {
+        if (!http_agg->other) {
+            http_agg->other = new_target_entry("", OTHER_TARGET, strlen(OTHER_TARGET));
         }
-        memset(&temp_target[http_agg->count], 0,
-               sizeof(*temp_target) * (new_size - http_agg->alloc));
-        http_agg->target = temp_target;
-        http_agg->alloc = new_size;
+        return http_agg->other;
     }
 
     // Now create the new target entry
-    target_agg_t *temp_target = calloc(1, sizeof(*temp_target));
-    if (!temp_target) {
-        free(temp_uri);
-        DBG(NULL);
-        return NULL;
-    }
+    target_agg_t *entry = new_target_entry(method, target_val, uri_len);
+    if (!entry) return NULL;
+    entry->hash = hash;
 
     // Add the new target entry
-    temp_target->uri = temp_uri;
-    http_agg->target[http_agg->count++] = temp_target;
+    http_agg->index[slot] = http_agg->count;
+    http_agg->target[http_agg->count++] = entry;
 
-    return temp_target;
+    return entry;
 }
 
 static void
@@ -195,25 +251,56 @@ add_status(target_agg_t *entry, long long value)
 {
     // rfc7231 defines 41 possible values from 100 to 505
     // This supports all of these without depending on the exact definition
-    if (value < 0 || value > 1000) {
+    if (value < 0 || value >= STATUS_CLASSES * STATUS_PER_CLASS) {
         DBG("%lld", value);
         return;
     }
 
-    int i;
-    for (i=0; i<MAX_CODE_ENTRIES; i++) {
-        if (entry->status[i].code == value) {
-            // the code already exists, increment the count for it
-            entry->status[i].count++;
-            break;
-        }
-        if (entry->status[i].code == 0) {
-            // add code to the end of the list and increment count
-            entry->status[i].code = value;
-            entry->status[i].count++;
-            break;
+    uint64_t **class = &entry->status[value / STATUS_PER_CLASS];
+    if (!*class && !(*class = calloc(STATUS_PER_CLASS, sizeof(**class)))) {
+        DBG(NULL);
+        return;
+    }
+    (*class)[value % STATUS_PER_CLASS]++;
+}
+
+static void
+add_histo(histo_t **histo, long long value)
+{
+    if (!*histo && !(*histo = calloc(1, sizeof(**histo)))) {
+        DBG(NULL);
+        return;
+    }
+    histoRecord(*histo, (value > 0) ? value : 0);
+}
+
+// Finds the next status code at or after *code that's been seen.
+// Returns its count, or 0 if there are no more.
+static uint64_t
+next_status(target_agg_t *entry, int *code)
+{
+    for (; *code < STATUS_CLASSES * STATUS_PER_CLASS; (*code)++) {
+        uint64_t *class = entry->status[*code / STATUS_PER_CLASS];
+        if (!class) {
+            *code += STATUS_PER_CLASS - (*code % STATUS_PER_CLASS) - 1;
+        } else if (class[*code % STATUS_PER_CLASS]) {
+            return class[*code % STATUS_PER_CLASS];
         }
     }
+    return 0;
+}
+
+// Targets are in the order they were first seen, then the "other" bucket
+static int
+num_targets(http_agg_t *http_agg)
+{
+    return http_agg->count + (http_agg->other != NULL);
+}
+
+static target_agg_t *
+target_at(http_agg_t *http_agg, int i)
+{
+    return (i < http_agg->count) ? http_agg->target[i] : http_agg->other;
 }
 
 void
@@ -223,11 +310,14 @@ httpAggAddMetric(http_agg_t *http_agg,
 {
     if (!http_agg || !duration) return;
 
-    // Aggregation is keyed by target (uri).  Get this from the duration event.
+    // Aggregation is keyed by method and target (uri).  Get these from the
+    // duration event.  Without the request, there's no method.
     const char *target_val = str_value(duration, "http_target");
     if (!target_val) return;
+    const char *method_val = str_value(duration, "http_method");
+    if (!method_val) method_val = "";
 
-    target_agg_t *target_entry = get_target_entry(http_agg, target_val);
+    target_agg_t *target_entry = get_target_entry(http_agg, method_val, target_val);
     if (!target_entry) return;
 
     // Record the status in the target_entry
@@ -241,6 +331,9 @@ httpAggAddMetric(http_agg_t *http_agg,
         case CLIENT_DURATION:
             if (duration->value.type == FMT_INT) {
                 add_counter(&target_entry->field[dur_field], duration->value.integer);
+                if (http_agg->quantiles) {
+                    add_histo(&target_entry->histo[dur_field], duration->value.integer);
+                }
             } else {
                 DBG(NULL);
             }
@@ -259,14 +352,17 @@ httpAggAddMetric(http_agg_t *http_agg,
 static void
 report_target(mtc_t *mtc, target_agg_t *target)
 {
-    {
-        int i;
-        for (i=0; i<MAX_CODE_ENTRIES; i++) {
-            if (target->status[i].code == 0) break;
+    // The method is left out when it isn't known
+    int first = (target->method[0]) ? 0 : 1;
 
+    {
+        int code;
+        uint64_t count;
+        for (code=0; (count = next_status(target, &code)); code++) {
             event_field_t fields[] = {
+                STRFIELD("http.method", target->method, 4, TRUE),
                 STRFIELD("http.target", target->uri, 4, TRUE),
-                NUMFIELD("http.status_code", target->status[i].code, 1, TRUE),
+                NUMFIELD("http.status_code", code, 1, TRUE),
                 STRFIELD("proc",        g_proc.procname, 4, TRUE),
                 NUMFIELD("pid",         g_proc.pid,      4, TRUE),
                 STRFIELD("host",        g_proc.hostname, 4, TRUE),
@@ -274,7 +370,7 @@ report_target(mtc_t *mtc, target_agg_t *target)
                 FIELDEND
             };
             event_t metric = INT_EVENT("http.requests",
-                                       target->status[i].count, DELTA, fields);
+                                       count, DELTA, &fields[first]);
             cmdSendMetric(mtc, &metric);
         }
     }
@@ -292,6 +388,7 @@ report_target(mtc_t *mtc, target_agg_t *target)
             }
 
             event_field_t fields[] = {
+                STRFIELD("http.method", target->method,  4, TRUE),
                 STRFIELD("http.target", target->uri,     4, TRUE),
                 NUMFIELD("numops",      target->field[i].num_entries, 8, TRUE),
                 STRFIELD("proc",        g_proc.procname, 4, TRUE),
@@ -301,10 +398,50 @@ report_target(mtc_t *mtc, target_agg_t *target)
                 FIELDEND
             };
             event_t metric = INT_EVENT(valToStr(fieldMapOut, i),
-                                       target->field[i].total, DELTA, fields);
+                                       target->field[i].total, DELTA,
+                                       &fields[first]);
             cmdSendMetric(mtc, &metric);
         }
     }
+
+    // Percentiles of the durations
+    {
+        counter_field_enum i;
+        for (i = SERVER_DURATION; i <= CLIENT_DURATION; i++) {
+            histo_t *histo = target->histo[i];
+            if (!histo || !histoCount(histo)) continue;
+
+            uint64_t quantile[] = {
+                histoQuantile(histo, 0.50),
+                histoQuantile(histo, 0.90),
+                histoQuantile(histo, 0.99),
+                histoMax(histo),
+            };
+
+            int j;
+            for (j = 0; j < sizeof(quantile) / sizeof(quantile[0]); j++) {
+                event_field_t fields[] = {
+                    STRFIELD("http.method", target->method,  4, TRUE),
+                    STRFIELD("http.target", target->uri,     4, TRUE),
+                    STRFIELD("proc",        g_proc.procname, 4, TRUE),
+                    NUMFIELD("pid",         g_proc.pid,      4, TRUE),
+                    STRFIELD("host",        g_proc.hostname, 4, TRUE),
+                    STRFIELD("unit",        "millisecond", 4, TRUE),
+                    FIELDEND
+                };
+                event_t metric = INT_EVENT(quantileName[i][j], quantile[j],
+                                           CURRENT, &fields[first]);
+                cmdSendMetric(mtc, &metric);
+            }
+        }
+    }
+}
+
+void
+httpAggNormalizerSet(http_agg_t *http_agg, urinorm_t *norm)
+{
+    if (!http_agg) return;
+    http_agg->norm = norm;
 }
 
 void
@@ -313,9 +450,8 @@ httpAggSendReport(http_agg_t *http_agg, mtc_t *mtc)
     if (!http_agg || !mtc) return;
 
     int i;
-    for (i=0; i<http_agg->count; i++) {
-        target_agg_t *target = http_agg->target[i];
-        report_target(mtc, target);
+    for (i=0; i<num_targets(http_agg); i++) {
+        report_target(mtc, target_at(http_agg, i));
     }
 }
 
@@ -325,15 +461,98 @@ httpAggReset(http_agg_t *http_agg)
     if (!http_agg) return;
 
     int i;
-    for (i=0; i<http_agg->count; i++) {
-        target_agg_t *target = http_agg->target[i];
+    for (i=0; i<num_targets(http_agg); i++) {
+        target_agg_t *target = target_at(http_agg, i);
         if (target) {
+            int j;
+            for (j=0; j<STATUS_CLASSES; j++) {
+                if (target->status[j]) free(target->status[j]);
+            }
+            for (j=0; j<FIELD_MAX; j++) {
+                if (target->histo[j]) free(target->histo[j]);
+            }
+            if (target->method) free(target->method);
             if (target->uri) free(target->uri);
             free(target);
         }
-        http_agg->target[i] = NULL;
     }
+    memset(http_agg->target, 0, http_agg->count * sizeof(*http_agg->target));
+    memset(http_agg->index, 0xff, INDEX_SIZE * sizeof(*http_agg->index));
     http_agg->count = 0;
+    http_agg->other = NULL;
 }
 
 
+
+static const char *scrapeFamilyName[FIELD_MAX] = {
+    "http_server_duration_seconds",
+    "http_client_duration_seconds",
+    "http_request_content_length_bytes",
+    "http_response_content_length_bytes",
+};
+
+void
+httpAggScrape(http_agg_t *http_agg, scrape_out_t *out)
+{
+    if (!http_agg || !out) return;
+
+    char pid[24];
+    snprintf(pid, sizeof(pid), "%d", g_proc.pid);
+
+    int i;
+    scrapeFamily(out, "http_requests", "counter", NULL,
+                 "HTTP requests, by method, target and status code");
+    for (i=0; i<num_targets(http_agg); i++) {
+        target_agg_t *target = target_at(http_agg, i);
+        int first = (target->method[0]) ? 0 : 2;
+
+        int j;
+        uint64_t count;
+        for (j=0; (count = next_status(target, &j)); j++) {
+            char code[8];
+            snprintf(code, sizeof(code), "%d", j);
+            const char *labels[] = {
+                "http_method", target->method,
+                "http_target", target->uri,
+                "http_status_code", code,
+                "proc", g_proc.procname,
+                "pid", pid,
+                "host", g_proc.hostname,
+                NULL
+            };
+            scrapeInt(out, "http_requests", "_total", &labels[first], count);
+        }
+    }
+
+    counter_field_enum f;
+    for (f = SERVER_DURATION; f < FIELD_MAX; f++) {
+        int seconds = ((f == SERVER_DURATION) || (f == CLIENT_DURATION));
+        scrapeFamily(out, scrapeFamilyName[f], "summary",
+                     (seconds) ? "seconds" : "bytes", NULL);
+
+        for (i=0; i<num_targets(http_agg); i++) {
+            target_agg_t *target = target_at(http_agg, i);
+            if (target->field[f].num_entries == 0) continue;
+            int first = (target->method[0]) ? 0 : 2;
+
+            const char *labels[] = {
+                "http_method", target->method,
+                "http_target", target->uri,
+                "proc", g_proc.procname,
+                "pid", pid,
+                "host", g_proc.hostname,
+                NULL
+            };
+            scrapeInt(out, scrapeFamilyName[f], "_count", &labels[first],
+                      target->field[f].num_entries);
+            if (seconds) {
+                // durations are kept in milliseconds
+                scrapeNum(out, scrapeFamilyName[f], "_sum", &labels[first],
+                          target->field[f].total / 1000.0);
+            } else {
+                scrapeInt(out, scrapeFamilyName[f], "_sum", &labels[first],
+                          target->field[f].total);
+            }
+        }
+    }
+}
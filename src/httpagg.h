@@ -1,6 +1,8 @@
 #ifndef __HTTPREPORT_H__
 #define __HTTPREPORT_H__
 #include "mtc.h"
+#include "scrape.h"
+#include "urinorm.h"
 
 // This was written to do aggregation of http for the metrics channel (statsd)
 //
@@ -11,13 +13,29 @@
 //   AddMetric
 //   SendReport (sends a summary of all Metrics received before it)
 //   Reset (returns to a state similar to Create)
+//
+// Scrape writes out the same summary in the OpenMetrics text format.  An
+// agg that's scraped is normally never Reset, so what it reports are totals.
+//
+// Metrics are kept by method and target (without its query string).  To
+// bound memory, only the first 1024 of these are kept between Resets;
+// requests for any others are counted together with a target of "other".
+// With a normalizer set, targets are normalized (see urinorm.h) before
+// they're counted.  The agg doesn't own the normalizer; it has to outlive
+// the agg, or be replaced first.
+//
+// SendReport's percentiles of the durations need a histogram per target
+// (a few KB each), so an agg only keeps them if created with quantiles
+// TRUE.  Scrape doesn't report them.
 
 typedef struct _http_agg_t http_agg_t;
 
-http_agg_t *httpAggCreate();
+http_agg_t *httpAggCreate(unsigned quantiles);
 void httpAggDestroy(http_agg_t **);
+void httpAggNormalizerSet(http_agg_t *, urinorm_t *);
 void httpAggAddMetric(http_agg_t *, event_t *, size_t, size_t);
 void httpAggSendReport(http_agg_t *, mtc_t *);
 void httpAggReset(http_agg_t *);
+void httpAggScrape(http_agg_t *, scrape_out_t *);
 
 #endif // __HTTPREPORT_H__
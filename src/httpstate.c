@@ -1,31 +1,119 @@
 #define _GNU_SOURCE
+#include <ctype.h>
 #include <errno.h>
+#include <stdint.h>
 #include <string.h>
+#include <strings.h>
 #include "com.h"
 #include "dbg.h"
+#include "hpack.h"
 #include "httpstate.h"
 #include "plattime.h"
 #include "search.h"
 #include "atomic.h"
 
 
-#define MIN_HDR_ALLOC (4  * 1024)
-#define MAX_HDR_ALLOC (16 * 1024)
+// Every header is kept in one slot this big, with only the lines that get
+// reported (see keepHttpField).  Fields kept for configured patterns
+// don't fill it past HDR_OTHER_MAX, so they can't crowd out the rest.
+#define HDR_SLOT_SIZE (4 * 1024)
+#define HDR_OTHER_MAX (3 * 1024)
+
+// How long a response header can be held waiting for its chunked body to end
+#define MAX_HDR_HOLD_NS (1000ULL * 1000 * 1000)
 
 #define HTTP_START "HTTP/"
 #define HTTP_END "\r\n"
 #define CONTENT_LENGTH "Content-Length:"
+#define TRANSFER_ENCODING "Transfer-Encoding:"
+#define CHUNKED "chunked"
+
+// RFC 7540 Section 3.5, 4.1 and 6
+#define H2_PREFACE "PRI * HTTP/2.0\r\n\r\nSM\r\n\r\n"
+#define H2_PREFACE_LEN 24
+#define H2_FRAME_HDR 9
+#define H2_HEADERS 0x1
+#define H2_PUSH_PROMISE 0x5
+#define H2_CONTINUATION 0x9
+#define H2_END_HEADERS 0x4
+#define H2_PADDED 0x8
+#define H2_PRIORITY 0x20
+
+// How big an HPACK table and a header block can get before we give up
+#define H2_MAX_TABLE (64 * 1024)
+#define H2_MAX_BLOCK (64 * 1024)
+
 static search_t* g_http_start = NULL;
 static search_t* g_http_end = NULL;
 static search_t* g_http_clen = NULL;
 
+// Where we are in a chunked body.  RFC 7230 Section 4.1:
+//   chunked-body = *chunk last-chunk trailer-part CRLF
+//   chunk        = chunk-size [ chunk-ext ] CRLF chunk-data CRLF
+typedef enum {
+    CHUNK_SIZE_START,   // expecting the first hex digit of a chunk-size
+    CHUNK_SIZE,         // in the chunk-size
+    CHUNK_EXT,          // in a chunk-ext, ignored
+    CHUNK_SIZE_LF,      // expecting the LF after a chunk-size
+    CHUNK_DATA,         // in chunk-data, clen bytes to go
+    CHUNK_DATA_CR,      // expecting the CRLF after chunk-data
+    CHUNK_DATA_LF,
+    CHUNK_TRAILER,      // at the start of a trailer line, or the final CRLF
+    CHUNK_TRAILER_LINE, // in a trailer line, ignored
+    CHUNK_END_LF,       // expecting the LF that ends the body
+    CHUNK_END,          // the body has ended
+    CHUNK_ERROR,        // this isn't a chunked body we can follow
+} chunk_enum_t;
+
+// One direction of an HTTP/2 connection
+typedef struct {
+    hpack_t *hpack;
+    uint8_t head[H2_FRAME_HDR];     // The current frame's header
+    size_t headlen;                 //   how much of it we've seen
+    size_t left;                    // Payload bytes of the frame to come
+    uint8_t *block;                 // Header block being gathered
+    size_t blocklen;
+    size_t blockalloc;
+    size_t fragment;                //   where this frame's part starts
+    uint32_t stream;                //   stream it's for
+    int inblock;                    //   CONTINUATION frames to come
+    int broken;                     // Lost track; nothing more is reported
+} h2_dir_t;
+
+typedef struct http2_t {
+    h2_dir_t dir[2];                // What's sent, what's received
+} http2_t;
+
+// An HTTP/1 style header being built from an HTTP/2 header block.  This
+// runs under the TLS hooks of go apps, on a small stack, so all of it is
+// in one allocation: the slot, then room for the pseudo-header values.
+#define H2_PSEUDO_SIZE HDR_SLOT_SIZE
+
+typedef struct {
+    char *pseudo;                   // Values of pseudo-header fields,
+    size_t pseudolen;               //   H2_PSEUDO_SIZE after buf
+    http_span method;
+    http_span path;
+    http_span authority;
+    http_span status;
+    char *buf;                      // Other fields, "name: value\r\n"
+    size_t len;                     //   in an HDR_SLOT_SIZE slot
+} h2_hdr_t;
+
 static void setHttpState(http_state_t *httpstate, http_enum_t toState);
-static void appendHeader(http_state_t *httpstate, char* buf, size_t len);
+static void appendHeader(http_state_t *httpstate, char* buf, size_t len, bool eol);
 static size_t getContentLength(char *header, size_t len);
 static size_t bytesToSkipForContentLength(http_state_t *httpstate, size_t len);
+static int isChunked(char *header);
+static size_t bytesToSkipForChunked(http_state_t *httpstate, char *buf, size_t len);
+static size_t skipChunkedBody(http_state_t *httpstate, char *buf, size_t len, httpId_t *httpId);
 static bool setHttpId(httpId_t *httpId, net_info *net, int sockfd, uint64_t id, metric_t src);
-static int reportHttp(http_state_t *httpstate);
+static int reportHttp(http_state_t *httpstate, size_t clen);
 static bool scanForHttpHeader(http_state_t *httpstate, char *buf, size_t len, httpId_t *httpId);
+static bool isHttp2Preface(char *buf, size_t len);
+static bool startHttp2(http_state_t *httpstate);
+static void destroyHttp2(http2_t **h2_ptr);
+static bool scanHttp2(http_state_t *httpstate, char *buf, size_t len, httpId_t *httpId);
 
 extern int      g_http_guard_enabled;
 extern uint64_t g_http_guard[];
@@ -37,11 +125,14 @@ setHttpState(http_state_t *httpstate, http_enum_t toState)
     switch (toState) {
         case HTTP_NONE:
             if (httpstate->hdr) free(httpstate->hdr);
+            destroyHttp2(&httpstate->h2);
             memset(httpstate, 0, sizeof(*httpstate));
             break;
         case HTTP_HDR:
         case HTTP_HDREND:
         case HTTP_DATA:
+        case HTTP_CHUNKED:
+        case HTTP_2:
             break;
         default:
             DBG(NULL);
@@ -50,41 +141,93 @@ setHttpState(http_state_t *httpstate, http_enum_t toState)
     httpstate->state = toState;
 }
 
-static void
-appendHeader(http_state_t *httpstate, char* buf, size_t len)
+// The fields that are reported on their own, or that say where the body ends
+static const char *const g_http_fields[] = {
+    "Host",
+    "User-Agent",
+    "X-Forwarded-For",
+    "Content-Length",
+    "Transfer-Encoding",
+    "x-appscope",
+};
+
+// Set when configured patterns can match any field
+static unsigned g_http_all_fields = FALSE;
+
+void
+setHttpHeaderCapture(unsigned all)
 {
-    if (!httpstate || !buf) return;
+    g_http_all_fields = all;
+}
 
-    // make sure we have enough allocated space
-    size_t content_size = httpstate->hdrlen+len;
-    size_t alloc_size = (!httpstate->hdralloc) ? MIN_HDR_ALLOC : httpstate->hdralloc;
-    while (alloc_size < content_size) {
-        alloc_size = alloc_size << 2; // same as multiplying by 4
-        if (alloc_size > MAX_HDR_ALLOC) {
-             DBG(NULL);
-             // More than we're willing to allocate for one header.
-             // We might have missed the end of the header???
-             setHttpState(httpstate, HTTP_NONE);
-             return;
-        }
+// end is where the field would end in the slot
+static bool
+keepHttpField(const char *name, size_t nlen, size_t end)
+{
+    int i;
+    for (i = 0; i < sizeof(g_http_fields) / sizeof(g_http_fields[0]); i++) {
+        if ((strlen(g_http_fields[i]) == nlen) &&
+            !strncasecmp(name, g_http_fields[i], nlen)) return TRUE;
     }
+    return g_http_all_fields && (end <= HDR_OTHER_MAX);
+}
 
-    // If we need more space, realloc
-    if (alloc_size != httpstate->hdralloc) {
-        char* temp = realloc(httpstate->hdr, alloc_size);
-        if (!temp) {
+/*
+ * A header is appended a line at a time, and a line can be split across
+ * buffers; eol is set when buf ends the line.  The start line is always
+ * kept, and a field line only if keepHttpField() wants it.  Lines are
+ * dropped when they end, so only the lines kept take up room.  A field
+ * line that doesn't fit is dropped too, and a start line that doesn't
+ * fit is cut short.  The last byte of the slot is saved for a nul.
+ */
+static void
+appendHeader(http_state_t *httpstate, char* buf, size_t len, bool eol)
+{
+    if (!httpstate || !buf) return;
+
+    if (!httpstate->hdr) {
+        if (!(httpstate->hdr = malloc(HDR_SLOT_SIZE))) {
             DBG(NULL);
-            // Don't return partial headers...  All or nothing.
             setHttpState(httpstate, HTTP_NONE);
             return;
         }
-        httpstate->hdr = temp;
-        httpstate->hdralloc = alloc_size;
+        httpstate->hdrlen = 0;
+        httpstate->hdrline = 0;
+        httpstate->hdrcut = FALSE;
+    }
+
+    char *hdr = httpstate->hdr;
+    size_t room = HDR_SLOT_SIZE - 1 - httpstate->hdrlen;
+    if (httpstate->hdrcut) {
+        // The rest of this line isn't kept
+    } else if (len <= room) {
+        memcpy(&hdr[httpstate->hdrlen], buf, len);
+        httpstate->hdrlen += len;
+    } else if (!httpstate->hdrline) {
+        memcpy(&hdr[httpstate->hdrlen], buf, room);
+        httpstate->hdrlen += room;
+        httpstate->hdrcut = TRUE;
+    } else {
+        httpstate->hdrlen = httpstate->hdrline;
+        httpstate->hdrcut = TRUE;
     }
 
-    // Append the data
-    memcpy(&httpstate->hdr[httpstate->hdrlen], buf, len);
-    httpstate->hdrlen += len;
+    if (!eol) return;
+
+    if (!httpstate->hdrline) {
+        // A start line that was cut short still ends with a CRLF
+        if (httpstate->hdrcut) {
+            memcpy(&hdr[httpstate->hdrlen - 2], HTTP_END, 2);
+        }
+    } else if (!httpstate->hdrcut) {
+        char *line = &hdr[httpstate->hdrline];
+        char *colon = memchr(line, ':', httpstate->hdrlen - httpstate->hdrline);
+        if (!colon || !keepHttpField(line, colon - line, httpstate->hdrlen)) {
+            httpstate->hdrlen = httpstate->hdrline;
+        }
+    }
+    httpstate->hdrline = httpstate->hdrlen;
+    httpstate->hdrcut = FALSE;
 }
 
 static size_t
@@ -129,6 +272,153 @@ bytesToSkipForContentLength(http_state_t *httpstate, size_t len)
     return len;
 }
 
+static int
+isChunked(char *header)
+{
+    // ex: Transfer-Encoding: gzip, chunked\r\n
+    char *val = strcasestr(header, HTTP_END TRANSFER_ENCODING);
+    if (!val) return FALSE;
+    val += strlen(HTTP_END TRANSFER_ENCODING);
+
+    char *end = strstr(val, HTTP_END);
+    if (!end) return FALSE;
+
+    // The body is only chunked if chunked is the last coding applied
+    while ((end > val) && isspace(end[-1])) end--;
+    size_t len = strlen(CHUNKED);
+    return ((end - val) >= len) && !strncasecmp(end - len, CHUNKED, len);
+}
+
+static int
+hexValue(char c)
+{
+    if ((c >= '0') && (c <= '9')) return c - '0';
+    if ((c >= 'a') && (c <= 'f')) return c - 'a' + 10;
+    if ((c >= 'A') && (c <= 'F')) return c - 'A' + 10;
+    return -1;
+}
+
+/*
+ * Follows a chunked body through buf.  Only the chunk sizes and the
+ * delimiters around them are looked at; chunk data is skipped over
+ * without being scanned, however it's split across buffers.
+ *
+ * Returns the number of bytes consumed.  That's len unless the body
+ * ended (CHUNK_END) or turned out not to be chunked (CHUNK_ERROR).
+ */
+static size_t
+bytesToSkipForChunked(http_state_t *httpstate, char *buf, size_t len)
+{
+    size_t i = 0;
+    while ((i < len) && (httpstate->chunk < CHUNK_END)) {
+        char c = buf[i];
+        int digit;
+
+        switch (httpstate->chunk) {
+            case CHUNK_DATA:
+            {
+                size_t skip = len - i;
+                if (skip > httpstate->clen) skip = httpstate->clen;
+                httpstate->clen -= skip;
+                httpstate->bodylen += skip;
+                if (!httpstate->clen) httpstate->chunk = CHUNK_DATA_CR;
+                i += skip;
+                continue;
+            }
+            case CHUNK_SIZE_START:
+            case CHUNK_SIZE:
+                if ((digit = hexValue(c)) != -1) {
+                    if (httpstate->clen > (SIZE_MAX >> 4)) {
+                        httpstate->chunk = CHUNK_ERROR;
+                        break;
+                    }
+                    httpstate->clen = (httpstate->clen << 4) | digit;
+                    httpstate->chunk = CHUNK_SIZE;
+                } else if (httpstate->chunk == CHUNK_SIZE_START) {
+                    httpstate->chunk = CHUNK_ERROR;
+                } else if (c == '\r') {
+                    httpstate->chunk = CHUNK_SIZE_LF;
+                } else if ((c == ';') || (c == ' ') || (c == '\t')) {
+                    httpstate->chunk = CHUNK_EXT;
+                } else {
+                    httpstate->chunk = CHUNK_ERROR;
+                }
+                break;
+            case CHUNK_EXT:
+                if (c == '\r') httpstate->chunk = CHUNK_SIZE_LF;
+                break;
+            case CHUNK_SIZE_LF:
+                if (c != '\n') {
+                    httpstate->chunk = CHUNK_ERROR;
+                } else {
+                    // A chunk-size of zero is the last-chunk
+                    httpstate->chunk = (httpstate->clen) ? CHUNK_DATA : CHUNK_TRAILER;
+                }
+                break;
+            case CHUNK_DATA_CR:
+                httpstate->chunk = (c == '\r') ? CHUNK_DATA_LF : CHUNK_ERROR;
+                break;
+            case CHUNK_DATA_LF:
+                httpstate->chunk = (c == '\n') ? CHUNK_SIZE_START : CHUNK_ERROR;
+                break;
+            case CHUNK_TRAILER:
+                httpstate->chunk = (c == '\r') ? CHUNK_END_LF : CHUNK_TRAILER_LINE;
+                break;
+            case CHUNK_TRAILER_LINE:
+                if (c == '\n') httpstate->chunk = CHUNK_TRAILER;
+                break;
+            case CHUNK_END_LF:
+                httpstate->chunk = (c == '\n') ? CHUNK_END : CHUNK_ERROR;
+                break;
+            default:
+                DBG("%d", httpstate->chunk);
+                httpstate->chunk = CHUNK_ERROR;
+                break;
+        }
+        i++;
+    }
+    return i;
+}
+
+/*
+ * Returns how much of buf belongs to the chunked body.  When the body
+ * ends, a header that was held for it is reported along with the body
+ * length, and the state goes back to HTTP_NONE.  If the body can't be
+ * followed, the header is reported without a length and nothing in buf
+ * is counted as body.
+ */
+static size_t
+skipChunkedBody(http_state_t *httpstate, char *buf, size_t len, httpId_t *httpId)
+{
+    // Data going the other way means the body is over,
+    // or that we've lost track of it.
+    if (httpId->src != httpstate->id.src) {
+        reportHttp(httpstate, -1);
+        setHttpState(httpstate, HTTP_NONE);
+        return 0;
+    }
+
+    size_t bts = bytesToSkipForChunked(httpstate, buf, len);
+
+    switch (httpstate->chunk) {
+        case CHUNK_END:
+            reportHttp(httpstate, (httpstate->bodylen) ? httpstate->bodylen : -1);
+            setHttpState(httpstate, HTTP_NONE);
+            return bts;
+        case CHUNK_ERROR:
+            reportHttp(httpstate, -1);
+            setHttpState(httpstate, HTTP_NONE);
+            return 0;
+        default:
+            // Don't hold a header indefinitely, e.g. for an event stream
+            if (httpstate->hdr &&
+                (getDuration(httpstate->hdrtime) > MAX_HDR_HOLD_NS)) {
+                reportHttp(httpstate, -1);
+            }
+            return len;
+    }
+}
+
 static bool
 setHttpId(httpId_t *httpId, net_info *net, int sockfd, uint64_t id, metric_t src)
 {
@@ -156,9 +446,9 @@ setHttpId(httpId_t *httpId, net_info *net, int sockfd, uint64_t id, metric_t src
     return TRUE;
 }
 
-// For now, only doing HTTP/1.X headers
+// HTTP/2 headers are rewritten in HTTP/1 form before they get here
 static int
-reportHttp(http_state_t *httpstate)
+reportHttp(http_state_t *httpstate, size_t clen)
 {
     if (!httpstate || !httpstate->hdr || !httpstate->hdrlen) return -1;
 
@@ -208,20 +498,341 @@ reportHttp(http_state_t *httpstate)
     // Set post info
     proto->data = (char *)post;
     post->ssl = httpstate->id.isSsl;
-    post->start_duration = getTime();
+    // A held header is reported as of when it was seen
+    post->start_duration = (httpstate->hdrtime) ? httpstate->hdrtime : getTime();
+    proto->captured = post->start_duration;
     post->id = httpstate->id.uid;
+    post->clen = clen;
+    post->stream = httpstate->stream;
 
     // "transfer ownership" of dynamically allocated header from
     // httpstate object to post object
     post->hdr = httpstate->hdr;
     httpstate->hdr = NULL;
     httpstate->hdrlen = 0;
+    httpstate->hdrline = 0;
+    httpstate->hdrcut = FALSE;
+    httpstate->hdrtime = 0;
 
     cmdPostEvent(g_ctl, (char *)proto);
 
     return 0;
 }
 
+/*
+ * HTTP/2 (RFC 7540).  Once a connection starts with the client preface,
+ * both directions are frames.  Frame headers are followed across buffers;
+ * the payloads of HEADERS, PUSH_PROMISE and CONTINUATION frames are
+ * gathered into a header block, and every other payload is skipped over.
+ *
+ * Each direction has its own HPACK decoder, which sees every header block
+ * sent that way.  A decoded block is rewritten as an HTTP/1 style header,
+ * e.g. "GET /path HTTP/2\r\nhost: example.com\r\n...", and reported like
+ * one, along with the stream it's from.  If a direction gets out of step
+ * (a frame we can't follow, or a block we can't decode) nothing more is
+ * reported from it, since nothing after can be decoded either.
+ */
+
+static bool
+isHttp2Preface(char *buf, size_t len)
+{
+    return (len >= H2_PREFACE_LEN) && (buf[0] == 'P') &&
+           !memcmp(buf, H2_PREFACE, H2_PREFACE_LEN);
+}
+
+static bool
+startHttp2(http_state_t *httpstate)
+{
+    http2_t *h2 = calloc(1, sizeof(*h2));
+    if (!h2) {
+        DBG(NULL);
+        return FALSE;
+    }
+    int i;
+    for (i = 0; i < 2; i++) {
+        if (!(h2->dir[i].hpack = hpackCreate(H2_MAX_TABLE))) {
+            destroyHttp2(&h2);
+            return FALSE;
+        }
+    }
+    httpstate->h2 = h2;
+    setHttpState(httpstate, HTTP_2);
+    return TRUE;
+}
+
+static void
+destroyHttp2(http2_t **h2_ptr)
+{
+    if (!h2_ptr || !*h2_ptr) return;
+    http2_t *h2 = *h2_ptr;
+
+    int i;
+    for (i = 0; i < 2; i++) {
+        hpackDestroy(&h2->dir[i].hpack);
+        if (h2->dir[i].block) free(h2->dir[i].block);
+    }
+    free(h2);
+    *h2_ptr = NULL;
+}
+
+// Appends to an HTTP/1 style header being built from an HTTP/2 one
+static void
+appendHttp2(h2_hdr_t *hdr, const char *str, size_t len)
+{
+    memcpy(&hdr->buf[hdr->len], str, len);
+    hdr->len += len;
+}
+
+static void
+addHttp2Field(void *arg, const char *name, size_t nlen, const char *value, size_t vlen)
+{
+    h2_hdr_t *hdr = arg;
+
+    // Pseudo-header fields come first; they make up the first line
+    if (nlen && (name[0] == ':')) {
+        http_span *span = NULL;
+        if ((nlen == 7) && !memcmp(name, ":method", nlen)) {
+            span = &hdr->method;
+        } else if ((nlen == 5) && !memcmp(name, ":path", nlen)) {
+            span = &hdr->path;
+        } else if ((nlen == 10) && !memcmp(name, ":authority", nlen)) {
+            span = &hdr->authority;
+        } else if ((nlen == 7) && !memcmp(name, ":status", nlen)) {
+            span = &hdr->status;
+        }
+        if (!span || (vlen > H2_PSEUDO_SIZE - hdr->pseudolen)) return;
+        memcpy(&hdr->pseudo[hdr->pseudolen], value, vlen);
+        span->off = hdr->pseudolen;
+        span->len = vlen;
+        hdr->pseudolen += vlen;
+        return;
+    }
+
+    // "name: value\r\n", if it's wanted and fits
+    size_t need = nlen + vlen + 4;
+    if (!keepHttpField(name, nlen, hdr->len + need) ||
+        (hdr->len + need >= HDR_SLOT_SIZE)) return;
+    appendHttp2(hdr, name, nlen);
+    appendHttp2(hdr, ": ", 2);
+    appendHttp2(hdr, value, vlen);
+    appendHttp2(hdr, HTTP_END, 2);
+}
+
+// Decodes the header block that dir has gathered, and reports it.
+// Returns TRUE if it was a request or response header.
+static bool
+reportHttp2(http_state_t *httpstate, h2_dir_t *dir)
+{
+    h2_hdr_t hdr = {0};
+    if (!(hdr.buf = malloc(HDR_SLOT_SIZE + H2_PSEUDO_SIZE))) {
+        DBG(NULL);
+        dir->broken = TRUE;
+        return FALSE;
+    }
+    hdr.pseudo = &hdr.buf[HDR_SLOT_SIZE];
+    if (hpackDecode(dir->hpack, dir->block, dir->blocklen, addHttp2Field, &hdr)) {
+        dir->broken = TRUE;
+        free(hdr.buf);
+        return FALSE;
+    }
+
+    // The pieces of the first line, and the authority as a host field
+    struct {
+        const char *str;
+        size_t len;
+    } part[8];
+    int num = 0;
+#define H2_PART(s, l) do { part[num].str = (s); part[num].len = (l); num++; } while (0)
+    char *p = hdr.pseudo;
+    if (hdr.method.len) {
+        // A CONNECT has no path; its target is the authority
+        http_span *target = (hdr.path.len) ? &hdr.path : &hdr.authority;
+        H2_PART(&p[hdr.method.off], hdr.method.len);
+        H2_PART(" ", 1);
+        H2_PART(&p[target->off], target->len);
+        H2_PART(" HTTP/2\r\n", 9);
+        if (hdr.authority.len) {
+            H2_PART("host: ", 6);
+            H2_PART(&p[hdr.authority.off], hdr.authority.len);
+            H2_PART(HTTP_END, 2);
+        }
+    } else if ((hdr.status.len == 3) && (p[hdr.status.off] != '1')) {
+        H2_PART("HTTP/2 ", 7);
+        H2_PART(&p[hdr.status.off], hdr.status.len);
+        H2_PART(HTTP_END, 2);
+    } else {
+        // Trailers, or an interim (1xx) response
+        free(hdr.buf);
+        return FALSE;
+    }
+#undef H2_PART
+
+    // Like an HTTP/1 header, a first line that doesn't fit is cut short,
+    // and fields that don't fit after it are dropped
+    size_t linelen = 0;
+    int i;
+    for (i = 0; i < num; i++) linelen += part[i].len;
+    int cut = (linelen > HDR_SLOT_SIZE - 1);
+    if (cut) linelen = HDR_SLOT_SIZE - 1;
+    while (hdr.len && (linelen + hdr.len >= HDR_SLOT_SIZE)) {
+        hdr.len--;
+        while (hdr.len && (hdr.buf[hdr.len - 1] != '\n')) hdr.len--;
+    }
+
+    // The fields move over, and the line is written in front of them
+    memmove(&hdr.buf[linelen], hdr.buf, hdr.len);
+    size_t off = 0;
+    for (i = 0; (i < num) && (off < linelen); i++) {
+        size_t n = (part[i].len < linelen - off) ? part[i].len : linelen - off;
+        memcpy(&hdr.buf[off], part[i].str, n);
+        off += n;
+    }
+    if (cut) memcpy(&hdr.buf[linelen - 2], HTTP_END, 2);
+
+    // It's nul terminated and the nul is counted
+    size_t len = linelen + hdr.len + 1;
+    hdr.buf[len - 1] = '\0';
+
+    // The pseudo-header values aren't needed any more
+    char *slot = realloc(hdr.buf, HDR_SLOT_SIZE);
+    if (slot) hdr.buf = slot;
+
+    httpstate->hdr = hdr.buf;
+    httpstate->hdrlen = len;
+    httpstate->stream = dir->stream;
+    return (reportHttp(httpstate, -1) == 0);
+}
+
+// Called when a frame's payload has all been seen
+static bool
+endHttp2Frame(http_state_t *httpstate, h2_dir_t *dir)
+{
+    uint8_t type = dir->head[3];
+    uint8_t flags = dir->head[4];
+    uint32_t stream = (((uint32_t)dir->head[5] << 24) | (dir->head[6] << 16) |
+                       (dir->head[7] << 8) | dir->head[8]) & 0x7fffffff;
+    dir->headlen = 0;
+
+    if ((type != H2_HEADERS) && (type != H2_PUSH_PROMISE) &&
+        (type != H2_CONTINUATION)) return FALSE;
+
+    // Take the padding, priority and promised stream off of the fragment
+    if (type != H2_CONTINUATION) {
+        uint8_t *frag = &dir->block[dir->fragment];
+        size_t fraglen = dir->blocklen - dir->fragment;
+        size_t skip = 0;
+        size_t pad = 0;
+        if (flags & H2_PADDED) {
+            if (!fraglen) goto broken;
+            pad = frag[0];
+            skip = 1;
+        }
+        if ((type == H2_HEADERS) && (flags & H2_PRIORITY)) skip += 5;
+        if (type == H2_PUSH_PROMISE) {
+            // The promised request is for the promised stream
+            if (fraglen < skip + 4) goto broken;
+            stream = (((uint32_t)frag[skip] << 24) | (frag[skip + 1] << 16) |
+                      (frag[skip + 2] << 8) | frag[skip + 3]) & 0x7fffffff;
+            skip += 4;
+        }
+        if (skip + pad > fraglen) goto broken;
+        if (skip + pad) {
+            memmove(frag, &frag[skip], fraglen - skip - pad);
+            dir->blocklen -= skip + pad;
+        }
+        dir->stream = stream;
+    }
+
+    if (!(flags & H2_END_HEADERS)) {
+        dir->inblock = TRUE;
+        return FALSE;
+    }
+    dir->inblock = FALSE;
+    bool reported = reportHttp2(httpstate, dir);
+    dir->blocklen = 0;
+    return reported;
+
+broken:
+    dir->broken = TRUE;
+    return FALSE;
+}
+
+// Called when a frame's header has all been seen
+static void
+startHttp2Frame(h2_dir_t *dir)
+{
+    uint8_t type = dir->head[3];
+    dir->left = (dir->head[0] << 16) | (dir->head[1] << 8) | dir->head[2];
+
+    // Nothing but CONTINUATION frames can come in the middle of a block
+    if (dir->inblock != (type == H2_CONTINUATION)) {
+        dir->broken = TRUE;
+        return;
+    }
+    if ((type != H2_HEADERS) && (type != H2_PUSH_PROMISE) &&
+        (type != H2_CONTINUATION)) return;
+
+    size_t need = dir->blocklen + dir->left;
+    if (need > H2_MAX_BLOCK) {
+        dir->broken = TRUE;
+        return;
+    }
+    if (need > dir->blockalloc) {
+        uint8_t *temp = realloc(dir->block, need);
+        if (!temp) {
+            DBG(NULL);
+            dir->broken = TRUE;
+            return;
+        }
+        dir->block = temp;
+        dir->blockalloc = need;
+    }
+    dir->fragment = dir->blocklen;
+}
+
+// Follows the frames in buf.  Returns TRUE if a header was reported.
+static bool
+scanHttp2(http_state_t *httpstate, char *buf, size_t len, httpId_t *httpId)
+{
+    httpstate->id = *httpId;
+    int isSend = (httpId->src == NETTX) || (httpId->src == TLSTX);
+    h2_dir_t *dir = &httpstate->h2->dir[(isSend) ? 0 : 1];
+    bool found = FALSE;
+
+    size_t i = 0;
+    while ((i < len) && !dir->broken) {
+        if (dir->headlen < H2_FRAME_HDR) {
+            size_t n = H2_FRAME_HDR - dir->headlen;
+            if (n > len - i) n = len - i;
+            memcpy(&dir->head[dir->headlen], &buf[i], n);
+            dir->headlen += n;
+            i += n;
+            if (dir->headlen < H2_FRAME_HDR) break;
+
+            startHttp2Frame(dir);
+            if (dir->broken) break;
+            if (!dir->left) {
+                found |= endHttp2Frame(httpstate, dir);
+                continue;
+            }
+        }
+
+        size_t n = dir->left;
+        if (n > len - i) n = len - i;
+        uint8_t type = dir->head[3];
+        if ((type == H2_HEADERS) || (type == H2_PUSH_PROMISE) ||
+            (type == H2_CONTINUATION)) {
+            memcpy(&dir->block[dir->blocklen], &buf[i], n);
+            dir->blocklen += n;
+        }
+        dir->left -= n;
+        i += n;
+        if (!dir->left) found |= endHttp2Frame(httpstate, dir);
+    }
+
+    return found;
+}
+
 
 /*
  * If we have an fd check for TCP
@@ -229,7 +840,11 @@ reportHttp(http_state_t *httpstate)
  * called from certain TLS sessions; not an error
  *
  * If we are working down a content length, no
- * need to scan for a header
+ * need to scan for a header.  The same goes for
+ * a chunked body, where only the chunk sizes are
+ * looked at.  A response with a chunked body
+ * isn't reported until the body ends, so that the
+ * body length can be reported with it.
  *
  * Note that, at this point, we are not able to
  * use a content length optimization with gnutls
@@ -240,6 +855,7 @@ static bool
 scanForHttpHeader(http_state_t *httpstate, char *buf, size_t len, httpId_t *httpId)
 {
     if (!buf) return FALSE;
+    bool found = FALSE;
 
     // We need to handle "double interception" when ssl is involved, e.g.
     // intercepting an SSL_write(), then intercepting the write() it calls.
@@ -250,6 +866,11 @@ scanForHttpHeader(http_state_t *httpstate, char *buf, size_t len, httpId_t *http
         if (headerCaptureInProgress && !isSslIsConsistent) return FALSE;
     }
 
+    // An HTTP/2 connection is all frames
+    if (httpstate->state == HTTP_2) {
+        return scanHttp2(httpstate, buf, len, httpId);
+    }
+
     // Skip data if instructed to do so by previous content length
     if (httpstate->state == HTTP_DATA) {
         size_t bts = bytesToSkipForContentLength(httpstate, len);
@@ -259,11 +880,26 @@ scanForHttpHeader(http_state_t *httpstate, char *buf, size_t len, httpId_t *http
         setHttpState(httpstate, HTTP_NONE);
     }
 
+    // Skip the rest of a chunked body
+    if (httpstate->state == HTTP_CHUNKED) {
+        size_t bts = skipChunkedBody(httpstate, buf, len, httpId);
+        if (httpstate->state == HTTP_CHUNKED) return FALSE;
+        buf = &buf[bts];
+        len = len - bts;
+    }
+
+    // An HTTP/2 connection starts with the client preface
+    if ((httpstate->state == HTTP_NONE) && isHttp2Preface(buf, len)) {
+        if (!startHttp2(httpstate)) return FALSE;
+        return scanHttp2(httpstate, &buf[H2_PREFACE_LEN], len - H2_PREFACE_LEN, httpId);
+    }
+
+next_header:
     // Look for start of http header
     if (httpstate->state == HTTP_NONE) {
 
         // find the start of http header data
-        if (searchExec(g_http_start, buf, len) == -1) return FALSE;
+        if (searchExec(g_http_start, buf, len) == -1) return found;
 
         setHttpState(httpstate, HTTP_HDR);
         httpstate->id = *httpId;
@@ -283,18 +919,22 @@ scanForHttpHeader(http_state_t *httpstate, char *buf, size_t len, httpId_t *http
             // We didn't find an end in this buffer, append the rest of the
             // buffer to what we've found before.
             setHttpState(httpstate, HTTP_HDR);
-            appendHeader(httpstate, &buf[header_start], len-header_start);
+            appendHeader(httpstate, &buf[header_start], len-header_start, FALSE);
             break;
         } else {
             found_end_of_all_headers =
                 ((httpstate->state == HTTP_HDREND) && (header_end == 0));
-            if (found_end_of_all_headers) break;
+            if (found_end_of_all_headers) {
+                // the body starts after this last \r\n
+                header_end = header_start + searchLen(g_http_end);
+                break;
+            }
 
             // We found a complete header!
             setHttpState(httpstate, HTTP_HDREND);
             header_end += header_start;  // was measured from header_start
             header_end += searchLen(g_http_end);
-            appendHeader(httpstate, &buf[header_start], header_end-header_start);
+            appendHeader(httpstate, &buf[header_start], header_end-header_start, TRUE);
             header_start = header_end;
         }
     }
@@ -302,15 +942,38 @@ scanForHttpHeader(http_state_t *httpstate, char *buf, size_t len, httpId_t *http
     // Found the end of all headers!  Time to report something!
     if (found_end_of_all_headers) {
 
-        // append a null terminator to allow us to treat it as a string
-        appendHeader(httpstate, "\0", 1);
+        // append a null terminator to allow us to treat it as a string;
+        // there's always room for it
+        if (!httpstate->hdr) return found;
+        httpstate->hdr[httpstate->hdrlen++] = '\0';
 
         // check to see if there is a Content-Length in the header
         size_t clen = getContentLength(httpstate->hdr, httpstate->hdrlen);
         size_t content_in_this_buf = len - header_end;
 
+        // A chunked body overrides any Content-Length (RFC 7230 3.3.3)
+        if (isChunked(httpstate->hdr)) {
+            int isResponse =
+              (searchExec(g_http_start, httpstate->hdr, searchLen(g_http_start)) != -1);
+
+            // Hold a response header until its body ends
+            if (isResponse) {
+                httpstate->hdrtime = getTime();
+            } else {
+                reportHttp(httpstate, -1);
+            }
+
+            httpstate->clen = 0;
+            httpstate->bodylen = 0;
+            httpstate->chunk = CHUNK_SIZE_START;
+            setHttpState(httpstate, HTTP_CHUNKED);
+            skipChunkedBody(httpstate, &buf[header_end], content_in_this_buf, httpId);
+            return TRUE;
+        }
+
         // post and event containing the header we found
-        reportHttp(httpstate);
+        reportHttp(httpstate, -1);
+        found = TRUE;
 
         // change httpstate to HTTP_DATA per Content-Length or HTTP_NONE
         if ((clen != -1) && (clen >= content_in_this_buf)) {
@@ -318,10 +981,19 @@ scanForHttpHeader(http_state_t *httpstate, char *buf, size_t len, httpId_t *http
             setHttpState(httpstate, HTTP_DATA);
         } else {
             setHttpState(httpstate, HTTP_NONE);
+
+            // Pipelined requests can follow this one (and its body) in
+            // the same buffer
+            size_t next = header_end + ((clen != -1) ? clen : 0);
+            if (next < len) {
+                buf = &buf[next];
+                len -= next;
+                goto next_header;
+            }
         }
     }
 
-    return (found_end_of_all_headers);
+    return found;
 }
 
 void
@@ -408,7 +1080,7 @@ doHttp(uint64_t id, int sockfd, net_info *net, char *buf, size_t len, metric_t s
 
     // If our state is temporary, clean up after each doHttp call
     if (httpstate == &tempstate) {
-        setHttpState(httpstate, HTTP_NONE);
+        resetHttp(httpstate);
     }
 
     if (guard_enabled) while (!atomicCasU64(&g_http_guard[sockfd], 1ULL, 0ULL));
@@ -419,6 +1091,10 @@ doHttp(uint64_t id, int sockfd, net_info *net, char *buf, size_t len, metric_t s
 void
 resetHttp(http_state_t *httpstate)
 {
+    // A header held for its chunked body is reported without a length
+    if (httpstate && (httpstate->state == HTTP_CHUNKED)) {
+        reportHttp(httpstate, -1);
+    }
     setHttpState(httpstate, HTTP_NONE);
 }
 
@@ -9,4 +9,8 @@ void initHttpState(void);
 bool doHttp(uint64_t, int, net_info*, char*, size_t, metric_t, src_data_t);
 void resetHttp(http_state_t *httpstate);
 
+// Only the fields that are reported on their own are kept from headers,
+// unless all is set, e.g. when there are patterns for other fields
+void setHttpHeaderCapture(unsigned all);
+
 #endif // __HTTPSTATE_H__
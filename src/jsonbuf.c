@@ -0,0 +1,404 @@
+#define _GNU_SOURCE
+#include <locale.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "dbg.h"
+#include "jsonbuf.h"
+#include "scopetypes.h"
+
+#define JS_INITIAL_SIZE 512
+
+// The widest integer that "%1.15g" (what cJSON uses) prints without an
+// exponent.  Anything in this range can be printed as an integer.
+#define JS_MAX_PLAIN_INT 999999999999999LL
+
+void
+jsBufInit(jsbuf_t *js, char *storage, size_t size)
+{
+    if (!js) return;
+    memset(js, 0, sizeof(*js));
+    if (storage && size) {
+        js->data = storage;
+        js->size = size;
+        js->data[0] = '\0';
+    }
+}
+
+void
+jsBufFree(jsbuf_t *js)
+{
+    if (!js) return;
+    if (js->heap && js->data) free(js->data);
+    jsBufInit(js, NULL, 0);
+}
+
+void
+jsBufReset(jsbuf_t *js)
+{
+    if (!js) return;
+    js->len = 0;
+    js->err = FALSE;
+    js->comma = FALSE;
+    if (js->data) js->data[0] = '\0';
+}
+
+int
+jsBufErr(jsbuf_t *js)
+{
+    return (!js || js->err);
+}
+
+char *
+jsBufDetach(jsbuf_t *js, size_t *len)
+{
+    if (!js) return NULL;
+
+    char *data = NULL;
+    if (len) *len = 0;
+
+    if (!js->err && js->data) {
+        if (js->heap) {
+            data = js->data;
+        } else if ((data = malloc(js->len + 1))) {
+            memcpy(data, js->data, js->len + 1);
+        }
+        if (data && len) *len = js->len;
+    }
+
+    if (js->heap && js->data && (data != js->data)) free(js->data);
+    jsBufInit(js, NULL, 0);
+    return data;
+}
+
+// Makes room for n more bytes, plus the nul terminator
+static int
+jsReserve(jsbuf_t *js, size_t n)
+{
+    if (js->err) return FALSE;
+    if (js->len + n + 1 <= js->size) return TRUE;
+
+    size_t size = (js->size) ? js->size : JS_INITIAL_SIZE;
+    while (size < js->len + n + 1) size *= 2;
+
+    char *temp;
+    if (js->heap) {
+        temp = realloc(js->data, size);
+    } else if ((temp = malloc(size)) && js->data) {
+        memcpy(temp, js->data, js->len);
+    }
+    if (!temp) {
+        DBG("%zu", size);
+        js->err = TRUE;
+        return FALSE;
+    }
+    js->data = temp;
+    js->size = size;
+    js->heap = TRUE;
+    return TRUE;
+}
+
+static void
+jsPut(jsbuf_t *js, const char *src, size_t n)
+{
+    if (!jsReserve(js, n)) return;
+    memcpy(&js->data[js->len], src, n);
+    js->len += n;
+    js->data[js->len] = '\0';
+}
+
+static void
+jsPutChar(jsbuf_t *js, char c)
+{
+    if (!jsReserve(js, 1)) return;
+    js->data[js->len++] = c;
+    js->data[js->len] = '\0';
+}
+
+// Called before every key or value that's not inside a key:value pair
+static int
+jsSeparate(jsbuf_t *js)
+{
+    if (!js || js->err) return FALSE;
+    if (js->comma) jsPutChar(js, ',');
+    js->comma = TRUE;
+    return !js->err;
+}
+
+void
+jsObjStart(jsbuf_t *js)
+{
+    if (!jsSeparate(js)) return;
+    jsPutChar(js, '{');
+    js->comma = FALSE;
+}
+
+void
+jsObjEnd(jsbuf_t *js)
+{
+    if (!js) return;
+    jsPutChar(js, '}');
+    js->comma = TRUE;
+}
+
+void
+jsArrStart(jsbuf_t *js)
+{
+    if (!jsSeparate(js)) return;
+    jsPutChar(js, '[');
+    js->comma = FALSE;
+}
+
+void
+jsArrEnd(jsbuf_t *js)
+{
+    if (!js) return;
+    jsPutChar(js, ']');
+    js->comma = TRUE;
+}
+
+// Quotes and escapes a string the way cJSON's print_string_ptr() does
+static void
+jsPutString(jsbuf_t *js, const char *str, size_t len)
+{
+    const unsigned char *in = (const unsigned char *)str;
+    size_t i, run = 0;
+
+    jsPutChar(js, '"');
+    for (i = 0; i < len; i++) {
+        unsigned char c = in[i];
+        if ((c > 31) && (c != '"') && (c != '\\')) continue;
+
+        // copy everything up to the character that needs escaping
+        jsPut(js, &str[run], i - run);
+        run = i + 1;
+
+        char esc[8];
+        switch (c) {
+            case '\\': jsPut(js, "\\\\", 2); break;
+            case '"':  jsPut(js, "\\\"", 2); break;
+            case '\b': jsPut(js, "\\b", 2); break;
+            case '\f': jsPut(js, "\\f", 2); break;
+            case '\n': jsPut(js, "\\n", 2); break;
+            case '\r': jsPut(js, "\\r", 2); break;
+            case '\t': jsPut(js, "\\t", 2); break;
+            default:
+                snprintf(esc, sizeof(esc), "\\u%04x", c);
+                jsPut(js, esc, 6);
+                break;
+        }
+    }
+    jsPut(js, &str[run], len - run);
+    jsPutChar(js, '"');
+}
+
+void
+jsKey(jsbuf_t *js, const char *key)
+{
+    if (!jsSeparate(js)) return;
+
+    // cJSON prints a missing key as an empty string
+    jsPutString(js, (key) ? key : "", (key) ? strlen(key) : 0);
+    jsPutChar(js, ':');
+    js->comma = FALSE;
+}
+
+void
+jsNull(jsbuf_t *js)
+{
+    if (!jsSeparate(js)) return;
+    jsPut(js, "null", 4);
+}
+
+void
+jsBool(jsbuf_t *js, int val)
+{
+    if (!jsSeparate(js)) return;
+    if (val) {
+        jsPut(js, "true", 4);
+    } else {
+        jsPut(js, "false", 5);
+    }
+}
+
+static void
+jsPutInt(jsbuf_t *js, long long val)
+{
+    char buf[24];
+    char *p = &buf[sizeof(buf)];
+    unsigned long long u = (val < 0) ? -(unsigned long long)val : val;
+
+    do {
+        *--p = '0' + (u % 10);
+        u /= 10;
+    } while (u);
+    if (val < 0) *--p = '-';
+
+    jsPut(js, p, &buf[sizeof(buf)] - p);
+}
+
+// The same algorithm as cJSON's print_number()
+static void
+jsPutDouble(jsbuf_t *js, double d)
+{
+    char buf[26];
+    int len;
+    double test = 0.0;
+
+    // NaN and Infinity
+    if ((d * 0) != 0) {
+        jsPut(js, "null", 4);
+        return;
+    }
+
+    // Integers are the common case, and don't need the round trip test
+    if ((d >= -JS_MAX_PLAIN_INT) && (d <= JS_MAX_PLAIN_INT) &&
+        (d == (double)(long long)d) && !((d == 0) && signbit(d))) {
+        jsPutInt(js, (long long)d);
+        return;
+    }
+
+    len = snprintf(buf, sizeof(buf), "%1.15g", d);
+    if ((sscanf(buf, "%lg", &test) != 1) || (test != d)) {
+        len = snprintf(buf, sizeof(buf), "%1.17g", d);
+    }
+    if ((len < 0) || (len > (int)(sizeof(buf) - 1))) {
+        js->err = TRUE;
+        return;
+    }
+
+    // cJSON is built with ENABLE_LOCALES, so it does this too
+    char point = localeconv()->decimal_point[0];
+    if (point != '.') {
+        int i;
+        for (i = 0; i < len; i++) {
+            if (buf[i] == point) buf[i] = '.';
+        }
+    }
+
+    jsPut(js, buf, len);
+}
+
+void
+jsNum(jsbuf_t *js, double val)
+{
+    if (!jsSeparate(js)) return;
+    jsPutDouble(js, val);
+}
+
+void
+jsInt(jsbuf_t *js, long long val)
+{
+    if (!jsSeparate(js)) return;
+    if ((val >= -JS_MAX_PLAIN_INT) && (val <= JS_MAX_PLAIN_INT)) {
+        jsPutInt(js, val);
+    } else {
+        jsPutDouble(js, (double)val);
+    }
+}
+
+void
+jsStr(jsbuf_t *js, const char *str)
+{
+    if (!str) {
+        if (js) js->err = TRUE;
+        return;
+    }
+    jsStrLen(js, str, strlen(str));
+}
+
+void
+jsStrLen(jsbuf_t *js, const char *str, size_t len)
+{
+    if (!str) {
+        if (js) js->err = TRUE;
+        return;
+    }
+    if (!jsSeparate(js)) return;
+    jsPutString(js, str, len);
+}
+
+void
+jsRaw(jsbuf_t *js, const char *raw)
+{
+    if (!raw) {
+        if (js) js->err = TRUE;
+        return;
+    }
+    if (!jsSeparate(js)) return;
+    jsPut(js, raw, strlen(raw));
+}
+
+void
+jsMembers(jsbuf_t *js, const char *members, size_t len)
+{
+    if (!members) {
+        if (js) js->err = TRUE;
+        return;
+    }
+    if (!len || !jsSeparate(js)) return;
+    jsPut(js, members, len);
+}
+
+void
+jsJson(jsbuf_t *js, const cJSON *item)
+{
+    if (!js) return;
+    if (!item) {
+        js->err = TRUE;
+        return;
+    }
+
+    const cJSON *child;
+
+    switch (item->type & 0xff) {
+        case cJSON_NULL:
+            jsNull(js);
+            break;
+        case cJSON_False:
+            jsBool(js, FALSE);
+            break;
+        case cJSON_True:
+            jsBool(js, TRUE);
+            break;
+        case cJSON_Number:
+            jsNum(js, item->valuedouble);
+            break;
+        case cJSON_Raw:
+            jsRaw(js, item->valuestring);
+            break;
+        case cJSON_String:
+            // cJSON prints a missing string as an empty one
+            jsStr(js, (item->valuestring) ? item->valuestring : "");
+            break;
+        case cJSON_Array:
+            jsArrStart(js);
+            for (child = item->child; child; child = child->next) {
+                jsJson(js, child);
+            }
+            jsArrEnd(js);
+            break;
+        case cJSON_Object:
+            jsObjStart(js);
+            for (child = item->child; child; child = child->next) {
+                jsKey(js, child->string);
+                jsJson(js, child);
+            }
+            jsObjEnd(js);
+            break;
+        default:
+            // cJSON won't print an invalid item
+            js->err = TRUE;
+            break;
+    }
+}
+
+void
+jsNewline(jsbuf_t *js)
+{
+    if (!js) return;
+    jsPutChar(js, '\n');
+    js->comma = FALSE;
+}
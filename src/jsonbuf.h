@@ -0,0 +1,76 @@
+#ifndef __JSONBUF_H__
+#define __JSONBUF_H__
+#include <stddef.h>
+#include "cJSON.h"
+
+/*
+ * A streaming json writer, used to format events without building (and
+ * then printing) a cJSON tree.  The output is byte for byte what
+ * cJSON_PrintUnformatted() would produce for the equivalent tree, with
+ * the same string escaping and number formatting.
+ *
+ * Values are appended to a growable buffer, which can start out in
+ * storage provided by the caller (e.g. on the stack) so that typical
+ * messages need no allocation at all.  Commas are inserted
+ * automatically:
+ *
+ *     char storage[512];
+ *     jsbuf_t js;
+ *     jsBufInit(&js, storage, sizeof(storage));
+ *     jsObjStart(&js);
+ *     jsKey(&js, "type"); jsStr(&js, "evt");
+ *     jsKey(&js, "pid");  jsInt(&js, 4130);
+ *     jsObjEnd(&js);
+ *     ...
+ *     jsBufFree(&js);
+ *
+ * Errors are sticky; once one happens every later write is ignored and
+ * jsBufErr() returns TRUE, so callers only need to check once at the
+ * end.  Besides allocation failures, anything cJSON would refuse (e.g. a
+ * NULL string value) is an error.  The data is always nul terminated.
+ */
+
+typedef struct {
+    char *data;
+    size_t len;
+    size_t size;
+    int err;
+    int comma;          // TRUE if the next key or value needs a comma
+    int heap;           // TRUE if data was allocated by us
+} jsbuf_t;
+
+// The storage argument is optional initial storage (and its size)
+void        jsBufInit(jsbuf_t *, char *, size_t);
+void        jsBufFree(jsbuf_t *);
+void        jsBufReset(jsbuf_t *);
+int         jsBufErr(jsbuf_t *);
+
+// Hands the data to the caller (who must free it) and reinitializes js
+// without any storage.  Copies the data if it's in caller storage.
+char *      jsBufDetach(jsbuf_t *, size_t *);
+
+void        jsObjStart(jsbuf_t *);
+void        jsObjEnd(jsbuf_t *);
+void        jsArrStart(jsbuf_t *);
+void        jsArrEnd(jsbuf_t *);
+void        jsKey(jsbuf_t *, const char *);
+
+void        jsNull(jsbuf_t *);
+void        jsBool(jsbuf_t *, int);
+void        jsNum(jsbuf_t *, double);
+void        jsInt(jsbuf_t *, long long);        // formatted as a double would be
+void        jsStr(jsbuf_t *, const char *);     // NULL is an error
+void        jsStrLen(jsbuf_t *, const char *, size_t);
+void        jsRaw(jsbuf_t *, const char *);     // json text, copied as is
+
+// Splices in already serialized members ("key":value pairs separated by
+// commas, with no braces) as if they'd been written one at a time.
+void        jsMembers(jsbuf_t *, const char *, size_t);
+
+// Writes any cJSON item (and its children)
+void        jsJson(jsbuf_t *, const cJSON *);
+
+// Appends a newline, as a delimiter after a complete value
+void        jsNewline(jsbuf_t *);
+
+#endif // __JSONBUF_H__
@@ -0,0 +1,359 @@
+#define _GNU_SOURCE
+#include <stdlib.h>
+#include <string.h>
+
+#include "dbg.h"
+#include "msgpack.h"
+#include "scopetypes.h"
+
+#define MP_INITIAL_SIZE 512
+
+// Largest double that's still exactly representable as an integer
+#define MP_MAX_EXACT_INT 9007199254740992.0
+
+void
+mpBufInit(mpbuf_t *mp)
+{
+    if (!mp) return;
+    memset(mp, 0, sizeof(*mp));
+}
+
+void
+mpBufFree(mpbuf_t *mp)
+{
+    if (!mp) return;
+    if (mp->data) free(mp->data);
+    mpBufInit(mp);
+}
+
+void
+mpBufReset(mpbuf_t *mp)
+{
+    if (!mp) return;
+    mp->len = 0;
+    mp->err = FALSE;
+}
+
+int
+mpBufErr(mpbuf_t *mp)
+{
+    return (!mp || mp->err);
+}
+
+char *
+mpBufDetach(mpbuf_t *mp, size_t *len)
+{
+    if (!mp) return NULL;
+
+    char *data = mp->data;
+    if (len) *len = mp->len;
+    if (mp->err && data) {
+        free(data);
+        data = NULL;
+        if (len) *len = 0;
+    }
+    mpBufInit(mp);
+    return data;
+}
+
+static int
+mpReserve(mpbuf_t *mp, size_t n)
+{
+    if (mp->err) return FALSE;
+    if (mp->len + n <= mp->size) return TRUE;
+
+    size_t size = (mp->size) ? mp->size : MP_INITIAL_SIZE;
+    while (size < mp->len + n) size *= 2;
+
+    char *temp = realloc(mp->data, size);
+    if (!temp) {
+        DBG("%zu", size);
+        mp->err = TRUE;
+        return FALSE;
+    }
+    mp->data = temp;
+    mp->size = size;
+    return TRUE;
+}
+
+static void
+mpPut(mpbuf_t *mp, const void *src, size_t n)
+{
+    if (!mpReserve(mp, n)) return;
+    memcpy(&mp->data[mp->len], src, n);
+    mp->len += n;
+}
+
+static void
+mpPutByte(mpbuf_t *mp, uint8_t b)
+{
+    if (!mpReserve(mp, 1)) return;
+    mp->data[mp->len++] = b;
+}
+
+static void
+mpStoreBE(char *dst, uint64_t val, int n)
+{
+    int i;
+    for (i = n - 1; i >= 0; i--) {
+        dst[i] = (char)(val & 0xff);
+        val >>= 8;
+    }
+}
+
+// A type byte followed by an n byte big-endian value
+static void
+mpPutTyped(mpbuf_t *mp, uint8_t type, uint64_t val, int n)
+{
+    if (!mpReserve(mp, 1 + n)) return;
+    mp->data[mp->len] = type;
+    mpStoreBE(&mp->data[mp->len + 1], val, n);
+    mp->len += 1 + n;
+}
+
+size_t
+mpMsgStart(mpbuf_t *mp)
+{
+    if (!mp) return 0;
+    size_t start = mp->len;
+    if (mpReserve(mp, MP_MSG_HDR_LEN)) mp->len += MP_MSG_HDR_LEN;
+    return start;
+}
+
+int
+mpMsgEnd(mpbuf_t *mp, size_t start)
+{
+    if (!mp || mp->err || start + MP_MSG_HDR_LEN > mp->len) return -1;
+
+    size_t bodylen = mp->len - start - MP_MSG_HDR_LEN;
+    if (bodylen > UINT32_MAX) {
+        DBG("%zu", bodylen);
+        mp->err = TRUE;
+        return -1;
+    }
+    mpStoreBE(&mp->data[start], bodylen, MP_MSG_HDR_LEN);
+    return 0;
+}
+
+size_t
+mpMsgLen(const char *msg)
+{
+    if (!msg) return 0;
+
+    const uint8_t *p = (const uint8_t *)msg;
+    uint32_t bodylen = ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) |
+                       ((uint32_t)p[2] << 8) | (uint32_t)p[3];
+    return MP_MSG_HDR_LEN + bodylen;
+}
+
+void
+mpNil(mpbuf_t *mp)
+{
+    if (!mp) return;
+    mpPutByte(mp, 0xc0);
+}
+
+void
+mpBool(mpbuf_t *mp, int val)
+{
+    if (!mp) return;
+    mpPutByte(mp, (val) ? 0xc3 : 0xc2);
+}
+
+void
+mpUint(mpbuf_t *mp, unsigned long long val)
+{
+    if (!mp) return;
+
+    if (val < 0x80) {
+        mpPutByte(mp, (uint8_t)val);
+    } else if (val <= UINT8_MAX) {
+        mpPutTyped(mp, 0xcc, val, 1);
+    } else if (val <= UINT16_MAX) {
+        mpPutTyped(mp, 0xcd, val, 2);
+    } else if (val <= UINT32_MAX) {
+        mpPutTyped(mp, 0xce, val, 4);
+    } else {
+        mpPutTyped(mp, 0xcf, val, 8);
+    }
+}
+
+void
+mpInt(mpbuf_t *mp, long long val)
+{
+    if (!mp) return;
+
+    if (val >= 0) {
+        mpUint(mp, (unsigned long long)val);
+    } else if (val >= -32) {
+        mpPutByte(mp, (uint8_t)(int8_t)val);
+    } else if (val >= INT8_MIN) {
+        mpPutTyped(mp, 0xd0, (uint8_t)(int8_t)val, 1);
+    } else if (val >= INT16_MIN) {
+        mpPutTyped(mp, 0xd1, (uint16_t)(int16_t)val, 2);
+    } else if (val >= INT32_MIN) {
+        mpPutTyped(mp, 0xd2, (uint32_t)(int32_t)val, 4);
+    } else {
+        mpPutTyped(mp, 0xd3, (uint64_t)val, 8);
+    }
+}
+
+void
+mpDouble(mpbuf_t *mp, double val)
+{
+    if (!mp) return;
+
+    uint64_t bits;
+    memcpy(&bits, &val, sizeof(bits));
+    mpPutTyped(mp, 0xcb, bits, 8);
+}
+
+void
+mpStrLen(mpbuf_t *mp, const char *str, size_t len)
+{
+    if (!mp) return;
+    if (!str) {
+        mpNil(mp);
+        return;
+    }
+
+    if (len < 32) {
+        mpPutByte(mp, 0xa0 | (uint8_t)len);
+    } else if (len <= UINT8_MAX) {
+        mpPutTyped(mp, 0xd9, len, 1);
+    } else if (len <= UINT16_MAX) {
+        mpPutTyped(mp, 0xda, len, 2);
+    } else {
+        mpPutTyped(mp, 0xdb, len, 4);
+    }
+    mpPut(mp, str, len);
+}
+
+void
+mpStr(mpbuf_t *mp, const char *str)
+{
+    mpStrLen(mp, str, (str) ? strlen(str) : 0);
+}
+
+void
+mpArray(mpbuf_t *mp, uint32_t count)
+{
+    if (!mp) return;
+
+    if (count < 16) {
+        mpPutByte(mp, 0x90 | (uint8_t)count);
+    } else if (count <= UINT16_MAX) {
+        mpPutTyped(mp, 0xdc, count, 2);
+    } else {
+        mpPutTyped(mp, 0xdd, count, 4);
+    }
+}
+
+void
+mpMap(mpbuf_t *mp, uint32_t count)
+{
+    if (!mp) return;
+
+    if (count < 16) {
+        mpPutByte(mp, 0x80 | (uint8_t)count);
+    } else if (count <= UINT16_MAX) {
+        mpPutTyped(mp, 0xde, count, 2);
+    } else {
+        mpPutTyped(mp, 0xdf, count, 4);
+    }
+}
+
+size_t
+mpMapStart(mpbuf_t *mp)
+{
+    if (!mp) return 0;
+
+    // Always a map32, so there's room for whatever count mpMapEnd finds
+    size_t start = mp->len;
+    mpPutTyped(mp, 0xdf, 0, 4);
+    return start;
+}
+
+void
+mpMapEnd(mpbuf_t *mp, size_t start, uint32_t count)
+{
+    if (!mp || mp->err || start + 5 > mp->len) return;
+    mpStoreBE(&mp->data[start + 1], count, 4);
+}
+
+static void
+mpJsonNumber(mpbuf_t *mp, double val)
+{
+    // Integral values are written as integers, as cJSON would print them
+    if (val >= -MP_MAX_EXACT_INT && val <= MP_MAX_EXACT_INT &&
+        val == (double)(long long)val) {
+        mpInt(mp, (long long)val);
+    } else {
+        mpDouble(mp, val);
+    }
+}
+
+static void mpJsonRaw(mpbuf_t *, const char *);
+
+void
+mpJson(mpbuf_t *mp, cJSON *item)
+{
+    if (!mp) return;
+    if (!item) {
+        mpNil(mp);
+        return;
+    }
+
+    cJSON *child;
+    uint32_t count = 0;
+
+    switch (item->type & 0xff) {
+        case cJSON_False:
+            mpBool(mp, FALSE);
+            break;
+        case cJSON_True:
+            mpBool(mp, TRUE);
+            break;
+        case cJSON_Number:
+            mpJsonNumber(mp, item->valuedouble);
+            break;
+        case cJSON_String:
+            mpStr(mp, item->valuestring);
+            break;
+        case cJSON_Raw:
+            mpJsonRaw(mp, item->valuestring);
+            break;
+        case cJSON_Array:
+            for (child = item->child; child; child = child->next) count++;
+            mpArray(mp, count);
+            for (child = item->child; child; child = child->next) {
+                mpJson(mp, child);
+            }
+            break;
+        case cJSON_Object:
+            for (child = item->child; child; child = child->next) count++;
+            mpMap(mp, count);
+            for (child = item->child; child; child = child->next) {
+                mpStr(mp, child->string);
+                mpJson(mp, child);
+            }
+            break;
+        case cJSON_NULL:
+        default:
+            mpNil(mp);
+            break;
+    }
+}
+
+// Raw items hold json text (e.g. from cJSON_CreateStringFromBuffer)
+static void
+mpJsonRaw(mpbuf_t *mp, const char *raw)
+{
+    cJSON *parsed = (raw) ? cJSON_Parse(raw) : NULL;
+    if (!parsed) {
+        mpStr(mp, raw);
+        return;
+    }
+    mpJson(mp, parsed);
+    cJSON_Delete(parsed);
+}
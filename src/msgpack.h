@@ -0,0 +1,67 @@
+#ifndef __MSGPACK_H__
+#define __MSGPACK_H__
+#include <stddef.h>
+#include <stdint.h>
+#include "cJSON.h"
+
+/*
+ * A minimal MessagePack writer, used for the binary event format.
+ *
+ * Values are appended to a growable buffer.  An allocation failure is
+ * sticky; once it happens every later write is ignored and mpBufErr()
+ * returns TRUE, so callers only need to check once at the end.
+ *
+ * On the wire each message is framed with a 4 byte big-endian length
+ * followed by exactly one MessagePack value (normally a map):
+ *
+ *     size_t msg = mpMsgStart(mp);
+ *     mpMap(mp, 2);
+ *     mpStr(mp, "type"); mpStr(mp, "evt");
+ *     ...
+ *     mpMsgEnd(mp, msg);
+ *
+ * Maps whose size isn't known up front can be opened with mpMapStart()
+ * and have their count filled in by mpMapEnd().
+ */
+
+#define MP_MSG_HDR_LEN 4
+
+typedef struct {
+    char *data;
+    size_t len;
+    size_t size;
+    int err;
+} mpbuf_t;
+
+void        mpBufInit(mpbuf_t *);
+void        mpBufFree(mpbuf_t *);
+void        mpBufReset(mpbuf_t *);
+int         mpBufErr(mpbuf_t *);
+
+// Hands the buffer to the caller (who must free it) and reinitializes mp
+char *      mpBufDetach(mpbuf_t *, size_t *);
+
+// Length framing; mpMsgEnd returns -1 if anything went wrong in between
+size_t      mpMsgStart(mpbuf_t *);
+int         mpMsgEnd(mpbuf_t *, size_t);
+
+// Length of the framed message at the start of a buffer, including the
+// 4 byte header
+size_t      mpMsgLen(const char *);
+
+void        mpNil(mpbuf_t *);
+void        mpBool(mpbuf_t *, int);
+void        mpInt(mpbuf_t *, long long);
+void        mpUint(mpbuf_t *, unsigned long long);
+void        mpDouble(mpbuf_t *, double);
+void        mpStr(mpbuf_t *, const char *);         // NULL is written as nil
+void        mpStrLen(mpbuf_t *, const char *, size_t);
+void        mpArray(mpbuf_t *, uint32_t);
+void        mpMap(mpbuf_t *, uint32_t);
+size_t      mpMapStart(mpbuf_t *);
+void        mpMapEnd(mpbuf_t *, size_t, uint32_t);
+
+// Writes any cJSON item (and its children) as the equivalent value
+void        mpJson(mpbuf_t *, cJSON *);
+
+#endif // __MSGPACK_H__
@@ -6,6 +6,8 @@
 #include "circbuf.h"
 #include "runtimecfg.h"
 
+#define MTC_STATSD_STORAGE 2048
+
 struct _mtc_t
 {
     unsigned enable;
@@ -57,6 +59,17 @@ mtcSendMetric(mtc_t *mtc, event_t *evt)
 {
     if (!mtc || !evt) return -1;
 
+    // statsd messages are normally formatted on the stack.  Anything else
+    // (json, or statsd with a big maxlen) is allocated.
+    // An event that can't be formatted into buf won't format any better
+    // allocated, so it's only formatted once.
+    if ((mtcFormatType(mtc->format) == CFG_FMT_STATSD) &&
+        (mtcFormatStatsDMaxLen(mtc->format) < MTC_STATSD_STORAGE)) {
+        char buf[MTC_STATSD_STORAGE];
+        int len = mtcFormatStatsDToBuf(mtc->format, evt, NULL, buf, sizeof(buf));
+        return (len >= 0) ? transportSend(mtc->transport, buf, len) : -1;
+    }
+
     char *msg = mtcFormatEventForOutput(mtc->format, evt, NULL);
     int rv = mtcSend(mtc, msg);
     if (msg) free(msg);
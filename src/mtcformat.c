@@ -4,11 +4,11 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
-#include <sys/timeb.h>
 #include <inttypes.h>
 #include "cJSON.h"
 #include "dbg.h"
 #include "mtcformat.h"
+#include "plattime.h"
 #include "scopetypes.h"
 #include "com.h"
 
@@ -96,155 +96,150 @@ statsdType(data_type_t x)
     }
 }
 
+// Writes the decimal digits of val, returning how many were written.
+// buf needs room for at least 20 chars; no nul terminator is added.
 static int
-createStatsFieldString(mtc_fmt_t* fmt, event_field_t* f, char* tag, int sizeoftag)
+statsdInt(char *buf, long long val)
 {
-    if (!fmt || !f || !tag || sizeoftag <= 0) return -1;
-
-    int sz;
-
-    switch (f->value_type) {
-        case FMT_NUM:
-            sz = snprintf(tag, sizeoftag, "%s:%lli", f->name, f->value.num);
-            break;
-        case FMT_STR:
-            sz = snprintf(tag, sizeoftag, "%s:%s", f->name, f->value.str);
-            break;
-        default:
-            DBG("%d %s", f->value_type, f->name);
-            sz = -1;
-    }
-    return sz;
+    char digits[20];
+    int n = 0, len = 0;
+    unsigned long long u = (val < 0) ? -(unsigned long long)val : val;
+
+    do {
+        digits[n++] = '0' + (u % 10);
+        u /= 10;
+    } while (u);
+
+    if (val < 0) buf[len++] = '-';
+    while (n) buf[len++] = digits[--n];
+    return len;
 }
 
+// Appends a "name:value" tag if there is room for it within max_len,
+// along with the "|#" or "," that precedes it.
 static void
-appendStatsdFieldString(mtc_fmt_t* fmt, char* tag, int sz, char** end, int* bytes, int* firstTagAdded)
+statsdAppendTag(mtc_fmt_t *fmt, char *buf, size_t *bytes, int *firstTagAdded,
+                const char *name, const char *value, size_t vlen)
 {
-    if (!*firstTagAdded) {
-        sz += 2; // add space for the |#
-        if ((*bytes + sz) >= fmt->statsd.max_len) return;
-        *end = stpcpy(*end, "|#");
-        *end = stpcpy(*end, tag);
-        strcpy(*end, "\n"); // add newline, but don't advance end
-        *firstTagAdded = 1;
+    size_t nlen = strlen(name);
+    size_t sep = (*firstTagAdded) ? 1 : 2;
+
+    if ((*bytes + sep + nlen + 1 + vlen) >= fmt->statsd.max_len) return;
+
+    char *end = &buf[*bytes];
+    if (*firstTagAdded) {
+        *end++ = ',';
     } else {
-        sz += 1; // add space for the comma
-        if ((*bytes + sz) >= fmt->statsd.max_len) return;
-        *end = stpcpy(*end, ",");
-        *end = stpcpy(*end, tag);
-        strcpy(*end, "\n"); // add newline, but don't advance end
+        *end++ = '|';
+        *end++ = '#';
+        *firstTagAdded = 1;
     }
-    *bytes += sz;
-}
+    memcpy(end, name, nlen);
+    end += nlen;
+    *end++ = ':';
+    memcpy(end, value, vlen);
+    end += vlen;
 
+    *bytes = end - buf;
+}
 
-static void
-addStatsdFields(mtc_fmt_t* fmt, event_field_t* fields, char** end, int* bytes, int* firstTagAdded, regex_t* fieldFilter)
+int
+mtcFormatStatsDToBuf(mtc_fmt_t *fmt, event_t *e, filter_t *fieldFilter, char *buf, size_t size)
 {
-    if (!fmt || !fields || ! end || !*end || !bytes) return;
+    if (!fmt || !e || !buf || (size <= fmt->statsd.max_len)) return -1;
+    if (fmt->format != CFG_FMT_STATSD) return -1;
+
+    const char *prefix = mtcFormatStatsDPrefix(fmt);
+    size_t plen = strlen(prefix);
+    size_t nlen = strlen(e->name);
 
-    char tag[fmt->statsd.max_len+1];
-    tag[fmt->statsd.max_len] = '\0'; // Ensures null termination
-    int sz;
+    char valuebuf[320]; // :-MAX_DBL.00| => max of 315 chars for float
+    int vlen = -1;
+    switch ( e->value.type ) {
+        case FMT_INT:
+            valuebuf[0] = ':';
+            vlen = 1 + statsdInt(&valuebuf[1], e->value.integer);
+            valuebuf[vlen++] = '|';
+            break;
+        case FMT_FLT:
+            vlen = snprintf(valuebuf, sizeof(valuebuf), ":%.2f|", e->value.floating);
+            break;
+        default:
+            DBG(NULL);
+    }
+    if (vlen < 0) return -1;
+
+    const char *type = statsdType(e->type);
+    size_t tlen = strlen(type);
+
+    // The trailing newline has to fit too
+    size_t bytes = plen + nlen + vlen + tlen;
+    if (bytes >= fmt->statsd.max_len) return -1;
+
+    char *end = buf;
+    memcpy(end, prefix, plen);
+    end += plen;
+    memcpy(end, e->name, nlen);
+    end += nlen;
+    memcpy(end, valuebuf, vlen);
+    end += vlen;
+    memcpy(end, type, tlen);
+
+    // Tags and fields are added as long as they fit; one that doesn't is
+    // skipped, but later (shorter) ones can still be added.
+    int firstTagAdded = 0;
+    custom_tag_t **tags = fmt->tags;
+    custom_tag_t *t;
+    int i = 0;
+    while (tags && (t = tags[i++])) {
+        // No verbosity setting exists for custom fields.
+        if (!t->name || !t->value) continue;
+        statsdAppendTag(fmt, buf, &bytes, &firstTagAdded,
+                        t->name, t->value, strlen(t->value));
+    }
 
-    event_field_t* f;
-    for (f = fields; f->value_type != FMT_END; f++) {
+    event_field_t *f;
+    for (f = e->fields; f && f->value_type != FMT_END; f++) {
 
-        if (fieldFilter && regexec_wrapper(fieldFilter, f->name, 0, NULL, 0)) continue;
+        if (fieldFilter && !filterMatchName(fieldFilter, f->name)) continue;
 
         // Honor Verbosity
         if (f->cardinality > fmt->verbosity) continue;
 
-        sz = createStatsFieldString(fmt, f, tag, sizeof(tag));
-        if (sz < 0) break;
-
-        appendStatsdFieldString(fmt, tag, sz, end, bytes, firstTagAdded);
+        if (f->value_type == FMT_NUM) {
+            char num[24];
+            int len = statsdInt(num, f->value.num);
+            statsdAppendTag(fmt, buf, &bytes, &firstTagAdded, f->name, num, len);
+        } else if (f->value_type == FMT_STR) {
+            const char *str = (f->value.str) ? f->value.str : "";
+            statsdAppendTag(fmt, buf, &bytes, &firstTagAdded, f->name, str, strlen(str));
+        } else {
+            DBG("%d %s", f->value_type, f->name);
+            break;
+        }
     }
-}
 
-static void
-addCustomFields(mtc_fmt_t* fmt, custom_tag_t** tags, char** end, int* bytes, int* firstTagAdded)
-{
-    if (!fmt || !tags || !*tags || !end || !*end || !bytes) return;
-
-    char tag[fmt->statsd.max_len+1];
-    tag[fmt->statsd.max_len] = '\0'; // Ensures null termination
-    int sz;
-
-    custom_tag_t* t;
-    int i = 0;
-    while ((t = tags[i++])) {
-
-        // No verbosity setting exists for custom fields.
-
-        sz = snprintf(tag, sizeof(tag), "%s:%s", t->name, t->value);
-        if (sz < 0) break;
-
-        appendStatsdFieldString(fmt, tag, sz, end, bytes, firstTagAdded);
-    }
+    buf[bytes++] = '\n';
+    buf[bytes] = '\0';
+    return bytes;
 }
 
 static char*
-mtcFormatStatsDString(mtc_fmt_t* fmt, event_t* e, regex_t* fieldFilter)
+mtcFormatStatsDString(mtc_fmt_t* fmt, event_t* e, filter_t* fieldFilter)
 {
     if (!fmt || !e) return NULL;
 
-    char* end = calloc(1, fmt->statsd.max_len + 1);
-    if (!end) {
+    char *msg = malloc(fmt->statsd.max_len + 1);
+    if (!msg) {
          DBG("%s", e->name);
          return NULL;
     }
 
-    char* end_start = end;
-
-    // First, calculate size
-    int bytes = 0;
-    bytes += strlen(fmt->statsd.prefix);
-    bytes += strlen(e->name);
-    char valuebuf[320]; // :-MAX_DBL.00| => max of 315 chars for float
-    int n = -1;
-    switch ( e->value.type ) {
-        case FMT_INT:
-            n = sprintf(valuebuf, ":%lli|", e->value.integer);
-            break;
-        case FMT_FLT:
-            n = sprintf(valuebuf, ":%.2f|", e->value.floating);
-            break;
-        default:
-            DBG(NULL);
-    }
-    if (n < 0) {
-        free(end_start);
-        return NULL;
-    }
-    bytes += n; // size of value in valuebuf
-    char* type = statsdType(e->type);
-    bytes += strlen(type);
-
-    // Test the calloc'd size is adequate
-    if (bytes >= fmt->statsd.max_len) {
-        free(end_start);
+    if (mtcFormatStatsDToBuf(fmt, e, fieldFilter, msg, fmt->statsd.max_len + 1) < 0) {
+        free(msg);
         return NULL;
     }
-
-    // Then construct it
-    end = stpcpy(end, fmt->statsd.prefix);
-    end = stpcpy(end, e->name);
-    end = stpcpy(end, valuebuf);
-    end = stpcpy(end, type);
-
-    // Add a newline that will get overwritten if there are fields.
-    // (strcpy doesn't advance end)
-    strcpy(end, "\n");
-
-    int firstTagAdded = 0;
-    addCustomFields(fmt, fmt->tags, &end, &bytes, &firstTagAdded);
-    addStatsdFields(fmt, e->fields, &end, &bytes, &firstTagAdded, fieldFilter);
-
-    // Now that we're done, we can count the trailing newline
-    bytes += 1;
-
-    return end_start;
+    return msg;
 }
 
 static void
@@ -261,7 +256,7 @@ addCustomJsonFields(mtc_fmt_t *fmt, cJSON *json)
 }
 
 char *
-mtcFormatEventForOutput(mtc_fmt_t *fmt, event_t *evt, regex_t *fieldFilter)
+mtcFormatEventForOutput(mtc_fmt_t *fmt, event_t *evt, filter_t *fieldFilter)
 {
     if (!fmt || !evt ) return NULL;
 
@@ -276,10 +271,7 @@ mtcFormatEventForOutput(mtc_fmt_t *fmt, event_t *evt, regex_t *fieldFilter)
         addCustomJsonFields(fmt, json);
 
         // Request is for this json, plus a _time field
-        struct timeb tb;
-        ftime(&tb);
-        double timestamp = tb.time + (double)tb.millitm/1000;
-        cJSON_AddNumberToObjLN(json, "_time", timestamp);
+        cJSON_AddNumberToObjLN(json, "_time", wallClockSecs());
 
         // add envelope for metric events 
         // https://github.com/criblio/appscope/issues/198
@@ -313,6 +305,12 @@ out:
     return msg;
 }
 
+cfg_mtc_format_t
+mtcFormatType(mtc_fmt_t* fmt)
+{
+    return (fmt) ? fmt->format : DEFAULT_MTC_FORMAT;
+}
+
 const char*
 mtcFormatStatsDPrefix(mtc_fmt_t* fmt)
 {
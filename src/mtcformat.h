@@ -1,10 +1,12 @@
 #ifndef __MTC_FORMAT_H__
 #define __MTC_FORMAT_H__
 
+#include <stdint.h>
 #include "pcre2posix.h"
 #include "scopetypes.h"
 #include "cfg.h"
 #include "cJSON.h"
+#include "filter.h"
 
 
 // This event structure is meant to meet our needs w.r.t. statsd,
@@ -45,6 +47,7 @@ typedef struct {
     event_field_t *fields;
     watch_t src;
     cJSON *data;
+    uint64_t captured;      // TSC when it happened, zero if not known
 } event_t;
 
 #define INT_EVENT(n, v, t, f) {n, { FMT_INT, .integer=v}, t, f, CFG_SRC_METRIC}
@@ -64,7 +67,7 @@ typedef struct {
     double timestamp;
     char *path;
     watch_t sourcetype;
-    regex_t *valuefilter;
+    filter_t *valuefilter;
     proc_id_t* proc;
 } log_id_t;
 
@@ -82,6 +85,7 @@ mtc_fmt_t*          mtcFormatCreate(cfg_mtc_format_t);
 void                mtcFormatDestroy(mtc_fmt_t**);
 
 // Accessors
+cfg_mtc_format_t    mtcFormatType(mtc_fmt_t*);
 const char*         mtcFormatStatsDPrefix(mtc_fmt_t*);
 unsigned            mtcFormatStatsDMaxLen(mtc_fmt_t*);
 unsigned            mtcFormatVerbosity(mtc_fmt_t*);
@@ -89,7 +93,13 @@ custom_tag_t**      mtcFormatCustomTags(mtc_fmt_t*);
 
 // This function returns a pointer to a malloc()'d buffer.
 // The caller is responsible for deallocating with free().
-char*               mtcFormatEventForOutput(mtc_fmt_t*, event_t*, regex_t*);
+char*               mtcFormatEventForOutput(mtc_fmt_t*, event_t*, filter_t*);
+
+// Writes a statsd message into the buffer provided, without allocating.
+// The buffer needs to be bigger than mtcFormatStatsDMaxLen().  Returns
+// the length of the (nul terminated) message, or -1 if the format isn't
+// statsd, the buffer is too small, or the event can't be formatted.
+int                 mtcFormatStatsDToBuf(mtc_fmt_t*, event_t*, filter_t*, char*, size_t);
 
 // Setters
 void                mtcFormatStatsDPrefixSet(mtc_fmt_t*, const char*);
@@ -0,0 +1,189 @@
+#define _GNU_SOURCE
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "dbg.h"
+#include "fn.h"
+#include "payfd.h"
+#include "scopetypes.h"
+
+typedef struct {
+    uint64_t uid;
+    payfd_dir_t dir;
+    int fd;             // -1 when the entry is unused
+    uint64_t used;      // value of tick when last used
+} payfd_entry_t;
+
+struct _payfd_t
+{
+    payfd_entry_t *entries;
+    unsigned max;
+    unsigned count;
+    uint64_t tick;
+
+    // what the cached fds were opened for
+    pid_t pid;
+    char *dir;
+};
+
+payfd_t *
+payFdCreate(unsigned max)
+{
+    if (!max) return NULL;
+
+    payfd_t *cache = calloc(1, sizeof(*cache));
+    if (!cache) {
+        DBG(NULL);
+        return NULL;
+    }
+
+    cache->entries = calloc(max, sizeof(payfd_entry_t));
+    if (!cache->entries) {
+        DBG("%u", max);
+        free(cache);
+        return NULL;
+    }
+
+    unsigned i;
+    for (i = 0; i < max; i++) {
+        cache->entries[i].fd = -1;
+    }
+    cache->max = max;
+    return cache;
+}
+
+void
+payFdDestroy(payfd_t **cache)
+{
+    if (!cache || !*cache) return;
+
+    payfd_t *c = *cache;
+    payFdCloseAll(c);
+    if (c->dir) free(c->dir);
+    free(c->entries);
+    free(c);
+    *cache = NULL;
+}
+
+static void
+entryClose(payfd_t *cache, payfd_entry_t *entry)
+{
+    if (entry->fd == -1) return;
+
+    g_fn.close(entry->fd);
+    entry->fd = -1;
+    cache->count--;
+}
+
+static payfd_entry_t *
+entryFind(payfd_t *cache, uint64_t uid, payfd_dir_t dir)
+{
+    unsigned i;
+    for (i = 0; i < cache->max; i++) {
+        payfd_entry_t *entry = &cache->entries[i];
+        if ((entry->fd != -1) && (entry->uid == uid) && (entry->dir == dir)) {
+            return entry;
+        }
+    }
+    return NULL;
+}
+
+// An unused entry if there is one, otherwise the least recently used
+static payfd_entry_t *
+entryVictim(payfd_t *cache)
+{
+    payfd_entry_t *victim = &cache->entries[0];
+    unsigned i;
+    for (i = 0; i < cache->max; i++) {
+        payfd_entry_t *entry = &cache->entries[i];
+        if (entry->fd == -1) return entry;
+        if (entry->used < victim->used) victim = entry;
+    }
+    return victim;
+}
+
+int
+payFdGet(payfd_t *cache, uint64_t uid, payfd_dir_t dir)
+{
+    if (!cache) return -1;
+
+    payfd_entry_t *entry = entryFind(cache, uid, dir);
+    if (!entry) return -1;
+
+    entry->used = ++cache->tick;
+    return entry->fd;
+}
+
+int
+payFdOpen(payfd_t *cache, uint64_t uid, payfd_dir_t dir, const char *path)
+{
+    if (!cache || !path) return -1;
+
+    int fd = g_fn.open(path, O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0666);
+    if (fd == -1) return -1;
+
+    // Move it out of the way of the app, since it may be open for a while
+    int highfd = g_fn.fcntl(fd, F_DUPFD_CLOEXEC, DEFAULT_MIN_FD);
+    if (highfd != -1) {
+        g_fn.close(fd);
+        fd = highfd;
+    }
+
+    payfd_entry_t *entry = entryFind(cache, uid, dir);
+    if (!entry) entry = entryVictim(cache);
+    entryClose(cache, entry);
+
+    entry->uid = uid;
+    entry->dir = dir;
+    entry->fd = fd;
+    entry->used = ++cache->tick;
+    cache->count++;
+    return fd;
+}
+
+void
+payFdClose(payfd_t *cache, uint64_t uid)
+{
+    if (!cache) return;
+
+    unsigned i;
+    for (i = 0; i < cache->max; i++) {
+        payfd_entry_t *entry = &cache->entries[i];
+        if ((entry->fd != -1) && (entry->uid == uid)) {
+            entryClose(cache, entry);
+        }
+    }
+}
+
+void
+payFdCloseAll(payfd_t *cache)
+{
+    if (!cache) return;
+
+    unsigned i;
+    for (i = 0; i < cache->max; i++) {
+        entryClose(cache, &cache->entries[i]);
+    }
+}
+
+void
+payFdValidate(payfd_t *cache, pid_t pid, const char *dir)
+{
+    if (!cache) return;
+
+    if ((cache->pid == pid) && cache->dir && dir && !strcmp(cache->dir, dir)) {
+        return;
+    }
+
+    payFdCloseAll(cache);
+    if (cache->dir) free(cache->dir);
+    cache->dir = (dir) ? strdup(dir) : NULL;
+    cache->pid = pid;
+}
+
+unsigned
+payFdCount(payfd_t *cache)
+{
+    return (cache) ? cache->count : 0;
+}
@@ -0,0 +1,52 @@
+#ifndef __PAYFD_H__
+#define __PAYFD_H__
+#include <stdint.h>
+#include <unistd.h>
+
+/*
+ * A small LRU cache of the files that payloads are written to.
+ *
+ * Without it, every captured chunk costs an open and a close of the
+ * connection's payload file.  Entries are keyed by connection uid and
+ * direction, and stay open until the connection is closed (payFdClose)
+ * or the entry is evicted to make room for another.  The least recently
+ * used entry is the one evicted.
+ *
+ * Cached descriptors are moved above DEFAULT_MIN_FD, out of the range an
+ * app is likely to use, and are close on exec.
+ *
+ * A payfd_t is not thread safe; it is intended to be used from the
+ * periodic thread only.
+ */
+
+typedef enum {
+    PAYFD_IN,
+    PAYFD_OUT,
+    PAYFD_NA,
+} payfd_dir_t;
+
+typedef struct _payfd_t payfd_t;
+
+// Constructors Destructors
+payfd_t *   payFdCreate(unsigned);
+void        payFdDestroy(payfd_t **);
+
+// Returns the cached fd for (uid, dir), or -1 if there isn't one
+int         payFdGet(payfd_t *, uint64_t, payfd_dir_t);
+
+// Opens path for appending and caches the fd as (uid, dir).
+// Returns the fd, or -1 if the open failed.
+int         payFdOpen(payfd_t *, uint64_t, payfd_dir_t, const char *);
+
+// Closes the cached fds of every direction for the uid
+void        payFdClose(payfd_t *, uint64_t);
+void        payFdCloseAll(payfd_t *);
+
+// Closes everything if the pid or directory differ from the ones the
+// cached fds were opened for, e.g. after a fork or a config change.
+void        payFdValidate(payfd_t *, pid_t, const char *);
+
+// Accessors
+unsigned    payFdCount(payfd_t *);
+
+#endif // __PAYFD_H__
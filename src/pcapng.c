@@ -0,0 +1,502 @@
+#define _GNU_SOURCE
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <netinet/in.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "dbg.h"
+#include "fn.h"
+#include "linklist.h"
+#include "pcapng.h"
+#include "scopetypes.h"
+
+// Block types and constants from the pcapng spec
+#define PCAPNG_SHB_TYPE 0x0A0D0D0A
+#define PCAPNG_IDB_TYPE 0x00000001
+#define PCAPNG_EPB_TYPE 0x00000006
+#define PCAPNG_BYTE_ORDER_MAGIC 0x1A2B3C4D
+#define PCAPNG_LINKTYPE_RAW 101         // packets begin with an IP header
+
+#define PCAPNG_SHB_LEN 28
+#define PCAPNG_IDB_LEN 20
+#define PCAPNG_EPB_LEN 32               // not counting the packet data
+
+#define IPV4_HDR_LEN 20
+#define IPV6_HDR_LEN 40
+#define TCP_HDR_LEN 20
+#define UDP_HDR_LEN 8
+#define MAX_HDR_LEN (IPV6_HDR_LEN + TCP_HDR_LEN)
+
+// Payload per packet; keeps the IPv4 total length within 16 bits
+#define PCAPNG_MAX_SEG 65000
+
+#define PCAPNG_MIN_BUF (2 * (PCAPNG_EPB_LEN + MAX_HDR_LEN + PCAPNG_MAX_SEG))
+
+#define TCP_FLAG_PSH 0x08
+#define TCP_FLAG_ACK 0x10
+
+typedef struct {
+    uint32_t seq[2];    // next sequence number, indexed by pcapng_dir_t
+} pcapng_conn_t;
+
+// Addresses for one direction of a packet, in network byte order
+typedef struct {
+    int family;
+    uint8_t src[16];
+    uint8_t dst[16];
+    uint16_t sport;
+    uint16_t dport;
+} pcapng_addr_t;
+
+struct _pcapng_t
+{
+    char *buf;
+    size_t len;
+    size_t size;
+
+    int fd;
+    int section;        // TRUE once the section headers are buffered
+    list_t *conns;
+
+    // what the file was opened for
+    pid_t pid;
+    char *dir;
+};
+
+pcapng_t *
+pcapngCreate(size_t size)
+{
+    pcapng_t *pc = calloc(1, sizeof(*pc));
+    if (!pc) {
+        DBG(NULL);
+        return NULL;
+    }
+
+    if (size < PCAPNG_MIN_BUF) size = PCAPNG_MIN_BUF;
+    pc->buf = malloc(size);
+    pc->conns = lstCreate(free);
+    if (!pc->buf || !pc->conns) {
+        DBG("%zu", size);
+        if (pc->buf) free(pc->buf);
+        lstDestroy(&pc->conns);
+        free(pc);
+        return NULL;
+    }
+
+    pc->size = size;
+    pc->fd = -1;
+    return pc;
+}
+
+static void
+pcapngClose(pcapng_t *pc)
+{
+    if (pc->fd != -1) {
+        g_fn.close(pc->fd);
+        pc->fd = -1;
+    }
+    pc->section = FALSE;
+}
+
+void
+pcapngDestroy(pcapng_t **pc)
+{
+    if (!pc || !*pc) return;
+
+    pcapng_t *p = *pc;
+    pcapngFlush(p);
+    pcapngClose(p);
+    lstDestroy(&p->conns);
+    if (p->dir) free(p->dir);
+    free(p->buf);
+    free(p);
+    *pc = NULL;
+}
+
+static int
+pcapngOpen(pcapng_t *pc)
+{
+    if (pc->fd != -1) return 0;
+    if (!pc->dir) return -1;
+
+    char path[PATH_MAX];
+    if (snprintf(path, sizeof(path), "%s/%d.pcapng",
+                 pc->dir, pc->pid) >= sizeof(path)) {
+        DBG("%s", pc->dir);
+        return -1;
+    }
+
+    int fd = g_fn.open(path, O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0666);
+    if (fd == -1) return -1;
+
+    // Move it out of the way of the app, since it stays open
+    int highfd = g_fn.fcntl(fd, F_DUPFD_CLOEXEC, DEFAULT_MIN_FD);
+    if (highfd != -1) {
+        g_fn.close(fd);
+        fd = highfd;
+    }
+
+    pc->fd = fd;
+    return 0;
+}
+
+int
+pcapngFlush(pcapng_t *pc)
+{
+    if (!pc) return -1;
+    if (!pc->len) return 0;
+
+    if (pcapngOpen(pc) == -1) {
+        // Nothing to write to; drop what we have and start a new section
+        pc->len = 0;
+        pc->section = FALSE;
+        return -1;
+    }
+
+    size_t written = 0;
+    while (written < pc->len) {
+        ssize_t rc = g_fn.write(pc->fd, &pc->buf[written], pc->len - written);
+        if (rc <= 0) {
+            DBG(NULL);
+            pc->len = 0;
+            pcapngClose(pc);
+            return -1;
+        }
+        written += rc;
+    }
+
+    pc->len = 0;
+    return 0;
+}
+
+static void
+put16(char *p, uint16_t val)
+{
+    memcpy(p, &val, sizeof(val));
+}
+
+static void
+put32(char *p, uint32_t val)
+{
+    memcpy(p, &val, sizeof(val));
+}
+
+// Callers make room with makeRoom() first
+static char *
+reserve(pcapng_t *pc, size_t n)
+{
+    if (pc->len + n > pc->size) return NULL;
+    char *p = &pc->buf[pc->len];
+    pc->len += n;
+    return p;
+}
+
+// Section header and interface description blocks, in host byte order
+static int
+putSection(pcapng_t *pc)
+{
+    char *p = reserve(pc, PCAPNG_SHB_LEN + PCAPNG_IDB_LEN);
+    if (!p) return -1;
+
+    put32(p, PCAPNG_SHB_TYPE);
+    put32(p + 4, PCAPNG_SHB_LEN);
+    put32(p + 8, PCAPNG_BYTE_ORDER_MAGIC);
+    put16(p + 12, 1);                           // major version
+    put16(p + 14, 0);                           // minor version
+    memset(p + 16, 0xff, 8);                    // section length unknown
+    put32(p + 24, PCAPNG_SHB_LEN);
+    p += PCAPNG_SHB_LEN;
+
+    put32(p, PCAPNG_IDB_TYPE);
+    put32(p + 4, PCAPNG_IDB_LEN);
+    put16(p + 8, PCAPNG_LINKTYPE_RAW);
+    put16(p + 10, 0);                           // reserved
+    put32(p + 12, 0);                           // no snap length
+    put32(p + 16, PCAPNG_IDB_LEN);
+
+    pc->section = TRUE;
+    return 0;
+}
+
+// Flushes if n more bytes (plus the section headers if they're needed)
+// won't fit, then starts a section if there isn't one.
+static int
+makeRoom(pcapng_t *pc, size_t n)
+{
+    size_t need = n + ((pc->section) ? 0 : PCAPNG_SHB_LEN + PCAPNG_IDB_LEN);
+    if (pc->len + need > pc->size) pcapngFlush(pc);
+
+    // A failed flush drops the section, so check after
+    if (!pc->section && (putSection(pc) == -1)) return -1;
+    if (pc->len + n > pc->size) return -1;
+    return 0;
+}
+
+static int
+ipAddr(const struct sockaddr_storage *ss, int *family, uint8_t *addr, uint16_t *port)
+{
+    if (!ss) return -1;
+
+    if (ss->ss_family == AF_INET) {
+        const struct sockaddr_in *sin = (const struct sockaddr_in *)ss;
+        *family = AF_INET;
+        memcpy(addr, &sin->sin_addr, 4);
+        *port = sin->sin_port;
+        return 0;
+    }
+
+    if (ss->ss_family == AF_INET6) {
+        const struct sockaddr_in6 *sin6 = (const struct sockaddr_in6 *)ss;
+        if (IN6_IS_ADDR_V4MAPPED(&sin6->sin6_addr)) {
+            *family = AF_INET;
+            memcpy(addr, &sin6->sin6_addr.s6_addr[12], 4);
+        } else {
+            *family = AF_INET6;
+            memcpy(addr, &sin6->sin6_addr, 16);
+        }
+        *port = sin6->sin6_port;
+        return 0;
+    }
+
+    return -1;
+}
+
+static void
+pktAddr(const pcapng_pkt_t *pkt, pcapng_addr_t *addr)
+{
+    int lfamily, rfamily;
+    uint8_t laddr[16], raddr[16];
+    uint16_t lport, rport;
+
+    if ((ipAddr(pkt->local, &lfamily, laddr, &lport) == -1) ||
+        (ipAddr(pkt->remote, &rfamily, raddr, &rport) == -1) ||
+        (lfamily != rfamily)) {
+        // Not IP; make up loopback addresses that identify the connection
+        const uint8_t loopback[] = {127, 0, 0, 1};
+        lfamily = AF_INET;
+        memcpy(laddr, loopback, sizeof(loopback));
+        memcpy(raddr, loopback, sizeof(loopback));
+        raddr[3] = 2;
+        lport = rport = htons(1 + (pkt->uid % 65535));
+    }
+
+    addr->family = lfamily;
+    if (pkt->dir == PCAPNG_TX) {
+        memcpy(addr->src, laddr, sizeof(laddr));
+        memcpy(addr->dst, raddr, sizeof(raddr));
+        addr->sport = lport;
+        addr->dport = rport;
+    } else {
+        memcpy(addr->src, raddr, sizeof(raddr));
+        memcpy(addr->dst, laddr, sizeof(laddr));
+        addr->sport = rport;
+        addr->dport = lport;
+    }
+}
+
+static uint16_t
+ipv4Checksum(const uint8_t *hdr)
+{
+    uint32_t sum = 0;
+    int i;
+    for (i = 0; i < IPV4_HDR_LEN; i += 2) {
+        sum += (hdr[i] << 8) | hdr[i + 1];
+    }
+    while (sum >> 16) sum = (sum & 0xffff) + (sum >> 16);
+    return htons(~sum & 0xffff);
+}
+
+// Writes the IP header, returns its length
+static size_t
+putIpHdr(uint8_t *p, const pcapng_addr_t *addr, int proto, size_t len)
+{
+    if (addr->family == AF_INET) {
+        memset(p, 0, IPV4_HDR_LEN);
+        p[0] = 0x45;                            // version 4, 5 words
+        uint16_t totlen = htons(IPV4_HDR_LEN + len);
+        memcpy(p + 2, &totlen, 2);
+        p[6] = 0x40;                            // don't fragment
+        p[8] = 64;                              // ttl
+        p[9] = proto;
+        memcpy(p + 12, addr->src, 4);
+        memcpy(p + 16, addr->dst, 4);
+        uint16_t csum = ipv4Checksum(p);
+        memcpy(p + 10, &csum, 2);
+        return IPV4_HDR_LEN;
+    }
+
+    memset(p, 0, IPV6_HDR_LEN);
+    p[0] = 0x60;                                // version 6
+    uint16_t paylen = htons(len);
+    memcpy(p + 4, &paylen, 2);
+    p[6] = proto;
+    p[7] = 64;                                  // hop limit
+    memcpy(p + 8, addr->src, 16);
+    memcpy(p + 24, addr->dst, 16);
+    return IPV6_HDR_LEN;
+}
+
+static size_t
+putTcpHdr(uint8_t *p, const pcapng_addr_t *addr, uint32_t seq, uint32_t ack)
+{
+    memset(p, 0, TCP_HDR_LEN);
+    memcpy(p, &addr->sport, 2);
+    memcpy(p + 2, &addr->dport, 2);
+    seq = htonl(seq);
+    ack = htonl(ack);
+    memcpy(p + 4, &seq, 4);
+    memcpy(p + 8, &ack, 4);
+    p[12] = (TCP_HDR_LEN / 4) << 4;
+    p[13] = TCP_FLAG_PSH | TCP_FLAG_ACK;
+    p[14] = p[15] = 0xff;                       // window
+    return TCP_HDR_LEN;
+}
+
+static size_t
+putUdpHdr(uint8_t *p, const pcapng_addr_t *addr, size_t len)
+{
+    memset(p, 0, UDP_HDR_LEN);
+    memcpy(p, &addr->sport, 2);
+    memcpy(p + 2, &addr->dport, 2);
+    uint16_t udplen = htons(UDP_HDR_LEN + len);
+    memcpy(p + 4, &udplen, 2);
+    return UDP_HDR_LEN;
+}
+
+static int
+isDgram(int sock_type)
+{
+#ifdef SOCK_NONBLOCK
+    // socket() flags may be included in the type
+    sock_type &= ~(SOCK_NONBLOCK | SOCK_CLOEXEC);
+#endif
+    return (sock_type == SOCK_DGRAM);
+}
+
+static pcapng_conn_t *
+connFind(pcapng_t *pc, uint64_t uid)
+{
+    pcapng_conn_t *conn = lstFind(pc->conns, uid);
+    if (conn) return conn;
+
+    if (!(conn = malloc(sizeof(*conn)))) return NULL;
+    conn->seq[PCAPNG_TX] = conn->seq[PCAPNG_RX] = 1;
+    if (!lstInsert(pc->conns, uid, conn)) {
+        free(conn);
+        return NULL;
+    }
+    return conn;
+}
+
+// One enhanced packet block
+static int
+putPacket(pcapng_t *pc, const pcapng_pkt_t *pkt, const pcapng_addr_t *addr,
+          pcapng_conn_t *conn, const char *data, size_t len)
+{
+    uint8_t hdr[MAX_HDR_LEN];
+    size_t hlen;
+
+    int tcp = !isDgram(pkt->sock_type);
+    size_t l4len = (tcp) ? TCP_HDR_LEN : UDP_HDR_LEN;
+    hlen = putIpHdr(hdr, addr, (tcp) ? IPPROTO_TCP : IPPROTO_UDP, l4len + len);
+    if (tcp) {
+        pcapng_dir_t other = (pkt->dir == PCAPNG_TX) ? PCAPNG_RX : PCAPNG_TX;
+        uint32_t seq = (conn) ? conn->seq[pkt->dir] : 1;
+        uint32_t ack = (conn) ? conn->seq[other] : 1;
+        hlen += putTcpHdr(&hdr[hlen], addr, seq, ack);
+        if (conn) conn->seq[pkt->dir] += len;
+    } else {
+        hlen += putUdpHdr(&hdr[hlen], addr, len);
+    }
+
+    size_t caplen = hlen + len;
+    size_t padded = (caplen + 3) & ~3;
+    size_t blklen = PCAPNG_EPB_LEN + padded;
+
+    char *p = reserve(pc, blklen);
+    if (!p) return -1;
+
+    uint64_t usec = (uint64_t)pkt->ts.tv_sec * 1000000 + pkt->ts.tv_usec;
+    put32(p, PCAPNG_EPB_TYPE);
+    put32(p + 4, blklen);
+    put32(p + 8, 0);                            // interface id
+    put32(p + 12, usec >> 32);
+    put32(p + 16, usec & 0xffffffff);
+    put32(p + 20, caplen);
+    put32(p + 24, caplen);
+    memcpy(p + 28, hdr, hlen);
+    memcpy(p + 28 + hlen, data, len);
+    memset(p + 28 + caplen, 0, padded - caplen);
+    put32(p + 28 + padded, blklen);
+    return 0;
+}
+
+int
+pcapngWrite(pcapng_t *pc, const pcapng_pkt_t *pkt)
+{
+    if (!pc || !pkt || (!pkt->data && pkt->len)) return -1;
+
+    pcapng_addr_t addr;
+    pktAddr(pkt, &addr);
+
+    pcapng_conn_t *conn = NULL;
+    if (!isDgram(pkt->sock_type)) {
+        conn = connFind(pc, pkt->uid);
+    }
+
+    size_t off = 0;
+    do {
+        size_t seg = pkt->len - off;
+        if (seg > PCAPNG_MAX_SEG) seg = PCAPNG_MAX_SEG;
+
+        if (makeRoom(pc, PCAPNG_EPB_LEN + MAX_HDR_LEN + seg + 3) == -1) {
+            return -1;
+        }
+        if (putPacket(pc, pkt, &addr, conn, &pkt->data[off], seg) == -1) {
+            return -1;
+        }
+        off += seg;
+    } while (off < pkt->len);
+
+    return 0;
+}
+
+void
+pcapngConnClose(pcapng_t *pc, uint64_t uid)
+{
+    if (!pc) return;
+    lstDelete(pc->conns, uid);
+}
+
+void
+pcapngValidate(pcapng_t *pc, pid_t pid, const char *dir)
+{
+    if (!pc) return;
+
+    if ((pc->pid == pid) && pc->dir && dir && !strcmp(pc->dir, dir)) {
+        return;
+    }
+
+    if (pc->pid == pid) {
+        pcapngFlush(pc);
+    } else {
+        // Buffered packets and sequence numbers are the parent's
+        pc->len = 0;
+        lstDestroy(&pc->conns);
+        pc->conns = lstCreate(free);
+    }
+    pcapngClose(pc);
+
+    if (pc->dir) free(pc->dir);
+    pc->dir = (dir) ? strdup(dir) : NULL;
+    pc->pid = pid;
+}
+
+size_t
+pcapngBuffered(pcapng_t *pc)
+{
+    return (pc) ? pc->len : 0;
+}
@@ -0,0 +1,71 @@
+#ifndef __PCAPNG_H__
+#define __PCAPNG_H__
+#include <stdint.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+/*
+ * Writes captured payloads as a pcapng file, so they can be loaded
+ * directly by wireshark and friends.  There is one file per process:
+ *
+ *     <dir>/<pid>.pcapng
+ *
+ * Each payload is wrapped in synthesized IPv4 or IPv6 and TCP (or UDP)
+ * headers built from the connection's addresses.  TCP sequence and ack
+ * numbers are tracked per connection and direction, so streams can be
+ * followed and reassembled.  Checksums in the synthesized TCP and UDP
+ * headers are left as zero.  Endpoints that aren't IP (e.g. unix
+ * sockets) are recorded as 127.0.0.1 (local) and 127.0.0.2 (remote),
+ * with ports taken from the connection uid.
+ *
+ * Packets are accumulated in memory and written with large sequential
+ * writes, when the buffer fills or with pcapngFlush().  Every time the
+ * file is opened a new section (header and interface blocks) is started,
+ * which is valid pcapng even when appending to an existing file.
+ *
+ * A pcapng_t is not thread safe; it is intended to be used from the
+ * periodic thread only.
+ */
+
+typedef enum {
+    PCAPNG_TX,      // sent from local to remote
+    PCAPNG_RX,      // received by local from remote
+} pcapng_dir_t;
+
+typedef struct {
+    uint64_t uid;                       // identifies the connection
+    int sock_type;                      // SOCK_STREAM or SOCK_DGRAM
+    const struct sockaddr_storage *local;
+    const struct sockaddr_storage *remote;
+    pcapng_dir_t dir;
+    struct timeval ts;                  // when the data was captured
+    const char *data;
+    size_t len;
+} pcapng_pkt_t;
+
+typedef struct _pcapng_t pcapng_t;
+
+// Constructors Destructors
+pcapng_t *  pcapngCreate(size_t);           // arg is the buffer size
+void        pcapngDestroy(pcapng_t **);     // flushes anything buffered
+
+// Adds the packet(s) for one payload.  Payloads too big for one packet
+// are split across several.  Returns 0 on success, -1 on error.
+int         pcapngWrite(pcapng_t *, const pcapng_pkt_t *);
+
+// Writes out anything buffered.  Returns 0 on success, -1 on error.
+int         pcapngFlush(pcapng_t *);
+
+// Forgets the sequence numbers of a connection which has been closed
+void        pcapngConnClose(pcapng_t *, uint64_t);
+
+// Starts over if the pid or directory differ from the ones the file was
+// opened for.  A change of pid (a fork) discards anything buffered since
+// it belongs to the parent.  A change of directory flushes it first.
+void        pcapngValidate(pcapng_t *, pid_t, const char *);
+
+// Accessors
+size_t      pcapngBuffered(pcapng_t *);
+
+#endif // __PCAPNG_H__
@@ -1,5 +1,7 @@
 #define _GNU_SOURCE
 #include <limits.h>
+#include <stddef.h>
+#include <sys/time.h>
 #include "os.h"
 #include "plattime.h"
 
@@ -8,6 +10,9 @@
 
 platform_time_t g_time = {0};
 
+// Milliseconds since the epoch, or zero when not being kept current
+static volatile uint64_t g_wallclock_ms = 0;
+
 platform_time_t *
 initTime(void)
 {
@@ -15,3 +20,45 @@ initTime(void)
     return &g_time;
 }
 
+
+static uint64_t
+wallClockNowMs(void)
+{
+    struct timeval tv;
+    if (gettimeofday(&tv, NULL)) return 0ULL;
+    return ((uint64_t)tv.tv_sec * 1000ULL) + (tv.tv_usec / 1000);
+}
+
+void
+wallClockTick(void)
+{
+    uint64_t now = wallClockNowMs();
+    if (now) g_wallclock_ms = now;
+}
+
+void
+wallClockStop(void)
+{
+    g_wallclock_ms = 0ULL;
+}
+
+double
+wallClockSecs(void)
+{
+    uint64_t now = g_wallclock_ms;
+    if (!now) now = wallClockNowMs();
+    return (double)(now / 1000) + (double)(now % 1000)/1000;
+}
+
+double
+wallClockSecsAt(uint64_t tsc)
+{
+    double now = wallClockSecs();
+    if (!tsc || !g_time.freq) return now;
+
+    // Don't trust a TSC from the future (e.g. read on another cpu)
+    uint64_t tsc_now = getTime();
+    if (tsc >= tsc_now) return now;
+
+    return now - ((double)getDurationNow(tsc_now, tsc) / 1000000000);
+}
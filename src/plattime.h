@@ -13,6 +13,20 @@ typedef struct {
 
 platform_time_t* initTime(void);
 
+// A coarse wall clock, so that timestamping an event is a load rather
+// than a system call.  The periodic thread calls wallClockTick() each
+// time around its loop (about every millisecond); until it first does,
+// or after wallClockStop(), the readers fall back to gettimeofday().
+void   wallClockTick(void);
+void   wallClockStop(void);
+
+// Seconds since the epoch, with millisecond resolution
+double wallClockSecs(void);
+
+// The wall clock time when the TSC read getTime() returned the value
+// provided.  Falls back to wallClockSecs() if the TSC can't be converted.
+double wallClockSecsAt(uint64_t);
+
 
 // We haven't measured it, but there are concerns about performance
 // with calling getTime and getDuration as functions across modules.
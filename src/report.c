@@ -5,6 +5,7 @@
 #include <stdlib.h>
 #include <string.h>
 #include <sys/stat.h>
+#include <sys/uio.h>
 #include <time.h>
 #include <fcntl.h>
 
@@ -14,14 +15,17 @@
 #include "fn.h"
 #include "httpagg.h"
 #include "mtcformat.h"
+#include "payfd.h"
+#include "pcapng.h"
 #include "plattime.h"
 #include "report.h"
-#include "search.h"
 #include "state_private.h"
-#include "linklist.h"
+#include "hmap.h"
 #include "dns.h"
 #include "utils.h"
 #include "runtimecfg.h"
+#include "scrape.h"
+#include "urinorm.h"
 #include "cfg.h"
 
 #ifndef AF_NETLINK
@@ -72,6 +76,8 @@
 
 #define EVENT_ONLY_ATTR (CFG_MAX_VERBOSITY+1)
 #define HTTP_MAX_FIELDS 30
+#define HTTP_MAP_SIZE 8192      // in-flight requests, one per connection
+#define HTTP_MAP_MAX_AGE 300    // seconds a request waits for its response
 #define NET_MAX_FIELDS 16
 #define NUM_DYNS 4
 
@@ -92,12 +98,9 @@
 #define HTTP_NEXT_FLD(n) if (n < HTTP_MAX_FIELDS-1) {n++;}else{DBG(NULL);}
 #define NEXT_FLD(n, max) if (n < max-1) {n+=1;}else{DBG(NULL);}
 
-#define HTTP_STATUS "HTTP/1."
+#define HTTP_VERSION "HTTP/"
 
 typedef struct http_report_t {
-    char *hreq;
-    char *hres;
-    metric_t ptype;
     int ix;
     size_t clen;
     char rport[8];
@@ -110,9 +113,22 @@ typedef struct http_report_t {
 // and replace it with a measured value.  It'd be one less dependency
 // and could be more accurate.
 int g_interval = DEFAULT_SUMMARY_PERIOD;
-static list_t *g_maplist;
-static search_t *g_http_status = NULL;
+static hmap_t *g_http_map;
+static time_t g_http_map_expire;
 static http_agg_t *g_http_agg;
+static http_agg_t *g_http_scrape;     // never reset; created by doScrape()
+static urinorm_t *g_http_norm;        // for both of the above; can be NULL
+static payfd_t *g_payfd;
+static pcapng_t *g_pcapng;
+static time_t g_pcapng_flush;
+
+// The i'th oldest request waiting for a response
+static http_pending *
+httpPendingAt(http_map *map, int i)
+{
+    if (!map->ring) return &map->pending[(map->first + i) % HTTP_MAX_PENDING];
+    return &map->ring[(map->first + i) % map->size];
+}
 
 static void
 destroyHttpMap(void *data)
@@ -120,17 +136,60 @@ destroyHttpMap(void *data)
     if (!data) return;
     http_map *map = (http_map *)data;
 
-    if (map->req) free(map->req);
-    if (map->resp) free(map->resp);
+    int i;
+    for (i = 0; i < map->num; i++) {
+        http_pending *req = httpPendingAt(map, i);
+        if (req->req) free(req->req);
+    }
+    if (map->ring) free(map->ring);
     if (map) free(map);
 }
 
+// Responses come in the order their requests were sent (RFC 7230 6.3.2),
+// so a response is for the oldest request that's pending.  Returns NULL
+// when no more can wait; that request's response won't be matched, but
+// the ones before it still are.
+static http_pending *
+httpPendingPush(http_map *map)
+{
+    int size = (map->ring) ? map->size : HTTP_MAX_PENDING;
+    if (map->num == size) {
+        if (size >= HTTP_MAX_PIPELINED) return NULL;
+
+        http_pending *ring = malloc(2 * size * sizeof(http_pending));
+        if (!ring) return NULL;
+        int i;
+        for (i = 0; i < map->num; i++) {
+            ring[i] = *httpPendingAt(map, i);
+        }
+        if (map->ring) free(map->ring);
+        map->ring = ring;
+        map->size = 2 * size;
+        map->first = 0;
+    }
+    http_pending *req = httpPendingAt(map, map->num);
+    map->num++;
+    return req;
+}
+
+static void
+httpPendingPop(http_map *map)
+{
+    if (!map->num) return;
+    http_pending *oldest = httpPendingAt(map, 0);
+    if (oldest->req) free(oldest->req);
+    oldest->req = NULL;
+    map->first = (map->first + 1) % ((map->ring) ? map->size : HTTP_MAX_PENDING);
+    map->num--;
+}
+
 void
 initReporting()
 {
-    g_maplist = lstCreate(destroyHttpMap);
-    g_http_status = searchComp(HTTP_STATUS);
-    g_http_agg = httpAggCreate();
+    g_http_map = hmapCreate(HTTP_MAP_SIZE, destroyHttpMap);
+    g_http_agg = httpAggCreate(TRUE);
+    g_payfd = payFdCreate(DEFAULT_PAYLOAD_FD_CACHE);
+    g_pcapng = pcapngCreate(DEFAULT_PAYLOAD_PCAPNG_BUF);
 }
 
 void
@@ -139,6 +198,16 @@ setReportingInterval(int seconds)
     g_interval = seconds;
 }
 
+void
+setHttpNormalizer(unsigned enable, const char *templates)
+{
+    urinorm_t *old = g_http_norm;
+    g_http_norm = (enable) ? urinormCreate(templates) : NULL;
+    httpAggNormalizerSet(g_http_agg, g_http_norm);
+    httpAggNormalizerSet(g_http_scrape, g_http_norm);
+    urinormDestroy(&old);
+}
+
 static void
 sendEvent(mtc_t *mtc, event_t *event)
 {
@@ -302,24 +371,105 @@ getNetInternals(net_info *net, int type,
     return TRUE;
 }
 
-static size_t
-getHttpStatus(char *header, size_t len, char **stext)
+static void
+httpSpanSet(http_span *span, char *hdr, char *start, char *end)
+{
+    span->off = start - hdr;
+    span->len = end - start;
+}
+
+static const char *
+httpSpanStr(char *hdr, http_span *span)
+{
+    return (span->len) ? &hdr[span->off] : "";
+}
+
+/*
+ * Splits an http header up in place, in one pass.  Each piece is nul
+ * terminated where it ends (the SP or CR after it is overwritten), so
+ * event fields can point right at it.  The ':' after a field name is left
+ * alone, so that the whole line of a field can still be matched.
+ *
+ * Returns FALSE if the first line isn't a Request-Line or Status-Line.
+ * Fields past HTTP_MAX_HDRS, and any line that doesn't end in LF, are
+ * ignored.
+ */
+static bool
+httpTokenize(char *hdr, size_t len, http_tokens *tok)
 {
-    size_t ix;
-    size_t rc;
-    char *val;
+    if (!tok) return FALSE;
+    memset(tok, 0, sizeof(*tok));
+    if (!hdr || (len > UINT16_MAX)) return FALSE;
+
+    char *end = hdr + strnlen(hdr, len);
+    char *line = hdr;
+    char *eol;
+
+    while ((line < end) && ((eol = memchr(line, '\n', end - line)))) {
+        char *term = ((eol > line) && (eol[-1] == '\r')) ? eol - 1 : eol;
+
+        if (line == hdr) {
+            // Method SP Request-URI SP HTTP-Version
+            // HTTP-Version SP Status-Code SP Reason-Phrase
+            char *sp1 = memchr(line, ' ', term - line);
+            if (!sp1 || (sp1 == line)) return FALSE;
+            char *sp2 = memchr(sp1 + 1, ' ', term - sp1 - 1);
+            if (!sp2) sp2 = term;
+
+            httpSpanSet(&tok->line[0], hdr, line, sp1);
+            httpSpanSet(&tok->line[1], hdr, sp1 + 1, sp2);
+            httpSpanSet(&tok->line[2], hdr, (sp2 < term) ? sp2 + 1 : term, term);
+            *sp1 = '\0';
+            *sp2 = '\0';
+            *term = '\0';
+        } else if ((*line != ' ') && (*line != '\t') && (tok->num < HTTP_MAX_HDRS)) {
+            // field-name ":" OWS field-value OWS
+            char *colon = memchr(line, ':', term - line);
+            if (colon && (colon > line)) {
+                char *val = colon + 1;
+                while ((val < term) && ((*val == ' ') || (*val == '\t'))) val++;
+                char *val_end = term;
+                while ((val_end > val) && ((val_end[-1] == ' ') || (val_end[-1] == '\t'))) val_end--;
+
+                httpSpanSet(&tok->name[tok->num], hdr, line, colon);
+                httpSpanSet(&tok->value[tok->num], hdr, val, val_end);
+                *val_end = '\0';
+                tok->num++;
+            }
+        }
+
+        line = eol + 1;
+    }
 
-    // ex: HTTP/1.1 200 OK\r\n
-    if ((ix = searchExec(g_http_status, header, len)) == -1) return -1;
+    return TRUE;
+}
 
-    if ((ix < 0) || (ix > len) || ((ix + strlen(HTTP_STATUS) + 1) > len)) return -1;
+// From RFC 2616 Section 4.2 "Field names are case-insensitive."
+static bool
+httpNameIs(const char *name, size_t len, const char *str)
+{
+    return (strlen(str) == len) && !strncasecmp(name, str, len);
+}
 
-    val = &header[ix + strlen(HTTP_STATUS) + 1];
+// Returns the version after "HTTP/", or NULL
+static const char *
+httpFlavor(char *hdr, http_span *span)
+{
+    if ((span->len <= strlen(HTTP_VERSION)) ||
+        strncmp(&hdr[span->off], HTTP_VERSION, strlen(HTTP_VERSION))) {
+        return NULL;
+    }
+    return &hdr[span->off + strlen(HTTP_VERSION)];
+}
+
+static size_t
+httpStatus(char *hdr, http_span *span)
+{
     // note that the spec defines the status code to be exactly 3 chars/digits
-    *stext = &header[ix + strlen(HTTP_STATUS) + 6];
+    if (span->len != 3) return -1;
 
     errno = 0;
-    rc = strtoull(val, NULL, 0);
+    size_t rc = strtoull(&hdr[span->off], NULL, 10);
     if ((errno != 0) || (rc == 0)) {
         return -1;
     }
@@ -347,67 +497,52 @@ headerMatch(regex_t *re, const char *match)
 
 static bool
 httpFields(event_field_t *fields, http_report *hreport, char *hdr,
-           size_t hdr_len, protocol_info *proto, config_t *cfg)
+           http_tokens *tok, protocol_info *proto, config_t *cfg)
 {
-    if (!fields || !hreport || !proto || !hdr) return FALSE;
+    if (!fields || !hreport || !proto || !hdr || !tok) return FALSE;
 
-    // Start with fields from the header
-    char *savea = NULL, *header;
-    size_t numExtracts;
+    size_t numExtracts = cfgEvtFormatNumHeaders(cfg);
 
     hreport->clen = -1;
 
-    if ((hreport->ptype == EVT_HREQ) && (hreport->hreq)) {
-        strncpy(hreport->hreq, hdr, hdr_len);
-        header = hreport->hreq;
-    } else if ((hreport->ptype == EVT_HRES) && (hreport->hres)) {
-        strncpy(hreport->hres, hdr, hdr_len);
-        header = hreport->hres;
-    } else {
-        scopeLog("WARN: httpFields: proto ptype is not req or resp", proto->fd, CFG_LOG_WARN);
-        return FALSE;
-    }
-
-    char *thishdr = strtok_r(header, "\r\n", &savea);
-    if (!thishdr) {
-        scopeLog("WARN: httpFields: parse an http header", proto->fd, CFG_LOG_WARN);
-        return FALSE;
-    }
+    int i;
+    for (i = 0; i < tok->num; i++) {
+        char *name = &hdr[tok->name[i].off];
+        size_t nlen = tok->name[i].len;
+        char *value = &hdr[tok->value[i].off];
 
-    while ((thishdr = strtok_r(NULL, "\r\n", &savea)) != NULL) {
-        // From RFC 2616 Section 4.2 "Field names are case-insensitive."
-        if (strcasestr(thishdr, "Host:")) {
-            H_ATTRIB(fields[hreport->ix], "http_host", strchr(thishdr, ':') + 2, 1);
+        if (httpNameIs(name, nlen, "Host")) {
+            H_ATTRIB(fields[hreport->ix], "http_host", value, 1);
             HTTP_NEXT_FLD(hreport->ix);
-        } else if (strcasestr(thishdr, "User-Agent:")) {
-            H_ATTRIB(fields[hreport->ix], "http_user_agent", strchr(thishdr, ':') + 2, 5);
+        } else if (httpNameIs(name, nlen, "User-Agent")) {
+            H_ATTRIB(fields[hreport->ix], "http_user_agent", value, 5);
             HTTP_NEXT_FLD(hreport->ix);
-        } else if (strcasestr(thishdr, "X-Forwarded-For:")) {
-            H_ATTRIB(fields[hreport->ix], "http_client_ip", strchr(thishdr, ':') + 2, 5);
+        } else if (httpNameIs(name, nlen, "X-Forwarded-For")) {
+            H_ATTRIB(fields[hreport->ix], "http_client_ip", value, 5);
             HTTP_NEXT_FLD(hreport->ix);
-        } else if (strcasestr(thishdr, "Content-Length:")) {
+        } else if (httpNameIs(name, nlen, "Content-Length")) {
             errno = 0;
-            if (((hreport->clen = strtoull(strchr(thishdr, ':') + 2, NULL, 0)) == 0) || (errno != 0)) {
+            if (((hreport->clen = strtoull(value, NULL, 0)) == 0) || (errno != 0)) {
                 hreport->clen = -1;
             }
-        } else if (strcasestr(thishdr, "x-appscope:")) {
-                H_ATTRIB(fields[hreport->ix], "x-appscope", strchr(thishdr, ':') + 2, 5);
-                HTTP_NEXT_FLD(hreport->ix);
-        } else if ((numExtracts = cfgEvtFormatNumHeaders(cfg)) > 0) {
-            int i;
+        } else if (httpNameIs(name, nlen, "x-appscope")) {
+            H_ATTRIB(fields[hreport->ix], "x-appscope", value, 5);
+            HTTP_NEXT_FLD(hreport->ix);
+        } else if (numExtracts > 0) {
+            // The configured patterns see the whole line, "name: value".
+            // A name that's been extracted before was nul terminated.
+            name[nlen] = ':';
 
-            for (i = 0; i < numExtracts; i++) {
+            int j;
+            for (j = 0; j < numExtracts; j++) {
                 regex_t *re;
 
-                if (((re = cfgEvtFormatHeaderRe(cfg, i)) != NULL) &&
-                    (headerMatch(re, thishdr) == TRUE)) {
-                    char *evsrc = strchr(thishdr, ':');
-
-                    if (evsrc) {
-                        *evsrc = '\0';
-                        H_ATTRIB(fields[hreport->ix], thishdr, evsrc + 2, 5);
-                        HTTP_NEXT_FLD(hreport->ix);
-                    }
+                if (((re = cfgEvtFormatHeaderRe(cfg, j)) != NULL) &&
+                    (headerMatch(re, name) == TRUE)) {
+                    name[nlen] = '\0';
+                    H_ATTRIB(fields[hreport->ix], name, value, 5);
+                    HTTP_NEXT_FLD(hreport->ix);
+                    break;
                 }
             }
         }
@@ -451,6 +586,15 @@ httpFieldsInternal(event_field_t *fields, http_report *hreport, protocol_info *p
     return TRUE;
 }
 
+// A request and its response are matched up by connection, and for
+// HTTP/2, by stream too.  The pair doesn't fit in a key, so it's mixed
+// into one, and the map remembers the pair to catch the rare collision.
+static uint64_t
+httpMapKey(http_post *post)
+{
+    return post->id ^ (post->stream * 0x9e3779b97f4a7c15ULL);
+}
+
 static void
 doHttpHeader(protocol_info *proto)
 {
@@ -464,31 +608,37 @@ doHttpHeader(protocol_info *proto)
     http_report hreport;
     http_post *post = (http_post *)proto->data;
     http_map *map;
+    uint64_t key = httpMapKey(post);
 
-    if ((map = lstFind(g_maplist, post->id)) == NULL) {
+    if ((map = hmapFind(g_http_map, key)) == NULL) {
         // lazy open
         if ((map = calloc(1, sizeof(http_map))) == NULL) {
             destroyProto(proto);
             return;
         }
 
-        if (lstInsert(g_maplist, post->id, map) == FALSE) {
+        if (hmapInsert(g_http_map, key, map) == FALSE) {
+            // e.g. too many requests waiting for responses
             destroyHttpMap(map);
+            if (post->hdr) free(post->hdr);
             destroyProto(proto);
             return;
         }
 
         map->id = post->id;
+        map->stream = post->stream;
         map->first_time = time(NULL);
-        map->req = NULL;
-        map->req_len = 0;
+    } else if ((map->id != post->id) || (map->stream != post->stream)) {
+        // Another connection's key; leave its requests alone
+        DBG("%lu:%u %lu:%u", map->id, map->stream, post->id, post->stream);
+        if (post->hdr) free(post->hdr);
+        destroyProto(proto);
+        return;
     }
 
     map->frequency++;
     ssl = (post->ssl) ? "https" : "http";
     hreport.ix = 0;
-    hreport.hreq = NULL;
-    hreport.hres = NULL;
 
  /*
      * RFC 2616 Section 5 Request
@@ -498,50 +648,43 @@ doHttpHeader(protocol_info *proto)
      *
      *  Request-Line   = Method SP Request-URI SP HTTP-Version CRLF
      */
+    http_pending *req = NULL;
+    http_pending untracked = {0};
     if (proto->ptype == EVT_HREQ) {
-        map->start_time = post->start_duration;
-        map->req = (char *)post->hdr;
-        map->req_len = proto->len;
+        // One that can't wait is still reported
+        if ((req = httpPendingPush(map)) == NULL) req = &untracked;
+        req->start_time = post->start_duration;
+        req->req = (char *)post->hdr;
+        req->req_len = proto->len;
+        req->clen = -1;
+        if (!httpTokenize(req->req, req->req_len, &req->req_tok)) {
+            scopeLog("WARN: doHttpHeader: parse an http request header", proto->fd, CFG_LOG_WARN);
+        }
+    } else if (map->num) {
+        req = httpPendingAt(map, 0);
     }
 
-    char header[map->req_len];
     // we're either building a new req or we have a previous req
-    if (map->req) {
-        if ((hreport.hreq = calloc(1, map->req_len)) == NULL) {
-            scopeLog("ERROR: doHttpHeader: hreq memory allocation failure", proto->fd, CFG_LOG_ERROR);
-            return;
-        }
-
-        char *savea = NULL;
-        strncpy(header, map->req, map->req_len);
-
-        char *headertok = strtok_r(header, "\r\n", &savea);
-        if (!headertok) {
-            scopeLog("WARN: doHttpHeader: parse an http request header", proto->fd, CFG_LOG_WARN);
-            return;
-        }
+    if (req) {
+        http_tokens *tok = &req->req_tok;
 
         // The request specific values from Request-Line
-        char *method_str = strtok_r(headertok, " ", &savea);
-        if (method_str) {
-            H_ATTRIB(fields[hreport.ix], "http_method", method_str, 1);
+        if (tok->line[0].len) {
+            H_ATTRIB(fields[hreport.ix], "http_method", httpSpanStr(req->req, &tok->line[0]), 1);
             HTTP_NEXT_FLD(hreport.ix);
         } else {
             scopeLog("WARN: doHttpHeader: no method in an http request header", proto->fd, CFG_LOG_WARN);
         }
 
-        char *target_str = strtok_r(NULL, " ", &savea);
-        if (target_str) {
-            H_ATTRIB(fields[hreport.ix], "http_target", target_str, 4);
+        if (tok->line[1].len) {
+            H_ATTRIB(fields[hreport.ix], "http_target", httpSpanStr(req->req, &tok->line[1]), 4);
             HTTP_NEXT_FLD(hreport.ix);
         } else {
             scopeLog("WARN: doHttpHeader: no target in an http request header", proto->fd, CFG_LOG_WARN);
         }
 
-        char *flavor_str = strtok_r(NULL, " ", &savea);
-        if (flavor_str &&
-            ((flavor_str = strtok_r(flavor_str, "/", &savea))) &&
-            ((flavor_str = strtok_r(NULL, "\r", &savea)))) {
+        const char *flavor_str = httpFlavor(req->req, &tok->line[2]);
+        if (flavor_str) {
             if (proto->ptype == EVT_HREQ) {
                 H_ATTRIB(fields[hreport.ix], "http_flavor", flavor_str, 1);
                 HTTP_NEXT_FLD(hreport.ix);
@@ -554,20 +697,20 @@ doHttpHeader(protocol_info *proto)
         HTTP_NEXT_FLD(hreport.ix);
 
         if (proto->ptype == EVT_HREQ) {
-            hreport.ptype = EVT_HREQ;
             // Fields common to request & response
-            httpFields(fields, &hreport, map->req, map->req_len, proto, g_cfg.staticfg);
+            httpFields(fields, &hreport, req->req, tok, proto, g_cfg.staticfg);
             httpFieldsInternal(fields, &hreport, proto);
 
             if (hreport.clen != -1) {
                 H_VALUE(fields[hreport.ix], "http_request_content_length", hreport.clen, EVENT_ONLY_ATTR);
                 HTTP_NEXT_FLD(hreport.ix);
             }
-            map->clen = hreport.clen;
+            req->clen = hreport.clen;
 
             httpFieldEnd(fields, &hreport);
 
             event_t sendEvent = INT_EVENT("http-req", proto->len, SET, fields);
+            sendEvent.captured = proto->captured;
             cmdSendHttp(g_ctl, &sendEvent, map->id, &g_proc);
         }
     }
@@ -586,72 +729,62 @@ doHttpHeader(protocol_info *proto)
     * Status-Line = HTTP-Version SP Status-Code SP Reason-Phrase CRLF
     */
     if (proto->ptype == EVT_HRES) {
-        if ((hreport.hres = calloc(1, proto->len)) == NULL) {
-            scopeLog("ERROR: doHttpHeader: hres memory allocation failure", proto->fd, CFG_LOG_ERROR);
-            return;
-        }
-
         int rps = map->frequency;
         int sec = (map->first_time > 0) ? (int)time(NULL) - map->first_time : 1;
         if (sec > 0) {
             rps = map->frequency / sec;
         }
 
-        map->resp = (char *)post->hdr;
+        char *resp = (char *)post->hdr;
 
-        if (!map->req) {
+        if (!req) {
             map->duration = 0;
         } else {
-            map->duration = getDurationNow(post->start_duration, map->start_time);
+            map->duration = getDurationNow(post->start_duration, req->start_time);
             map->duration = map->duration / 1000000;
         }
 
-        char *stext;
-        size_t status = getHttpStatus((char *)map->resp, proto->len, &stext);
+        http_tokens rtok;
+        if (!httpTokenize(resp, proto->len, &rtok)) {
+            scopeLog("WARN: doHttpHeader: parse an http response header", proto->fd, CFG_LOG_WARN);
+        }
 
         // The response specific values from Status-Line
-        char *savea;
-        char reqheader[proto->len];
-        strncpy(reqheader, map->resp, proto->len);
-
-        char *headertok = strtok_r(reqheader, "\r\n", &savea);
-        char *flavor_str = strtok_r(headertok, " ", &savea);
-        if (flavor_str &&
-            ((flavor_str = strtok_r(flavor_str, "/", &savea))) &&
-            ((flavor_str = strtok_r(NULL, "", &savea)))) {
+        const char *flavor_str = httpFlavor(resp, &rtok.line[0]);
+        if (flavor_str) {
             H_ATTRIB(fields[hreport.ix], "http_flavor", flavor_str, 1);
             HTTP_NEXT_FLD(hreport.ix);
         } else {
-            scopeLog("WARN: doHttpHeader: no version string in an http request header", proto->fd, CFG_LOG_WARN);
+            scopeLog("WARN: doHttpHeader: no version string in an http response header", proto->fd, CFG_LOG_WARN);
         }
 
+        size_t status = httpStatus(resp, &rtok.line[1]);
         H_VALUE(fields[hreport.ix], "http_status_code", status, 1);
         HTTP_NEXT_FLD(hreport.ix);
 
-        // point past the status code
-        char st[strlen(stext)];
-        strncpy(st, stext, strlen(stext));
-        char *status_str = strtok_r(st, "\r", &savea);
-        H_ATTRIB(fields[hreport.ix], "http_status_text", status_str, 1);
+        H_ATTRIB(fields[hreport.ix], "http_status_text", httpSpanStr(resp, &rtok.line[2]), 1);
         HTTP_NEXT_FLD(hreport.ix);
 
         H_VALUE(fields[hreport.ix], "http_server_duration", map->duration, EVENT_ONLY_ATTR);
         HTTP_NEXT_FLD(hreport.ix);
 
         // Fields common to request & response
-        if (map->req) {
-            hreport.ptype = EVT_HREQ;
-            httpFields(fields, &hreport, map->req, map->req_len, proto, g_cfg.staticfg);
+        size_t req_clen = -1;
+        if (req) {
+            httpFields(fields, &hreport, req->req, &req->req_tok, proto, g_cfg.staticfg);
             if (hreport.clen != -1) {
                 H_VALUE(fields[hreport.ix], "http_request_content_length", hreport.clen, EVENT_ONLY_ATTR);
                 HTTP_NEXT_FLD(hreport.ix);
             }
-            map->clen = hreport.clen;
+            req_clen = hreport.clen;
         }
 
-        hreport.ptype = EVT_HRES;
-        httpFields(fields, &hreport, map->resp, proto->len, proto, g_cfg.staticfg);
+        httpFields(fields, &hreport, resp, &rtok, proto, g_cfg.staticfg);
         httpFieldsInternal(fields, &hreport, proto);
+        // A chunked body has no Content-Length, but may have been measured
+        if ((hreport.clen == -1) && post->clen && (post->clen != -1)) {
+            hreport.clen = post->clen;
+        }
         if (hreport.clen != -1) {
             H_VALUE(fields[hreport.ix], "http_response_content_length", hreport.clen, EVENT_ONLY_ATTR);
             HTTP_NEXT_FLD(hreport.ix);
@@ -660,6 +793,7 @@ doHttpHeader(protocol_info *proto)
         httpFieldEnd(fields, &hreport);
 
         event_t hevent = INT_EVENT("http-resp", proto->len, SET, fields);
+        hevent.captured = proto->captured;
         cmdSendHttp(g_ctl, &hevent, map->id, &g_proc);
 
         // Are we doing a metric event?
@@ -675,19 +809,21 @@ doHttpHeader(protocol_info *proto)
         };
 
         event_t mevent = INT_EVENT("http-metrics", proto->len, SET, mfields);
+        mevent.captured = proto->captured;
         cmdSendHttp(g_ctl, &mevent, map->id, &g_proc);
 
+        char *mtx_name = (proto->isServer) ? "http_server_duration" : "http_client_duration";
+        event_t http_dur = INT_EVENT(mtx_name, map->duration, DELTA, fields);
+
         // emit statsd metrics, if enabled.
         if (mtcEnabled(g_mtc)) {
 
-            char *mtx_name = (proto->isServer) ? "http_server_duration" : "http_client_duration";
-            event_t http_dur = INT_EVENT(mtx_name, map->duration, DELTA, fields);
             // TBD AGG Only cmdSendMetric(g_mtc, &http_dur);
-            httpAggAddMetric(g_http_agg, &http_dur, map->clen, hreport.clen);
+            httpAggAddMetric(g_http_agg, &http_dur, req_clen, hreport.clen);
 
             /* TBD AGG Only
-            if (map->clen != -1) {
-                event_t http_req_len = INT_EVENT("http.request.content_length", map->clen, DELTA, fields);
+            if (req_clen != -1) {
+                event_t http_req_len = INT_EVENT("http.request.content_length", req_clen, DELTA, fields);
                 cmdSendMetric(g_mtc, &http_req_len);
             }
 
@@ -699,12 +835,19 @@ doHttpHeader(protocol_info *proto)
 
         }
 
-        // Done; we remove the list entry; complete when reported
-        if (lstDelete(g_maplist, post->id) == FALSE) DBG(NULL);
+        // Scrapes report totals, so this one is never reset
+        if (g_http_scrape) {
+            httpAggAddMetric(g_http_scrape, &http_dur, req_clen, hreport.clen);
+        }
+
+        // Done with the request this answered; when no more are
+        // waiting, we remove the list entry
+        free(resp);
+        httpPendingPop(map);
+        if (!map->num && (hmapDelete(g_http_map, key) == FALSE)) DBG(NULL);
     }
 
-    if (hreport.hreq) free(hreport.hreq);
-    if (hreport.hres) free(hreport.hres);
+    if (untracked.req) free(untracked.req);
     destroyProto(proto);
 }
 
@@ -731,6 +874,7 @@ doDetection(protocol_info *proto)
     };
 
     event_t evt = INT_EVENT("remote_protocol", proto->fd, SET, fields);
+    evt.captured = proto->captured;
     cmdSendEvent(g_ctl, &evt, proto->uid, &g_proc);
     destroyProto(proto);
 }
@@ -761,6 +905,7 @@ addToInterfaceCounts(counters_element_t* value, uint64_t x)
     if (!value) return;
     atomicAddU64(&value->mtc, x);
     atomicAddU64(&value->evt, x);
+    atomicAddU64(&value->total, x);
 }
 
 void
@@ -945,6 +1090,7 @@ doDNSMetricName(metric_t type, net_info *net)
                     FIELDEND
                 };
                 event_t dnsMetric = INT_EVENT("net.dns.resp", ctrs->numDNS.evt, DELTA, resp);
+                dnsMetric.captured = net->captured;
                 cmdSendEvent(g_ctl, &dnsMetric, getTime(), &g_proc);
 
                 // This creates a DNS event
@@ -956,6 +1102,7 @@ doDNSMetricName(metric_t type, net_info *net)
                 event_t dnsEvent = INT_EVENT("net.dns.resp", ctrs->numDNS.evt, DELTA, evfield);
                 dnsEvent.src = CFG_SRC_DNS;
                 dnsEvent.data = net->dnsAnswer;
+                dnsEvent.captured = net->captured;
                 cmdSendEvent(g_ctl, &dnsEvent, getTime(), &g_proc);
             } else {
                 // This create a DNS raw event
@@ -968,6 +1115,7 @@ doDNSMetricName(metric_t type, net_info *net)
                     FIELDEND
                 };
                 event_t dnsMetric = INT_EVENT("net.dns.req", ctrs->numDNS.evt, DELTA, req);
+                dnsMetric.captured = net->captured;
                 cmdSendEvent(g_ctl, &dnsMetric, getTime(), &g_proc);
 
                 // This creates a DNS event
@@ -977,6 +1125,7 @@ doDNSMetricName(metric_t type, net_info *net)
                 };
                 event_t dnsEvent = INT_EVENT("net.dns.req", ctrs->numDNS.evt, DELTA, evfield);
                 dnsEvent.src = CFG_SRC_DNS;
+                dnsEvent.captured = net->captured;
                 cmdSendEvent(g_ctl, &dnsEvent, getTime(), &g_proc);
             }
         }
@@ -1010,6 +1159,8 @@ doDNSMetricName(metric_t type, net_info *net)
         addToInterfaceCounts(&ctrs->dnsDurationNum, 1);
         atomicAddU64(&ctrs->dnsDurationTotal.mtc, duration->mtc);
         atomicAddU64(&ctrs->dnsDurationTotal.evt, duration->evt);
+        atomicAddU64(&ctrs->dnsDurationTotal.total, duration->mtc);
+        histoRecord(&g_histos.dns, duration->mtc);
 
         uint64_t dur = 0ULL;
         int cachedDurationNum = ctrs->dnsDurationNum.evt; // avoid div by zero
@@ -1033,6 +1184,7 @@ doDNSMetricName(metric_t type, net_info *net)
             };
 
             event_t dnsDurMetric = INT_EVENT("net.dns.duration", dur, DELTA_MS, fields);
+            dnsDurMetric.captured = net->captured;
             cmdSendEvent(g_ctl, &dnsDurMetric, getTime(), &g_proc);
             atomicSwapU64(&ctrs->dnsDurationNum.evt, 0);
             atomicSwapU64(&ctrs->dnsDurationTotal.evt, 0);
@@ -1180,6 +1332,43 @@ doProcMetric(metric_t type, long long measurement)
     }
 }
 
+void
+doEvtSpillMetric(void)
+{
+    if (!ctlSpillEnabled(g_ctl)) return;
+
+    spill_counters_t ctrs;
+    ctlSpillCounters(g_ctl, &ctrs);
+
+    struct {
+        const char *name;
+        uint64_t value;
+    } *m, spill_mtc[] = {
+        {"evt.spilled",         ctrs.spilled},
+        {"evt.replayed",        ctrs.replayed},
+        {"evt.spill_dropped",   ctrs.dropped},
+        {NULL,                  0}
+    };
+
+    for (m = spill_mtc; m->name; m++) {
+        // Don't report zeros.
+        if (m->value == 0) continue;
+
+        event_field_t fields[] = {
+            PROC_FIELD(g_proc.procname),
+            PID_FIELD(g_proc.pid),
+            HOST_FIELD(g_proc.hostname),
+            UNIT_FIELD("event"),
+            CLASS_FIELD("summary"),
+            FIELDEND
+        };
+        event_t evt = INT_EVENT(m->name, m->value, DELTA, fields);
+        if (cmdSendMetric(g_mtc, &evt)) {
+            scopeLog("ERROR: doEvtSpillMetric:cmdSendMetric", -1, CFG_LOG_ERROR);
+        }
+    }
+}
+
 void
 doStatMetric(const char *op, const char *pathname, void* ctr)
 {
@@ -1308,6 +1497,7 @@ doNetOpenEvent(net_info *net)
 
     event_t evt = INT_EVENT(metric, g_ctrs.openPorts.evt, CURRENT, nevent);
     evt.src = CFG_SRC_NET;
+    evt.captured = net->captured;
     cmdSendEvent(g_ctl, &evt, net->uid, &g_proc);
 }
 
@@ -1387,6 +1577,7 @@ doNetCloseEvent(net_info *net, uint64_t dur)
 
     event_t evt = INT_EVENT(metric, g_ctrs.openPorts.evt, CURRENT, nevent);
     evt.src = CFG_SRC_NET;
+    evt.captured = net->captured;
     cmdSendEvent(g_ctl, &evt, net->uid, &g_proc);
 }
 
@@ -1458,6 +1649,7 @@ doFSOpenEvent(fs_info *fs, const char *op)
 
         event_t evt = INT_EVENT(metric, numops->evt, DELTA, fevent);
         evt.src = CFG_SRC_FS;
+        evt.captured = fs->captured;
         cmdSendEvent(g_ctl, &evt, fs->uid, &g_proc);
     }
 }
@@ -1490,6 +1682,7 @@ doFSCloseEvent(fs_info *fs, const char *op)
 
         event_t evt = INT_EVENT(metric, fs->numClose.evt, DELTA, fevent);
         evt.src = CFG_SRC_FS;
+        evt.captured = fs->captured;
         cmdSendEvent(g_ctl, &evt, fs->uid, &g_proc);
     }
 }
@@ -1526,6 +1719,7 @@ doFSMetric(metric_t type, fs_info *fs, control_type_t source,
             };
 
             event_t evt = INT_EVENT("fs.duration", dur, HISTOGRAM, fields);
+            evt.captured = fs->captured;
             cmdSendEvent(g_ctl, &evt, fs->uid, &g_proc);
             //atomicSwapU64(&fs->numDuration.evt, 0);
             //atomicSwapU64(&fs->totalDuration.evt, 0);
@@ -1615,6 +1809,7 @@ doFSMetric(metric_t type, fs_info *fs, control_type_t source,
             };
 
             event_t rwMetric = INT_EVENT(metric, sizebytes->evt, HISTOGRAM, fields);
+            rwMetric.captured = fs->captured;
             cmdSendEvent(g_ctl, &rwMetric, fs->uid, &g_proc);
             //atomicSwapU64(&numops->evt, 0);
             //atomicSwapU64(&sizebytes->evt, 0);
@@ -1703,6 +1898,7 @@ doFSMetric(metric_t type, fs_info *fs, control_type_t source,
         // Don't report zeros.
         if (ctlEvtSourceEnabled(g_ctl, CFG_SRC_METRIC) && (numops->evt != 0ULL)) {
             event_t evt = INT_EVENT(metric, numops->evt, DELTA, fields);
+            evt.captured = fs->captured;
             cmdSendEvent(g_ctl, &evt, fs->uid, &g_proc);
             reported = TRUE;
         }
@@ -1912,12 +2108,49 @@ doTotal(metric_t type)
     if (aggregation_type != CURRENT) atomicSwapU64(&value->mtc, 0);
 }
 
+// Sends the percentiles of what histo recorded since it was last taken.
+// names are for the p50, p90, p99 and max.  factor scales the recorded
+// values to units.
+static void
+doDurationQuantiles(histo_t *histo, const char *names[4], const char *units,
+                    uint64_t factor, const char *err_str)
+{
+    histo_t taken;
+    histoTake(histo, &taken);
+    if (!histoCount(&taken)) return;
+
+    uint64_t quantile[] = {
+        histoQuantile(&taken, 0.50),
+        histoQuantile(&taken, 0.90),
+        histoQuantile(&taken, 0.99),
+        histoMax(&taken),
+    };
+
+    int i;
+    for (i = 0; i < sizeof(quantile) / sizeof(quantile[0]); i++) {
+        event_field_t fields[] = {
+            PROC_FIELD(g_proc.procname),
+            PID_FIELD(g_proc.pid),
+            HOST_FIELD(g_proc.hostname),
+            UNIT_FIELD(units),
+            CLASS_FIELD("summary"),
+            FIELDEND
+        };
+        event_t evt = INT_EVENT(names[i], quantile[i] / factor, CURRENT, fields);
+        if (cmdSendMetric(g_mtc, &evt)) {
+            scopeLog(err_str, -1, CFG_LOG_ERROR);
+        }
+    }
+}
+
 void
 doTotalDuration(metric_t type)
 {
     const char* metric = "UNKNOWN";
     counters_element_t* value = NULL;
     counters_element_t* num = NULL;
+    histo_t* histo = NULL;
+    const char* quantile_names[4] = {NULL};
     data_type_t aggregation_type = DELTA_MS;
     const char* units = "UNKNOWN";
     uint64_t factor = 1ULL;
@@ -1927,6 +2160,11 @@ doTotalDuration(metric_t type)
             metric = "fs.duration";
             value = &g_ctrs.fsDurationTotal;
             num = &g_ctrs.fsDurationNum;
+            histo = &g_histos.fs;
+            quantile_names[0] = "fs.duration.p50";
+            quantile_names[1] = "fs.duration.p90";
+            quantile_names[2] = "fs.duration.p99";
+            quantile_names[3] = "fs.duration.max";
             aggregation_type = HISTOGRAM;
             units = "microsecond";
             factor = 1000;
@@ -1936,6 +2174,11 @@ doTotalDuration(metric_t type)
             metric = "net.conn_duration";
             value = &g_ctrs.connDurationTotal;
             num = &g_ctrs.connDurationNum;
+            histo = &g_histos.conn;
+            quantile_names[0] = "net.conn_duration.p50";
+            quantile_names[1] = "net.conn_duration.p90";
+            quantile_names[2] = "net.conn_duration.p99";
+            quantile_names[3] = "net.conn_duration.max";
             aggregation_type = DELTA_MS;
             units = "millisecond";
             factor = 1000000;
@@ -1945,6 +2188,11 @@ doTotalDuration(metric_t type)
             metric = "net.dns.duration";
             value = &g_ctrs.dnsDurationTotal;
             num = &g_ctrs.dnsDurationNum;
+            histo = &g_histos.dns;
+            quantile_names[0] = "net.dns.duration.p50";
+            quantile_names[1] = "net.dns.duration.p90";
+            quantile_names[2] = "net.dns.duration.p99";
+            quantile_names[3] = "net.dns.duration.max";
             aggregation_type = DELTA_MS;
             units = "millisecond";
             factor = 1000000;
@@ -1955,6 +2203,8 @@ doTotalDuration(metric_t type)
             return;
     }
 
+    doDurationQuantiles(histo, quantile_names, units, factor, err_str);
+
     uint64_t dur = 0ULL;
     int cachedDurationNum = num->mtc; // avoid div by zero
     if (cachedDurationNum >= 1) {
@@ -2043,6 +2293,7 @@ doNetMetric(metric_t type, net_info *net, control_type_t source, ssize_t size)
 
         {
             event_t evt = INT_EVENT(metric, value->evt, CURRENT, fields);
+            evt.captured = net->captured;
             cmdSendEvent(g_ctl, &evt, net->uid, &g_proc);
             // Don't reset the info if we tried to report.  It's a gauge.
             //atomicSwapU64(value->evt, 0ULL);
@@ -2092,6 +2343,7 @@ doNetMetric(metric_t type, net_info *net, control_type_t source, ssize_t size)
                 FIELDEND
             };
             event_t evt = INT_EVENT("net.conn_duration", dur, DELTA_MS, fields);
+            evt.captured = net->captured;
             cmdSendEvent(g_ctl, &evt, net->uid, &g_proc);
             atomicSwapU64(&net->numDuration.evt, 0);
             atomicSwapU64(&net->totalDuration.evt, 0);
@@ -2239,6 +2491,7 @@ doNetMetric(metric_t type, net_info *net, control_type_t source, ssize_t size)
         // Don't report zeros.
         if (net->rxBytes.evt != 0ULL) {
 
+             rxMetric.captured = net->captured;
              cmdSendEvent(g_ctl, &rxMetric, net->uid, &g_proc);
              atomicSwapU64(&net->numRX.evt, 0);
              atomicSwapU64(&net->rxBytes.evt, 0);
@@ -2370,6 +2623,7 @@ doNetMetric(metric_t type, net_info *net, control_type_t source, ssize_t size)
         // Don't report zeros.
         if (net->txBytes.evt != 0ULL) {
 
+            txMetric.captured = net->captured;
             cmdSendEvent(g_ctl, &txMetric, net->uid, &g_proc);
             //atomicSwapU64(&net->numTX.evt, 0);
             //atomicSwapU64(&net->txBytes.evt, 0);
@@ -2432,6 +2686,9 @@ doEvent()
         ready = TRUE;
     }
 
+    // With a spill queue, events are written to disk while disconnected
+    if ((ready == FALSE) && ctlSpillEnabled(g_ctl)) ready = TRUE;
+
     if (ready == FALSE) {
         if (mtcNeedsConnection(g_mtc)) {
             if (mtcConnect(g_mtc)) {
@@ -2480,10 +2737,67 @@ doEvent()
     }
     httpAggSendReport(g_http_agg, g_mtc);
     httpAggReset(g_http_agg);
+
+    // Forget requests whose responses were never seen
+    time_t now = time(NULL);
+    if (now >= g_http_map_expire) {
+        hmapExpire(g_http_map, now - HTTP_MAP_MAX_AGE);
+        g_http_map_expire = now + 10;
+    }
+
     ctlFlushLog(g_ctl);
     ctlFlush(g_ctl);
 }
 
+// Writes all of the iovecs, continuing after partial writes
+static int
+payloadWrite(int fd, struct iovec *iov, int iovcnt)
+{
+    while (iovcnt > 0) {
+        ssize_t rc = g_fn.writev(fd, iov, iovcnt);
+        if (rc <= 0) return -1;
+
+        while ((iovcnt > 0) && (rc >= iov->iov_len)) {
+            rc -= iov->iov_len;
+            iov++;
+            iovcnt--;
+        }
+        if (iovcnt > 0) {
+            iov->iov_base = (char *)iov->iov_base + rc;
+            iov->iov_len -= rc;
+        }
+    }
+    return 0;
+}
+
+static void
+payloadPcapng(payload_info *pinfo)
+{
+    net_info *net = &pinfo->net;
+    pcapng_pkt_t pkt = {
+        .uid = net->uid,
+        .sock_type = net->type,
+        .local = (net->active) ? &net->localConn : NULL,
+        .remote = (net->active) ? &net->remoteConn : NULL,
+        .dir = ((pinfo->src == NETTX) || (pinfo->src == TLSTX)) ? PCAPNG_TX : PCAPNG_RX,
+        .ts = pinfo->tv,
+        .data = pinfo->data,
+        .len = pinfo->len,
+    };
+
+    pcapngValidate(g_pcapng, g_proc.pid, ctlPayDir(g_ctl));
+    if (pcapngWrite(g_pcapng, &pkt) == -1) {
+        DBG(NULL);
+    }
+}
+
+void
+doPayloadFlush()
+{
+    pcapngFlush(g_pcapng);
+    g_pcapng_flush = time(NULL) + DEFAULT_PAYLOAD_PCAPNG_FLUSH;
+}
+
 void
 doPayload()
 {
@@ -2502,6 +2816,15 @@ doPayload()
         if (data) {
             payload_info *pinfo = (payload_info *)data;
             net_info *net = &pinfo->net;
+
+            // A connection was closed; its payload files won't be needed
+            if (pinfo->evtype == EVT_NET) {
+                payFdClose(g_payfd, net->uid);
+                pcapngConnClose(g_pcapng, net->uid);
+                free(pinfo);
+                continue;
+            }
+
             size_t hlen = 1024;
             char pay[hlen];
             char *srcstr = NULL,
@@ -2590,51 +2913,80 @@ doPayload()
                     memmove(&bdata[hlen], pinfo->data, pinfo->len);
                     cmdSendPayload(g_ctl, bdata, hlen + pinfo->len);
                 }
+            } else if (ctlPayDir(g_ctl) && (ctlPayFormat(g_ctl) == CFG_PAY_PCAPNG)) {
+                payloadPcapng(pinfo);
             } else if (ctlPayDir(g_ctl)) {
                 int fd;
                 char path[PATH_MAX];
+                payfd_dir_t dir;
 
-                ///tmp/<splunk-pid>/<src_host:src_port:dst_port>.in
                 switch (pinfo->src) {
                 case NETTX:
                 case TLSTX:
-                    snprintf(path, PATH_MAX, "%s/%d_%s:%s_%s:%s.out",
-                             ctlPayDir(g_ctl), g_proc.pid, rip, rport, lip, lport);
+                    dir = PAYFD_OUT;
                     break;
 
                 case NETRX:
                 case TLSRX:
-                    snprintf(path, PATH_MAX, "%s/%d_%s:%s_%s:%s.in",
-                             ctlPayDir(g_ctl), g_proc.pid, rip, rport, lip, lport);
+                    dir = PAYFD_IN;
                     break;
 
                 default:
-                    snprintf(path, PATH_MAX, "%s/%d.na",
-                             ctlPayDir(g_ctl), g_proc.pid);
+                    dir = PAYFD_NA;
                     break;
                 }
 
-                if ((fd = g_fn.open(path, O_WRONLY | O_CREAT | O_APPEND, 0666)) != -1) {
-                    if (checkEnv("SCOPE_PAYLOAD_HEADER", "true")) {
-                        g_fn.write(fd, pay, rc);
+                // Without a uid, connections can't be told apart in the cache
+                int cached = (netid != 0) || (dir == PAYFD_NA);
+
+                payFdValidate(g_payfd, g_proc.pid, ctlPayDir(g_ctl));
+                fd = (cached) ? payFdGet(g_payfd, netid, dir) : -1;
+
+                if (fd == -1) {
+                    ///tmp/<splunk-pid>/<src_host:src_port:dst_port>.in
+                    switch (dir) {
+                    case PAYFD_OUT:
+                        snprintf(path, PATH_MAX, "%s/%d_%s:%s_%s:%s.out",
+                                 ctlPayDir(g_ctl), g_proc.pid, rip, rport, lip, lport);
+                        break;
+
+                    case PAYFD_IN:
+                        snprintf(path, PATH_MAX, "%s/%d_%s:%s_%s:%s.in",
+                                 ctlPayDir(g_ctl), g_proc.pid, rip, rport, lip, lport);
+                        break;
+
+                    default:
+                        snprintf(path, PATH_MAX, "%s/%d.na",
+                                 ctlPayDir(g_ctl), g_proc.pid);
+                        break;
                     }
 
-                    size_t to_write = pinfo->len;
-                    size_t written = 0;
-                    int rc;
+                    if (cached && g_payfd) {
+                        fd = payFdOpen(g_payfd, netid, dir, path);
+                    } else {
+                        fd = g_fn.open(path, O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0666);
+                        cached = FALSE;
+                    }
+                }
 
-                    while (to_write > 0) {
-                        rc = g_fn.write(fd, &pinfo->data[written], to_write);
-                        if (rc <= 0) {
-                            DBG(NULL);
-                            break;
-                        }
+                if (fd != -1) {
+                    struct iovec iov[2];
+                    int iovcnt = 0;
+
+                    if (checkEnv("SCOPE_PAYLOAD_HEADER", "true")) {
+                        iov[iovcnt].iov_base = pay;
+                        iov[iovcnt++].iov_len = rc;
+                    }
+                    iov[iovcnt].iov_base = pinfo->data;
+                    iov[iovcnt++].iov_len = pinfo->len;
 
-                        written += rc;
-                        to_write -= rc;
+                    if (payloadWrite(fd, iov, iovcnt) == -1) {
+                        DBG(NULL);
+                        // Reopen on the next chunk rather than trust this fd
+                        if (cached) payFdClose(g_payfd, netid);
                     }
 
-                    g_fn.close(fd);
+                    if (!cached) g_fn.close(fd);
                 }
             }
 
@@ -2643,4 +2995,190 @@ doPayload()
             if (pinfo) free(pinfo);
         }
     }
+
+    // pcapng output is written in big chunks, but not held for long
+    if (pcapngBuffered(g_pcapng) && (time(NULL) >= g_pcapng_flush)) {
+        doPayloadFlush();
+    }
+}
+
+// Every sample is labeled with the process it came from, like the statsd
+// metrics are
+#define SCRAPE_PROC_LABELS(pid) \
+    "proc", g_proc.procname, "pid", (pid), "host", g_proc.hostname
+
+static void
+scrapeCounter(scrape_out_t *out, const char *name, const char *unit,
+              const char *help, const char *pid, counters_element_t *value)
+{
+    const char *labels[] = {SCRAPE_PROC_LABELS(pid), NULL};
+    scrapeFamily(out, name, "counter", unit, help);
+    scrapeInt(out, name, "_total", labels, value->total);
+}
+
+static void
+scrapeGauge(scrape_out_t *out, const char *name, const char *help,
+            const char *pid, counters_element_t *value)
+{
+    const char *labels[] = {SCRAPE_PROC_LABELS(pid), NULL};
+    scrapeFamily(out, name, "gauge", NULL, help);
+    scrapeInt(out, name, NULL, labels, value->mtc);
+}
+
+// Durations are counted in nanoseconds
+static void
+scrapeDuration(scrape_out_t *out, const char *name, const char *help,
+               const char *pid, counters_element_t *num,
+               counters_element_t *total)
+{
+    const char *labels[] = {SCRAPE_PROC_LABELS(pid), NULL};
+    scrapeFamily(out, name, "summary", "seconds", help);
+    scrapeInt(out, name, "_count", labels, num->total);
+    scrapeNum(out, name, "_sum", labels, total->total / 1e9);
+}
+
+static void
+scrapeClasses(scrape_out_t *out, const char *name, const char *unit,
+              const char *help, const char *pid, const char **class,
+              counters_element_t **value, int num)
+{
+    scrapeFamily(out, name, "counter", unit, help);
+
+    int i;
+    for (i = 0; i < num; i++) {
+        const char *labels[] = {SCRAPE_PROC_LABELS(pid), "class", class[i], NULL};
+        scrapeInt(out, name, "_total", labels, value[i]->total);
+    }
+}
+
+static void
+scrapeFds(scrape_out_t *out, const char *pid)
+{
+    char fdstr[16];
+    int fd;
+
+    scrapeFamily(out, "net_fd_rx_bytes", "counter", "bytes",
+                 "Bytes received, by open socket");
+    for (fd = 0; checkNetEntry(fd); fd++) {
+        net_info *net = &g_netinfo[fd];
+        if (!net->active || !net->rxBytes.total) continue;
+        snprintf(fdstr, sizeof(fdstr), "%d", fd);
+        const char *labels[] = {SCRAPE_PROC_LABELS(pid), "fd", fdstr,
+                                "class", bucketName[getNetRxTxBucket(net)], NULL};
+        scrapeInt(out, "net_fd_rx_bytes", "_total", labels, net->rxBytes.total);
+    }
+
+    scrapeFamily(out, "net_fd_tx_bytes", "counter", "bytes",
+                 "Bytes sent, by open socket");
+    for (fd = 0; checkNetEntry(fd); fd++) {
+        net_info *net = &g_netinfo[fd];
+        if (!net->active || !net->txBytes.total) continue;
+        snprintf(fdstr, sizeof(fdstr), "%d", fd);
+        const char *labels[] = {SCRAPE_PROC_LABELS(pid), "fd", fdstr,
+                                "class", bucketName[getNetRxTxBucket(net)], NULL};
+        scrapeInt(out, "net_fd_tx_bytes", "_total", labels, net->txBytes.total);
+    }
+
+    scrapeFamily(out, "fs_fd_read_bytes", "counter", "bytes",
+                 "Bytes read, by open file");
+    for (fd = 0; checkFSEntry(fd); fd++) {
+        fs_info *fs = &g_fsinfo[fd];
+        if (!fs->active || !fs->readBytes.total) continue;
+        snprintf(fdstr, sizeof(fdstr), "%d", fd);
+        const char *labels[] = {SCRAPE_PROC_LABELS(pid), "fd", fdstr,
+                                "file", fs->path, NULL};
+        scrapeInt(out, "fs_fd_read_bytes", "_total", labels, fs->readBytes.total);
+    }
+
+    scrapeFamily(out, "fs_fd_write_bytes", "counter", "bytes",
+                 "Bytes written, by open file");
+    for (fd = 0; checkFSEntry(fd); fd++) {
+        fs_info *fs = &g_fsinfo[fd];
+        if (!fs->active || !fs->writeBytes.total) continue;
+        snprintf(fdstr, sizeof(fdstr), "%d", fd);
+        const char *labels[] = {SCRAPE_PROC_LABELS(pid), "fd", fdstr,
+                                "file", fs->path, NULL};
+        scrapeInt(out, "fs_fd_write_bytes", "_total", labels, fs->writeBytes.total);
+    }
+}
+
+static void
+scrapeRender(scrape_out_t *out)
+{
+    char pid[24];
+    snprintf(pid, sizeof(pid), "%d", g_proc.pid);
+
+    scrapeCounter(out, "fs_read_bytes", "bytes", "Bytes read from files",
+                  pid, &g_ctrs.readBytes);
+    scrapeCounter(out, "fs_write_bytes", "bytes", "Bytes written to files",
+                  pid, &g_ctrs.writeBytes);
+    scrapeCounter(out, "fs_seek", NULL, "File seek operations",
+                  pid, &g_ctrs.numSeek);
+    scrapeCounter(out, "fs_stat", NULL, "File stat operations",
+                  pid, &g_ctrs.numStat);
+    scrapeCounter(out, "fs_open", NULL, "File open operations",
+                  pid, &g_ctrs.numOpen);
+    scrapeCounter(out, "fs_close", NULL, "File close operations",
+                  pid, &g_ctrs.numClose);
+    scrapeCounter(out, "net_dns", NULL, "DNS requests",
+                  pid, &g_ctrs.numDNS);
+
+    counters_element_t *rx[SOCK_NUM_BUCKETS];
+    counters_element_t *tx[SOCK_NUM_BUCKETS];
+    sock_summary_bucket_t bucket;
+    for (bucket = INET_TCP; bucket < SOCK_NUM_BUCKETS; bucket++) {
+        rx[bucket] = &g_ctrs.netrxBytes[bucket];
+        tx[bucket] = &g_ctrs.nettxBytes[bucket];
+    }
+    scrapeClasses(out, "net_rx_bytes", "bytes", "Bytes received",
+                  pid, bucketName, rx, SOCK_NUM_BUCKETS);
+    scrapeClasses(out, "net_tx_bytes", "bytes", "Bytes sent",
+                  pid, bucketName, tx, SOCK_NUM_BUCKETS);
+
+    const char *netErrClass[] = {"connection", "rx_tx", "dns"};
+    counters_element_t *netErr[] = {&g_ctrs.netConnectErrors,
+                                    &g_ctrs.netTxRxErrors,
+                                    &g_ctrs.netDNSErrors};
+    scrapeClasses(out, "net_error", NULL, "Failed network operations",
+                  pid, netErrClass, netErr, 3);
+
+    const char *fsErrClass[] = {"open_close", "read_write", "stat"};
+    counters_element_t *fsErr[] = {&g_ctrs.fsOpenCloseErrors,
+                                   &g_ctrs.fsRdWrErrors,
+                                   &g_ctrs.fsStatErrors};
+    scrapeClasses(out, "fs_error", NULL, "Failed file operations",
+                  pid, fsErrClass, fsErr, 3);
+
+    scrapeGauge(out, "net_port", "Open ports", pid, &g_ctrs.openPorts);
+    scrapeGauge(out, "net_tcp", "Open tcp connections",
+                pid, &g_ctrs.netConnectionsTcp);
+    scrapeGauge(out, "net_udp", "Open udp connections",
+                pid, &g_ctrs.netConnectionsUdp);
+    scrapeGauge(out, "net_other", "Other open connections",
+                pid, &g_ctrs.netConnectionsOther);
+
+    scrapeDuration(out, "fs_duration_seconds", "Time spent in file operations",
+                   pid, &g_ctrs.fsDurationNum, &g_ctrs.fsDurationTotal);
+    scrapeDuration(out, "net_conn_duration_seconds", "Lifetime of connections",
+                   pid, &g_ctrs.connDurationNum, &g_ctrs.connDurationTotal);
+    scrapeDuration(out, "net_dns_duration_seconds", "Time spent in DNS requests",
+                   pid, &g_ctrs.dnsDurationNum, &g_ctrs.dnsDurationTotal);
+
+    scrapeFds(out, pid);
+
+    httpAggScrape(g_http_scrape, out);
+}
+
+void
+doScrape(scrape_t *scrape)
+{
+    if (!scrape) return;
+
+    // From here on, http metrics are kept for scraping too
+    if (!g_http_scrape) {
+        g_http_scrape = httpAggCreate(FALSE);
+        httpAggNormalizerSet(g_http_scrape, g_http_norm);
+    }
+
+    scrapePoll(scrape, scrapeRender);
 }
@@ -7,6 +7,7 @@
 
 #include "ctl.h"
 #include "mtc.h"
+#include "scrape.h"
 
 typedef enum {
     LOCAL,
@@ -85,12 +86,16 @@ extern ctl_t *g_ctl;
 
 void initReporting(void);
 void setReportingInterval(int);
+void setHttpNormalizer(unsigned, const char *);
 void doErrorMetric(metric_t, control_type_t, const char *, const char *, void *);
 void doProcMetric(metric_t, long long);
 void doStatMetric(const char *, const char *, void *);
 void doTotal(metric_t);
 void doTotalDuration(metric_t);
+void doEvtSpillMetric(void);
 void doEvent(void);
 void doPayload(void);
+void doPayloadFlush(void);
+void doScrape(scrape_t *);
 
 #endif // __REPORT_H__
@@ -5,6 +5,7 @@
 
 typedef enum {CFG_FMT_STATSD,
               CFG_FMT_NDJSON,
+              CFG_FMT_MSGPACK,           // events only; see msgpack.h
               CFG_FORMAT_MAX} cfg_mtc_format_t;
 typedef enum {CFG_UDP, CFG_UNIX, CFG_FILE, CFG_SYSLOG, CFG_SHM, CFG_TCP} cfg_transport_t;
 typedef enum {CFG_MTC, CFG_CTL, CFG_LOG, CFG_LS, CFG_WHICH_MAX} which_transport_t;
@@ -15,6 +16,8 @@ typedef enum {CFG_LOG_TRACE,
               CFG_LOG_ERROR,
               CFG_LOG_NONE} cfg_log_level_t;
 typedef enum {CFG_BUFFER_FULLY, CFG_BUFFER_LINE} cfg_buffer_t;
+typedef enum {CFG_COMPRESS_NONE, CFG_COMPRESS_LZ4} cfg_compress_t;
+typedef enum {CFG_PAY_RAW, CFG_PAY_PCAPNG} cfg_pay_format_t;
 typedef enum {CFG_SRC_FILE,
               CFG_SRC_CONSOLE,
               CFG_SRC_SYSLOG,
@@ -66,6 +69,10 @@ typedef unsigned int bool;
 #define DEFAULT_CUSTOM_TAGS NULL
 #define DEFAULT_NUM_TAGS 8
 #define DEFAULT_MTC_VERBOSITY 4
+#define DEFAULT_MTC_SCRAPE_ENABLE FALSE
+#define DEFAULT_MTC_SCRAPE_LISTEN "tcp://127.0.0.1:9190"
+#define DEFAULT_MTC_HTTP_NORMALIZE TRUE
+#define DEFAULT_MTC_HTTP_TEMPLATES NULL
 #define DEFAULT_COMMAND_DIR "/tmp"
 #define DEFAULT_LOG_LEVEL CFG_LOG_WARN
 #define DEFAULT_SUMMARY_PERIOD 10
@@ -111,11 +118,16 @@ typedef unsigned int bool;
 
 #define DEFAULT_MAXEVENTSPERSEC 100000
 #define DEFAULT_ENHANCE_FS TRUE
+#define DEFAULT_EVT_CAPTURE_TIME FALSE
+#define DEFAULT_EVT_SPILL_DIR NULL
+#define DEFAULT_EVT_SPILL_MAXSIZE (100 * 1024 * 1024)
+#define DEFAULT_EVT_SPILL_REPLAY_RATE 100
 #define DEFAULT_PORTBLOCK 0
 #define DEFAULT_METRIC_CBUF_SIZE 50 * 1024
 #define DEFAULT_PROCESS_START_MSG TRUE
 #define DEFAULT_PAYLOAD_ENABLE FALSE
 #define DEFAULT_PAYLOAD_DIR "/tmp"
+#define DEFAULT_PAYLOAD_FORMAT CFG_PAY_RAW
 
 #define DEFAULT_MTC_TYPE CFG_UDP
 #define DEFAULT_MTC_HOST "127.0.0.1"
@@ -140,6 +152,7 @@ typedef unsigned int bool;
 #define DEFAULT_TLS_ENABLE FALSE
 #define DEFAULT_TLS_VALIDATE_SERVER FALSE
 #define DEFAULT_TLS_CA_CERT NULL
+#define DEFAULT_COMPRESSION CFG_COMPRESS_NONE
 
 #define DEFAULT_LOGSTREAM FALSE
 #define DEFAULT_LOGSTREAM_LOGMSG "The following settings have been overridden by a LogStream connection: event, metric and payload transport, "
@@ -153,6 +166,9 @@ typedef unsigned int bool;
  */
 #define DEFAULT_CBUF_SIZE (DEFAULT_MAXEVENTSPERSEC * DEFAULT_SUMMARY_PERIOD)
 #define DEFAULT_PAYLOAD_RING_SIZE 10000
+#define DEFAULT_PAYLOAD_FD_CACHE 64
+#define DEFAULT_PAYLOAD_PCAPNG_BUF (1024 * 1024)
+#define DEFAULT_PAYLOAD_PCAPNG_FLUSH 1   // seconds
 #define DEFAULT_CONFIG_SIZE 30 * 1024
 
 // Unpublished scope env vars that are not processed by config:
@@ -175,8 +191,9 @@ typedef unsigned int bool;
 // https://tools.ietf.org/html/rfc5246
 // http://blog.fourthbit.com/2014/12/23/traffic-analysis-of-an-ssl-slash-tls-session/
 // https://tls13.ulfheim.net/
-#define PAYLOAD_BYTESRC 8
-#define PAYLOAD_REGEX "^16030[0-3].{4}0[12]"
+// A handshake record (22) of SSL 3.0 to TLS 1.2, with a ClientHello (1)
+// or ServerHello (2) in it.  See src/bytesig.h.
+#define PAYLOAD_SIGNATURE "16 03 00-03 ?? ?? 01-02"
 
 #endif // __SCOPETYPES_H__
 
@@ -0,0 +1,543 @@
+#define _GNU_SOURCE
+#include <arpa/inet.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "dbg.h"
+#include "fn.h"
+#include "scopetypes.h"
+#include "scrape.h"
+
+#define SCRAPE_OUT_INITIAL_SIZE 4096
+// Connections beyond this wait in the listen backlog
+#define SCRAPE_MAX_CLIENTS 4
+#define SCRAPE_MAX_REQUEST 2048
+// Seconds a client has to send its request
+#define SCRAPE_REQUEST_TIMEOUT 5
+// Seconds between attempts to listen, when the address isn't available
+#define SCRAPE_RETRY_PERIOD 10
+// Milliseconds a client has to read its whole response
+#define SCRAPE_SEND_TIMEOUT 2000
+
+#define SCRAPE_CONTENT_TYPE \
+    "application/openmetrics-text; version=1.0.0; charset=utf-8"
+
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0
+#endif
+
+typedef struct {
+    int fd;                 // -1 if the slot is free
+    time_t start;
+    size_t len;
+    char req[SCRAPE_MAX_REQUEST];
+
+    // Once the request is in, the response is sent as the client takes it
+    int responding;
+    uint64_t deadline;      // in ms; see nowMs()
+    char header[256];
+    size_t hlen;
+    size_t bodylen;         // of out; 0 for HEAD
+    size_t sent;            // of the header, then the body
+    scrape_out_t out;       // kept for the next client in this slot
+} scrape_client_t;
+
+struct _scrape_t {
+    struct sockaddr_storage addr;
+    socklen_t addrlen;
+    int sock;               // -1 when not listening
+    pid_t pid;              // the process that's listening
+    int disabled;           // TRUE in the child of a fork
+    int logged;             // TRUE once a failure to listen has been logged
+    time_t retry;           // when to try to listen again
+    scrape_client_t client[SCRAPE_MAX_CLIENTS];
+};
+
+static int
+loopbackAddr(const char *host, const char *port, struct sockaddr_storage *addr,
+             socklen_t *addrlen)
+{
+    char *end;
+    errno = 0;
+    long num = strtol(port, &end, 10);
+    if (errno || (end == port) || *end || (num < 1) || (num > 65535)) return FALSE;
+
+    struct sockaddr_in *sin = (struct sockaddr_in *)addr;
+    struct sockaddr_in6 *sin6 = (struct sockaddr_in6 *)addr;
+
+    if (!strcmp(host, "localhost")) host = "127.0.0.1";
+    if (!strcmp(host, "[::1]")) host = "::1";
+
+    if (inet_pton(AF_INET, host, &sin->sin_addr) == 1) {
+        // anything in 127.0.0.0/8
+        if ((ntohl(sin->sin_addr.s_addr) >> 24) != 127) return FALSE;
+        sin->sin_family = AF_INET;
+        sin->sin_port = htons(num);
+        *addrlen = sizeof(*sin);
+        return TRUE;
+    }
+
+    if (inet_pton(AF_INET6, host, &sin6->sin6_addr) == 1) {
+        if (!IN6_IS_ADDR_LOOPBACK(&sin6->sin6_addr)) return FALSE;
+        sin6->sin6_family = AF_INET6;
+        sin6->sin6_port = htons(num);
+        *addrlen = sizeof(*sin6);
+        return TRUE;
+    }
+
+    return FALSE;
+}
+
+scrape_t *
+scrapeCreate(const char *listen)
+{
+    if (!listen) return NULL;
+
+    scrape_t *s = calloc(1, sizeof(*s));
+    if (!s) {
+        DBG(NULL);
+        return NULL;
+    }
+    s->sock = -1;
+
+    int i;
+    for (i = 0; i < SCRAPE_MAX_CLIENTS; i++) s->client[i].fd = -1;
+
+    if (listen == strstr(listen, "unix://")) {
+        const char *path = listen + strlen("unix://");
+        struct sockaddr_un *sun = (struct sockaddr_un *)&s->addr;
+        if (!*path || (strlen(path) >= sizeof(sun->sun_path))) goto err;
+        sun->sun_family = AF_UNIX;
+        strcpy(sun->sun_path, path);
+        s->addrlen = sizeof(*sun);
+    } else if (listen == strstr(listen, "tcp://")) {
+        char host[256];
+        strncpy(host, listen + strlen("tcp://"), sizeof(host) - 1);
+        host[sizeof(host) - 1] = '\0';
+
+        // port is *required*
+        char *port = strrchr(host, ':');
+        if (!port) goto err;
+        *port++ = '\0';
+        if (!loopbackAddr(host, port, &s->addr, &s->addrlen)) goto err;
+    } else {
+        goto err;
+    }
+
+    return s;
+
+err:
+    free(s);
+    return NULL;
+}
+
+static void
+clientClose(scrape_client_t *client)
+{
+    if (client->fd != -1) g_fn.close(client->fd);
+    client->fd = -1;
+    client->len = 0;
+    client->responding = FALSE;
+}
+
+void
+scrapeDestroy(scrape_t **scrape)
+{
+    if (!scrape || !*scrape) return;
+    scrape_t *s = *scrape;
+
+    int i;
+    for (i = 0; i < SCRAPE_MAX_CLIENTS; i++) {
+        clientClose(&s->client[i]);
+        scrapeOutFree(&s->client[i].out);
+    }
+
+    if (s->sock != -1) {
+        g_fn.close(s->sock);
+        if ((s->addr.ss_family == AF_UNIX) && (s->pid == getpid())) {
+            unlink(((struct sockaddr_un *)&s->addr)->sun_path);
+        }
+    }
+
+    free(s);
+    *scrape = NULL;
+}
+
+// TRUE if something is accepting connections on this unix socket path
+static int
+unixSocketInUse(scrape_t *s)
+{
+    int sock = g_fn.socket(AF_UNIX, SOCK_STREAM, 0);
+    if (sock == -1) return TRUE;
+    int rc = g_fn.connect(sock, (struct sockaddr *)&s->addr, s->addrlen);
+    g_fn.close(sock);
+    return (rc == 0);
+}
+
+static void
+scrapeListen(scrape_t *s)
+{
+    time_t now = time(NULL);
+    if (now < s->retry) return;
+    s->retry = now + SCRAPE_RETRY_PERIOD;
+
+    int sock = g_fn.socket(s->addr.ss_family, SOCK_STREAM, 0);
+    if (sock == -1) return;
+
+    int on = 1;
+    if (s->addr.ss_family != AF_UNIX) {
+        setsockopt(sock, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+    }
+
+    int rc = g_fn.bind(sock, (struct sockaddr *)&s->addr, s->addrlen);
+    if ((rc == -1) && (errno == EADDRINUSE) &&
+        (s->addr.ss_family == AF_UNIX) && !unixSocketInUse(s)) {
+        // Left behind by a process that's gone
+        unlink(((struct sockaddr_un *)&s->addr)->sun_path);
+        rc = g_fn.bind(sock, (struct sockaddr *)&s->addr, s->addrlen);
+    }
+    if ((rc == -1) || (g_fn.listen(sock, SCRAPE_MAX_CLIENTS) == -1)) {
+        if (!s->logged) {
+            scopeLog("WARN: scrapeListen: can't listen for metric scrapes", -1, CFG_LOG_WARN);
+            s->logged = TRUE;
+        }
+        g_fn.close(sock);
+        return;
+    }
+
+    // Move it out of the way of the app
+    int highfd = g_fn.fcntl(sock, F_DUPFD_CLOEXEC, DEFAULT_MIN_FD);
+    if (highfd != -1) {
+        g_fn.close(sock);
+        sock = highfd;
+    }
+    g_fn.fcntl(sock, F_SETFL, g_fn.fcntl(sock, F_GETFL, 0) | O_NONBLOCK);
+
+    s->sock = sock;
+    s->pid = getpid();
+    s->logged = FALSE;
+}
+
+static void
+scrapeAccept(scrape_t *s)
+{
+    int i;
+    for (i = 0; i < SCRAPE_MAX_CLIENTS; i++) {
+        scrape_client_t *client = &s->client[i];
+        if (client->fd != -1) continue;
+
+        int fd = g_fn.accept(s->sock, NULL, NULL);
+        if (fd == -1) return;
+
+        int highfd = g_fn.fcntl(fd, F_DUPFD_CLOEXEC, DEFAULT_MIN_FD);
+        if (highfd != -1) {
+            g_fn.close(fd);
+            fd = highfd;
+        }
+        g_fn.fcntl(fd, F_SETFL, g_fn.fcntl(fd, F_GETFL, 0) | O_NONBLOCK);
+
+        client->fd = fd;
+        client->start = time(NULL);
+        client->len = 0;
+    }
+}
+
+static uint64_t
+nowMs(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000 + now.tv_nsec / 1000000;
+}
+
+// Sends as much of the response as the client will take without waiting.
+// Returns TRUE when the client is done with, one way or another.
+static int
+scrapeSend(scrape_client_t *client)
+{
+    size_t total = client->hlen + client->bodylen;
+    while (client->sent < total) {
+        const char *data;
+        size_t len;
+        if (client->sent < client->hlen) {
+            data = &client->header[client->sent];
+            len = client->hlen - client->sent;
+        } else {
+            data = &client->out.data[client->sent - client->hlen];
+            len = total - client->sent;
+        }
+
+        ssize_t rc = g_fn.send(client->fd, data, len, MSG_NOSIGNAL | MSG_DONTWAIT);
+        if (rc > 0) {
+            client->sent += rc;
+            continue;
+        }
+        if ((rc == -1) && (errno == EINTR)) continue;
+        if ((rc == 0) || ((errno != EAGAIN) && (errno != EWOULDBLOCK))) return TRUE;
+
+        // Not reading; it can have more time on the next poll, up to a point
+        return (nowMs() >= client->deadline);
+    }
+    return TRUE;
+}
+
+static void
+scrapeRespond(scrape_client_t *client, scrape_render_fn render)
+{
+    const char *status = "200 OK";
+    const char *req = client->req;
+    int head = FALSE;
+
+    if (req == strstr(req, "GET ")) {
+        req += strlen("GET ");
+    } else if (req == strstr(req, "HEAD ")) {
+        req += strlen("HEAD ");
+        head = TRUE;
+    } else {
+        status = "405 Method Not Allowed";
+    }
+
+    // The path is all that matters; any query is ignored
+    size_t pathlen = strcspn(req, " ?\r\n");
+    if (strncmp(req, "/metrics", pathlen) || (pathlen != strlen("/metrics"))) {
+        if (!strcmp(status, "200 OK")) status = "404 Not Found";
+    }
+
+    scrape_out_t *out = &client->out;
+    out->len = 0;
+    out->err = FALSE;
+    if (out->data) out->data[0] = '\0';
+
+    if (!strcmp(status, "200 OK")) {
+        if (render) render(out);
+        scrapeFamily(out, NULL, NULL, NULL, NULL);
+        if (out->err) status = "500 Internal Server Error";
+    }
+    if (strcmp(status, "200 OK")) out->len = 0;
+
+    client->hlen = snprintf(client->header, sizeof(client->header),
+                            "HTTP/1.1 %s\r\n"
+                            "Content-Type: %s\r\n"
+                            "Content-Length: %zu\r\n"
+                            "Connection: close\r\n\r\n",
+                            status, (out->len) ? SCRAPE_CONTENT_TYPE : "text/plain",
+                            out->len);
+    client->bodylen = (head) ? 0 : out->len;
+    client->sent = 0;
+    client->deadline = nowMs() + SCRAPE_SEND_TIMEOUT;
+    client->responding = TRUE;
+}
+
+static void
+scrapeRead(scrape_client_t *client, scrape_render_fn render)
+{
+    ssize_t rc = g_fn.recv(client->fd, &client->req[client->len],
+                           sizeof(client->req) - 1 - client->len, MSG_DONTWAIT);
+    if (rc > 0) {
+        client->len += rc;
+        client->req[client->len] = '\0';
+
+        // Only the request line is used, but the whole request is read
+        if (strstr(client->req, "\r\n\r\n") || strstr(client->req, "\n\n")) {
+            scrapeRespond(client, render);
+            if (scrapeSend(client)) clientClose(client);
+            return;
+        }
+        if (client->len == sizeof(client->req) - 1) {
+            clientClose(client);
+            return;
+        }
+    } else if ((rc == 0) || ((errno != EAGAIN) && (errno != EWOULDBLOCK) &&
+                             (errno != EINTR))) {
+        clientClose(client);
+        return;
+    }
+
+    if (time(NULL) - client->start > SCRAPE_REQUEST_TIMEOUT) clientClose(client);
+}
+
+void
+scrapePoll(scrape_t *s, scrape_render_fn render)
+{
+    if (!s || s->disabled) return;
+
+    if (s->sock == -1) {
+        scrapeListen(s);
+        if (s->sock == -1) return;
+    }
+
+    // A forked child shares the listening socket; leave it to the parent
+    if (s->pid != getpid()) {
+        int i;
+        for (i = 0; i < SCRAPE_MAX_CLIENTS; i++) clientClose(&s->client[i]);
+        g_fn.close(s->sock);
+        s->sock = -1;
+        s->disabled = TRUE;
+        return;
+    }
+
+    scrapeAccept(s);
+
+    int i;
+    for (i = 0; i < SCRAPE_MAX_CLIENTS; i++) {
+        scrape_client_t *client = &s->client[i];
+        if (client->fd == -1) continue;
+        if (!client->responding) {
+            scrapeRead(client, render);
+        } else if (scrapeSend(client)) {
+            clientClose(client);
+        }
+    }
+}
+
+// Makes room for n more bytes, plus the nul terminator
+static int
+outReserve(scrape_out_t *out, size_t n)
+{
+    if (out->err) return FALSE;
+    if (out->len + n + 1 <= out->size) return TRUE;
+
+    size_t size = (out->size) ? out->size : SCRAPE_OUT_INITIAL_SIZE;
+    while (size < out->len + n + 1) size *= 2;
+
+    char *temp = realloc(out->data, size);
+    if (!temp) {
+        DBG("%zu", size);
+        out->err = TRUE;
+        return FALSE;
+    }
+    out->data = temp;
+    out->size = size;
+    return TRUE;
+}
+
+static void
+outPut(scrape_out_t *out, const char *str, size_t len)
+{
+    if (!outReserve(out, len)) return;
+    memcpy(&out->data[out->len], str, len);
+    out->len += len;
+    out->data[out->len] = '\0';
+}
+
+static void
+outStr(scrape_out_t *out, const char *str)
+{
+    outPut(out, str, strlen(str));
+}
+
+// Label values and help text escape backslashes, newlines and (for label
+// values) double quotes
+static void
+outEscaped(scrape_out_t *out, const char *str, int quotes)
+{
+    const char *run = str;
+    for (; *str; str++) {
+        const char *esc = NULL;
+        if (*str == '\\') esc = "\\\\";
+        if (*str == '\n') esc = "\\n";
+        if ((*str == '"') && quotes) esc = "\\\"";
+        if (!esc) continue;
+
+        outPut(out, run, str - run);
+        outStr(out, esc);
+        run = str + 1;
+    }
+    outPut(out, run, str - run);
+}
+
+void
+scrapeFamily(scrape_out_t *out, const char *name, const char *type,
+             const char *unit, const char *help)
+{
+    if (!out) return;
+
+    // scrapePoll() uses this to end the exposition
+    if (!name) {
+        outStr(out, "# EOF\n");
+        return;
+    }
+
+    outStr(out, "# TYPE ");
+    outStr(out, name);
+    outStr(out, " ");
+    outStr(out, (type) ? type : "unknown");
+    outStr(out, "\n");
+    if (unit) {
+        outStr(out, "# UNIT ");
+        outStr(out, name);
+        outStr(out, " ");
+        outStr(out, unit);
+        outStr(out, "\n");
+    }
+    if (help) {
+        outStr(out, "# HELP ");
+        outStr(out, name);
+        outStr(out, " ");
+        outEscaped(out, help, FALSE);
+        outStr(out, "\n");
+    }
+}
+
+static void
+outSampleName(scrape_out_t *out, const char *name, const char *suffix,
+              const char **labels)
+{
+    outStr(out, name);
+    if (suffix) outStr(out, suffix);
+    if (!labels || !labels[0]) return;
+
+    outStr(out, "{");
+    int i;
+    for (i = 0; labels[i] && labels[i + 1]; i += 2) {
+        if (i) outStr(out, ",");
+        outStr(out, labels[i]);
+        outStr(out, "=\"");
+        outEscaped(out, labels[i + 1], TRUE);
+        outStr(out, "\"");
+    }
+    outStr(out, "}");
+}
+
+void
+scrapeInt(scrape_out_t *out, const char *name, const char *suffix,
+          const char **labels, uint64_t value)
+{
+    if (!out || !name) return;
+
+    char num[32];
+    int len = snprintf(num, sizeof(num), " %llu\n", (unsigned long long)value);
+
+    outSampleName(out, name, suffix, labels);
+    outPut(out, num, len);
+}
+
+void
+scrapeNum(scrape_out_t *out, const char *name, const char *suffix,
+          const char **labels, double value)
+{
+    if (!out || !name) return;
+
+    char num[48];
+    int len = snprintf(num, sizeof(num), " %.10g\n", value);
+
+    outSampleName(out, name, suffix, labels);
+    outPut(out, num, len);
+}
+
+void
+scrapeOutFree(scrape_out_t *out)
+{
+    if (!out) return;
+    if (out->data) free(out->data);
+    memset(out, 0, sizeof(*out));
+}
@@ -0,0 +1,59 @@
+#ifndef __SCRAPE_H__
+#define __SCRAPE_H__
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * A local endpoint that Prometheus (or anything else that reads the
+ * OpenMetrics text format) can scrape, so metrics don't have to be pushed
+ * over udp to an aggregator.
+ *
+ * It listens on a unix socket or a loopback tcp port, given as
+ * "unix:///path/to/socket" or "tcp://127.0.0.1:9190".  Nothing is queued
+ * for it.  scrapePoll() accepts waiting connections, and for each
+ * "GET /metrics" the render function writes out the counters as they are
+ * right then.  If the address can't be listened on (e.g. another process
+ * already has it), it's tried again every little while.
+ *
+ * A scrape_t is not thread safe; it is intended to be polled from the
+ * periodic thread only.  It never waits for a client, either to send a
+ * request or to read its response.  A response is rendered once, and
+ * sent over as many polls as it takes the client to read it; one that
+ * hasn't read all of it within a couple of seconds is dropped.  After a
+ * fork, only the process that was listening answers scrapes.
+ */
+
+typedef struct _scrape_t scrape_t;
+
+// What the render function writes to.  data is nul terminated.
+typedef struct {
+    char *data;
+    size_t len;
+    size_t size;
+    int err;
+} scrape_out_t;
+
+typedef void (*scrape_render_fn)(scrape_out_t *);
+
+// Constructors Destructors
+// Returns NULL if the address isn't a unix socket or a loopback tcp port
+scrape_t *          scrapeCreate(const char *);
+void                scrapeDestroy(scrape_t **);
+
+void                scrapePoll(scrape_t *, scrape_render_fn);
+
+// For render functions.  Every metric family starts with scrapeFamily(),
+// and is followed by its samples.  unit and help are optional.  Labels are
+// name, value pairs in an array that ends with NULL; labels can be NULL.
+void                scrapeFamily(scrape_out_t *, const char *name,
+                                 const char *type, const char *unit,
+                                 const char *help);
+void                scrapeInt(scrape_out_t *, const char *name,
+                              const char *suffix, const char **labels,
+                              uint64_t);
+void                scrapeNum(scrape_out_t *, const char *name,
+                              const char *suffix, const char **labels,
+                              double);
+void                scrapeOutFree(scrape_out_t *);
+
+#endif // __SCRAPE_H__
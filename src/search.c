@@ -4,15 +4,35 @@
 #include "scopetypes.h"
 #include "search.h"
 
+#if defined(__x86_64__)
+#include <immintrin.h>
+#endif
+
 #define ASIZE 256
 
+typedef int (*search_fn)(search_t *, char *, int);
+
 struct _search_t
 {
     int nlen;
     unsigned char* str;
     int bmBc[ASIZE];
+    search_fn exec;
 };
 
+static search_fn
+searchBestExec(void)
+{
+#if defined(__x86_64__)
+    // This can run before the constructors that would normally init this
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) return searchExecAvx2;
+    return searchExecSse2;
+#else
+    return searchExecScalar;
+#endif
+}
+
 /*
  * This is an implementation of the Horspool
  * string search algorithm.
@@ -38,6 +58,8 @@ searchComp(const char *input_str)
     for (i = 0; i < handle->nlen - 1; ++i)
         handle->bmBc[handle->str[i]] = handle->nlen - i - 1;
 
+    handle->exec = searchBestExec();
+
     return handle;
 
 failed:
@@ -64,6 +86,14 @@ searchLen(search_t *handle)
 
 int
 searchExec(search_t *handle, char *haystack, int hlen)
+{
+    if (!handle || !haystack || hlen < 0) return -1;
+
+    return handle->exec(handle, haystack, hlen);
+}
+
+int
+searchExecScalar(search_t *handle, char *haystack, int hlen)
 {
     int j;
     unsigned char c;
@@ -84,3 +114,101 @@ searchExec(search_t *handle, char *haystack, int hlen)
 
     return -1;
 }
+
+#if defined(__x86_64__)
+
+/*
+ * The vector versions compare a block of the haystack against the first
+ * byte of the string, and the block nlen-1 bytes further on against the
+ * last byte.  Only where both match is the rest of the string compared.
+ * For the strings we look for in network traffic that's rarely more than
+ * once per block.  Whatever is left at the end, where a whole block
+ * can't be loaded, goes to the scalar version.
+ * ref: http://0x80.pl/articles/simd-strfind.html
+ */
+static int
+searchMatchBits(search_t *handle, char *block, unsigned int bits)
+{
+    while (bits) {
+        int bit = __builtin_ctz(bits);
+        if ((handle->nlen <= 2) ||
+            !memcmp(block + bit + 1, handle->str + 1, handle->nlen - 2)) {
+            return bit;
+        }
+        bits &= bits - 1;
+    }
+    return -1;
+}
+
+static int
+searchExecTail(search_t *handle, char *haystack, int hlen, int j)
+{
+    int rv = searchExecScalar(handle, haystack + j, hlen - j);
+    return (rv == -1) ? -1 : j + rv;
+}
+
+int
+searchExecSse2(search_t *handle, char *haystack, int hlen)
+{
+    if (!handle || !haystack || hlen < 0) return -1;
+
+    int last = handle->nlen - 1;
+    const __m128i first_byte = _mm_set1_epi8(handle->str[0]);
+    const __m128i last_byte = _mm_set1_epi8(handle->str[last]);
+
+    int j;
+    for (j = 0; j + last + 16 <= hlen; j += 16) {
+        __m128i block_first = _mm_loadu_si128((__m128i *)(haystack + j));
+        __m128i block_last = _mm_loadu_si128((__m128i *)(haystack + j + last));
+        __m128i eq = _mm_and_si128(_mm_cmpeq_epi8(block_first, first_byte),
+                                   _mm_cmpeq_epi8(block_last, last_byte));
+        unsigned int bits = _mm_movemask_epi8(eq);
+        if (bits) {
+            int bit = searchMatchBits(handle, haystack + j, bits);
+            if (bit != -1) return j + bit;
+        }
+    }
+
+    return searchExecTail(handle, haystack, hlen, j);
+}
+
+__attribute__((target("avx2"))) int
+searchExecAvx2(search_t *handle, char *haystack, int hlen)
+{
+    if (!handle || !haystack || hlen < 0) return -1;
+
+    int last = handle->nlen - 1;
+    const __m256i first_byte = _mm256_set1_epi8(handle->str[0]);
+    const __m256i last_byte = _mm256_set1_epi8(handle->str[last]);
+
+    int j;
+    for (j = 0; j + last + 32 <= hlen; j += 32) {
+        __m256i block_first = _mm256_loadu_si256((__m256i *)(haystack + j));
+        __m256i block_last = _mm256_loadu_si256((__m256i *)(haystack + j + last));
+        __m256i eq = _mm256_and_si256(_mm256_cmpeq_epi8(block_first, first_byte),
+                                      _mm256_cmpeq_epi8(block_last, last_byte));
+        unsigned int bits = _mm256_movemask_epi8(eq);
+        if (bits) {
+            int bit = searchMatchBits(handle, haystack + j, bits);
+            if (bit != -1) return j + bit;
+        }
+    }
+
+    return searchExecTail(handle, haystack, hlen, j);
+}
+
+#else
+
+int
+searchExecSse2(search_t *handle, char *haystack, int hlen)
+{
+    return searchExecScalar(handle, haystack, hlen);
+}
+
+int
+searchExecAvx2(search_t *handle, char *haystack, int hlen)
+{
+    return searchExecScalar(handle, haystack, hlen);
+}
+
+#endif // __x86_64__
@@ -18,6 +18,9 @@
 // searching if it sees NULL characters/bytes.  If a match is found, it
 // returns the offset of the first match, otherwise it returns -1.
 //
+// On x86_64, searchExec() compares 16 or 32 bytes at a time using SSE2
+// or AVX2, whichever the cpu supports.  Elsewhere it's a Horspool search.
+//
 
 typedef struct _search_t search_t;
 
@@ -27,4 +30,11 @@ int           searchLen(search_t*);
 
 int           searchExec(search_t*, char *, int);
 
+// Could be static; these are lower level funcs only exposed for testing.
+// searchExecAvx2() must only be called if the cpu supports AVX2.
+// Where there's no SSE2 or AVX2, they're the same as searchExecScalar().
+int           searchExecScalar(search_t*, char *, int);
+int           searchExecSse2(search_t*, char *, int);
+int           searchExecAvx2(search_t*, char *, int);
+
 #endif // __SEARCH_H__
@@ -0,0 +1,355 @@
+#define _GNU_SOURCE
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/uio.h>
+
+#include "atomic.h"
+#include "dbg.h"
+#include "fn.h"
+#include "spill.h"
+
+#define SPILL_MAX_SEGMENTS 16
+#define SPILL_PREFIX "scope_spill_"
+
+typedef uint32_t spill_hdr_t;
+
+// Shared by every spill in the process, so that one made by a config
+// change never names a segment the same as one still held by the old one
+static uint64_t g_next_seq = 0;
+
+typedef struct {
+    uint64_t seq;
+    off_t size;         // bytes written to the segment
+    off_t rdoff;        // bytes of the segment already replayed
+    unsigned msgs;      // messages written to the segment
+    unsigned sent;      // messages of the segment already replayed
+} segment_t;
+
+struct _spill_t
+{
+    char *dir;
+    size_t max_bytes;
+    size_t seg_bytes;
+    size_t tot_bytes;
+
+    // segments[head] is the oldest, the newest is the write segment
+    segment_t segments[SPILL_MAX_SEGMENTS];
+    int head;
+    int num;
+    int wrfd;
+    int rdfd;
+
+    // reused across replays to avoid an allocation per message
+    char *buf;
+    size_t buflen;
+
+    spill_counters_t ctrs;
+};
+
+static void
+segmentPath(spill_t *spill, uint64_t seq, char *path, size_t len)
+{
+    snprintf(path, len, "%s/" SPILL_PREFIX "%d.%lu",
+             spill->dir, getpid(), seq);
+}
+
+static segment_t *
+oldestSegment(spill_t *spill)
+{
+    return (spill->num) ? &spill->segments[spill->head] : NULL;
+}
+
+static segment_t *
+newestSegment(spill_t *spill)
+{
+    if (!spill->num) return NULL;
+    return &spill->segments[(spill->head + spill->num - 1) % SPILL_MAX_SEGMENTS];
+}
+
+// Removes the oldest segment; anything in it that wasn't replayed is dropped
+static void
+removeOldestSegment(spill_t *spill)
+{
+    segment_t *seg = oldestSegment(spill);
+    if (!seg) return;
+
+    char path[PATH_MAX];
+    segmentPath(spill, seg->seq, path, sizeof(path));
+
+    if (spill->rdfd != -1) {
+        g_fn.close(spill->rdfd);
+        spill->rdfd = -1;
+    }
+    if ((spill->num == 1) && (spill->wrfd != -1)) {
+        g_fn.close(spill->wrfd);
+        spill->wrfd = -1;
+    }
+    unlink(path);
+
+    atomicAddU64(&spill->ctrs.dropped, seg->msgs - seg->sent);
+    spill->tot_bytes -= seg->size;
+    spill->head = (spill->head + 1) % SPILL_MAX_SEGMENTS;
+    spill->num--;
+}
+
+static int
+newSegment(spill_t *spill)
+{
+    if (spill->num >= SPILL_MAX_SEGMENTS) removeOldestSegment(spill);
+
+    if (spill->wrfd != -1) {
+        g_fn.close(spill->wrfd);
+        spill->wrfd = -1;
+    }
+
+    segment_t *seg = &spill->segments[(spill->head + spill->num) % SPILL_MAX_SEGMENTS];
+    memset(seg, 0, sizeof(*seg));
+    seg->seq = __atomic_fetch_add(&g_next_seq, 1, __ATOMIC_RELAXED);
+
+    char path[PATH_MAX];
+    segmentPath(spill, seg->seq, path, sizeof(path));
+    spill->wrfd = g_fn.open(path, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0600);
+    if (spill->wrfd == -1) {
+        DBG("%s %d", path, errno);
+        return -1;
+    }
+
+    spill->num++;
+    return 0;
+}
+
+spill_t *
+spillCreate(const char *dir, size_t max_bytes)
+{
+    if (!dir || !dir[0] || !max_bytes) return NULL;
+
+    spill_t *spill = calloc(1, sizeof(spill_t));
+    if (!spill) {
+        DBG(NULL);
+        return NULL;
+    }
+
+    if (!(spill->dir = strdup(dir))) {
+        DBG(NULL);
+        free(spill);
+        return NULL;
+    }
+
+    // Eviction happens a segment at a time; keep segments small enough
+    // that evicting one doesn't throw away most of what we've spilled.
+    spill->max_bytes = max_bytes;
+    spill->seg_bytes = max_bytes / (SPILL_MAX_SEGMENTS / 2);
+    if (!spill->seg_bytes) spill->seg_bytes = 1;
+    spill->wrfd = -1;
+    spill->rdfd = -1;
+
+    return spill;
+}
+
+void
+spillDestroy(spill_t **spill)
+{
+    if (!spill || !*spill) return;
+
+    spill_t *s = *spill;
+    while (s->num) removeOldestSegment(s);
+
+    if (s->buf) free(s->buf);
+    free(s->dir);
+    free(s);
+    *spill = NULL;
+}
+
+void
+spillReset(spill_t *spill)
+{
+    if (!spill) return;
+
+    if (spill->wrfd != -1) g_fn.close(spill->wrfd);
+    if (spill->rdfd != -1) g_fn.close(spill->rdfd);
+    spill->wrfd = -1;
+    spill->rdfd = -1;
+
+    spill->head = 0;
+    spill->num = 0;
+    spill->tot_bytes = 0;
+    memset(&spill->ctrs, 0, sizeof(spill->ctrs));
+}
+
+int
+spillWrite(spill_t *spill, const char *msg, size_t len)
+{
+    if (!spill || !msg) return -1;
+
+    size_t rec_len = sizeof(spill_hdr_t) + len;
+    if ((len > UINT32_MAX) || (rec_len > spill->max_bytes)) {
+        atomicAddU64(&spill->ctrs.dropped, 1);
+        return -1;
+    }
+
+    // Make room by evicting the oldest segments
+    while (spill->num && (spill->tot_bytes + rec_len > spill->max_bytes)) {
+        removeOldestSegment(spill);
+    }
+
+    segment_t *seg = newestSegment(spill);
+    if (!seg || (spill->wrfd == -1) ||
+        ((seg->size > 0) && (seg->size + rec_len > spill->seg_bytes))) {
+        if (newSegment(spill)) {
+            atomicAddU64(&spill->ctrs.dropped, 1);
+            return -1;
+        }
+        seg = newestSegment(spill);
+    }
+
+    spill_hdr_t hdr = len;
+    struct iovec iov[] = {
+        {.iov_base = &hdr,        .iov_len = sizeof(hdr)},
+        {.iov_base = (void *)msg, .iov_len = len},
+    };
+
+    ssize_t rc = g_fn.writev(spill->wrfd, iov, sizeof(iov)/sizeof(iov[0]));
+    if (rc != rec_len) {
+        // A partial record can't be replayed.  Stop writing to this
+        // segment; the reader will discard the partial record.
+        DBG("%zd %zu %d", rc, rec_len, errno);
+        if (rc > 0) {
+            seg->size += rc;
+            spill->tot_bytes += rc;
+        }
+        g_fn.close(spill->wrfd);
+        spill->wrfd = -1;
+        atomicAddU64(&spill->ctrs.dropped, 1);
+        return -1;
+    }
+
+    seg->size += rec_len;
+    seg->msgs++;
+    spill->tot_bytes += rec_len;
+    atomicAddU64(&spill->ctrs.spilled, 1);
+    return 0;
+}
+
+static int
+readRecord(spill_t *spill, segment_t *seg, size_t *len)
+{
+    if (spill->rdfd == -1) {
+        char path[PATH_MAX];
+        segmentPath(spill, seg->seq, path, sizeof(path));
+        spill->rdfd = g_fn.open(path, O_RDONLY | O_CLOEXEC);
+        if (spill->rdfd == -1) {
+            DBG("%s %d", path, errno);
+            return -1;
+        }
+    }
+
+    spill_hdr_t hdr;
+    if (g_fn.pread(spill->rdfd, &hdr, sizeof(hdr), seg->rdoff) != sizeof(hdr)) {
+        return -1;
+    }
+
+    if (hdr > spill->buflen) {
+        char *temp = realloc(spill->buf, hdr);
+        if (!temp) {
+            DBG(NULL);
+            return -1;
+        }
+        spill->buf = temp;
+        spill->buflen = hdr;
+    }
+
+    if (g_fn.pread(spill->rdfd, spill->buf, hdr, seg->rdoff + sizeof(hdr)) != hdr) {
+        return -1;
+    }
+
+    *len = hdr;
+    return 0;
+}
+
+int
+spillReplay(spill_t *spill, spill_send_fn_t send_fn, void *ctx, unsigned max)
+{
+    if (!spill || !send_fn) return 0;
+
+    int num_sent = 0;
+    segment_t *seg;
+    while ((num_sent < max) && (seg = oldestSegment(spill))) {
+
+        if (seg->rdoff >= seg->size) {
+            // Done with this segment.  If it's also the one being written
+            // to, removing it means the next write will start a new one.
+            removeOldestSegment(spill);
+            continue;
+        }
+
+        size_t len;
+        if (readRecord(spill, seg, &len)) {
+            // Truncated or unreadable; the rest of this segment is lost.
+            DBG("%lu %ld %ld", seg->seq, seg->rdoff, seg->size);
+            removeOldestSegment(spill);
+            continue;
+        }
+
+        if (send_fn(ctx, spill->buf, len)) break;
+
+        seg->rdoff += sizeof(spill_hdr_t) + len;
+        seg->sent++;
+        atomicAddU64(&spill->ctrs.replayed, 1);
+        num_sent++;
+    }
+
+    // Don't hang on to the space used by an unusually large message
+    seg = oldestSegment(spill);
+    if (!seg && spill->buf) {
+        free(spill->buf);
+        spill->buf = NULL;
+        spill->buflen = 0;
+    }
+
+    return num_sent;
+}
+
+int
+spillEmpty(spill_t *spill)
+{
+    if (!spill) return TRUE;
+
+    segment_t *seg = oldestSegment(spill);
+    return !seg || ((spill->num == 1) && (seg->rdoff >= seg->size));
+}
+
+size_t
+spillBytes(spill_t *spill)
+{
+    return (spill) ? spill->tot_bytes : 0;
+}
+
+const char *
+spillDir(spill_t *spill)
+{
+    return (spill) ? spill->dir : NULL;
+}
+
+size_t
+spillMaxBytes(spill_t *spill)
+{
+    return (spill) ? spill->max_bytes : 0;
+}
+
+void
+spillCountersGet(spill_t *spill, spill_counters_t *ctrs)
+{
+    if (!ctrs) return;
+    if (!spill) {
+        memset(ctrs, 0, sizeof(*ctrs));
+        return;
+    }
+
+    ctrs->spilled = atomicSwapU64(&spill->ctrs.spilled, 0);
+    ctrs->replayed = atomicSwapU64(&spill->ctrs.replayed, 0);
+    ctrs->dropped = atomicSwapU64(&spill->ctrs.dropped, 0);
+}
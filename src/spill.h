@@ -0,0 +1,62 @@
+#ifndef __SPILL_H__
+#define __SPILL_H__
+#include <stdint.h>
+#include <unistd.h>
+
+/*
+ * A bounded, on-disk, append-only queue of messages.
+ *
+ * This is used to hold on to events while the event transport is not
+ * connected, and to replay them once it is.  Messages are appended to
+ * segment files in the configured directory, one set of segments per
+ * process:
+ *
+ *     <dir>/scope_spill_<pid>.<seq>
+ *
+ * Each message is stored as a native uint32_t length followed by the
+ * message bytes.  When the total size of all segments would exceed the
+ * configured maximum, the oldest segment is removed and the messages it
+ * held are counted as dropped.  Segments are removed as soon as they
+ * have been replayed.
+ *
+ * A spill_t is not thread safe; it is intended to be used from the
+ * periodic thread only.
+ */
+
+typedef struct _spill_t spill_t;
+
+typedef struct {
+    uint64_t spilled;      // messages written to disk
+    uint64_t replayed;     // messages read back and sent successfully
+    uint64_t dropped;      // messages lost to eviction or write errors
+} spill_counters_t;
+
+// Return 0 if the message was sent, -1 if it should be retried later
+typedef int (*spill_send_fn_t)(void *, const char *, size_t);
+
+// Constructors Destructors
+spill_t *   spillCreate(const char *, size_t);
+void        spillDestroy(spill_t **);
+
+// After a fork, forgets the segments and closes the fds inherited from
+// the parent.  The parent's files are left alone; they're still its own.
+void        spillReset(spill_t *);
+
+// Append a message.  0 on success, -1 if the message was dropped.
+int         spillWrite(spill_t *, const char *, size_t);
+
+// Send up to max messages, oldest first, with the provided function.
+// Stops early when the send function fails.  Returns the number sent.
+int         spillReplay(spill_t *, spill_send_fn_t, void *, unsigned);
+
+// Accessors
+int         spillEmpty(spill_t *);
+size_t      spillBytes(spill_t *);
+const char *spillDir(spill_t *);
+size_t      spillMaxBytes(spill_t *);
+
+// Copies out the counters accumulated since the previous call, and
+// resets them to zero.
+void        spillCountersGet(spill_t *, spill_counters_t *);
+
+#endif // __SPILL_H__
@@ -11,6 +11,7 @@
 #include <fcntl.h>
 
 #include "atomic.h"
+#include "bytesig.h"
 #include "com.h"
 #include "dbg.h"
 #include "dns.h"
@@ -44,11 +45,28 @@ summary_t g_summary = {{0}};
 net_info *g_netinfo;
 fs_info *g_fsinfo;
 metric_counters g_ctrs = {{0}};
+duration_histos g_histos = {{0}};
 int g_mtc_addr_output = TRUE;
 static search_t* g_http_redirect = NULL;
-static list_t *g_protlist;
 static unsigned int g_prot_sequence = 0;
-static protocol_def_t *g_payload_pre = NULL;
+static bytesig_t *g_payload_sig = NULL;
+
+// The protocol definitions that are checked, in the order they were added.
+// A set isn't changed once it's published; adding or deleting a definition
+// publishes a new one, so that it can be walked without a lock.  Changes
+// are only made by one thread, the one that applies requests.
+typedef struct protocol_set {
+    struct protocol_set *next;      // the next older one that was replaced
+    unsigned int num;
+    protocol_def_t *def[];
+} protocol_set_t;
+
+static protocol_set_t *g_protset = NULL;
+// Sets that were replaced, newest first.  They're freed, with the
+// definitions that were deleted, once no thread is walking a set.
+static protocol_set_t *g_oldprotsets = NULL;
+// How many threads are walking a set right now
+static unsigned int g_protreaders = 0;
 
 #define REDIRECTURL "fluentd"
 #define OVERURL "<!DOCTYPE html>\r\n<html>\r\n<head>\r\n<meta http-equiv=\"refresh\" content=\"3; URL='http://cribl.io'\" />\r\n</head>\r\n<body>\r\n<h1>Welcome to Cribl!</h1>\r\n</body>\r\n</html>\r\n\r\n"
@@ -127,23 +145,89 @@ get_port_net(net_info *net, int type, control_type_t which) {
     return htons(port);
 }
 
+static protocol_set_t *
+protocolSetCreate(unsigned int max)
+{
+    protocol_set_t *set = malloc(sizeof(*set) + max * sizeof(set->def[0]));
+    if (!set) {
+        DBG(NULL);
+        return NULL;
+    }
+    set->next = NULL;
+    set->num = 0;
+    return set;
+}
+
+static bool
+protocolSetHas(protocol_set_t *set, protocol_def_t *def)
+{
+    unsigned int i;
+    for (i = 0; set && (i < set->num); i++) {
+        if (set->def[i] == def) return TRUE;
+    }
+    return FALSE;
+}
+
+static void
+protocolSetPublish(protocol_set_t *set)
+{
+    protocol_set_t *cur = g_protset;
+
+    __atomic_store_n(&g_protset, set, __ATOMIC_SEQ_CST);
+    if (cur) {
+        cur->next = g_oldprotsets;
+        g_oldprotsets = cur;
+    }
+
+    // A thread that starts walking after the store sees the new set.  So
+    // with no threads walking, none can still be walking an old one.
+    // Otherwise they're kept until the next change finds none walking.
+    if (__atomic_load_n(&g_protreaders, __ATOMIC_SEQ_CST)) return;
+
+    protocol_set_t *old;
+    while ((old = g_oldprotsets)) {
+        g_oldprotsets = old->next;
+
+        // A deleted definition is destroyed with the oldest set it's in
+        unsigned int i;
+        for (i = 0; i < old->num; i++) {
+            protocol_def_t *def = old->def[i];
+            protocol_set_t *older;
+            bool again = protocolSetHas(set, def);
+            for (older = g_oldprotsets; older && !again; older = older->next) {
+                again = protocolSetHas(older, def);
+            }
+            if (!again) destroyProtEntry(def);
+        }
+        free(old);
+    }
+}
+
 bool
 delProtocol(request_t *req)
 {
-    unsigned int ptype;
+    unsigned int i;
     protocol_def_t *protoreq, *protolist;
 
     if (!req) return FALSE;
 
     protoreq = req->protocol;
 
-    for (ptype = 0; ptype <= g_prot_sequence; ptype++) {
-        if ((protolist = lstFind(g_protlist, ptype)) != NULL) {
-            if (strncmp(protoreq->protname, protolist->protname, strlen(protolist->protname)) == 0) {
-                // decrement g_prot_sequence?: values are assigned to an entry, used as a key
-                lstDelete(g_protlist, ptype);
+    protocol_set_t *cur = g_protset;
+    protocol_set_t *set;
+    if (protoreq && cur && (set = protocolSetCreate(cur->num))) {
+        for (i = 0; i < cur->num; i++) {
+            protolist = cur->def[i];
+            if (strncmp(protoreq->protname, protolist->protname, strlen(protolist->protname))) {
+                set->def[set->num++] = protolist;
             }
         }
+
+        if (set->num < cur->num) {
+            protocolSetPublish(set);
+        } else {
+            free(set);
+        }
     }
 
     if (protoreq && protoreq->protname) free(protoreq->protname);
@@ -162,21 +246,44 @@ addProtocol(request_t *req)
 
     proto = req->protocol;
 
-    proto->re = pcre2_compile((PCRE2_SPTR)proto->regex, PCRE2_ZERO_TERMINATED,
-                              0, &errornumber, &erroroffset, NULL);
-
-    if (proto->re == NULL) {
-        destroyProtEntry(proto);
-        return FALSE;
+    /*
+     * A signature is matched against the bytes themselves.  So is a
+     * binary regex that's simple enough to be turned into one; others
+     * are matched against the bytes in hex.
+     */
+    if (proto->signature) {
+        proto->sig = bytesigCreate(proto->signature);
+    } else if (proto->binary) {
+        proto->sig = bytesigFromHexRegex(proto->regex);
     }
 
-    proto->type = ++g_prot_sequence;
+    if (!proto->sig) {
+        proto->re = (proto->regex) ?
+            pcre2_compile((PCRE2_SPTR)proto->regex, PCRE2_ZERO_TERMINATED,
+                          0, &errornumber, &erroroffset, NULL) : NULL;
+
+        if ((proto->re == NULL) || proto->signature) {
+            destroyProtEntry(proto);
+            return FALSE;
+        }
 
-    if (lstInsert(g_protlist, proto->type, proto) == FALSE) {
+        // If there's no JIT support, pcre2_match() interprets the pattern
+        pcre2_jit_compile(proto->re, PCRE2_JIT_COMPLETE);
+    }
+
+    protocol_set_t *cur = g_protset;
+    unsigned int num = (cur) ? cur->num : 0;
+    protocol_set_t *set = protocolSetCreate(num + 1);
+    if (!set) {
         destroyProtEntry(proto);
-        --g_prot_sequence;
         return FALSE;
     }
+    if (num) memcpy(set->def, cur->def, num * sizeof(set->def[0]));
+    set->def[num] = proto;
+    set->num = num + 1;
+
+    proto->type = ++g_prot_sequence;
+    protocolSetPublish(set);
 
     return TRUE;
 }
@@ -184,34 +291,8 @@ addProtocol(request_t *req)
 static void
 initPayloadExtract()
 {
-    int errornumber = 0;
-    PCRE2_SIZE erroroffset = 0;
-
-    if ((g_payload_pre = calloc(1, sizeof(protocol_def_t))) == NULL) return;
-
-    g_payload_pre->binary = TRUE;
-    g_payload_pre->len = PAYLOAD_BYTESRC;
-    g_payload_pre->type = 0;
-    g_payload_pre->protname = NULL;
-    g_payload_pre->regex = PAYLOAD_REGEX;
-
-    g_payload_pre->re = pcre2_compile((PCRE2_SPTR)g_payload_pre->regex,
-                                      PCRE2_ZERO_TERMINATED, 0,
-                                      &errornumber, &erroroffset, NULL);
-
-    if (g_payload_pre->re == NULL) {
-        destroyProtEntry(g_payload_pre);
-        g_payload_pre = NULL;
-        return;
-    }
-
-    g_payload_pre->match_data = pcre2_match_data_create_from_pattern(g_payload_pre->re, NULL);
-
-    if (g_payload_pre->match_data == NULL) {
-        destroyProtEntry(g_payload_pre);
-        g_payload_pre = NULL;
-        return;
-    }
+    g_payload_sig = bytesigCreate(PAYLOAD_SIGNATURE);
+    if (!g_payload_sig) DBG(NULL);
 }
 
 static void
@@ -285,7 +366,6 @@ initState()
 
     g_http_redirect = searchComp(REDIRECTURL);
 
-    g_protlist = lstCreate(destroyProtEntry);
     initProtocolDetection();
     initPayloadExtract();
 
@@ -296,6 +376,7 @@ void
 resetState()
 {
     memset(&g_ctrs, 0, sizeof(struct metric_counters_t));
+    memset(&g_histos, 0, sizeof(g_histos));
 }
 
 // DEBUG
@@ -446,6 +527,7 @@ postFSState(int fd, metric_t type, fs_info *fs, const char *funcop, const char *
     fsp->fd = fd;
     fsp->evtype = EVT_FS;
     fsp->data_type = type;
+    fsp->captured = getTime();
 
     if (pathname && (fs->path[0] == '\0')) {
         strncpy(fsp->path, pathname, strnlen(pathname, sizeof(fsp->path)));
@@ -479,6 +561,7 @@ postDNSState(int fd, metric_t type, net_info *net, uint64_t duration, const char
     netp->fd = fd;
     netp->evtype = EVT_DNS;
     netp->data_type = type;
+    netp->captured = getTime();
 
     if (duration > 0) {
         addToInterfaceCounts(&netp->totalDuration, duration);
@@ -529,6 +612,7 @@ postNetState(int fd, metric_t type, net_info *net)
     netp->fd = fd;
     netp->evtype = EVT_NET;
     netp->data_type = type;
+    netp->captured = getTime();
 
     cmdPostEvent(g_ctl, (char *)netp);
     return mtc_needs_reporting;
@@ -598,6 +682,7 @@ doUpdateState(metric_t type, int fd, ssize_t size, const char *funcop, const cha
             addToInterfaceCounts(&g_netinfo[fd].totalDuration, new_duration);
             addToInterfaceCounts(&g_ctrs.connDurationNum, 1);
             addToInterfaceCounts(&g_ctrs.connDurationTotal, new_duration);
+            histoRecord(&g_histos.conn, new_duration);
         }
 
         if ((g_netinfo[fd].rxBytes.evt > 0) || (g_netinfo[fd].txBytes.evt > 0) ||
@@ -709,6 +794,7 @@ doUpdateState(metric_t type, int fd, ssize_t size, const char *funcop, const cha
         addToInterfaceCounts(&g_fsinfo[fd].totalDuration, size);
         addToInterfaceCounts(&g_ctrs.fsDurationNum, 1);
         addToInterfaceCounts(&g_ctrs.fsDurationTotal, size);
+        histoRecord(&g_histos.fs, size);
         if (postFSState(fd, type, &g_fsinfo[fd], funcop, pathname)) {
             atomicSwapU64(&g_fsinfo[fd].numDuration.mtc, 0);
             atomicSwapU64(&g_fsinfo[fd].totalDuration.mtc, 0);
@@ -863,17 +949,53 @@ doUpdateState(metric_t type, int fd, ssize_t size, const char *funcop, const cha
     }
 }
 
+// Returns 1 if pre's regex matches the first len bytes of buf (as hex,
+// for a binary protocol), 0 if it doesn't, or -1 if it can't tell
+static int
+protocolRegexMatch(protocol_def_t *pre, char *buf, size_t len)
+{
+    static const char hex[] = "0123456789abcdef";
+    char cpdata[(MAX_CONVERT * 2) + 1];
+    char *data = buf;
+    pcre2_match_data *match_data, *temp = NULL;
+
+    if (pre->binary) {
+        if (len > MAX_CONVERT) return -1;
+
+        size_t i;
+        for (i = 0; i < len; i++) {
+            cpdata[i << 1] = hex[(unsigned char)buf[i] >> 4];
+            cpdata[(i << 1) + 1] = hex[buf[i] & 0xf];
+        }
+        cpdata[len * 2] = '\0';
+
+        data = cpdata;
+        len = len * 2;
+    }
+
+    if (!(match_data = pcre2ThreadMatchData()) &&
+        !(match_data = temp = pcre2_match_data_create(1, NULL))) {
+        return -1;
+    }
+
+    int rc = pcre2_match_wrapper(pre->re, (PCRE2_SPTR)data, (PCRE2_SIZE)len, 0, 0,
+                                 match_data, NULL);
+    if (temp) pcre2_match_data_free(temp);
+
+    // 0 means a match, with captures that didn't fit in the match data
+    return (rc >= 0);
+}
+
 static bool
 setProtocol(int sockfd, protocol_def_t *pre, net_info *net, char *buf, size_t len)
 {
-    char *data, *cpdata = NULL;
-    pcre2_match_data *match_data;
     protocol_info *proto;
+    int match;
 
     // nothing we can do; don't risk reading past end of a buffer
     size_t cvlen = (len < MAX_CONVERT) ? len : MAX_CONVERT;
     if (((len <= 0) && (pre->len <= 0)) ||   // no len
-        !pre->re ||                          // no regex
+        (!pre->re && !pre->sig) ||           // nothing to match
         (pre->len > cvlen)) {                // not enough buf for pre->len
         SET_PROT(net);
         return FALSE;
@@ -888,36 +1010,19 @@ setProtocol(int sockfd, protocol_def_t *pre, net_info *net, char *buf, size_t le
         cvlen = pre->len;
     }
 
-    if (pre->binary == FALSE) {
-        data = buf;
-    } else {
-        int i;
-        size_t alen = (cvlen * 2) + 1;
-
-        if ((cpdata = calloc(1, alen)) == NULL) {
-            SET_PROT(net);
-            return FALSE;
-        }
-
-        for (i = 0; i < cvlen; i++) {
-            snprintf(&cpdata[i<<1], 3, "%02x", (unsigned char)buf[i]);
-        }
-
-        data = cpdata;
-        cvlen = cvlen * 2;
+    if (pre->sig) {
+        match = bytesigMatch(pre->sig, buf, cvlen);
+    } else if ((match = protocolRegexMatch(pre, buf, cvlen)) < 0) {
+        SET_PROT(net);
+        return FALSE;
     }
 
-    match_data = pcre2_match_data_create_from_pattern(pre->re, NULL);
-    if (pcre2_match_wrapper(pre->re, (PCRE2_SPTR)data, (PCRE2_SIZE)cvlen, 0, 0,
-                            match_data, NULL) > 0) {
+    SET_PROT(net);
+
+    if (match) {
         //DEBUG
         //scopeLog("setProtocol: SUCCESS", sockfd, CFG_LOG_ERROR);
-        SET_PROT(net);
-
         if ((proto = calloc(1, sizeof(struct protocol_info_t))) == NULL) {
-            if (cpdata) free(cpdata);
-            if (match_data) pcre2_match_data_free(match_data);
-            SET_PROT(net);
             return FALSE;
         }
 
@@ -927,14 +1032,10 @@ setProtocol(int sockfd, protocol_def_t *pre, net_info *net, char *buf, size_t le
         proto->fd = sockfd;
         proto->uid = net->uid;
         proto->data = (char *)strdup(pre->protname);
+        proto->captured = getTime();
         cmdPostEvent(g_ctl, (char *)proto);
-    } else {
-        SET_PROT(net);
     }
 
-    if (match_data) pcre2_match_data_free(match_data);
-    if (cpdata) free(cpdata);
-
     // return true implies no error and not a match; completed a scan
     return TRUE;
 }
@@ -959,38 +1060,29 @@ extractPayload(int sockfd, net_info *net, void *buf, size_t len, metric_t src, s
         if (net && (net->protocol == PROT_TLS)) return 0;
 
         // haven't checked for a protocol yet
-        if (net && (net->protocol == PROT_NOTCHECKED) && g_payload_pre) {
-            int rc;
-            unsigned char *data = buf;
-
-            // TLS data is binary, convert to chars
-            int i;
-            size_t alen = (g_payload_pre->len * 2) + 1;
-            char cpdata[alen];
-
-            memset(cpdata, 0, alen);
-
-            for (i = 0; i < g_payload_pre->len; i++) {
-                snprintf(&cpdata[i<<1], 3, "%02x", (unsigned char)data[i]);
+        if (net && (net->protocol == PROT_NOTCHECKED) && g_payload_sig) {
+            // A handshake starts the first buffer, or its first vector
+            const void *data = buf;
+            size_t dlen = len;
+            if (dtype == MSG) {
+                struct msghdr *msg = (struct msghdr *)buf;
+                int first = msg->msg_iov && msg->msg_iovlen;
+                data = (first) ? msg->msg_iov[0].iov_base : NULL;
+                dlen = (first) ? msg->msg_iov[0].iov_len : 0;
+            } else if (dtype == IOV) {
+                // len is the iovcnt here
+                struct iovec *iov = (struct iovec *)buf;
+                int first = iov && (len > 0);
+                data = (first) ? iov[0].iov_base : NULL;
+                dlen = (first) ? iov[0].iov_len : 0;
             }
 
-            if ((rc = pcre2_match_wrapper(g_payload_pre->re, (PCRE2_SPTR)cpdata,
-                                          (PCRE2_SIZE)alen, 0, 0,
-                                          g_payload_pre->match_data, NULL)) > 0) {
+            if (bytesigMatch(g_payload_sig, data, dlen)) {
                 net->protocol = PROT_TLS;
                 return 0;
-            } else {
-                net->protocol = PROT_CHECKED;
-                switch(rc)
-                {
-                case PCRE2_ERROR_NOMATCH:
-                    scopeLog("extractPayload: No match", sockfd, CFG_LOG_DEBUG);
-                    break;
-                default:
-                    scopeLog("extractPayload: Matching error", sockfd, CFG_LOG_DEBUG);
-                    break;
-                }
             }
+            net->protocol = PROT_CHECKED;
+            scopeLog("extractPayload: No match", sockfd, CFG_LOG_DEBUG);
         }
     }
 
@@ -1077,6 +1169,7 @@ extractPayload(int sockfd, net_info *net, void *buf, size_t len, metric_t src, s
     pinfo->src = src;
     pinfo->sockfd = sockfd;
     pinfo->len = len;
+    gettimeofday(&pinfo->tv, NULL);
 
     if (cmdPostPayload(g_ctl, (char *)pinfo) == -1) {
         if (pinfo->data) free(pinfo->data);
@@ -1087,58 +1180,79 @@ extractPayload(int sockfd, net_info *net, void *buf, size_t len, metric_t src, s
     return 0;
 }
 
+// Lets the periodic thread close the files holding a connection's payloads
+static void
+payloadConnClosed(int sockfd, net_info *net)
+{
+    if (!net || !net->uid || !ctlPayEnable(g_ctl)) return;
+
+    payload_info *pinfo = calloc(1, sizeof(struct payload_info_t));
+    if (!pinfo) return;
+
+    pinfo->evtype = EVT_NET;
+    pinfo->sockfd = sockfd;
+    pinfo->net.uid = net->uid;
+
+    if (cmdPostPayload(g_ctl, (char *)pinfo) == -1) {
+        free(pinfo);
+    }
+}
+
 static void
 detectProtocol(int sockfd, net_info *net, void *buf, size_t len, metric_t src, src_data_t dtype)
 {
-    unsigned int ptype;
+    unsigned int ix;
     protocol_def_t *pre;
 
     // check once per connection
     if (!buf || !net || (net->protocol != PROT_NOTCHECKED)) return;
 
-    for (ptype = 0; ptype <= g_prot_sequence; ptype++) {
-        if ((pre = lstFind(g_protlist, ptype)) != NULL) {
-            switch (dtype) {
-            case BUF:
-                setProtocol(sockfd, pre, net, buf, len);
-                break;
-
-            case MSG:
-            {
-                int i;
-                struct msghdr *msg = (struct msghdr *)buf;
-                struct iovec *iov;
+    // Counted as walking before the set is loaded; see protocolSetPublish()
+    __atomic_add_fetch(&g_protreaders, 1, __ATOMIC_SEQ_CST);
+    protocol_set_t *set = __atomic_load_n(&g_protset, __ATOMIC_SEQ_CST);
+    for (ix = 0; set && (ix < set->num); ix++) {
+        pre = set->def[ix];
+        switch (dtype) {
+        case BUF:
+            setProtocol(sockfd, pre, net, buf, len);
+            break;
 
-                for (i = 0; i < msg->msg_iovlen; i++) {
-                    iov = &msg->msg_iov[i];
-                    if (iov && iov->iov_base && (iov->iov_len > 0)) {
-                        // check every vector?
-                        setProtocol(sockfd, pre, net, iov->iov_base, iov->iov_len);
-                    }
+        case MSG:
+        {
+            int i;
+            struct msghdr *msg = (struct msghdr *)buf;
+            struct iovec *iov;
+
+            for (i = 0; i < msg->msg_iovlen; i++) {
+                iov = &msg->msg_iov[i];
+                if (iov && iov->iov_base && (iov->iov_len > 0)) {
+                    // check every vector?
+                    setProtocol(sockfd, pre, net, iov->iov_base, iov->iov_len);
                 }
-                break;
             }
+            break;
+        }
 
-            case IOV:
-            {
-                int i;
-                struct iovec *iov = (struct iovec *)buf;
+        case IOV:
+        {
+            int i;
+            struct iovec *iov = (struct iovec *)buf;
 
-                // len is expected to be an iovcnt for an IOV data type
-                for (i = 0; i < len; i++) {
-                    if (iov[i].iov_base && (iov[i].iov_len > 0)) {
-                        // check every vector?
-                        setProtocol(sockfd, pre, net, iov[i].iov_base, iov[i].iov_len);
-                    }
+            // len is expected to be an iovcnt for an IOV data type
+            for (i = 0; i < len; i++) {
+                if (iov[i].iov_base && (iov[i].iov_len > 0)) {
+                    // check every vector?
+                    setProtocol(sockfd, pre, net, iov[i].iov_base, iov[i].iov_len);
                 }
-                break;
             }
+            break;
+        }
 
-            default:
-                break;
-            }
+        default:
+            break;
         }
     }
+    __atomic_sub_fetch(&g_protreaders, 1, __ATOMIC_RELEASE);
 }
 
 int
@@ -2145,6 +2259,7 @@ doClose(int fd, const char *func)
         doUpdateState(NET_CONNECTIONS, fd, -1, func, NULL);
         doUpdateState(CONNECTION_DURATION, fd, -1, func, NULL);
         resetHttp(&ninfo->http);
+        payloadConnClosed(fd, ninfo);
     }
 
     // Check both file desriptor tables
@@ -3,6 +3,8 @@
 
 #include <limits.h>
 #include <sys/socket.h>
+#include <sys/time.h>
+#include "histo.h"
 
 #define PROTOCOL_STR 16
 #define FUNC_MAX 24
@@ -35,6 +37,7 @@ typedef enum
 typedef struct {
     uint64_t mtc;
     uint64_t evt;
+    uint64_t total;     // only ever added to; what a scrape reports
 } counters_element_t;
 
 typedef struct metric_counters_t {
@@ -65,6 +68,14 @@ typedef struct metric_counters_t {
     counters_element_t  fsStatErrors;
 } metric_counters;
 
+// Durations in ns, since they were last reported.  These aren't in
+// metric_counters, since that's copied into every net_info.
+typedef struct {
+    histo_t fs;
+    histo_t conn;
+    histo_t dns;
+} duration_histos;
+
 typedef struct {
     struct {
         int open_close;
@@ -91,20 +102,53 @@ typedef struct http_post_t {
     uint64_t start_duration;
     uint64_t id;
     char *hdr;
+    size_t clen;        // Length of a chunked body, or -1 if unknown
+    uint32_t stream;    // HTTP/2 stream, or 0 for HTTP/1
 } http_post;
 
+#define HTTP_MAX_HDRS 64
+
+// Where a piece of an http header is, as an offset from its start
+typedef struct {
+    uint16_t off;
+    uint16_t len;
+} http_span;
+
+// An http header, split up by one pass over it
+typedef struct {
+    http_span line[3];              // Request-Line or Status-Line, on SP
+    http_span name[HTTP_MAX_HDRS];  // Field names
+    http_span value[HTTP_MAX_HDRS]; // Field values, without whitespace
+    int num;                        // Number of fields
+} http_tokens;
+
+// Requests that can wait for responses on one connection, e.g. when
+// they're pipelined.  Past this, the oldest is given up on.
+// Requests waiting on one connection that fit in its http_map; past that
+// they're kept on the heap, up to a limit
+#define HTTP_MAX_PENDING 4
+#define HTTP_MAX_PIPELINED 64
+
+// A request waiting for its response
+typedef struct {
+    uint64_t start_time;
+    char *req;          // The whole original request
+    size_t req_len;
+    http_tokens req_tok; //  req, split up
+    size_t clen;        //   Content-Length entity-header value from req
+} http_pending;
+
 typedef struct http_map_t {
     time_t first_time;
     uint64_t frequency;
-    uint64_t start_time;
     uint64_t duration;
     uint64_t id;
-    char *req;          // The whole original request
-    size_t req_len;
-    char *method_str;   //   Method field from Request-Line
-    char *target_str;   //   Request-URI field from Request-Line
-    size_t clen;        //   Content-Length entity-header value from req
-    char *resp;         // The whole original response
+    uint32_t stream;
+    http_pending pending[HTTP_MAX_PENDING]; // In the order they were sent,
+    http_pending *ring;                     //   as a ring; in pending, or
+    int size;                               //   if there are more, in ring
+    int first;
+    int num;
 } http_map;
 
 typedef struct stat_err_info_t {
@@ -119,7 +163,9 @@ typedef enum {
     HTTP_NONE,
     HTTP_HDR,
     HTTP_HDREND,
-    HTTP_DATA
+    HTTP_DATA,
+    HTTP_CHUNKED,
+    HTTP_2
 } http_enum_t;
 
 typedef struct
@@ -141,14 +187,21 @@ typedef struct protocol_info_t {
     int sock_type;
     struct sockaddr_storage localConn;
     struct sockaddr_storage remoteConn;
+    uint64_t captured;          // TSC when posted
 } protocol_info;
 
 typedef struct {
     http_enum_t state;
     char *hdr;          // Used if state == HDR
     size_t hdrlen;
-    size_t hdralloc;
-    size_t clen;        // Used if state==HTTP_DATA
+    size_t hdrline;     //   Where the line being appended starts
+    bool hdrcut;        //   The rest of that line isn't kept
+    size_t clen;        // Used if state==HTTP_DATA or HTTP_CHUNKED
+    int chunk;          // Used if state==HTTP_CHUNKED
+    size_t bodylen;     //   Chunk data seen so far
+    uint64_t hdrtime;   //   When the header ended, if hdr is held
+    struct http2_t *h2; // Used if state==HTTP_2
+    uint32_t stream;    //   Stream hdr is from
     httpId_t id;
 } http_state_t;
 
@@ -182,6 +235,7 @@ typedef struct net_info_t {
     struct sockaddr_storage remoteConn;
     metric_counters counters;
     protocol_type_t protocol;
+    uint64_t captured;          // TSC when posted, zero in g_netinfo
 } net_info;
 
 typedef struct fs_info_t {
@@ -205,13 +259,20 @@ typedef struct fs_info_t {
     mode_t mode;
     char path[PATH_MAX];
     char funcop[FUNC_MAX];
+    uint64_t captured;          // TSC when posted, zero in g_fsinfo
 } fs_info;
 
+/*
+ * Posted to the payload ring with an evtype of EVT_PAYLOAD for each chunk
+ * of captured data.  When a connection is closed, an entry with an evtype
+ * of EVT_NET and no data is posted so its payload files can be closed.
+ */
 typedef struct payload_info_t {
     metric_t evtype;
     metric_t src;
     int sockfd;
     net_info net;
+    struct timeval tv;      // when the data was captured
     size_t len;
     char *data;
 } payload_info;
@@ -240,5 +301,6 @@ extern summary_t g_summary;
 extern net_info *g_netinfo;
 extern fs_info *g_fsinfo;
 extern metric_counters g_ctrs;
+extern duration_histos g_histos;
 
 #endif // __STATE_PRIVATE_H__
@@ -13,6 +13,7 @@
 #include <unistd.h>
 
 #include "dbg.h"
+#include "lz4s.h"
 #include "scopetypes.h"
 #include "os.h"
 #include "transport.h"
@@ -62,6 +63,18 @@ struct _transport_t
                 SSL_CTX *ctx;
                 SSL *ssl;
             } tls;
+            struct {
+                // Configuration
+                cfg_compress_t type;
+                // Operational params
+                lz4s_stream_t *lz4;
+                unsigned frame_started;
+                uint8_t *in;         // data waiting to be compressed
+                size_t inlen;
+                uint8_t *out;
+                char *tail;          // the rest of a message that was
+                size_t taillen;      //   only partly sent
+            } compress;
         } net;
         struct {
             char *path;
@@ -87,6 +100,8 @@ static struct addrinfo *g_cached_addr = NULL;
 static pthread_mutex_t g_tls_lock = PTHREAD_MUTEX_INITIALIZER;
 static int g_tls_calls_are_safe = TRUE;  // until handle_tls_destroy() is called
 
+static int tcpFinishCompressed(transport_t *);
+
 static inline void
 enterCriticalSection(void)
 {
@@ -442,6 +457,16 @@ err:
     return FALSE;
 }
 
+// Data that's buffered but not yet sent is kept; it starts the frame on
+// the next connection.
+static void
+resetCompression(transport_t *trans)
+{
+    if (!trans->net.compress.lz4) return;
+    lz4s_reset(trans->net.compress.lz4);
+    trans->net.compress.frame_started = FALSE;
+}
+
 int
 transportDisconnect(transport_t *trans)
 {
@@ -451,6 +476,8 @@ transportDisconnect(transport_t *trans)
         case CFG_TCP:
             // appropriate for both tls and non-tls connections...
             shutdownTlsSession(trans);
+            // a new connection starts a new compressed stream
+            resetCompression(trans);
             int i;
             for (i=0; i<FD_SETSIZE; i++) {
                 if (!FD_ISSET(i, &trans->net.pending_connect)) continue;
@@ -1046,10 +1073,15 @@ transportDestroy(transport_t** transport)
     switch (t->type) {
         case CFG_UDP:
         case CFG_TCP:
+            tcpFinishCompressed(t);
             transportDisconnect(t);
             if (t->net.host) free (t->net.host);
             if (t->net.port) free (t->net.port);
             if (t->net.tls.cacertpath) free(t->net.tls.cacertpath);
+            lz4s_destroy(&t->net.compress.lz4);
+            if (t->net.compress.in) free(t->net.compress.in);
+            if (t->net.compress.out) free(t->net.compress.out);
+            if (t->net.compress.tail) free(t->net.compress.tail);
             break;
         case CFG_UNIX:
             break;
@@ -1093,6 +1125,33 @@ transportConfigureTls(transport_t *trans, unsigned int enable,
     }
 }
 
+void
+transportConfigureCompression(transport_t *trans, cfg_compress_t type)
+{
+    if (!trans || (trans->type != CFG_TCP)) return;
+    if (type == trans->net.compress.type) return;
+
+    if (type == CFG_COMPRESS_LZ4) {
+        trans->net.compress.lz4 = lz4s_create();
+        trans->net.compress.in = malloc(LZ4S_BLOCK_MAX);
+        trans->net.compress.out =
+            malloc(LZ4S_FRAME_HEADER_LEN + LZ4S_BLOCK_BOUND(LZ4S_BLOCK_MAX));
+        if (!trans->net.compress.lz4 ||
+            !trans->net.compress.in || !trans->net.compress.out) {
+            DBG(NULL);
+            lz4s_destroy(&trans->net.compress.lz4);
+            if (trans->net.compress.in) free(trans->net.compress.in);
+            if (trans->net.compress.out) free(trans->net.compress.out);
+            trans->net.compress.in = NULL;
+            trans->net.compress.out = NULL;
+            return;
+        }
+    }
+    trans->net.compress.type = type;
+    trans->net.compress.frame_started = FALSE;
+    trans->net.compress.inlen = 0;
+}
+
 static int
 tcpSendPlain(transport_t *trans, const char *msg, size_t len)
 {
@@ -1182,6 +1241,144 @@ tcpSendTls(transport_t *trans, const char *msg, size_t len)
     return 0;
 }
 
+static int
+tcpSend(transport_t *trans, const char *msg, size_t len)
+{
+    if (trans->net.tls.enable) {
+        return tcpSendTls(trans, msg, len);
+    } else {
+        return tcpSendPlain(trans, msg, len);
+    }
+}
+
+/*
+ * With compression, data is collected in net.compress.in and sent as
+ * one block of an lz4 frame when 64KB has accumulated or when the
+ * transport is flushed.  Each connection carries a single frame, which
+ * starts with the first block sent after connecting.  Blocks are linked,
+ * so small blocks still benefit from the data sent before them.
+ *
+ * Messages in net.compress.in have already been accepted by
+ * transportSend(), so they stay there until they're sent; if the
+ * connection is down they go out on the next one.  So does the tail of
+ * a message too big for one block, when the blocks before it were sent.
+ */
+static void
+takeCompressedTail(transport_t *trans)
+{
+    size_t room = LZ4S_BLOCK_MAX - trans->net.compress.inlen;
+    size_t bytes = (trans->net.compress.taillen < room) ?
+                    trans->net.compress.taillen : room;
+    if (!bytes) return;
+
+    memcpy(&trans->net.compress.in[trans->net.compress.inlen],
+           trans->net.compress.tail, bytes);
+    trans->net.compress.inlen += bytes;
+    trans->net.compress.taillen -= bytes;
+    if (trans->net.compress.taillen) {
+        memmove(trans->net.compress.tail, &trans->net.compress.tail[bytes],
+                trans->net.compress.taillen);
+    } else {
+        free(trans->net.compress.tail);
+        trans->net.compress.tail = NULL;
+    }
+}
+
+static int
+tcpFlushCompressed(transport_t *trans)
+{
+    while (trans->net.compress.inlen) {
+        if (transportNeedsConnection(trans)) return -1;
+
+        uint8_t *out = trans->net.compress.out;
+        size_t outlen = 0;
+        if (!trans->net.compress.frame_started) {
+            outlen += lz4s_frame_header(out);
+        }
+
+        size_t blklen = lz4s_compress_block(trans->net.compress.lz4,
+                             trans->net.compress.in, trans->net.compress.inlen,
+                             &out[outlen], LZ4S_BLOCK_BOUND(trans->net.compress.inlen));
+        if (!blklen) {
+            DBG(NULL);
+            trans->net.compress.inlen = 0;
+            return -1;
+        }
+        outlen += blklen;
+        trans->net.compress.frame_started = TRUE;
+
+        if (tcpSend(trans, (const char *)out, outlen)) {
+            // The receiver is missing a block the ones after it depend on,
+            // so this frame can't go on; start over on a new connection.
+            if (!transportNeedsConnection(trans)) transportDisconnect(trans);
+            return -1;
+        }
+        trans->net.compress.inlen = 0;
+        takeCompressedTail(trans);
+    }
+    return 0;
+}
+
+static int
+tcpSendCompressed(transport_t *trans, const char *msg, size_t len)
+{
+    if (transportNeedsConnection(trans)) return -1;
+
+    // The rest of a message that was partly sent has to go first
+    if (trans->net.compress.tail && tcpFlushCompressed(trans)) return -1;
+
+    // What was buffered before this message.  If the message can't be
+    // taken in full, none of it stays buffered and the caller keeps it.
+    size_t keep = trans->net.compress.inlen;
+    int sent = FALSE;
+    while (len > 0) {
+        size_t room = LZ4S_BLOCK_MAX - trans->net.compress.inlen;
+        size_t bytes = (len < room) ? len : room;
+        memcpy(&trans->net.compress.in[trans->net.compress.inlen], msg, bytes);
+        trans->net.compress.inlen += bytes;
+        msg += bytes;
+        len -= bytes;
+
+        if (trans->net.compress.inlen == LZ4S_BLOCK_MAX) {
+            if (!tcpFlushCompressed(trans)) {
+                sent = TRUE;
+            } else if (!sent) {
+                trans->net.compress.inlen = keep;
+                return -1;
+            } else {
+                // Its start has been sent, so the caller can't send it
+                // again; the rest waits here for the next connection.
+                if (len && (trans->net.compress.tail = malloc(len))) {
+                    memcpy(trans->net.compress.tail, msg, len);
+                    trans->net.compress.taillen = len;
+                } else if (len) {
+                    DBG(NULL);
+                }
+                return 0;
+            }
+        }
+    }
+    return 0;
+}
+
+// Sends anything buffered, then ends the frame so the receiver knows the
+// stream ended cleanly rather than being cut off.
+static int
+tcpFinishCompressed(transport_t *trans)
+{
+    if ((trans->type != CFG_TCP) ||
+        (trans->net.compress.type == CFG_COMPRESS_NONE)) return 0;
+
+    int rc = tcpFlushCompressed(trans);
+    if (!rc && trans->net.compress.frame_started &&
+        !transportNeedsConnection(trans)) {
+        uint8_t end[LZ4S_END_MARK_LEN];
+        rc = tcpSend(trans, (const char *)end, lz4s_end_mark(end));
+    }
+    resetCompression(trans);
+    return rc;
+}
+
 int
 transportSend(transport_t *trans, const char *msg, size_t len)
 {
@@ -1213,12 +1410,10 @@ transportSend(transport_t *trans, const char *msg, size_t len)
             }
             break;
         case CFG_TCP:
-            if (trans->net.tls.enable) {
-                return tcpSendTls(trans, msg, len);
-            } else {
-                return tcpSendPlain(trans, msg, len);
+            if (trans->net.compress.type != CFG_COMPRESS_NONE) {
+                return tcpSendCompressed(trans, msg, len);
             }
-            break;
+            return tcpSend(trans, msg, len);
         case CFG_FILE:
             if (trans->file.stream) {
                 size_t msg_size = len;
@@ -1253,7 +1448,11 @@ transportFlush(transport_t* t)
 
     switch (t->type) {
         case CFG_UDP:
+            break;
         case CFG_TCP:
+            if (t->net.compress.type != CFG_COMPRESS_NONE) {
+                return tcpFlushCompressed(t);
+            }
             break;
         case CFG_FILE:
             if (fflush(t->file.stream) == EOF) {
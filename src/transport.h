@@ -16,6 +16,7 @@ void                transportDestroy(transport_t **);
 // Supplemental configuration
 void                transportConfigureTls(transport_t *,
                           unsigned int, unsigned int, const char*);
+void                transportConfigureCompression(transport_t *, cfg_compress_t);
 
 // Accessors
 int                 transportSend(transport_t *, const char *, size_t);
@@ -0,0 +1,213 @@
+#define _GNU_SOURCE
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include "dbg.h"
+#include "urinorm.h"
+
+#define MAX_TEMPLATES 64            // one bit each in a uint64_t
+#define MAX_SEGMENTS 32
+#define MIN_HEX_LEN 8
+#define UUID_LEN 36
+#define UUID_DASHES ((1ULL << 8) | (1ULL << 13) | (1ULL << 18) | (1ULL << 23))
+
+typedef struct {
+    uint16_t off;                   // in the template's text
+    uint16_t len;
+    int any;                        // in braces; matches any segment
+} tmpl_seg_t;
+
+typedef struct {
+    char *text;
+    size_t len;
+    int nseg;
+    tmpl_seg_t seg[MAX_SEGMENTS];
+} tmpl_t;
+
+struct _urinorm_t {
+    int num;
+    tmpl_t tmpl[MAX_TEMPLATES];
+};
+
+// What each byte of a target can be.  Other bytes are 0.
+#define C_DIGIT   0x1
+#define C_HEX     0x2               // a-f, A-F
+#define C_END     0x4               // ends a segment
+#define C_OTHER   0x8               // never in the table; see urinormApply
+
+static const uint8_t byteClass[256] = {
+    ['0' ... '9'] = C_DIGIT,
+    ['a' ... 'f'] = C_HEX,
+    ['A' ... 'F'] = C_HEX,
+    ['/'] = C_END,
+    ['?'] = C_END,
+    ['#'] = C_END,
+    ['\0'] = C_END,
+};
+
+// Parses one template, e.g. "/users/{id}".  Returns FALSE if it can't be used.
+static int
+tmplParse(tmpl_t *tmpl, const char *text, size_t len)
+{
+    if (!len || (text[0] != '/')) return FALSE;
+    if (!(tmpl->text = strndup(text, len))) {
+        DBG(NULL);
+        return FALSE;
+    }
+    tmpl->len = len;
+    tmpl->nseg = 0;
+
+    size_t start = 1;
+    size_t i;
+    for (i = 1; i <= len; i++) {
+        if ((i < len) && (text[i] != '/')) continue;
+
+        if (tmpl->nseg >= MAX_SEGMENTS) {
+            free(tmpl->text);
+            tmpl->text = NULL;
+            return FALSE;
+        }
+        tmpl_seg_t *seg = &tmpl->seg[tmpl->nseg++];
+        seg->off = start;
+        seg->len = i - start;
+        seg->any = (seg->len >= 2) && (text[start] == '{') && (text[i - 1] == '}');
+        start = i + 1;
+    }
+    return TRUE;
+}
+
+urinorm_t *
+urinormCreate(const char *templates)
+{
+    urinorm_t *norm = calloc(1, sizeof(*norm));
+    if (!norm) {
+        DBG(NULL);
+        return NULL;
+    }
+    if (!templates) return norm;
+
+    const char *item = templates;
+    while (*item) {
+        size_t len = strcspn(item, ",");
+        const char *next = (item[len]) ? &item[len + 1] : &item[len];
+
+        // Spaces around a template aren't part of it
+        while (len && ((*item == ' ') || (*item == '\t'))) {
+            item++;
+            len--;
+        }
+        while (len && ((item[len - 1] == ' ') || (item[len - 1] == '\t'))) {
+            len--;
+        }
+
+        if (len) {
+            if (norm->num >= MAX_TEMPLATES) break;
+            if (tmplParse(&norm->tmpl[norm->num], item, len)) norm->num++;
+        }
+        item = next;
+    }
+    return norm;
+}
+
+void
+urinormDestroy(urinorm_t **norm_ptr)
+{
+    if (!norm_ptr || !*norm_ptr) return;
+    urinorm_t *norm = *norm_ptr;
+
+    int i;
+    for (i = 0; i < norm->num; i++) {
+        free(norm->tmpl[i].text);
+    }
+    free(norm);
+    *norm_ptr = NULL;
+}
+
+// Appends what fits of str to buf, leaving room for a nul
+static void
+emit(char *buf, size_t size, size_t *len, const char *str, size_t n)
+{
+    if (*len + n >= size) n = size - 1 - *len;
+    memcpy(&buf[*len], str, n);
+    *len += n;
+}
+
+size_t
+urinormApply(urinorm_t *norm, const char *uri, char *buf, size_t size)
+{
+    if (!buf || !size) return 0;
+    buf[0] = '\0';
+    if (!norm || !uri) return 0;
+
+    const unsigned char *p = (const unsigned char *)uri;
+    size_t len = 0;
+    if (*p == '/') {
+        emit(buf, size, &len, "/", 1);
+        p++;
+    }
+
+    // Templates that match every segment so far
+    uint64_t alive = (norm->num == MAX_TEMPLATES) ? ~0ULL : (1ULL << norm->num) - 1;
+    int nseg = 0;
+
+    for (;;) {
+        const unsigned char *start = p;
+        uint8_t seen = 0;
+        int uuid = TRUE;
+        uint8_t class;
+        while (!((class = byteClass[*p]) & C_END)) {
+            size_t i = p - start;
+            if (i < UUID_LEN) {
+                uuid &= ((UUID_DASHES >> i) & 1) ?
+                        (*p == '-') : ((class & (C_DIGIT | C_HEX)) != 0);
+            }
+            seen |= (class) ? class : C_OTHER;
+            p++;
+        }
+        size_t seglen = p - start;
+
+        uint64_t check = alive;
+        while (check) {
+            int t = __builtin_ctzll(check);
+            check &= check - 1;
+            tmpl_t *tmpl = &norm->tmpl[t];
+            if (nseg >= tmpl->nseg) {
+                alive &= ~(1ULL << t);
+                continue;
+            }
+            tmpl_seg_t *seg = &tmpl->seg[nseg];
+            if ((seg->any) ? (seglen == 0) :
+                ((seglen != seg->len) || memcmp(start, &tmpl->text[seg->off], seglen))) {
+                alive &= ~(1ULL << t);
+            }
+        }
+
+        if (seen == C_DIGIT) {
+            emit(buf, size, &len, "{int}", 5);
+        } else if (uuid && (seglen == UUID_LEN)) {
+            emit(buf, size, &len, "{uuid}", 6);
+        } else if ((seen == (C_DIGIT | C_HEX)) && (seglen >= MIN_HEX_LEN)) {
+            emit(buf, size, &len, "{hex}", 5);
+        } else {
+            emit(buf, size, &len, (const char *)start, seglen);
+        }
+        nseg++;
+
+        if (*p != '/') break;
+        emit(buf, size, &len, "/", 1);
+        p++;
+    }
+
+    // The first template that matched every segment
+    while (alive) {
+        tmpl_t *tmpl = &norm->tmpl[__builtin_ctzll(alive)];
+        alive &= alive - 1;
+        if (tmpl->nseg != nseg) continue;
+        len = 0;
+        emit(buf, size, &len, tmpl->text, tmpl->len);
+        break;
+    }
+
+    buf[len] = '\0';
+    return len;
+}
@@ -0,0 +1,41 @@
+#ifndef __URINORM_H__
+#define __URINORM_H__
+
+#include <stddef.h>
+
+/*
+ * Normalizes the path of an http target before it's aggregated, so that
+ * e.g. /users/81237/orders/991 and /users/5/orders/6 are counted together
+ * as /users/{int}/orders/{int} instead of as two of thousands of targets.
+ *
+ * Path segments that are all digits become {int}, ones that look like a
+ * UUID (8-4-4-4-12 hex digits) become {uuid}, and ones of 8 or more hex
+ * digits (with at least one digit and one letter) become {hex}.  Anything
+ * after a '?' or '#' is left off.
+ *
+ * Templates are given as a comma separated list, e.g.
+ * "/users/{id}/orders/{order}, /v1/files/{name}".  A segment in braces
+ * matches any non-empty segment; others have to match exactly.  A target
+ * with the same number of segments as a template, that matches each of
+ * them, becomes the template.  The first template that matches wins, and
+ * targets that match none are normalized as above.
+ *
+ * The target is scanned once, a byte at a time; there are no regular
+ * expressions.  A urinorm_t isn't changed once it's created, so it can be
+ * used from any number of threads at once.
+ */
+
+typedef struct _urinorm_t urinorm_t;
+
+// Constructors Destructors
+// templates can be NULL.  Up to 64 templates are used; ones that don't
+// start with a '/' are ignored.
+urinorm_t *         urinormCreate(const char *templates);
+void                urinormDestroy(urinorm_t **);
+
+// Writes the normalized path of uri to buf, nul terminated, and returns
+// its length.  It's truncated if it doesn't fit in size.
+size_t              urinormApply(urinorm_t *, const char *uri,
+                                 char *buf, size_t size);
+
+#endif // __URINORM_H__
@@ -21,6 +21,7 @@
 #include "dbg.h"
 #include "dns.h"
 #include "fn.h"
+#include "httpstate.h"
 #include "os.h"
 #include "plattime.h"
 #include "report.h"
@@ -41,6 +42,7 @@ static config_t *g_staticfg = NULL;
 static log_t *g_prevlog = NULL;
 static mtc_t *g_prevmtc = NULL;
 static ctl_t *g_prevctl = NULL;
+static scrape_t *g_scrape = NULL;
 static bool g_replacehandler = FALSE;
 static const char *g_cmddir;
 static list_t *g_nsslist;
@@ -578,6 +580,8 @@ doConfig(config_t *cfg)
     }
 
     setVerbosity(cfgMtcVerbosity(cfg));
+    setHttpNormalizer(cfgMtcHttpNormalize(cfg), cfgMtcHttpTemplates(cfg));
+    setHttpHeaderCapture(cfgEvtFormatNumHeaders(cfg) > 0);
     g_cmddir = cfgCmdDir(cfg);
     g_sendprocessstart = cfgSendProcessStartMsg(cfg);
 
@@ -585,6 +589,11 @@ doConfig(config_t *cfg)
     g_mtc = initMtc(cfg);
     g_ctl = initCtl(cfg);
 
+    // Only the periodic thread polls this, and config changes are applied
+    // there too, so the old one can go right away
+    scrapeDestroy(&g_scrape);
+    if (cfgMtcScrapeEnable(cfg)) g_scrape = scrapeCreate(cfgMtcScrapeListen(cfg));
+
     if (cfgLogStream(cfg)) {
         singleChannelSet(g_ctl, g_mtc);
     }
@@ -594,6 +603,7 @@ doConfig(config_t *cfg)
     logDisconnect(g_prevlog);
     ctlStopAggregating(g_prevctl);
     ctlFlush(g_prevctl);
+    ctlSpillInherit(g_ctl, g_prevctl);
     ctlDisconnect(g_prevctl, CFG_CTL);
 }
 
@@ -813,6 +823,11 @@ doReset()
 {
     setProcId(&g_proc);
     setPidEnv(g_proc.pid);
+    ctlEvtProcChanged(g_ctl);
+    ctlSpillReset(g_ctl);
+
+    // Nothing keeps the clock current until the periodic thread restarts
+    wallClockStop();
 
     g_thread.once = 0;
     g_thread.startTime = time(NULL) + g_thread.interval;
@@ -880,6 +895,9 @@ reportPeriodicStuff(void)
     doTotalDuration(TOT_NET_DURATION);
     doTotalDuration(TOT_DNS_DURATION);
 
+    // report on events held on disk while disconnected
+    doEvtSpillMetric();
+
     // Report errors
     doErrorMetric(NET_ERR_CONN, PERIODIC, "summary", "summary", NULL);
     doErrorMetric(NET_ERR_RX_TX, PERIODIC, "summary", "summary", NULL);
@@ -913,6 +931,7 @@ handleExit(void)
         reportPeriodicStuff();
     }
 
+    doPayloadFlush();
     mtcFlush(g_mtc);
     logFlush(g_log);
     ctlStopAggregating(g_ctl);
@@ -940,6 +959,9 @@ periodic(void *arg)
     perf = checkEnv(PRESERVE_PERF_REPORTING, "true");
 
     while (1) {
+        // Keep the coarse clock used to timestamp events current
+        wallClockTick();
+
         if (time(NULL) >= summaryTime) {
             // Process dynamic config changes, if any
             dynConfig();
@@ -970,6 +992,12 @@ periodic(void *arg)
             }
         }
         remoteConfig();
+
+        // Scrapes are answered right away, rather than at the summary period
+        if (g_scrape && atomicCasU64(&reentrancy_guard, 0ULL, 1ULL)) {
+            doScrape(g_scrape);
+            atomicCasU64(&reentrancy_guard, 1ULL, 0ULL);
+        }
     }
 
     return NULL;
@@ -0,0 +1,250 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "bytesig.h"
+#include "dbg.h"
+#include "pcre2posix.h"
+#include "test.h"
+
+static const unsigned char clientHello[] = {
+    0x16, 0x03, 0x01, 0x02, 0x00, 0x01, 0x00, 0x01, 0xfc, 0x03, 0x03, 0x5a,
+    0x5a, 0x5a,
+};
+
+static const unsigned char otherHello[] = {
+    0x24, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0xd4, 0x07,
+};
+
+static void
+bytesigCreateAndDestroy(void **state)
+{
+    bytesig_t *sig = bytesigCreate("16 03");
+    assert_non_null(sig);
+    bytesigDestroy(&sig);
+    assert_null(sig);
+
+    // Don't crash
+    bytesigDestroy(&sig);
+    bytesigDestroy(NULL);
+    assert_null(bytesigCreate(NULL));
+    assert_int_equal(bytesigMatch(NULL, clientHello, sizeof(clientHello)), 0);
+}
+
+static void
+bytesigExactBytes(void **state)
+{
+    bytesig_t *sig = bytesigCreate("16 03 01");
+    assert_non_null(sig);
+    assert_int_equal(bytesigMatch(sig, clientHello, sizeof(clientHello)), 1);
+    assert_int_equal(bytesigMatch(sig, "\x16\x03\x02", 3), 0);
+    assert_int_equal(bytesigMatch(sig, "\x17\x03\x01", 3), 0);
+    bytesigDestroy(&sig);
+
+    // Case and extra spaces don't matter
+    sig = bytesigCreate("  fC \t 0A ");
+    assert_non_null(sig);
+    assert_int_equal(bytesigMatch(sig, "\xfc\x0a", 2), 1);
+    assert_int_equal(bytesigMatch(sig, "\xfc\x0b", 2), 0);
+    bytesigDestroy(&sig);
+}
+
+static void
+bytesigWildcardsRangesAndMasks(void **state)
+{
+    bytesig_t *sig = bytesigCreate("?? 1? ?f 00-03 40&f0");
+    assert_non_null(sig);
+    assert_int_equal(bytesigMatch(sig, "\xaa\x10\x0f\x00\x40", 5), 1);
+    assert_int_equal(bytesigMatch(sig, "\x00\x1f\xff\x03\x4f", 5), 1);
+    assert_int_equal(bytesigMatch(sig, "\x00\x20\xff\x03\x4f", 5), 0);
+    assert_int_equal(bytesigMatch(sig, "\x00\x1f\xfe\x03\x4f", 5), 0);
+    assert_int_equal(bytesigMatch(sig, "\x00\x1f\xff\x04\x4f", 5), 0);
+    assert_int_equal(bytesigMatch(sig, "\x00\x1f\xff\x03\x50", 5), 0);
+    bytesigDestroy(&sig);
+
+    // Any byte still has to be there
+    sig = bytesigCreate("16 ??");
+    assert_non_null(sig);
+    assert_int_equal(bytesigMatch(sig, "\x16", 1), 0);
+    assert_int_equal(bytesigMatch(sig, "\x16\x00", 2), 1);
+    bytesigDestroy(&sig);
+}
+
+static void
+bytesigOffsets(void **state)
+{
+    bytesig_t *sig = bytesigCreate("16 @5 01 ?? 01");
+    assert_non_null(sig);
+    assert_int_equal(bytesigMatch(sig, clientHello, sizeof(clientHello)), 1);
+    assert_int_equal(bytesigMatch(sig, clientHello, 7), 0);
+    assert_int_equal(bytesigMatch(sig, clientHello, 8), 1);
+    bytesigDestroy(&sig);
+
+    // Offsets can go back, too
+    sig = bytesigCreate("@4 00 @0 16");
+    assert_non_null(sig);
+    assert_int_equal(bytesigMatch(sig, clientHello, 5), 1);
+    assert_int_equal(bytesigMatch(sig, clientHello, 4), 0);
+    bytesigDestroy(&sig);
+
+    sig = bytesigCreate("@4095 ff");
+    assert_non_null(sig);
+    unsigned char *buf = calloc(1, 4096);
+    assert_non_null(buf);
+    assert_int_equal(bytesigMatch(sig, buf, 4096), 0);
+    buf[4095] = 0xff;
+    assert_int_equal(bytesigMatch(sig, buf, 4096), 1);
+    assert_int_equal(bytesigMatch(sig, buf, 4095), 0);
+    free(buf);
+    bytesigDestroy(&sig);
+}
+
+static void
+bytesigInvalid(void **state)
+{
+    const char *invalid[] = {
+        "",
+        "   ",
+        "1",
+        "123",
+        "g0",
+        "16,03",
+        "03-00",
+        "0?-03",
+        "00-0?",
+        "00-3",
+        "00~03",
+        "41&f0",
+        "@",
+        "@x",
+        "@12x",
+        "@4096 00",
+        "@4095 00 00",
+        "@5",
+    };
+    int i;
+    for (i = 0; i < sizeof(invalid) / sizeof(invalid[0]); i++) {
+        assert_null(bytesigCreate(invalid[i]));
+    }
+
+    // There's a limit on tests, but not on ones any byte passes
+    char str[4 * (BYTESIG_MAX_TESTS + 1)] = {0};
+    for (i = 0; i < BYTESIG_MAX_TESTS; i++) strcat(str, "00 ");
+    bytesig_t *sig = bytesigCreate(str);
+    assert_non_null(sig);
+    bytesigDestroy(&sig);
+    strcat(str, "?? ");
+    sig = bytesigCreate(str);
+    assert_non_null(sig);
+    bytesigDestroy(&sig);
+    strcat(str, "00");
+    assert_null(bytesigCreate(str));
+}
+
+// Does a regex match buf in lowercase hex, the way definitions without a
+// signature are matched
+static int
+regexMatchesHex(const char *regex, const unsigned char *buf, size_t len)
+{
+    char hex[(len * 2) + 1];
+    hex[0] = '\0';
+    size_t i;
+    for (i = 0; i < len; i++) {
+        snprintf(&hex[i * 2], 3, "%02x", buf[i]);
+    }
+    regex_t re;
+    assert_int_equal(regcomp(&re, regex, REG_EXTENDED), 0);
+    int rc = regexec(&re, hex, 0, NULL, 0);
+    regfree(&re);
+    return (rc == 0);
+}
+
+static void
+bytesigFromHexRegexMatchesLikeTheRegex(void **state)
+{
+    const char *regex[] = {
+        "^16030[0-3].{4}0[12]",
+        "^240100000000000000000000d407",
+        "^1[67]",
+        "^[0-36-9a]f",
+        "^.{6}0",
+    };
+    unsigned char buf[14];
+
+    srandom(42);
+    int i, j, k;
+    for (i = 0; i < sizeof(regex) / sizeof(regex[0]); i++) {
+        bytesig_t *sig = bytesigFromHexRegex(regex[i]);
+        assert_non_null(sig);
+        int matched = 0;
+        for (j = 0; j < 20000; j++) {
+            // Mostly bytes from the ones the regexes look for
+            for (k = 0; k < sizeof(buf); k++) {
+                const unsigned char likely[] = {0x00, 0x01, 0x02, 0x03, 0x04,
+                    0x10, 0x16, 0x17, 0x24, 0x3f, 0x6f, 0xaf, 0xbf, 0xd4, 0x07};
+                buf[k] = (random() & 1) ? likely[random() % sizeof(likely)] : random();
+            }
+            // From the real things, too
+            if (j & 1) {
+                const unsigned char *real = (j & 2) ? clientHello : otherHello;
+                memcpy(buf, real, sizeof(buf));
+                if (j & 4) buf[random() % sizeof(buf)] = random();
+            }
+            size_t len = random() % (sizeof(buf) + 1);
+            int expect = regexMatchesHex(regex[i], buf, len);
+            assert_int_equal(bytesigMatch(sig, buf, len), expect);
+            matched += expect;
+        }
+        assert_true(matched > 0);
+        bytesigDestroy(&sig);
+    }
+}
+
+static void
+bytesigFromHexRegexRejectsOthers(void **state)
+{
+    const char *regex[] = {
+        NULL,
+        "",
+        "^",
+        "1603",
+        "^16|17",
+        "^16.*",
+        "^16+",
+        "^(16)",
+        "^16$",
+        "^16\\x03",
+        "^16{x}",
+        "^16{}",
+        "^1603A",
+        "^[^0]",
+        "^[0-3",
+        "^[]",
+        "^[3-0]",
+        "^.{9000}",
+        "^http",
+    };
+    int i;
+    for (i = 0; i < sizeof(regex) / sizeof(regex[0]); i++) {
+        assert_null(bytesigFromHexRegex(regex[i]));
+    }
+}
+
+int
+main(int argc, char* argv[])
+{
+    printf("running %s\n", argv[0]);
+
+    const struct CMUnitTest tests[] = {
+        cmocka_unit_test(bytesigCreateAndDestroy),
+        cmocka_unit_test(bytesigExactBytes),
+        cmocka_unit_test(bytesigWildcardsRangesAndMasks),
+        cmocka_unit_test(bytesigOffsets),
+        cmocka_unit_test(bytesigInvalid),
+        cmocka_unit_test(bytesigFromHexRegexMatchesLikeTheRegex),
+        cmocka_unit_test(bytesigFromHexRegexRejectsOthers),
+        cmocka_unit_test(dbgHasNoUnexpectedFailures),
+    };
+    return cmocka_run_group_tests(tests, groupSetup, groupTeardown);
+}
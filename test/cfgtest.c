@@ -17,12 +17,19 @@ verifyDefaults(config_t* config)
     assert_int_equal       (cfgMtcStatsDMaxLen(config), DEFAULT_STATSD_MAX_LEN);
     assert_int_equal       (cfgMtcVerbosity(config), DEFAULT_MTC_VERBOSITY);
     assert_int_equal       (cfgMtcPeriod(config), DEFAULT_SUMMARY_PERIOD);
+    assert_int_equal       (cfgMtcScrapeEnable(config), DEFAULT_MTC_SCRAPE_ENABLE);
+    assert_string_equal    (cfgMtcScrapeListen(config), DEFAULT_MTC_SCRAPE_LISTEN);
+    assert_int_equal       (cfgMtcHttpNormalize(config), DEFAULT_MTC_HTTP_NORMALIZE);
+    assert_null            (cfgMtcHttpTemplates(config));
     assert_string_equal    (cfgCmdDir(config), DEFAULT_COMMAND_DIR);
     assert_int_equal       (cfgSendProcessStartMsg(config), DEFAULT_PROCESS_START_MSG);
     assert_int_equal       (cfgEvtEnable(config), DEFAULT_EVT_ENABLE);
     assert_int_equal       (cfgEventFormat(config), DEFAULT_CTL_FORMAT);
     assert_int_equal       (cfgEvtRateLimit(config), DEFAULT_MAXEVENTSPERSEC);
+    assert_int_equal       (cfgEvtCaptureTime(config), DEFAULT_EVT_CAPTURE_TIME);
     assert_int_equal       (cfgEnhanceFs(config), DEFAULT_ENHANCE_FS);
+    assert_null            (cfgEvtSpillDir(config));
+    assert_int_equal       (cfgEvtSpillMaxSize(config), DEFAULT_EVT_SPILL_MAXSIZE);
     assert_string_equal    (cfgEvtFormatValueFilter(config, CFG_SRC_FILE), DEFAULT_SRC_FILE_VALUE);
     assert_string_equal    (cfgEvtFormatValueFilter(config, CFG_SRC_CONSOLE), DEFAULT_SRC_CONSOLE_VALUE);
     assert_string_equal    (cfgEvtFormatValueFilter(config, CFG_SRC_SYSLOG), DEFAULT_SRC_SYSLOG_VALUE);
@@ -75,6 +82,7 @@ verifyDefaults(config_t* config)
     assert_int_equal       (cfgLogLevel(config), DEFAULT_LOG_LEVEL);
     assert_int_equal       (cfgPayEnable(config), DEFAULT_PAYLOAD_ENABLE);
     assert_string_equal    (cfgPayDir(config), DEFAULT_PAYLOAD_DIR);
+    assert_int_equal       (cfgPayFormat(config), DEFAULT_PAYLOAD_FORMAT);
 }
 
 static void
@@ -132,6 +140,9 @@ cfgMtcFormatSetAndGet(void** state)
     assert_int_equal(cfgMtcFormat(config), CFG_FMT_NDJSON);
     cfgMtcFormatSet(config, CFG_FMT_STATSD);
     assert_int_equal(cfgMtcFormat(config), CFG_FMT_STATSD);
+    // msgpack is for events only
+    cfgMtcFormatSet(config, CFG_FMT_MSGPACK);
+    assert_int_equal(cfgMtcFormat(config), CFG_FMT_STATSD);
     cfgMtcFormatSet(config, CFG_FMT_NDJSON);
     assert_int_equal(cfgMtcFormat(config), CFG_FMT_NDJSON);
     cfgDestroy(&config);
@@ -241,6 +252,8 @@ cfgEventFormatSetAndGet(void** state)
     config_t* config = cfgCreateDefault();
     cfgEventFormatSet(config, CFG_FMT_STATSD);
     assert_int_equal(cfgEventFormat(config), CFG_FMT_STATSD);
+    cfgEventFormatSet(config, CFG_FMT_MSGPACK);
+    assert_int_equal(cfgEventFormat(config), CFG_FMT_MSGPACK);
     cfgEventFormatSet(config, CFG_FMT_NDJSON);
     assert_int_equal(cfgEventFormat(config), CFG_FMT_NDJSON);
     cfgEventFormatSet(config, CFG_FMT_NDJSON);
@@ -261,6 +274,19 @@ cfgEvtRateLimitSetAndGet(void** state)
     cfgDestroy(&config);
 }
 
+static void
+cfgEvtCaptureTimeSetAndGet(void** state)
+{
+    config_t* config = cfgCreateDefault();
+    cfgEvtCaptureTimeSet(config, 1);
+    assert_int_equal(cfgEvtCaptureTime(config), 1);
+    cfgEvtCaptureTimeSet(config, 0);
+    assert_int_equal(cfgEvtCaptureTime(config), 0);
+    cfgEvtCaptureTimeSet(config, 2);
+    assert_int_equal(cfgEvtCaptureTime(config), 0);
+    cfgDestroy(&config);
+}
+
 static void
 cfgEnhanceFsSetAndGet(void** state)
 {
@@ -272,6 +298,81 @@ cfgEnhanceFsSetAndGet(void** state)
     cfgDestroy(&config);
 }
 
+static void
+cfgEvtSpillSetAndGet(void** state)
+{
+    config_t* config = cfgCreateDefault();
+    cfgEvtSpillDirSet(config, "/var/tmp");
+    assert_string_equal(cfgEvtSpillDir(config), "/var/tmp");
+    cfgEvtSpillDirSet(config, "");
+    assert_null(cfgEvtSpillDir(config));
+    cfgEvtSpillDirSet(config, NULL);
+    assert_null(cfgEvtSpillDir(config));
+
+    cfgEvtSpillMaxSizeSet(config, 4096);
+    assert_int_equal(cfgEvtSpillMaxSize(config), 4096);
+    cfgDestroy(&config);
+
+    // Don't crash
+    cfgEvtSpillDirSet(config, "/var/tmp");
+    cfgEvtSpillMaxSizeSet(config, 4096);
+    assert_null(cfgEvtSpillDir(config));
+    assert_int_equal(cfgEvtSpillMaxSize(config), DEFAULT_EVT_SPILL_MAXSIZE);
+}
+
+static void
+cfgMtcScrapeSetAndGet(void** state)
+{
+    config_t* config = cfgCreateDefault();
+    cfgMtcScrapeEnableSet(config, TRUE);
+    assert_int_equal(cfgMtcScrapeEnable(config), TRUE);
+    cfgMtcScrapeEnableSet(config, 2);
+    assert_int_equal(cfgMtcScrapeEnable(config), TRUE);
+    cfgMtcScrapeEnableSet(config, FALSE);
+    assert_int_equal(cfgMtcScrapeEnable(config), FALSE);
+
+    cfgMtcScrapeListenSet(config, "unix:///var/run/scope.sock");
+    assert_string_equal(cfgMtcScrapeListen(config), "unix:///var/run/scope.sock");
+    cfgMtcScrapeListenSet(config, "");
+    assert_string_equal(cfgMtcScrapeListen(config), DEFAULT_MTC_SCRAPE_LISTEN);
+    cfgMtcScrapeListenSet(config, NULL);
+    assert_string_equal(cfgMtcScrapeListen(config), DEFAULT_MTC_SCRAPE_LISTEN);
+    cfgDestroy(&config);
+
+    // Don't crash
+    cfgMtcScrapeEnableSet(config, TRUE);
+    cfgMtcScrapeListenSet(config, "tcp://127.0.0.1:9999");
+    assert_int_equal(cfgMtcScrapeEnable(config), DEFAULT_MTC_SCRAPE_ENABLE);
+    assert_string_equal(cfgMtcScrapeListen(config), DEFAULT_MTC_SCRAPE_LISTEN);
+}
+
+static void
+cfgMtcHttpSetAndGet(void** state)
+{
+    config_t* config = cfgCreateDefault();
+    cfgMtcHttpNormalizeSet(config, FALSE);
+    assert_int_equal(cfgMtcHttpNormalize(config), FALSE);
+    cfgMtcHttpNormalizeSet(config, 2);
+    assert_int_equal(cfgMtcHttpNormalize(config), FALSE);
+    cfgMtcHttpNormalizeSet(config, TRUE);
+    assert_int_equal(cfgMtcHttpNormalize(config), TRUE);
+
+    cfgMtcHttpTemplatesSet(config, "/users/{id},/files/{name}");
+    assert_string_equal(cfgMtcHttpTemplates(config), "/users/{id},/files/{name}");
+    cfgMtcHttpTemplatesSet(config, "");
+    assert_null(cfgMtcHttpTemplates(config));
+    cfgMtcHttpTemplatesSet(config, "/a/{b}");
+    cfgMtcHttpTemplatesSet(config, NULL);
+    assert_null(cfgMtcHttpTemplates(config));
+    cfgDestroy(&config);
+
+    // Don't crash
+    cfgMtcHttpNormalizeSet(config, FALSE);
+    cfgMtcHttpTemplatesSet(config, "/a/{b}");
+    assert_int_equal(cfgMtcHttpNormalize(config), DEFAULT_MTC_HTTP_NORMALIZE);
+    assert_null(cfgMtcHttpTemplates(config));
+}
+
 typedef struct
 {
     watch_t   src;
@@ -511,6 +612,26 @@ cfgTransportBufSetAndGet(void** state)
     cfgDestroy(&config);
 }
 
+static void
+cfgTransportCompressionSetAndGet(void** state)
+{
+    which_transport_t t = *(which_transport_t*)state[0];
+    config_t* config = cfgCreateDefault();
+    assert_int_equal(cfgTransportCompression(config, t), DEFAULT_COMPRESSION);
+    cfgTransportCompressionSet(config, t, CFG_COMPRESS_LZ4);
+    assert_int_equal(cfgTransportCompression(config, t), CFG_COMPRESS_LZ4);
+    cfgTransportCompressionSet(config, t, CFG_COMPRESS_NONE);
+    assert_int_equal(cfgTransportCompression(config, t), CFG_COMPRESS_NONE);
+
+    // Don't crash
+    cfgTransportCompressionSet(NULL, t, CFG_COMPRESS_LZ4);
+    assert_int_equal(cfgTransportCompression(NULL, t), DEFAULT_COMPRESSION);
+    cfgTransportCompressionSet(config, t, CFG_COMPRESS_LZ4+1);
+    assert_int_equal(cfgTransportCompression(config, t), CFG_COMPRESS_NONE);
+
+    cfgDestroy(&config);
+}
+
 
 static void
 cfgCustomTagsSetAndGet(void** state)
@@ -600,6 +721,23 @@ cfgPayDirSetAndGet(void** state)
     cfgDestroy(&config);
 }
 
+static void
+cfgPayFormatSetAndGet(void** state)
+{
+    config_t* config = cfgCreateDefault();
+    cfgPayFormatSet(config, CFG_PAY_PCAPNG);
+    assert_int_equal(cfgPayFormat(config), CFG_PAY_PCAPNG);
+    cfgPayFormatSet(config, CFG_PAY_RAW);
+    assert_int_equal(cfgPayFormat(config), CFG_PAY_RAW);
+
+    // Invalid values are ignored
+    cfgPayFormatSet(config, CFG_PAY_PCAPNG + 1);
+    assert_int_equal(cfgPayFormat(config), CFG_PAY_RAW);
+    cfgPayFormatSet(config, -1);
+    assert_int_equal(cfgPayFormat(config), CFG_PAY_RAW);
+    cfgDestroy(&config);
+}
+
 
 int
 main(int argc, char* argv[])
@@ -633,7 +771,11 @@ main(int argc, char* argv[])
         cmocka_unit_test(cfgEvtEnableSetAndGet),
         cmocka_unit_test(cfgEventFormatSetAndGet),
         cmocka_unit_test(cfgEvtRateLimitSetAndGet),
+        cmocka_unit_test(cfgEvtCaptureTimeSetAndGet),
         cmocka_unit_test(cfgEnhanceFsSetAndGet),
+        cmocka_unit_test(cfgEvtSpillSetAndGet),
+        cmocka_unit_test(cfgMtcScrapeSetAndGet),
+        cmocka_unit_test(cfgMtcHttpSetAndGet),
 
         cmocka_unit_test_prestate(cfgEvtFormatValueFilterSetAndGet, &log),
         cmocka_unit_test_prestate(cfgEvtFormatValueFilterSetAndGet, &con),
@@ -669,24 +811,28 @@ main(int argc, char* argv[])
         cmocka_unit_test_prestate(cfgTransportPortSetAndGet, mtc_state),
         cmocka_unit_test_prestate(cfgTransportPathSetAndGet, mtc_state),
         cmocka_unit_test_prestate(cfgTransportBufSetAndGet,  mtc_state),
+        cmocka_unit_test_prestate(cfgTransportCompressionSetAndGet, mtc_state),
 
         cmocka_unit_test_prestate(cfgTransportTypeSetAndGet, evt_state),
         cmocka_unit_test_prestate(cfgTransportHostSetAndGet, evt_state),
         cmocka_unit_test_prestate(cfgTransportPortSetAndGet, evt_state),
         cmocka_unit_test_prestate(cfgTransportPathSetAndGet, evt_state),
         cmocka_unit_test_prestate(cfgTransportBufSetAndGet,  evt_state),
+        cmocka_unit_test_prestate(cfgTransportCompressionSetAndGet, evt_state),
 
         cmocka_unit_test_prestate(cfgTransportTypeSetAndGet, log_state),
         cmocka_unit_test_prestate(cfgTransportHostSetAndGet, log_state),
         cmocka_unit_test_prestate(cfgTransportPortSetAndGet, log_state),
         cmocka_unit_test_prestate(cfgTransportPathSetAndGet, log_state),
         cmocka_unit_test_prestate(cfgTransportBufSetAndGet,  log_state),
+        cmocka_unit_test_prestate(cfgTransportCompressionSetAndGet, log_state),
 
         cmocka_unit_test(cfgCustomTagsSetAndGet),
         cmocka_unit_test(cfgLoggingSetAndGet),
         cmocka_unit_test(cfgLogLevelSetAndGet),
         cmocka_unit_test(cfgPayEnableSetAndGet),
         cmocka_unit_test(cfgPayDirSetAndGet),
+        cmocka_unit_test(cfgPayFormatSetAndGet),
         cmocka_unit_test(dbgHasNoUnexpectedFailures),
     };
     return cmocka_run_group_tests(tests, groupSetup, groupTeardown);
@@ -411,6 +411,14 @@ cfgProcessEnvironmentEventFormat(void** state)
     cfgProcessEnvironment(cfg);
     assert_int_equal(cfgEventFormat(cfg), CFG_FMT_NDJSON);
 
+    assert_int_equal(setenv("SCOPE_EVENT_FORMAT", "msgpack", 1), 0);
+    cfgProcessEnvironment(cfg);
+    assert_int_equal(cfgEventFormat(cfg), CFG_FMT_MSGPACK);
+
+    assert_int_equal(setenv("SCOPE_EVENT_FORMAT", "ndjson", 1), 0);
+    cfgProcessEnvironment(cfg);
+    assert_int_equal(cfgEventFormat(cfg), CFG_FMT_NDJSON);
+
     // if env is not defined, cfg should not be affected
     assert_int_equal(unsetenv("SCOPE_EVENT_FORMAT"), 0);
     cfgProcessEnvironment(cfg);
@@ -457,6 +465,34 @@ cfgProcessEnvironmentMaxEps(void** state)
     cfgProcessEnvironment(cfg);
 }
 
+static void
+cfgProcessEnvironmentCaptureTime(void** state)
+{
+    config_t* cfg = cfgCreateDefault();
+    assert_int_equal(cfgEvtCaptureTime(cfg), FALSE);
+
+    // should override current cfg
+    assert_int_equal(setenv("SCOPE_EVENT_CAPTURE_TIME", "true", 1), 0);
+    cfgProcessEnvironment(cfg);
+    assert_int_equal(cfgEvtCaptureTime(cfg), TRUE);
+
+    // unrecognised value should not affect cfg
+    assert_int_equal(setenv("SCOPE_EVENT_CAPTURE_TIME", "sometimes", 1), 0);
+    cfgProcessEnvironment(cfg);
+    assert_int_equal(cfgEvtCaptureTime(cfg), TRUE);
+
+    assert_int_equal(setenv("SCOPE_EVENT_CAPTURE_TIME", "false", 1), 0);
+    cfgProcessEnvironment(cfg);
+    assert_int_equal(cfgEvtCaptureTime(cfg), FALSE);
+
+    // if env is not defined, cfg should not be affected
+    assert_int_equal(unsetenv("SCOPE_EVENT_CAPTURE_TIME"), 0);
+    cfgProcessEnvironment(cfg);
+    assert_int_equal(cfgEvtCaptureTime(cfg), FALSE);
+
+    cfgDestroy(&cfg);
+}
+
 static void
 cfgProcessEnvironmentEnhanceFs(void** state)
 {
@@ -488,6 +524,94 @@ cfgProcessEnvironmentEnhanceFs(void** state)
     cfgProcessEnvironment(cfg);
 }
 
+static void
+cfgProcessEnvironmentEvtSpill(void** state)
+{
+    config_t* cfg = cfgCreateDefault();
+    assert_null(cfgEvtSpillDir(cfg));
+
+    // should override current cfg
+    assert_int_equal(setenv("SCOPE_EVENT_SPILL_DIR", "/var/tmp", 1), 0);
+    assert_int_equal(setenv("SCOPE_EVENT_SPILL_MAXSIZE", "2048", 1), 0);
+    cfgProcessEnvironment(cfg);
+    assert_string_equal(cfgEvtSpillDir(cfg), "/var/tmp");
+    assert_int_equal(cfgEvtSpillMaxSize(cfg), 2048);
+
+    // unrecognised value should not affect cfg
+    assert_int_equal(setenv("SCOPE_EVENT_SPILL_MAXSIZE", "lots", 1), 0);
+    cfgProcessEnvironment(cfg);
+    assert_int_equal(cfgEvtSpillMaxSize(cfg), 2048);
+
+    // an empty dir turns spilling off
+    assert_int_equal(setenv("SCOPE_EVENT_SPILL_DIR", "", 1), 0);
+    cfgProcessEnvironment(cfg);
+    assert_null(cfgEvtSpillDir(cfg));
+
+    assert_int_equal(unsetenv("SCOPE_EVENT_SPILL_DIR"), 0);
+    assert_int_equal(unsetenv("SCOPE_EVENT_SPILL_MAXSIZE"), 0);
+    cfgDestroy(&cfg);
+}
+
+static void
+cfgProcessEnvironmentMtcScrape(void** state)
+{
+    config_t* cfg = cfgCreateDefault();
+    assert_int_equal(cfgMtcScrapeEnable(cfg), FALSE);
+
+    // should override current cfg
+    assert_int_equal(setenv("SCOPE_METRIC_SCRAPE_ENABLE", "true", 1), 0);
+    assert_int_equal(setenv("SCOPE_METRIC_SCRAPE_LISTEN", "unix:///tmp/scope.sock", 1), 0);
+    cfgProcessEnvironment(cfg);
+    assert_int_equal(cfgMtcScrapeEnable(cfg), TRUE);
+    assert_string_equal(cfgMtcScrapeListen(cfg), "unix:///tmp/scope.sock");
+
+    // unrecognised value should not affect cfg
+    assert_int_equal(setenv("SCOPE_METRIC_SCRAPE_ENABLE", "yup", 1), 0);
+    cfgProcessEnvironment(cfg);
+    assert_int_equal(cfgMtcScrapeEnable(cfg), TRUE);
+
+    // an empty address is the default
+    assert_int_equal(setenv("SCOPE_METRIC_SCRAPE_ENABLE", "false", 1), 0);
+    assert_int_equal(setenv("SCOPE_METRIC_SCRAPE_LISTEN", "", 1), 0);
+    cfgProcessEnvironment(cfg);
+    assert_int_equal(cfgMtcScrapeEnable(cfg), FALSE);
+    assert_string_equal(cfgMtcScrapeListen(cfg), DEFAULT_MTC_SCRAPE_LISTEN);
+
+    assert_int_equal(unsetenv("SCOPE_METRIC_SCRAPE_ENABLE"), 0);
+    assert_int_equal(unsetenv("SCOPE_METRIC_SCRAPE_LISTEN"), 0);
+    cfgDestroy(&cfg);
+}
+
+static void
+cfgProcessEnvironmentMtcHttp(void** state)
+{
+    config_t* cfg = cfgCreateDefault();
+    assert_int_equal(cfgMtcHttpNormalize(cfg), TRUE);
+
+    // should override current cfg
+    assert_int_equal(setenv("SCOPE_METRIC_HTTP_NORMALIZE", "false", 1), 0);
+    assert_int_equal(setenv("SCOPE_METRIC_HTTP_TEMPLATES", "/users/{id},/files/{name}", 1), 0);
+    cfgProcessEnvironment(cfg);
+    assert_int_equal(cfgMtcHttpNormalize(cfg), FALSE);
+    assert_string_equal(cfgMtcHttpTemplates(cfg), "/users/{id},/files/{name}");
+
+    // unrecognised value should not affect cfg
+    assert_int_equal(setenv("SCOPE_METRIC_HTTP_NORMALIZE", "maybe", 1), 0);
+    cfgProcessEnvironment(cfg);
+    assert_int_equal(cfgMtcHttpNormalize(cfg), FALSE);
+
+    // empty templates are none
+    assert_int_equal(setenv("SCOPE_METRIC_HTTP_NORMALIZE", "true", 1), 0);
+    assert_int_equal(setenv("SCOPE_METRIC_HTTP_TEMPLATES", "", 1), 0);
+    cfgProcessEnvironment(cfg);
+    assert_int_equal(cfgMtcHttpNormalize(cfg), TRUE);
+    assert_null(cfgMtcHttpTemplates(cfg));
+
+    assert_int_equal(unsetenv("SCOPE_METRIC_HTTP_NORMALIZE"), 0);
+    assert_int_equal(unsetenv("SCOPE_METRIC_HTTP_TEMPLATES"), 0);
+    cfgDestroy(&cfg);
+}
+
 typedef struct
 {
     const char* env_name;
@@ -714,6 +838,29 @@ cfgProcessEnvironmentPayEnable(void **state)
     cfgProcessEnvironment(cfg);
 }
 
+static void
+cfgProcessEnvironmentPayFormat(void **state)
+{
+    config_t* cfg = cfgCreateDefault();
+    assert_int_equal(cfgPayFormat(cfg), CFG_PAY_RAW);
+
+    assert_int_equal(setenv("SCOPE_PAYLOAD_FORMAT", "pcapng", 1), 0);
+    cfgProcessEnvironment(cfg);
+    assert_int_equal(cfgPayFormat(cfg), CFG_PAY_PCAPNG);
+
+    // unknown values are ignored
+    assert_int_equal(setenv("SCOPE_PAYLOAD_FORMAT", "pcap", 1), 0);
+    cfgProcessEnvironment(cfg);
+    assert_int_equal(cfgPayFormat(cfg), CFG_PAY_PCAPNG);
+
+    assert_int_equal(setenv("SCOPE_PAYLOAD_FORMAT", "raw", 1), 0);
+    cfgProcessEnvironment(cfg);
+    assert_int_equal(cfgPayFormat(cfg), CFG_PAY_RAW);
+
+    assert_int_equal(unsetenv("SCOPE_PAYLOAD_FORMAT"), 0);
+    cfgDestroy(&cfg);
+}
+
 static void
 cfgProcessEnvironmentPayDir(void **state)
 {
@@ -876,9 +1023,11 @@ cfgProcessCommandsFromFile(void** state)
         "SCOPE_EVENT_FS_VALUE=w\n"
         "SCOPE_EVENT_DNS_VALUE=x\n"
         "SCOPE_EVENT_MAXEPS=123456789\n"
+        "SCOPE_EVENT_CAPTURE_TIME=true\n"
         "SCOPE_ENHANCE_FS=false\n"
         "SCOPE_PAYLOAD_ENABLE=false\n"
         "SCOPE_PAYLOAD_DIR=/the/path\n"
+        "SCOPE_PAYLOAD_FORMAT=pcapng\n"
     );
 
     openFileAndExecuteCfgProcessCommands(path, cfg);
@@ -932,9 +1081,11 @@ cfgProcessCommandsFromFile(void** state)
     assert_string_equal(cfgEvtFormatValueFilter(cfg, CFG_SRC_FS), "w");
     assert_string_equal(cfgEvtFormatValueFilter(cfg, CFG_SRC_DNS), "x");
     assert_int_equal(cfgEvtRateLimit(cfg), 123456789);
+    assert_int_equal(cfgEvtCaptureTime(cfg), TRUE);
     assert_int_equal(cfgEnhanceFs(cfg), FALSE);
     assert_int_equal(cfgPayEnable(cfg), FALSE);
     assert_string_equal(cfgPayDir(cfg), "/the/path");
+    assert_int_equal(cfgPayFormat(cfg), CFG_PAY_PCAPNG);
 
     deleteFile(path);
     cfgDestroy(&cfg);
@@ -1053,6 +1204,7 @@ verifyDefaults(config_t* config)
     assert_int_equal       (cfgEvtEnable(config), DEFAULT_EVT_ENABLE);
     assert_int_equal       (cfgEventFormat(config), DEFAULT_CTL_FORMAT);
     assert_int_equal       (cfgEvtRateLimit(config), DEFAULT_MAXEVENTSPERSEC);
+    assert_int_equal       (cfgEvtCaptureTime(config), DEFAULT_EVT_CAPTURE_TIME);
     assert_int_equal       (cfgEnhanceFs(config), DEFAULT_ENHANCE_FS);
     assert_string_equal    (cfgEvtFormatValueFilter(config, CFG_SRC_FILE), DEFAULT_SRC_FILE_VALUE);
     assert_string_equal    (cfgEvtFormatValueFilter(config, CFG_SRC_CONSOLE), DEFAULT_SRC_CONSOLE_VALUE);
@@ -1087,6 +1239,10 @@ verifyDefaults(config_t* config)
     assert_int_equal       (cfgEvtFormatSourceEnabled(config, CFG_SRC_FS), DEFAULT_SRC_FS);
     assert_int_equal       (cfgEvtFormatSourceEnabled(config, CFG_SRC_DNS), DEFAULT_SRC_DNS);
     assert_null            (cfgEvtFormatHeader(config, 0));
+    assert_int_equal       (cfgMtcScrapeEnable(config), DEFAULT_MTC_SCRAPE_ENABLE);
+    assert_string_equal    (cfgMtcScrapeListen(config), DEFAULT_MTC_SCRAPE_LISTEN);
+    assert_int_equal       (cfgMtcHttpNormalize(config), DEFAULT_MTC_HTTP_NORMALIZE);
+    assert_null            (cfgMtcHttpTemplates(config));
     assert_int_equal       (cfgTransportType(config, CFG_MTC), DEFAULT_MTC_TYPE);
     assert_string_equal    (cfgTransportHost(config, CFG_MTC), DEFAULT_MTC_HOST);
     assert_string_equal    (cfgTransportPort(config, CFG_MTC), DEFAULT_MTC_PORT);
@@ -1107,6 +1263,7 @@ verifyDefaults(config_t* config)
     assert_int_equal       (cfgLogLevel(config), DEFAULT_LOG_LEVEL);
     assert_int_equal       (cfgPayEnable(config), DEFAULT_PAYLOAD_ENABLE);
     assert_string_equal    (cfgPayDir(config), DEFAULT_PAYLOAD_DIR);
+    assert_int_equal       (cfgPayFormat(config), DEFAULT_PAYLOAD_FORMAT);
 }
 
 
@@ -1130,6 +1287,12 @@ cfgReadGoodYaml(void** state)
         "    type: file                      # udp, unix, file, syslog\n"
         "    path: '/var/log/scope.log'\n"
         "    buffering: line\n"
+        "  scrape:\n"
+        "    enable: true\n"
+        "    listen: 'unix:///var/run/scope.sock'\n"
+        "  http:\n"
+        "    normalize: false\n"
+        "    templates: '/users/{id}, /files/{name}'\n"
         "event:\n"
         "  enable: true\n"
         "  transport:\n"
@@ -1141,6 +1304,7 @@ cfgReadGoodYaml(void** state)
         "    type : ndjson                   # ndjson\n"
         "    maxeventpersec : 989898         # max events per second.\n"
         "    enhancefs : false               # true, false\n"
+        "    capturetime : true              # true, false\n"
         "  watch:\n"
         "    - type: file                    # create events from file\n"
         "      name: .*[.]log$\n"
@@ -1156,6 +1320,7 @@ cfgReadGoodYaml(void** state)
         "payload:\n"
         "  enable: false\n"
         "  dir: '/my/dir'\n"
+        "  format: pcapng\n"
         "libscope:\n"
         "  configevent: true\n"
         "  summaryperiod: 11                 # in seconds\n"
@@ -1176,12 +1341,17 @@ cfgReadGoodYaml(void** state)
     assert_int_equal(cfgMtcStatsDMaxLen(config), 1024);
     assert_int_equal(cfgMtcVerbosity(config), 3);
     assert_int_equal(cfgMtcPeriod(config), 11);
+    assert_int_equal(cfgMtcScrapeEnable(config), TRUE);
+    assert_string_equal(cfgMtcScrapeListen(config), "unix:///var/run/scope.sock");
+    assert_int_equal(cfgMtcHttpNormalize(config), FALSE);
+    assert_string_equal(cfgMtcHttpTemplates(config), "/users/{id}, /files/{name}");
     assert_string_equal(cfgCmdDir(config), "/tmp");
     assert_int_equal(cfgSendProcessStartMsg(config), TRUE);
     assert_int_equal(cfgEvtEnable(config), TRUE);
     assert_int_equal(cfgEventFormat(config), CFG_FMT_NDJSON);
     assert_int_equal(cfgEvtRateLimit(config), 989898);
     assert_int_equal(cfgEnhanceFs(config), FALSE);
+    assert_int_equal(cfgEvtCaptureTime(config), TRUE);
     assert_string_equal(cfgEvtFormatNameFilter(config, CFG_SRC_FILE), ".*[.]log$");
     assert_string_equal(cfgEvtFormatFieldFilter(config, CFG_SRC_FILE), ".*host.*");
     assert_string_equal(cfgEvtFormatValueFilter(config, CFG_SRC_FILE), "[0-9]+");
@@ -1214,6 +1384,7 @@ cfgReadGoodYaml(void** state)
     assert_int_equal(cfgLogLevel(config), CFG_LOG_DEBUG);
     assert_int_equal(cfgPayEnable(config), FALSE);
     assert_string_equal(cfgPayDir(config), "/my/dir");
+    assert_int_equal(cfgPayFormat(config), CFG_PAY_PCAPNG);
     cfgDestroy(&config);
     deleteFile(path);
 }
@@ -1340,7 +1511,8 @@ const char* jsonText =
     "    'format': {\n"
     "      'type': 'ndjson',\n"
     "      'maxeventpersec': '42',\n"
-    "      'enhancefs': 'false'\n"
+    "      'enhancefs': 'false',\n"
+    "      'capturetime': 'true'\n"
     "    },\n"
     "    'watch' : [\n"
     "      {'type':'file', 'name':'.*[.]log$'},\n"
@@ -1387,6 +1559,7 @@ cfgReadGoodJson(void** state)
     assert_int_equal(cfgEventFormat(config), CFG_FMT_NDJSON);
     assert_int_equal(cfgEvtRateLimit(config), 42);
     assert_int_equal(cfgEnhanceFs(config), FALSE);
+    assert_int_equal(cfgEvtCaptureTime(config), TRUE);
     assert_string_equal(cfgEvtFormatNameFilter(config, CFG_SRC_FILE), ".*[.]log$");
     assert_int_equal(cfgEvtFormatSourceEnabled(config, CFG_SRC_FILE), 1);
     assert_int_equal(cfgEvtFormatSourceEnabled(config, CFG_SRC_CONSOLE), 1);
@@ -1833,6 +2006,11 @@ cfgReadProtocol(void **state)
         "    binary: 'false'\n"
         "    regex: 'sup up?'\n"
         "    len: 222\n"
+        "\n"
+        "  - name: test3\n"
+        "    binary: 'true'\n"
+        "    signature: '16 03 00-03'\n"
+        "    len: 333\n"
         "...\n";
 
     char *name[2] = {"test1", "test2"};
@@ -1863,6 +2041,14 @@ cfgReadProtocol(void **state)
         }
     }
 
+    prot = lstFind(plist, 2);
+    assert_non_null(prot);
+    assert_string_equal(prot->protname, "test3");
+    assert_null(prot->regex);
+    assert_string_equal(prot->signature, "16 03 00-03");
+    assert_int_equal(prot->binary, 1);
+    assert_int_equal(prot->len, 333);
+
     lstDestroy(&plist);
     deleteFile(ppath);
 }
@@ -1905,7 +2091,11 @@ main(int argc, char* argv[])
         cmocka_unit_test(cfgProcessEnvironmentEvtEnable),
         cmocka_unit_test(cfgProcessEnvironmentEventFormat),
         cmocka_unit_test(cfgProcessEnvironmentMaxEps),
+        cmocka_unit_test(cfgProcessEnvironmentCaptureTime),
         cmocka_unit_test(cfgProcessEnvironmentEnhanceFs),
+        cmocka_unit_test(cfgProcessEnvironmentEvtSpill),
+        cmocka_unit_test(cfgProcessEnvironmentMtcScrape),
+        cmocka_unit_test(cfgProcessEnvironmentMtcHttp),
         cmocka_unit_test_prestate(cfgProcessEnvironmentEventSource, &log),
         cmocka_unit_test_prestate(cfgProcessEnvironmentEventSource, &con),
         cmocka_unit_test_prestate(cfgProcessEnvironmentEventSource, &sys),
@@ -1922,6 +2112,7 @@ main(int argc, char* argv[])
         cmocka_unit_test(cfgProcessEnvironmentStatsdTags),
         cmocka_unit_test(cfgProcessEnvironmentPayEnable),
         cmocka_unit_test(cfgProcessEnvironmentPayDir),
+        cmocka_unit_test(cfgProcessEnvironmentPayFormat),
         cmocka_unit_test(cfgProcessEnvironmentCmdDebugIsIgnored),
         cmocka_unit_test(cfgProcessCommandsCmdDebugIsProcessed),
         cmocka_unit_test(cfgProcessCommandsFromFile),
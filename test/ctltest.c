@@ -7,8 +7,19 @@
 #include "ctl.h"
 #include "dbg.h"
 #include "cfgutils.h"
+#include "fn.h"
 #include "test.h"
 
+static int
+ctlTestSetup(void** state)
+{
+    // The spill writes its segments with g_fn
+    initFn();
+
+    // Call the general groupSetup() too.
+    return groupSetup(state);
+}
+
 static void
 ctlParseRxMsgNullReturnsParseError(void** state)
 {
@@ -651,6 +662,289 @@ ctlTransportSetAndMtcSend(void** state)
     ctlDestroy(&ctl);
 }
 
+static void
+ctlSendEventMsgpackIsLengthPrefixed(void** state)
+{
+    const char* file_path = "/tmp/ctlmsgpack.out";
+    unlink(file_path);
+    ctl_t* ctl = ctlCreate();
+    assert_non_null(ctl);
+
+    assert_int_equal(ctlFormat(ctl), CFG_FMT_NDJSON);
+    ctlFormatSet(ctl, CFG_FMT_STATSD);
+    assert_int_equal(ctlFormat(ctl), CFG_FMT_NDJSON);
+    ctlFormatSet(ctl, CFG_FMT_MSGPACK);
+    assert_int_equal(ctlFormat(ctl), CFG_FMT_MSGPACK);
+
+    transport_t* t = transportCreateFile(file_path, CFG_BUFFER_FULLY);
+    assert_non_null(t);
+    ctlTransportSet(ctl, t, CFG_CTL);
+    evt_fmt_t* evt = evtFormatCreate();
+    assert_non_null(evt);
+    evtFormatSourceEnabledSet(evt, CFG_SRC_METRIC, 1);
+    ctlEvtSet(ctl, evt);
+
+    proc_id_t proc = {.pid = 4848,
+                      .ppid = 4847,
+                      .hostname = "host",
+                      .procname = "ctltest",
+                      .cmd = "cmd-4",
+                      .id = "host-ctltest-cmd-4"};
+    event_t e1 = INT_EVENT("first", 1, DELTA, NULL);
+    event_t e2 = INT_EVENT("second", 2, DELTA, NULL);
+    assert_int_equal(ctlSendEvent(ctl, &e1, 12345, &proc), 0);
+    assert_int_equal(ctlSendEvent(ctl, &e2, 0, &proc), 0);
+    ctlFlush(ctl);
+
+    FILE* f = fopen(file_path, "r");
+    assert_non_null(f);
+    char buf[1024];
+    size_t len = fread(buf, 1, sizeof(buf), f);
+    fclose(f);
+
+    // Two messages, back to back, each with a length header
+    size_t first = mpMsgLen(buf);
+    assert_true(first < len);
+    assert_int_equal(first + mpMsgLen(&buf[first]), len);
+
+    cJSON* json = msgpackToJson(&buf[MP_MSG_HDR_LEN], first - MP_MSG_HDR_LEN);
+    assert_non_null(json);
+    assert_string_equal(cJSON_GetObjectItem(json, "type")->valuestring, "evt");
+    assert_string_equal(cJSON_GetObjectItem(json, "id")->valuestring, "host-ctltest-cmd-4");
+    assert_string_equal(cJSON_GetObjectItem(json, "_channel")->valuestring, "12345");
+    cJSON* body = cJSON_GetObjectItem(json, "body");
+    assert_string_equal(cJSON_GetObjectItem(body, "source")->valuestring, "first");
+    cJSON_Delete(json);
+
+    json = msgpackToJson(&buf[first + MP_MSG_HDR_LEN], len - first - MP_MSG_HDR_LEN);
+    assert_non_null(json);
+    assert_null(cJSON_GetObjectItem(json, "_channel"));
+    body = cJSON_GetObjectItem(json, "body");
+    assert_string_equal(cJSON_GetObjectItem(body, "source")->valuestring, "second");
+    cJSON_Delete(json);
+
+    if (unlink(file_path))
+        fail_msg("Couldn't delete file %s", file_path);
+
+    ctlDestroy(&ctl);
+}
+
+static void
+ctlSendEventNdjsonIsNewlineDelimited(void** state)
+{
+    const char* file_path = "/tmp/ctlndjson.out";
+    unlink(file_path);
+    ctl_t* ctl = ctlCreate();
+    assert_non_null(ctl);
+    assert_int_equal(ctlFormat(ctl), CFG_FMT_NDJSON);
+
+    transport_t* t = transportCreateFile(file_path, CFG_BUFFER_FULLY);
+    assert_non_null(t);
+    ctlTransportSet(ctl, t, CFG_CTL);
+    evt_fmt_t* evt = evtFormatCreate();
+    assert_non_null(evt);
+    evtFormatSourceEnabledSet(evt, CFG_SRC_METRIC, 1);
+    ctlEvtSet(ctl, evt);
+
+    proc_id_t proc = {.pid = 4848,
+                      .ppid = 4847,
+                      .hostname = "host",
+                      .procname = "ctltest",
+                      .cmd = "cmd-4",
+                      .id = "host-ctltest-cmd-4"};
+
+    // The buffer events are formatted in has to grow for this one, and
+    // the one after it reuses what's left in it
+    char big[4096];
+    memset(big, 'x', sizeof(big) - 1);
+    big[sizeof(big) - 1] = '\0';
+    event_field_t fields[] = {
+        STRFIELD("big", big, 4, TRUE),
+        FIELDEND
+    };
+    event_t e1 = INT_EVENT("first", 1, DELTA, NULL);
+    event_t e2 = INT_EVENT("second", 2, DELTA, fields);
+    event_t e3 = INT_EVENT("third", 3, DELTA, NULL);
+    assert_int_equal(ctlSendEvent(ctl, &e1, 12345, &proc), 0);
+    assert_int_equal(ctlSendEvent(ctl, &e2, 0, &proc), 0);
+    assert_int_equal(ctlSendEvent(ctl, &e3, 0, &proc), 0);
+    ctlFlush(ctl);
+
+    FILE* f = fopen(file_path, "r");
+    assert_non_null(f);
+    char *line = NULL;
+    size_t size = 0;
+
+    assert_true(getline(&line, &size, f) > 0);
+    const char *head = "{\"type\":\"evt\",\"id\":\"host-ctltest-cmd-4\","
+                       "\"_channel\":\"12345\",\"body\":{\"sourcetype\":\"metric\",";
+    assert_memory_equal(line, head, strlen(head));
+    assert_non_null(strstr(line, "\"data\":{\"_metric\":\"first\","
+                                 "\"_metric_type\":\"counter\",\"_value\":1}}}\n"));
+
+    assert_true(getline(&line, &size, f) > sizeof(big));
+    cJSON* json = cJSON_Parse(line);
+    assert_non_null(json);
+    assert_null(cJSON_GetObjectItem(json, "_channel"));
+    cJSON* data = cJSON_GetObjectItem(cJSON_GetObjectItem(json, "body"), "data");
+    assert_string_equal(cJSON_GetObjectItem(data, "big")->valuestring, big);
+    cJSON_Delete(json);
+
+    assert_true(getline(&line, &size, f) > 0);
+    assert_non_null(strstr(line, "\"data\":{\"_metric\":\"third\","
+                                 "\"_metric_type\":\"counter\",\"_value\":3}}}\n"));
+    assert_null(strstr(line, "xxx"));
+
+    assert_int_equal(getline(&line, &size, f), -1);
+    free(line);
+    fclose(f);
+
+    if (unlink(file_path))
+        fail_msg("Couldn't delete file %s", file_path);
+
+    ctlDestroy(&ctl);
+}
+
+static void
+ctlSendLogNdjson(void** state)
+{
+    const char* file_path = "/tmp/ctllog.out";
+    unlink(file_path);
+    ctl_t* ctl = ctlCreate();
+    assert_non_null(ctl);
+    transport_t* t = transportCreateFile(file_path, CFG_BUFFER_FULLY);
+    assert_non_null(t);
+    ctlTransportSet(ctl, t, CFG_CTL);
+    evt_fmt_t* evt = evtFormatCreate();
+    assert_non_null(evt);
+    evtFormatSourceEnabledSet(evt, CFG_SRC_CONSOLE, 1);
+    // The filter sees the message escaped, and in quotes
+    evtFormatValueFilterSet(evt, CFG_SRC_CONSOLE, "^\"keep");
+    ctlEvtSet(ctl, evt);
+
+    proc_id_t proc = {.pid = 4848,
+                      .ppid = 4847,
+                      .hostname = "host",
+                      .procname = "ctltest",
+                      .cmd = "cmd-4",
+                      .id = "host-ctltest-cmd-4"};
+
+    const char *keep = "keep \"this\"\tline\n";
+    const char *drop = "drop this one\n";
+    assert_int_equal(ctlSendLog(ctl, 1, "stdout", keep, strlen(keep), 1, &proc), 0);
+    ctlFlushLog(ctl);
+    assert_int_equal(ctlSendLog(ctl, 2, "stderr", drop, strlen(drop), 2, &proc), 0);
+    ctlFlushLog(ctl);
+    ctlStopAggregating(ctl);
+    ctlFlush(ctl);
+
+    FILE* f = fopen(file_path, "r");
+    assert_non_null(f);
+    char *line = NULL;
+    size_t size = 0;
+
+    assert_true(getline(&line, &size, f) > 0);
+    const char *head = "{\"type\":\"evt\",\"body\":{\"sourcetype\":\"console\",";
+    assert_memory_equal(line, head, strlen(head));
+    assert_non_null(strstr(line, "\"source\":\"stdout\",\"host\":\"host\","
+                                 "\"proc\":\"ctltest\",\"cmd\":\"cmd-4\",\"pid\":4848,"
+                                 "\"data\":{\"message\":\"keep \\\"this\\\"\\tline\\n\"}}}\n"));
+    cJSON* json = cJSON_Parse(line);
+    assert_non_null(json);
+    cJSON* data = cJSON_GetObjectItem(cJSON_GetObjectItem(json, "body"), "data");
+    assert_string_equal(cJSON_GetObjectItem(data, "message")->valuestring, keep);
+    cJSON_Delete(json);
+
+    assert_int_equal(getline(&line, &size, f), -1);
+    free(line);
+    fclose(f);
+
+    if (unlink(file_path))
+        fail_msg("Couldn't delete file %s", file_path);
+
+    ctlDestroy(&ctl);
+}
+
+// A ctl whose event transport can't connect, so events go to its spill
+static ctl_t *
+spillingCtl(size_t spill_max)
+{
+    ctl_t* ctl = ctlCreate();
+    assert_non_null(ctl);
+    transport_t* t = transportCreateTCP("127.0.0.1", "1");
+    assert_non_null(t);
+    ctlTransportSet(ctl, t, CFG_CTL);
+    evt_fmt_t* evt = evtFormatCreate();
+    assert_non_null(evt);
+    evtFormatSourceEnabledSet(evt, CFG_SRC_METRIC, 1);
+    ctlEvtSet(ctl, evt);
+    ctlSpillSet(ctl, spillCreate("/tmp", spill_max));
+    assert_true(ctlSpillEnabled(ctl));
+    return ctl;
+}
+
+static int
+linesInFile(const char *path)
+{
+    FILE* f = fopen(path, "r");
+    if (!f) return -1;
+    int lines = 0;
+    int c;
+    while ((c = fgetc(f)) != EOF) {
+        if (c == '\n') lines++;
+    }
+    fclose(f);
+    return lines;
+}
+
+static void
+ctlSpillSurvivesConfigReload(void** state)
+{
+    const char* file_path = "/tmp/ctlspill.out";
+    proc_id_t proc = {.pid = 4848,
+                      .ppid = 4847,
+                      .hostname = "host",
+                      .procname = "ctltest",
+                      .cmd = "cmd-4",
+                      .id = "host-ctltest-cmd-4"};
+    event_t e1 = INT_EVENT("first", 1, DELTA, NULL);
+
+    // The same spill config keeps the same segments; a different one
+    // gets the pending events moved into its own
+    size_t new_max[] = {64 * 1024, 128 * 1024};
+    int i;
+    for (i = 0; i < sizeof(new_max) / sizeof(new_max[0]); i++) {
+        unlink(file_path);
+        ctl_t* prev = spillingCtl(64 * 1024);
+        assert_int_equal(ctlSendEvent(prev, &e1, 0, &proc), 0);
+        assert_int_equal(ctlSendEvent(prev, &e1, 0, &proc), 0);
+        ctlFlush(prev);
+
+        // Like doConfig(), which makes a new ctl before it's done with
+        // the previous one
+        ctl_t* ctl = spillingCtl(new_max[i]);
+        transport_t* t = transportCreateFile(file_path, CFG_BUFFER_FULLY);
+        assert_non_null(t);
+        ctlTransportSet(ctl, t, CFG_CTL);
+        ctlSpillInherit(ctl, prev);
+        ctlDestroy(&prev);
+
+        // Replayed once the new ctl is connected
+        assert_int_equal(ctlSendEvent(ctl, &e1, 0, &proc), 0);
+        ctlFlush(ctl);
+        ctlFlush(ctl);
+        assert_int_equal(linesInFile(file_path), 3);
+
+        spill_counters_t ctrs;
+        ctlSpillCounters(ctl, &ctrs);
+        assert_int_equal(ctrs.dropped, 0);
+
+        ctlDestroy(&ctl);
+        if (unlink(file_path))
+            fail_msg("Couldn't delete file %s", file_path);
+    }
+}
+
 static void
 ctlAddProtocol(void** state)
 {
@@ -662,9 +956,30 @@ ctlAddProtocol(void** state)
     assert_int_equal(req->cmd, REQ_ADD_PROTOCOL);
     assert_string_equal(req->cmd_str, "AddProto");
     assert_string_equal(req->protocol->protname, "Dummy");
+    assert_null(req->protocol->signature);
+
+    destroyProtEntry(req->protocol);
+    destroyReq(&req);
+
+    // A signature can take the place of the regex
+    char sigdummy[] = "{\"type\": \"req\",\"req\": \"AddProto\",\"reqId\":6395,\"body\":{\"binary\":\"true\",\"signature\":\"16 03 00-03\",\"pname\":\"Sig\",\"len\":12}}";
+
+    req = ctlParseRxMsg(sigdummy);
+    assert_non_null(req);
+    assert_int_equal(req->cmd, REQ_ADD_PROTOCOL);
+    assert_null(req->protocol->regex);
+    assert_string_equal(req->protocol->signature, "16 03 00-03");
 
     destroyProtEntry(req->protocol);
     destroyReq(&req);
+
+    // Without either, it's a parameter error
+    char nodummy[] = "{\"type\": \"req\",\"req\": \"AddProto\",\"reqId\":6396,\"body\":{\"binary\":\"true\",\"pname\":\"None\",\"len\":12}}";
+
+    req = ctlParseRxMsg(nodummy);
+    assert_non_null(req);
+    assert_int_equal(req->cmd, REQ_PARAM_ERR);
+    destroyReq(&req);
 }
 
 static void
@@ -703,11 +1018,15 @@ main(int argc, char* argv[])
         cmocka_unit_test(ctlSendMsgForNullMtcDoesntCrash),
         cmocka_unit_test(ctlSendMsgForNullMessageDoesntCrash),
         cmocka_unit_test(ctlTransportSetAndMtcSend),
+        cmocka_unit_test(ctlSendEventMsgpackIsLengthPrefixed),
+        cmocka_unit_test(ctlSendEventNdjsonIsNewlineDelimited),
+        cmocka_unit_test(ctlSendLogNdjson),
+        cmocka_unit_test(ctlSpillSurvivesConfigReload),
         cmocka_unit_test(ctlAddProtocol),
         cmocka_unit_test(ctlDelProtocol),
         cmocka_unit_test(dbgHasNoUnexpectedFailures),
     };
 
-    return cmocka_run_group_tests(tests, groupSetup, groupTeardown);
+    return cmocka_run_group_tests(tests, ctlTestSetup, groupTeardown);
 }
 
@@ -1,4 +1,5 @@
 #define _GNU_SOURCE
+#include <math.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -6,6 +7,8 @@
 #include <unistd.h>
 #include "dbg.h"
 #include "evtformat.h"
+#include "fn.h"
+#include "plattime.h"
 
 #include "test.h"
 
@@ -531,9 +534,9 @@ fmtMetricJsonWFilteredFields(void** state)
         FIELDEND
     };
     event_t e = INT_EVENT("hey", 2, HISTOGRAM, fields);
-    regex_t re;
-    assert_int_equal(regcomp(&re, "[AD]", REG_EXTENDED), 0);
-    cJSON* json = fmtMetricJson(&e, &re, CFG_SRC_METRIC);
+    filter_t *re = filterCreate("[AD]");
+    assert_non_null(re);
+    cJSON* json = fmtMetricJson(&e, re, CFG_SRC_METRIC);
     assert_non_null(json);
     char* str = cJSON_PrintUnformatted(json);
     assert_non_null(str);
@@ -543,7 +546,7 @@ fmtMetricJsonWFilteredFields(void** state)
                  "\"_value\":2,"
                  "\"A\":\"Z\",\"D\":654}");
     if (str) free(str);
-    regfree(&re);
+    filterDestroy(&re);
     cJSON_Delete(json);
 }
 
@@ -586,6 +589,322 @@ fmtMetricJsonEscapedValues(void** state)
     }
 }
 
+static void
+evtFormatMetricMsgpackMatchesJson(void** state)
+{
+    evt_fmt_t* evt = evtFormatCreate();
+    assert_non_null(evt);
+
+    custom_tag_t tag = {.name = "hey", .value = "you"};
+    custom_tag_t* tags[] = {&tag, NULL};
+    evtFormatCustomTagsSet(evt, tags);
+
+    event_field_t fields[] = {
+        STRFIELD("A",     "Z",  0,  TRUE),
+        NUMFIELD("B",     -987, 1,  TRUE),
+        STRFIELD("C",     "Y",  2,  FALSE),
+        NUMFIELD("D",     654,  3,  TRUE),
+        FIELDEND
+    };
+    event_t e = FLT_EVENT("A", 1.25, CURRENT, fields);
+    proc_id_t proc = {.pid = 4848,
+                      .ppid = 4847,
+                      .hostname = "host",
+                      .procname = "evttest",
+                      .cmd = "cmd-4",
+                      .id = "host-evttest-cmd-4"};
+
+    evtFormatSourceEnabledSet(evt, CFG_SRC_METRIC, 1);
+    cJSON* json = evtFormatMetric(evt, &e, 12345, &proc);
+    assert_non_null(json);
+
+    mpbuf_t mp;
+    mpBufInit(&mp);
+    assert_int_equal(evtFormatMetricMsgpack(evt, &e, 12345, &proc, &mp), 0);
+    cJSON* decoded = msgpackToJson(mp.data, mp.len);
+    assert_non_null(decoded);
+
+    // Everything but the time should be the same
+    cJSON_DeleteItemFromObject(json, "_time");
+    cJSON_DeleteItemFromObject(decoded, "_time");
+    char* expected = cJSON_PrintUnformatted(json);
+    char* actual = cJSON_PrintUnformatted(decoded);
+    assert_string_equal(expected, actual);
+    free(expected);
+    free(actual);
+    cJSON_Delete(json);
+    cJSON_Delete(decoded);
+
+    // A filtered event writes nothing useful and says so
+    mpBufReset(&mp);
+    evtFormatSourceEnabledSet(evt, CFG_SRC_METRIC, 0);
+    assert_int_equal(evtFormatMetricMsgpack(evt, &e, 12345, &proc, &mp), -1);
+
+    mpBufFree(&mp);
+    evtFormatDestroy(&evt);
+}
+
+// Formats with the jsbuf functions, and checks that the output is exactly
+// what printing the cJSON tree for the same event would give.
+static void
+assertJsonBufMatchesJson(evt_fmt_t *evt, event_t *e, cJSON *data, proc_id_t *proc)
+{
+    // Each consumes the data, so each gets its own copy
+    event_t a = *e, b = *e;
+    if (data) {
+        a.data = cJSON_Duplicate(data, TRUE);
+        b.data = cJSON_Duplicate(data, TRUE);
+    }
+
+    cJSON* json = evtFormatMetric(evt, &a, 12345, proc);
+    assert_non_null(json);
+
+    jsbuf_t js;
+    jsBufInit(&js, NULL, 0);
+    assert_int_equal(evtFormatMetricJsonBuf(evt, &b, 12345, proc, &js), 0);
+
+    // The time is taken separately by each, so use the same one
+    cJSON* decoded = cJSON_Parse(js.data);
+    assert_non_null(decoded);
+    double time = cJSON_GetObjectItem(decoded, "_time")->valuedouble;
+    cJSON_SetNumberValue(cJSON_GetObjectItem(json, "_time"), time);
+
+    char* expected = cJSON_PrintUnformatted(json);
+    assert_string_equal(js.data, expected);
+    free(expected);
+    cJSON_Delete(decoded);
+    cJSON_Delete(json);
+    jsBufFree(&js);
+}
+
+static void
+evtFormatMetricJsonBufMatchesJson(void** state)
+{
+    evt_fmt_t* evt = evtFormatCreate();
+    assert_non_null(evt);
+
+    custom_tag_t tag = {.name = "hey", .value = "you\"there\""};
+    custom_tag_t* tags[] = {&tag, NULL};
+    evtFormatCustomTagsSet(evt, tags);
+
+    event_field_t fields[] = {
+        STRFIELD("A",     "Z\n",  0,  TRUE),
+        NUMFIELD("B",     -987,   1,  TRUE),
+        STRFIELD("C",     "Y",    2,  FALSE),
+        NUMFIELD("D",     654,    3,  TRUE),
+        FIELDEND
+    };
+    event_t e = FLT_EVENT("A", 1.25, CURRENT, fields);
+    proc_id_t proc = {.pid = 4848,
+                      .ppid = 4847,
+                      .hostname = "host",
+                      .procname = "evttest",
+                      .cmd = "cmd-4 \"quoted\"",
+                      .id = "host-evttest-cmd-4"};
+
+    evtFormatSourceEnabledSet(evt, CFG_SRC_METRIC, 1);
+    assertJsonBufMatchesJson(evt, &e, NULL, &proc);
+
+    event_t i = INT_EVENT("B", 9876543210, DELTA, NULL);
+    assertJsonBufMatchesJson(evt, &i, NULL, &proc);
+
+    // events whose data arrives as json
+    char buf[] = "with\0nul";
+    cJSON* data = cJSON_CreateStringFromBuffer(buf, sizeof(buf) - 1);
+    assertJsonBufMatchesJson(evt, &e, data, &proc);
+    cJSON_Delete(data);
+    data = cJSON_Parse("{\"a\":[1,2.5,\"x\"],\"b\":null}");
+    assertJsonBufMatchesJson(evt, &e, data, &proc);
+    cJSON_Delete(data);
+
+    // A filtered event writes nothing useful and says so
+    jsbuf_t js;
+    jsBufInit(&js, NULL, 0);
+    evtFormatSourceEnabledSet(evt, CFG_SRC_METRIC, 0);
+    assert_int_equal(evtFormatMetricJsonBuf(evt, &e, 12345, &proc, &js), -1);
+
+    // As does one cJSON can't represent
+    evtFormatSourceEnabledSet(evt, CFG_SRC_METRIC, 1);
+    fields[0].value.str = NULL;
+    assert_null(evtFormatMetric(evt, &e, 12345, &proc));
+    assert_int_equal(dbgCountMatchingLines("src/evtformat.c"), 1);
+    dbgInit(); // reset dbg for the rest of the tests
+    assert_int_equal(evtFormatMetricJsonBuf(evt, &e, 12345, &proc, &js), -1);
+
+    jsBufFree(&js);
+    evtFormatDestroy(&evt);
+}
+
+static void
+fmtEventJsonHeadReusesEnvelope(void** state)
+{
+    evt_fmt_t* evt = evtFormatCreate();
+    assert_non_null(evt);
+
+    custom_tag_t tag = {.name = "hey", .value = "you"};
+    custom_tag_t* tags[] = {&tag, NULL};
+    evtFormatCustomTagsSet(evt, tags);
+
+    proc_id_t proc = {.pid = 4848,
+                      .ppid = 4847,
+                      .hostname = "host",
+                      .procname = "evttest",
+                      .cmd = "java -jar \"app.jar\"",
+                      .id = "host-evttest-cmd-4"};
+    event_format_t event = {.timestamp = 1573058085.001,
+                            .src = "A",
+                            .proc = &proc,
+                            .sourcetype = CFG_SRC_METRIC};
+    const char *expected = "{\"sourcetype\":\"metric\","
+                           "\"_time\":1573058085.001,"
+                           "\"source\":\"A\","
+                           "\"host\":\"host\","
+                           "\"proc\":\"evttest\","
+                           "\"cmd\":\"java -jar \\\"app.jar\\\"\","
+                           "\"pid\":4848,"
+                           "\"hey\":\"you\","
+                           "\"data\":";
+
+    jsbuf_t js;
+    jsBufInit(&js, NULL, 0);
+    fmtEventJsonHead(evt, &event, &js);
+    assert_string_equal(js.data, expected);
+
+    // The envelope isn't rebuilt until it's known to have changed...
+    proc.cmd = "different";
+    jsBufReset(&js);
+    fmtEventJsonHead(evt, &event, &js);
+    assert_string_equal(js.data, expected);
+
+    // ...which is when it is
+    evtFormatProcChanged(evt);
+    jsBufReset(&js);
+    fmtEventJsonHead(evt, &event, &js);
+    assert_non_null(strstr(js.data, "\"cmd\":\"different\",\"pid\":4848,\"hey\":\"you\","));
+
+    // A different process (e.g. after a fork) is never given the old one
+    proc_id_t child = proc;
+    child.pid = 4849;
+    event.proc = &child;
+    jsBufReset(&js);
+    fmtEventJsonHead(evt, &event, &js);
+    assert_non_null(strstr(js.data, "\"pid\":4849,"));
+
+    // Nor is anyone once the tags change
+    custom_tag_t tag2 = {.name = "bye", .value = "now"};
+    custom_tag_t* tags2[] = {&tag2, NULL};
+    evtFormatCustomTagsSet(evt, tags2);
+    event.proc = &proc;
+    jsBufReset(&js);
+    fmtEventJsonHead(evt, &event, &js);
+    assert_non_null(strstr(js.data, "\"pid\":4848,\"bye\":\"now\",\"data\":"));
+
+    jsBufFree(&js);
+    evtFormatDestroy(&evt);
+}
+
+// Not a pass/fail test; reports events/sec for the cJSON and jsbuf paths
+static void
+evtFormatJsonBufBenchmark(void** state)
+{
+    const int count = 20000;
+    evt_fmt_t* evt = evtFormatCreate();
+    assert_non_null(evt);
+    evtFormatSourceEnabledSet(evt, CFG_SRC_METRIC, 1);
+    evtFormatRateLimitSet(evt, 0);
+
+    event_field_t fields[] = {
+        STRFIELD("proc",   "evttest",       4,  TRUE),
+        NUMFIELD("pid",    4848,            4,  TRUE),
+        NUMFIELD("fd",     3,               7,  TRUE),
+        STRFIELD("file",   "/var/log/file", 7,  TRUE),
+        STRFIELD("op",     "read",          7,  TRUE),
+        NUMFIELD("bytes",  4096,            7,  TRUE),
+        FIELDEND
+    };
+    event_t e = INT_EVENT("fs.read", 4096, HISTOGRAM, fields);
+    proc_id_t proc = {.pid = 4848,
+                      .ppid = 4847,
+                      .hostname = "host",
+                      .procname = "evttest",
+                      .cmd = "cmd-4",
+                      .id = "host-evttest-cmd-4"};
+
+    struct timespec start, end;
+    int n;
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (n = 0; n < count; n++) {
+        cJSON* json = evtFormatMetric(evt, &e, 12345, &proc);
+        char* msg = cJSON_PrintUnformatted(json);
+        assert_non_null(msg);
+        free(msg);
+        cJSON_Delete(json);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    double cjson = (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
+
+    char storage[2048];
+    jsbuf_t js;
+    jsBufInit(&js, storage, sizeof(storage));
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (n = 0; n < count; n++) {
+        jsBufReset(&js);
+        assert_int_equal(evtFormatMetricJsonBuf(evt, &e, 12345, &proc, &js), 0);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    double jsbuf = (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
+    jsBufFree(&js);
+
+    printf("    cJSON: %.0f events/sec, jsbuf: %.0f events/sec\n",
+           count / cjson, count / jsbuf);
+
+    evtFormatDestroy(&evt);
+}
+
+static void
+fmtMetricMsgpackWFilteredFields(void** state)
+{
+    event_field_t fields[] = {
+        STRFIELD("A",  "Z",  0,  TRUE),
+        NUMFIELD("B",  987,  1,  TRUE),
+        STRFIELD("C",  "Y",  2,  TRUE),
+        NUMFIELD("D",  654,  3,  TRUE),
+        FIELDEND
+    };
+    event_t e = INT_EVENT("hey", 2, HISTOGRAM, fields);
+    filter_t *re = filterCreate("[AD]");
+    assert_non_null(re);
+
+    mpbuf_t mp;
+    mpBufInit(&mp);
+    assert_int_equal(fmtMetricMsgpack(&e, re, CFG_SRC_METRIC, &mp), 0);
+    cJSON* json = msgpackToJson(mp.data, mp.len);
+    assert_non_null(json);
+    char* str = cJSON_PrintUnformatted(json);
+    assert_non_null(str);
+    assert_string_equal(str,
+                 "{\"_metric\":\"hey\","
+                 "\"_metric_type\":\"histogram\","
+                 "\"_value\":2,"
+                 "\"A\":\"Z\",\"D\":654}");
+    free(str);
+    cJSON_Delete(json);
+
+    // Sources other than metric only get the fields
+    mpBufReset(&mp);
+    assert_int_equal(fmtMetricMsgpack(&e, NULL, CFG_SRC_NET, &mp), 0);
+    json = msgpackToJson(mp.data, mp.len);
+    assert_non_null(json);
+    str = cJSON_PrintUnformatted(json);
+    assert_string_equal(str, "{\"A\":\"Z\",\"B\":987,\"C\":\"Y\",\"D\":654}");
+    free(str);
+    cJSON_Delete(json);
+
+    filterDestroy(&re);
+    mpBufFree(&mp);
+}
+
 static void
 evtFormatValueFilterSetAndGet(void** state)
 {
@@ -596,35 +915,35 @@ evtFormatValueFilterSetAndGet(void** state)
      * The default is ".*"
      * When the default changes this needs to change
     */
-    regex_t* default_re = evtFormatValueFilter(evt, CFG_SRC_FILE);
+    filter_t* default_re = evtFormatValueFilter(evt, CFG_SRC_FILE);
     assert_non_null(default_re);
-    assert_int_equal(regexec(default_re, "anythingmatches", 0, NULL, 0), 0);
+    assert_true(filterMatch(default_re, "anythingmatches"));
 
     // Make sure it can be changed
     evtFormatValueFilterSet(evt, CFG_SRC_FILE, "myvalue.*");
-    regex_t* new_re = evtFormatValueFilter(evt, CFG_SRC_FILE);
+    filter_t* new_re = evtFormatValueFilter(evt, CFG_SRC_FILE);
     assert_non_null(new_re);
-    assert_int_equal(regexec(new_re, "whatever", 0, NULL, 0), REG_NOMATCH);
-    assert_int_equal(regexec(new_re, "myvalue.value", 0, NULL, 0), 0);
+    assert_false(filterMatch(new_re, "whatever"));
+    assert_true(filterMatch(new_re, "myvalue.value"));
 
     // Make sure default is returned for null strings
     evtFormatValueFilterSet(evt, CFG_SRC_FILE, "");
     new_re = evtFormatValueFilter(evt, CFG_SRC_FILE);
     assert_non_null(new_re);
-    assert_int_equal(regexec(new_re, "anythingmatches", 0, NULL, 0), 0);
+    assert_true(filterMatch(new_re, "anythingmatches"));
 
     // Make sure default is returned for bad regex
     evtFormatValueFilterSet(evt, CFG_SRC_FILE, "W![T^F?");
     new_re = evtFormatValueFilter(evt, CFG_SRC_FILE);
     assert_non_null(new_re);
-    assert_int_equal(regexec(new_re, "anything", 0, NULL, 0), 0);
+    assert_true(filterMatch(new_re, "anything"));
 
     evtFormatDestroy(&evt);
 
     // Get a default filter, even if evt is NULL
     default_re = evtFormatValueFilter(evt, CFG_SRC_FILE);
     assert_non_null(default_re);
-    assert_int_equal(regexec(default_re, "whatever", 0, NULL, 0), 0);
+    assert_true(filterMatch(default_re, "whatever"));
 }
 
 static void
@@ -637,35 +956,35 @@ evtFormatFieldFilterSetAndGet(void** state)
      * The default is ".*host.*"
      * When the default changes this needs to change
     */
-    regex_t* default_re = evtFormatFieldFilter(evt, CFG_SRC_FILE);
+    filter_t* default_re = evtFormatFieldFilter(evt, CFG_SRC_FILE);
     assert_non_null(default_re);
-    assert_int_equal(regexec(default_re, "host:", 0, NULL, 0), 0);
+    assert_true(filterMatch(default_re, "host:"));
 
     // Make sure it can be changed
     evtFormatFieldFilterSet(evt, CFG_SRC_FILE, "myfield.*");
-    regex_t* new_re = evtFormatFieldFilter(evt, CFG_SRC_FILE);
+    filter_t* new_re = evtFormatFieldFilter(evt, CFG_SRC_FILE);
     assert_non_null(new_re);
-    assert_int_equal(regexec(new_re, "whatever", 0, NULL, 0), REG_NOMATCH);
-    assert_int_equal(regexec(new_re, "myfield.value", 0, NULL, 0), 0);
+    assert_false(filterMatch(new_re, "whatever"));
+    assert_true(filterMatch(new_re, "myfield.value"));
 
     // Make sure default is returned for null strings
     evtFormatFieldFilterSet(evt, CFG_SRC_FILE, "");
     new_re = evtFormatFieldFilter(evt, CFG_SRC_FILE);
     assert_non_null(new_re);
-    assert_int_equal(regexec(new_re, "host.myhost", 0, NULL, 0), 0);
+    assert_true(filterMatch(new_re, "host.myhost"));
 
     // Make sure default is returned for bad regex
     evtFormatFieldFilterSet(evt, CFG_SRC_FILE, "W![T^F?");
     new_re = evtFormatFieldFilter(evt, CFG_SRC_FILE);
     assert_non_null(new_re);
-    assert_int_equal(regexec(new_re, "thishost", 0, NULL, 0), 0);
+    assert_true(filterMatch(new_re, "thishost"));
 
     evtFormatDestroy(&evt);
 
     // Get a default filter, even if evt is NULL
     default_re = evtFormatFieldFilter(evt, CFG_SRC_FILE);
     assert_non_null(default_re);
-    assert_int_equal(regexec(default_re, "dohost", 0, NULL, 0), 0);
+    assert_true(filterMatch(default_re, "dohost"));
 }
 
 static void
@@ -678,35 +997,109 @@ evtFormatNameFilterSetAndGet(void** state)
      * The default is ".*log.*"
      * When the default changes this needs to change
     */
-    regex_t* default_re = evtFormatNameFilter(evt, CFG_SRC_FILE);
+    filter_t* default_re = evtFormatNameFilter(evt, CFG_SRC_FILE);
     assert_non_null(default_re);
-    assert_int_equal(regexec(default_re, "anythingwithlogmatches", 0, NULL, 0), 0);
+    assert_true(filterMatch(default_re, "anythingwithlogmatches"));
 
     // Make sure it can be changed
     evtFormatNameFilterSet(evt, CFG_SRC_FILE, "net.*");
-    regex_t* new_re = evtFormatNameFilter(evt, CFG_SRC_FILE);
+    filter_t* new_re = evtFormatNameFilter(evt, CFG_SRC_FILE);
     assert_non_null(new_re);
-    assert_int_equal(regexec(new_re, "whatever", 0, NULL, 0), REG_NOMATCH);
-    assert_int_equal(regexec(new_re, "net.tx", 0, NULL, 0), 0);
+    assert_false(filterMatch(new_re, "whatever"));
+    assert_true(filterMatch(new_re, "net.tx"));
 
     // Make sure default is returned for null strings
     evtFormatNameFilterSet(evt, CFG_SRC_FILE, "");
     new_re = evtFormatNameFilter(evt, CFG_SRC_FILE);
     assert_non_null(new_re);
-    assert_int_equal(regexec(new_re, "anythingwithlogmatches", 0, NULL, 0), 0);
+    assert_true(filterMatch(new_re, "anythingwithlogmatches"));
 
     // Make sure default is returned for bad regex
     evtFormatNameFilterSet(evt, CFG_SRC_FILE, "W![T^F?");
     new_re = evtFormatNameFilter(evt, CFG_SRC_FILE);
     assert_non_null(new_re);
-    assert_int_equal(regexec(new_re, "anythingwithlog", 0, NULL, 0), 0);
+    assert_true(filterMatch(new_re, "anythingwithlog"));
 
     evtFormatDestroy(&evt);
 
     // Get a default filter, even if evt is NULL
     default_re = evtFormatNameFilter(evt, CFG_SRC_FILE);
     assert_non_null(default_re);
-    assert_int_equal(regexec(default_re, "logthingsmatch", 0, NULL, 0), 0);
+    assert_true(filterMatch(default_re, "logthingsmatch"));
+}
+
+static double
+evtFormatMetricTime(evt_fmt_t *evt, event_t *e, proc_id_t *proc)
+{
+    cJSON *json = evtFormatMetric(evt, e, 12345, proc);
+    assert_non_null(json);
+    double t = cJSON_GetObjectItem(json, "_time")->valuedouble;
+    cJSON_Delete(json);
+
+    // the streaming format has to agree
+    jsbuf_t js;
+    jsBufInit(&js, NULL, 0);
+    assert_int_equal(evtFormatMetricJsonBuf(evt, e, 12345, proc, &js), 0);
+    jsObjEnd(&js);
+    json = cJSON_Parse(js.data);
+    assert_non_null(json);
+    assert_true(fabs(cJSON_GetObjectItem(json, "_time")->valuedouble - t) < 0.5);
+    cJSON_Delete(json);
+    jsBufFree(&js);
+
+    return t;
+}
+
+static void
+evtFormatMetricUsesCaptureTime(void** state)
+{
+    initFn();
+    initTime();
+    if (!g_time.freq) skip();
+
+    evt_fmt_t* evt = evtFormatCreate();
+    assert_non_null(evt);
+    assert_int_equal(evtFormatCaptureTime(evt), DEFAULT_EVT_CAPTURE_TIME);
+    evtFormatSourceEnabledSet(evt, CFG_SRC_METRIC, 1);
+
+    proc_id_t proc = {.pid = 4848,
+                      .ppid = 4847,
+                      .hostname = "host",
+                      .procname = "evttest",
+                      .cmd = "cmd-4",
+                      .id = "host-evttest-cmd-4"};
+
+    // captured a minute ago, according to the TSC
+    event_t e = INT_EVENT("A", 1, DELTA, NULL);
+    e.captured = getTime() - (g_time.freq * 1000000ULL * 60);
+
+    // by default events are stamped when they're formatted
+    double now = time(NULL);
+    double t = evtFormatMetricTime(evt, &e, &proc);
+    assert_true((t > now - 2) && (t < now + 2));
+
+    evtFormatCaptureTimeSet(evt, TRUE);
+    assert_int_equal(evtFormatCaptureTime(evt), TRUE);
+    t = evtFormatMetricTime(evt, &e, &proc);
+    assert_true((t > now - 62) && (t < now - 58));
+
+    // the same, with the coarse clock kept current
+    wallClockTick();
+    assert_true(fabs(wallClockSecs() - now) < 2);
+    t = evtFormatMetricTime(evt, &e, &proc);
+    assert_true((t > now - 62) && (t < now - 58));
+    wallClockStop();
+
+    // without a capture time, it's still now
+    e.captured = 0;
+    t = evtFormatMetricTime(evt, &e, &proc);
+    assert_true((t > now - 2) && (t < now + 2));
+
+    // only true and false are valid
+    evtFormatCaptureTimeSet(evt, 2);
+    assert_int_equal(evtFormatCaptureTime(evt), TRUE);
+
+    evtFormatDestroy(&evt);
 }
 
 static void
@@ -798,6 +1191,12 @@ main(int argc, char* argv[])
         cmocka_unit_test(fmtMetricJsonWFields),
         cmocka_unit_test(fmtMetricJsonWFilteredFields),
         cmocka_unit_test(fmtMetricJsonEscapedValues),
+        cmocka_unit_test(evtFormatMetricMsgpackMatchesJson),
+        cmocka_unit_test(fmtMetricMsgpackWFilteredFields),
+        cmocka_unit_test(evtFormatMetricJsonBufMatchesJson),
+        cmocka_unit_test(fmtEventJsonHeadReusesEnvelope),
+        cmocka_unit_test(evtFormatJsonBufBenchmark),
+        cmocka_unit_test(evtFormatMetricUsesCaptureTime),
         cmocka_unit_test(evtFormatSourceEnabledSetAndGet),
         cmocka_unit_test(evtFormatValueFilterSetAndGet),
         cmocka_unit_test(evtFormatFieldFilterSetAndGet),
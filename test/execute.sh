@@ -72,17 +72,30 @@ run_test test/${OS}/ctltest
 run_test test/${OS}/mtcformattest
 run_test test/${OS}/circbuftest
 run_test test/${OS}/linklisttest
+run_test test/${OS}/hmaptest
 run_test test/${OS}/comtest
+run_test test/${OS}/spilltest
+run_test test/${OS}/msgpacktest
+run_test test/${OS}/jsonbuftest
+run_test test/${OS}/payfdtest
+run_test test/${OS}/scrapetest
+run_test test/${OS}/pcapngtest
 run_test test/${OS}/dbgtest
 run_test test/${OS}/searchtest
+run_test test/${OS}/filtertest
 run_test test/${OS}/httpstatetest
 if [ "${OS}" = "linux" ]; then
     run_test test/${OS}/glibcvertest
     run_test test/${OS}/reporttest
     run_test test/${OS}/javabcitest
     run_test test/${OS}/httpheadertest
+    run_test test/${OS}/protocoltest
 fi
 run_test test/${OS}/httpaggtest
+run_test test/${OS}/urinormtest
+run_test test/${OS}/histotest
+run_test test/${OS}/hpacktest
+run_test test/${OS}/bytesigtest
 run_test test/${OS}/selfinterposetest
 
 if [ "${OS}" = "linux" ]; then
@@ -0,0 +1,308 @@
+#define _GNU_SOURCE
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "com.h"
+#include "dbg.h"
+#include "filter.h"
+#include "test.h"
+
+static void
+filterCreateReturnsNullForBadPatterns(void** state)
+{
+    assert_null(filterCreate(NULL));
+    assert_null(filterCreate("W![T^F?"));
+
+    filter_t *filter = filterCreate("");
+    assert_non_null(filter);
+    assert_true(filterMatch(filter, "anything"));
+    filterDestroy(&filter);
+    assert_null(filter);
+
+    // Just don't crash
+    filterDestroy(NULL);
+    filterDestroy(&filter);
+    assert_false(filterMatch(NULL, "x"));
+    assert_false(filterMatchName(NULL, "x"));
+}
+
+static void
+filterMatchIsExtendedRegex(void** state)
+{
+    filter_t *filter = filterCreate("^(net|fs)\\.(rx|tx|read)$");
+    assert_non_null(filter);
+
+    assert_true(filterMatch(filter, "net.rx"));
+    assert_true(filterMatch(filter, "fs.read"));
+    assert_false(filterMatch(filter, "fs.rx.bytes"));
+    assert_false(filterMatch(filter, ""));
+    assert_false(filterMatch(filter, NULL));
+
+    filterDestroy(&filter);
+}
+
+static void
+filterMatchIsPcre2(void** state)
+{
+    // The same syntax the filters had when they went through pcre2posix
+    filter_t *filter = filterCreate("\\bERR(OR)?\\b|(?i)timeout");
+    assert_non_null(filter);
+
+    assert_true(filterMatch(filter, "level=ERROR msg=oops"));
+    assert_true(filterMatch(filter, "ERR: disk full"));
+    assert_true(filterMatch(filter, "read TimeOut after 30s"));
+    assert_false(filterMatch(filter, "ERRORS=0"));
+    assert_false(filterMatch(filter, "all good"));
+
+    filterDestroy(&filter);
+}
+
+static void
+filterMatchAgreesWithRegexec(void** state)
+{
+    // Some of these are prefiltered by their literals, some aren't.
+    // Either way the answers have to be the regex's answers.
+    const char *patterns[] = {
+        "ERROR|WARN|timeout", "colou?r", "ab*c", "a{2}b|x{1,}y", "a{b",
+        "x\\.y|q\\|r", "[]|]z|[^a-c]d", "[[:digit:]]ms|sec", "(ab|cd)ef",
+        "\\bERR\\b|fail(ed|ure)", "^start|end$", "a+b+", "a|", "",
+        "(?i)error", "\\x41B", "\\Qa.b\\E", "a.c|xyz", "re(ad|cv)?(from)?",
+        "\\d+ bytes", "a?", "\\}x\\{",
+    };
+    const char *strs[] = {
+        "", "ERROR", "a WARNing", "timeout!", "time out", "error", "color",
+        "colour", "colr", "ac", "abbbc", "aab", "ab", "xy", "xxy", "a{b",
+        "x.y", "xzy", "q|r", "qr", "|z", "]z", "dd", "ad", "5ms", "ms",
+        "sec", "abef", "cdef", "ef", "ERR", "ERRS", "failed", "failure",
+        "start here", "at the end", "end.", "ab", "aabb", "AB", "a.b",
+        "abc", "xyz", "recv", "re", "readfrom", "12 bytes", " bytes", "}x{",
+    };
+
+    int i, j;
+    for (i = 0; i < sizeof(patterns)/sizeof(patterns[0]); i++) {
+        regex_t re;
+        assert_int_equal(regcomp(&re, patterns[i], REG_EXTENDED | REG_NOSUB), 0);
+        filter_t *filter = filterCreate(patterns[i]);
+        assert_non_null(filter);
+
+        for (j = 0; j < sizeof(strs)/sizeof(strs[0]); j++) {
+            int expected = !regexec(&re, strs[j], 0, NULL, 0);
+            if (filterMatch(filter, strs[j]) != expected) {
+                fail_msg("\"%s\" on \"%s\"", patterns[i], strs[j]);
+            }
+            assert_int_equal(filterMatchName(filter, strs[j]), expected);
+        }
+
+        filterDestroy(&filter);
+        regfree(&re);
+    }
+}
+
+#define THREADS 8
+
+static void *
+matchFromThread(void *arg)
+{
+    filter_t *filter = arg;
+    char line[64];
+    long i, wrong = 0;
+
+    for (i = 0; i < 20000; i++) {
+        snprintf(line, sizeof(line), "request %ld took %ldms", i, i % 1000);
+        if (filterMatch(filter, line) != ((i % 1000) >= 900)) wrong++;
+    }
+    return (void *)wrong;
+}
+
+static void
+filterMatchFromManyThreads(void** state)
+{
+    filter_t *filter = filterCreate("took 9[0-9][0-9]ms$");
+    assert_non_null(filter);
+
+    pthread_t tid[THREADS];
+    int i;
+    for (i = 0; i < THREADS; i++) {
+        assert_int_equal(pthread_create(&tid[i], NULL, matchFromThread, filter), 0);
+    }
+    for (i = 0; i < THREADS; i++) {
+        void *wrong;
+        assert_int_equal(pthread_join(tid[i], &wrong), 0);
+        assert_null(wrong);
+    }
+
+    filterDestroy(&filter);
+}
+
+static void
+filterMatchNameRemembersDecisions(void** state)
+{
+    filter_t *filter = filterCreate("^[AD]|host");
+    assert_non_null(filter);
+
+    const char *names[] = {"A", "B", "C", "D", "Alpha", "proc", "host", "ghost"};
+    const int expected[] = {TRUE, FALSE, FALSE, TRUE, TRUE, FALSE, TRUE, TRUE};
+
+    // The second and third times around come from what's remembered
+    int i, pass;
+    for (pass = 0; pass < 3; pass++) {
+        for (i = 0; i < sizeof(names)/sizeof(names[0]); i++) {
+            assert_int_equal(filterMatchName(filter, names[i]), expected[i]);
+        }
+    }
+
+    // Names are compared by value, not by pointer
+    char name[16];
+    strcpy(name, "D");
+    assert_true(filterMatchName(filter, name));
+    strcpy(name, "B");
+    assert_false(filterMatchName(filter, name));
+
+    filterDestroy(&filter);
+}
+
+static void
+filterMatchNameWithManyNames(void** state)
+{
+    filter_t *filter = filterCreate("7$");
+    assert_non_null(filter);
+
+    // Far more names than can be remembered; the answers are still right
+    char name[32];
+    int i, pass;
+    for (pass = 0; pass < 2; pass++) {
+        for (i = 0; i < 5000; i++) {
+            snprintf(name, sizeof(name), "field%d", i);
+            assert_int_equal(filterMatchName(filter, name), (i % 10) == 7);
+        }
+    }
+
+    // As are names too long to remember
+    char longname[1024];
+    memset(longname, 'x', sizeof(longname) - 2);
+    longname[sizeof(longname) - 2] = '7';
+    longname[sizeof(longname) - 1] = '\0';
+    assert_true(filterMatchName(filter, longname));
+    longname[sizeof(longname) - 2] = '8';
+    assert_false(filterMatchName(filter, longname));
+
+    filterDestroy(&filter);
+}
+
+static void
+filterMatchLogLinesBenchmark(void** state)
+{
+    // Not a pass/fail test; reports what a typical value filter costs on
+    // console and file log lines, compared to the regexec() it replaced.
+    const int count = 100000;
+    const char *pattern = "ERROR|WARN|timeout";
+    const char *lines[] = {
+        "2021-03-04T10:15:32.123Z INFO  [main] c.e.app.Server - Started in 2.31 seconds",
+        "127.0.0.1 - - [04/Mar/2021:10:15:33 +0000] \"GET /api/v1/users?page=2 HTTP/1.1\" 200 5123",
+        "2021-03-04T10:15:34.004Z DEBUG [pool-3-thread-7] c.e.db.Pool - checked out connection 17",
+        "Mar  4 10:15:35 host sshd[4242]: Accepted publickey for deploy from 10.1.2.3 port 52814",
+        "2021-03-04T10:15:36.770Z WARN  [pool-3-thread-2] c.e.db.Pool - connection 9 idle for 300s",
+        "{\"ts\":1614852937.1,\"level\":\"info\",\"msg\":\"cache hit\",\"key\":\"user:1234\"}",
+        "2021-03-04T10:15:38.512Z INFO  [http-nio-8080-exec-4] c.e.web.Api - 200 GET /health 1ms",
+        "2021-03-04T10:15:39.999Z ERROR [http-nio-8080-exec-1] c.e.web.Api - upstream timeout",
+    };
+    const int num = sizeof(lines)/sizeof(lines[0]);
+
+    regex_t re;
+    assert_int_equal(regcomp(&re, pattern, REG_EXTENDED | REG_NOSUB), 0);
+    filter_t *filter = filterCreate(pattern);
+    assert_non_null(filter);
+
+    struct timespec start, end;
+    int n, i, matches = 0;
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (n = 0; n < count; n++) {
+        for (i = 0; i < num; i++) matches += !regexec_wrapper(&re, lines[i], 0, NULL, 0);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    double posix = (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (n = 0; n < count; n++) {
+        for (i = 0; i < num; i++) matches -= filterMatch(filter, lines[i]);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    double pcre2 = (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
+
+    assert_int_equal(matches, 0);
+    printf("    regexec: %.0f lines/sec, filter: %.0f lines/sec\n",
+           count * num / posix, count * num / pcre2);
+
+    filterDestroy(&filter);
+    regfree(&re);
+}
+
+static void
+filterMatchLogBufferBenchmark(void** state)
+{
+    // Not a pass/fail test; reports how fast a value filter rejects 32k
+    // of aggregated log lines, escaped the way createLogEventJson() has
+    // them, that have nothing it's looking for.
+    const int count = 2000;
+    const char *pattern = "ERROR|WARN|timeout";
+    const char *line =
+        "2021-03-04T10:15:32.123Z INFO  [main] c.e.app.Server - Started in 2.31 seconds\\n"
+        "127.0.0.1 - - [04/Mar/2021:10:15:33 +0000] \\\"GET /api/v1/users HTTP/1.1\\\" 200\\n";
+
+    char *buf = malloc(32768 + strlen(line));
+    assert_non_null(buf);
+    size_t len = 0;
+    while (len < 32768) {
+        strcpy(&buf[len], line);
+        len += strlen(line);
+    }
+
+    regex_t re;
+    assert_int_equal(regcomp(&re, pattern, REG_EXTENDED | REG_NOSUB), 0);
+    filter_t *filter = filterCreate(pattern);
+    assert_non_null(filter);
+
+    struct timespec start, end;
+    int n, matches = 0;
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (n = 0; n < count; n++) matches += !regexec_wrapper(&re, buf, 0, NULL, 0);
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    double posix = (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (n = 0; n < count; n++) matches += filterMatch(filter, buf);
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    double pcre2 = (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
+
+    assert_int_equal(matches, 0);
+    printf("    regexec: %.0f MB/sec, filter: %.0f MB/sec\n",
+           count * len / posix / 1e6, count * len / pcre2 / 1e6);
+
+    filterDestroy(&filter);
+    regfree(&re);
+    free(buf);
+}
+
+int
+main(int argc, char* argv[])
+{
+    printf("running %s\n", argv[0]);
+
+    const struct CMUnitTest tests[] = {
+        cmocka_unit_test(filterCreateReturnsNullForBadPatterns),
+        cmocka_unit_test(filterMatchIsExtendedRegex),
+        cmocka_unit_test(filterMatchIsPcre2),
+        cmocka_unit_test(filterMatchAgreesWithRegexec),
+        cmocka_unit_test(filterMatchFromManyThreads),
+        cmocka_unit_test(filterMatchNameRemembersDecisions),
+        cmocka_unit_test(filterMatchNameWithManyNames),
+        cmocka_unit_test(filterMatchLogLinesBenchmark),
+        cmocka_unit_test(filterMatchLogBufferBenchmark),
+        cmocka_unit_test(dbgHasNoUnexpectedFailures),
+    };
+    return cmocka_run_group_tests(tests, groupSetup, groupTeardown);
+}
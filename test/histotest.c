@@ -0,0 +1,199 @@
+#define _GNU_SOURCE
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "dbg.h"
+#include "histo.h"
+#include "test.h"
+
+static int
+compareU64(const void *a, const void *b)
+{
+    uint64_t x = *(const uint64_t *)a;
+    uint64_t y = *(const uint64_t *)b;
+    return (x > y) - (x < y);
+}
+
+// The exact value that q of vals are at or under; vals has to be sorted
+static uint64_t
+exactQuantile(uint64_t *vals, size_t num, double q)
+{
+    size_t rank = q * num;
+    if (rank < q * num) rank++;
+    if (rank < 1) rank = 1;
+    return vals[rank - 1];
+}
+
+static void
+histoEmptyAndNull(void **state)
+{
+    histo_t histo = {0};
+    assert_int_equal(histoCount(&histo), 0);
+    assert_int_equal(histoMax(&histo), 0);
+    assert_int_equal(histoQuantile(&histo, 0.5), 0);
+
+    // Don't crash
+    histoRecord(NULL, 1);
+    histoTake(NULL, &histo);
+    histoTake(&histo, NULL);
+    histoMerge(NULL, &histo);
+    histoMerge(&histo, NULL);
+    assert_int_equal(histoCount(NULL), 0);
+    assert_int_equal(histoMax(NULL), 0);
+    assert_int_equal(histoQuantile(NULL, 0.5), 0);
+}
+
+static void
+histoSmallValuesAreExact(void **state)
+{
+    histo_t histo = {0};
+    uint64_t i;
+    for (i = 0; i < 8; i++) {
+        histoRecord(&histo, i);
+    }
+    assert_int_equal(histoCount(&histo), 8);
+    assert_int_equal(histoMax(&histo), 7);
+    assert_int_equal(histoQuantile(&histo, 0.0), 0);
+    assert_int_equal(histoQuantile(&histo, 0.125), 0);
+    assert_int_equal(histoQuantile(&histo, 0.5), 3);
+    assert_int_equal(histoQuantile(&histo, 0.51), 4);
+    assert_int_equal(histoQuantile(&histo, 1.0), 7);
+    assert_int_equal(histoQuantile(&histo, 2.0), 7);
+    assert_int_equal(histoQuantile(&histo, -1.0), 0);
+}
+
+static void
+histoQuantilesAreWithinOneSixteenth(void **state)
+{
+    const size_t num = 100000;
+    uint64_t *vals = malloc(num * sizeof(*vals));
+    assert_non_null(vals);
+
+    // Spread over many powers of 2, like durations in ns
+    histo_t histo = {0};
+    srandom(42);
+    size_t i;
+    for (i = 0; i < num; i++) {
+        vals[i] = (uint64_t)random() >> (random() % 31);
+        histoRecord(&histo, vals[i]);
+    }
+    qsort(vals, num, sizeof(*vals), compareU64);
+
+    assert_int_equal(histoCount(&histo), num);
+    assert_int_equal(histoMax(&histo), vals[num - 1]);
+
+    double q[] = {0.001, 0.1, 0.25, 0.5, 0.75, 0.9, 0.99, 0.999, 1.0};
+    for (i = 0; i < sizeof(q) / sizeof(q[0]); i++) {
+        uint64_t exact = exactQuantile(vals, num, q[i]);
+        uint64_t approx = histoQuantile(&histo, q[i]);
+        uint64_t diff = (approx > exact) ? approx - exact : exact - approx;
+        assert_true(diff <= exact / 16);
+    }
+
+    free(vals);
+}
+
+static void
+histoLargeValuesGoInLastBucket(void **state)
+{
+    histo_t histo = {0};
+    histoRecord(&histo, 1ULL << 40);
+    histoRecord(&histo, UINT64_MAX);
+    assert_int_equal(histoCount(&histo), 2);
+    assert_int_equal(histoMax(&histo), UINT64_MAX);
+    assert_int_equal(histo.bucket[HISTO_BUCKETS - 1], 2);
+
+    // The last bucket counts values just under 2^40 too
+    uint64_t q = histoQuantile(&histo, 0.5);
+    assert_true(q > (1ULL << 39) + (1ULL << 38));
+    assert_true(q < (1ULL << 40));
+
+    histoRecord(&histo, (1ULL << 40) - 1);
+    assert_int_equal(histo.bucket[HISTO_BUCKETS - 1], 3);
+}
+
+static void
+histoTakeAndMerge(void **state)
+{
+    histo_t a = {0};
+    histo_t b = {0};
+    histo_t taken;
+    memset(&taken, 0xff, sizeof(taken));
+
+    int i;
+    for (i = 1; i <= 100; i++) {
+        histoRecord(&a, i);
+        histoRecord(&b, 1000 + i);
+    }
+
+    histoTake(&a, &taken);
+    assert_int_equal(histoCount(&a), 0);
+    assert_int_equal(histoMax(&a), 0);
+    assert_int_equal(histoCount(&taken), 100);
+    assert_int_equal(histoMax(&taken), 100);
+
+    histoMerge(&taken, &b);
+    assert_int_equal(histoCount(&taken), 200);
+    assert_int_equal(histoMax(&taken), 1100);
+    assert_true(histoQuantile(&taken, 0.5) <= 100);
+    assert_true(histoQuantile(&taken, 0.51) > 1000 - 1000 / 16);
+    assert_int_equal(histoCount(&b), 100);
+}
+
+#define RECORDS_PER_THREAD 100000
+
+static void *
+recordValues(void *arg)
+{
+    histo_t *histo = arg;
+    int i;
+    for (i = 0; i < RECORDS_PER_THREAD; i++) {
+        histoRecord(histo, i);
+    }
+    return NULL;
+}
+
+static void
+histoIsThreadSafe(void **state)
+{
+    histo_t histo = {0};
+    histo_t taken = {0};
+    histo_t total = {0};
+
+    pthread_t thread[4];
+    int i;
+    for (i = 0; i < 4; i++) {
+        assert_int_equal(pthread_create(&thread[i], NULL, recordValues, &histo), 0);
+    }
+    // Take while the others record; nothing's lost or counted twice
+    for (i = 0; i < 100; i++) {
+        histoTake(&histo, &taken);
+        histoMerge(&total, &taken);
+    }
+    for (i = 0; i < 4; i++) {
+        pthread_join(thread[i], NULL);
+    }
+    histoTake(&histo, &taken);
+    histoMerge(&total, &taken);
+
+    assert_int_equal(histoCount(&total), 4 * RECORDS_PER_THREAD);
+    assert_int_equal(histoMax(&total), RECORDS_PER_THREAD - 1);
+}
+
+int
+main(int argc, char* argv[])
+{
+    printf("running %s\n", argv[0]);
+
+    const struct CMUnitTest tests[] = {
+        cmocka_unit_test(histoEmptyAndNull),
+        cmocka_unit_test(histoSmallValuesAreExact),
+        cmocka_unit_test(histoQuantilesAreWithinOneSixteenth),
+        cmocka_unit_test(histoLargeValuesGoInLastBucket),
+        cmocka_unit_test(histoTakeAndMerge),
+        cmocka_unit_test(histoIsThreadSafe),
+        cmocka_unit_test(dbgHasNoUnexpectedFailures),
+    };
+    return cmocka_run_group_tests(tests, groupSetup, groupTeardown);
+}
@@ -0,0 +1,204 @@
+#define _GNU_SOURCE
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "dbg.h"
+#include "hmap.h"
+#include "test.h"
+
+static int g_deletes = 0;
+
+static void
+countDelete(void *data)
+{
+    g_deletes++;
+}
+
+static void
+hmapCreateAndDestroy(void **state)
+{
+    hmap_t *map = hmapCreate(100, NULL);
+    assert_non_null(map);
+    hmapDestroy(&map);
+    assert_null(map);
+
+    // Don't crash
+    hmapDestroy(&map);
+    hmapDestroy(NULL);
+    assert_false(hmapInsert(NULL, 23, (void*)23));
+    assert_false(hmapDelete(NULL, 23));
+    assert_null(hmapFind(NULL, 23));
+    assert_int_equal(hmapExpire(NULL, time(NULL)), 0);
+}
+
+static void
+hmapInsertFindDelete(void **state)
+{
+    hmap_t *map = hmapCreate(16, countDelete);
+    assert_non_null(map);
+    g_deletes = 0;
+
+    assert_null(hmapFind(map, 23));
+    assert_true(hmapInsert(map, 23, (void*)23));
+    assert_ptr_equal(hmapFind(map, 23), (void*)23);
+    assert_null(hmapFind(map, 24));
+
+    // Keys are unique
+    assert_false(hmapInsert(map, 23, (void*)24));
+    assert_ptr_equal(hmapFind(map, 23), (void*)23);
+
+    // Zero is a key like any other
+    assert_true(hmapInsert(map, 0, (void*)1));
+    assert_ptr_equal(hmapFind(map, 0), (void*)1);
+
+    assert_true(hmapDelete(map, 23));
+    assert_int_equal(g_deletes, 1);
+    assert_null(hmapFind(map, 23));
+    assert_false(hmapDelete(map, 23));
+    assert_int_equal(g_deletes, 1);
+
+    // And it can go back in
+    assert_true(hmapInsert(map, 23, (void*)25));
+    assert_ptr_equal(hmapFind(map, 23), (void*)25);
+
+    hmapDestroy(&map);
+    assert_int_equal(g_deletes, 3);
+}
+
+static void
+hmapInsertFailsWhenFull(void **state)
+{
+    hmap_t *map = hmapCreate(8, NULL);
+    assert_non_null(map);
+
+    list_key_t key;
+    for (key = 1; key <= 8; key++) {
+        assert_true(hmapInsert(map, key, (void*)key));
+    }
+    assert_false(hmapInsert(map, 9, (void*)9));
+    for (key = 1; key <= 8; key++) {
+        assert_ptr_equal(hmapFind(map, key), (void*)key);
+    }
+
+    // Room again after a delete
+    assert_true(hmapDelete(map, 4));
+    assert_true(hmapInsert(map, 9, (void*)9));
+    assert_ptr_equal(hmapFind(map, 9), (void*)9);
+
+    hmapDestroy(&map);
+}
+
+static void
+hmapReusesDeletedSlots(void **state)
+{
+    // Like uids of connections, keys keep growing and never come back.
+    // A map much smaller than the number of keys must keep working.
+    hmap_t *map = hmapCreate(256, NULL);
+    assert_non_null(map);
+
+    list_key_t key;
+    for (key = 1; key < 100000; key++) {
+        assert_true(hmapInsert(map, key, (void*)key));
+        if (key > 16) {
+            assert_ptr_equal(hmapFind(map, key - 16), (void*)(key - 16));
+            assert_true(hmapDelete(map, key - 16));
+        }
+    }
+    for (key = 100000 - 16; key < 100000; key++) {
+        assert_ptr_equal(hmapFind(map, key), (void*)key);
+    }
+
+    hmapDestroy(&map);
+}
+
+static void
+hmapExpireDeletesOldElements(void **state)
+{
+    hmap_t *map = hmapCreate(16, countDelete);
+    assert_non_null(map);
+    g_deletes = 0;
+
+    assert_true(hmapInsert(map, 1, (void*)1));
+    assert_true(hmapInsert(map, 2, (void*)2));
+    assert_true(hmapDelete(map, 2));
+    assert_int_equal(g_deletes, 1);
+
+    // Nothing was inserted before now
+    time_t now = time(NULL);
+    assert_int_equal(hmapExpire(map, now - 1), 0);
+    assert_ptr_equal(hmapFind(map, 1), (void*)1);
+
+    // Everything was inserted before the next second
+    assert_int_equal(hmapExpire(map, now + 1), 1);
+    assert_int_equal(g_deletes, 2);
+    assert_null(hmapFind(map, 1));
+
+    hmapDestroy(&map);
+    assert_int_equal(g_deletes, 2);
+}
+
+#define THREADS 4
+#define KEYS_PER_THREAD 50000
+
+typedef struct {
+    hmap_t *map;
+    int id;
+    int failures;
+} thread_arg_t;
+
+static void *
+insertFindDelete(void *arg)
+{
+    thread_arg_t *targ = arg;
+    list_key_t key;
+    for (key = targ->id; key < THREADS * KEYS_PER_THREAD; key += THREADS) {
+        void *data = (void*)(key + 1);
+        if (!hmapInsert(targ->map, key, data)) targ->failures++;
+        if (hmapFind(targ->map, key) != data) targ->failures++;
+        // Keep a few around so the threads probe past each other
+        if (key >= 32 * THREADS) {
+            if (!hmapDelete(targ->map, key - 32 * THREADS)) targ->failures++;
+        }
+    }
+    return NULL;
+}
+
+static void
+hmapIsThreadSafe(void **state)
+{
+    hmap_t *map = hmapCreate(1024, NULL);
+    assert_non_null(map);
+
+    pthread_t threads[THREADS];
+    thread_arg_t args[THREADS];
+    int i;
+    for (i = 0; i < THREADS; i++) {
+        args[i] = (thread_arg_t){.map = map, .id = i, .failures = 0};
+        assert_int_equal(pthread_create(&threads[i], NULL, insertFindDelete, &args[i]), 0);
+    }
+    for (i = 0; i < THREADS; i++) {
+        pthread_join(threads[i], NULL);
+        assert_int_equal(args[i].failures, 0);
+    }
+
+    hmapDestroy(&map);
+}
+
+int
+main(int argc, char* argv[])
+{
+    printf("running %s\n", argv[0]);
+
+    const struct CMUnitTest tests[] = {
+        cmocka_unit_test(hmapCreateAndDestroy),
+        cmocka_unit_test(hmapInsertFindDelete),
+        cmocka_unit_test(hmapInsertFailsWhenFull),
+        cmocka_unit_test(hmapReusesDeletedSlots),
+        cmocka_unit_test(hmapExpireDeletesOldElements),
+        cmocka_unit_test(hmapIsThreadSafe),
+        cmocka_unit_test(dbgHasNoUnexpectedFailures),
+    };
+    return cmocka_run_group_tests(tests, groupSetup, groupTeardown);
+}
@@ -0,0 +1,185 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "dbg.h"
+#include "hpack.h"
+#include "test.h"
+
+// The fields of a block, as "name: value\n" lines
+static char fields[1024];
+
+static void
+addField(void *arg, const char *name, size_t nlen, const char *value, size_t vlen)
+{
+    size_t len = strlen(fields);
+    snprintf(&fields[len], sizeof(fields) - len, "%.*s: %.*s\n",
+             (int)nlen, name, (int)vlen, value);
+}
+
+static size_t
+fromHex(const char *hex, uint8_t *buf)
+{
+    size_t len = 0;
+    unsigned int byte;
+    while (sscanf(hex, "%2x", &byte) == 1) {
+        buf[len++] = byte;
+        hex += 2;
+    }
+    return len;
+}
+
+// Returns the fields of a block, or NULL if it can't be decoded
+static const char *
+decode(hpack_t *hpack, const char *hex)
+{
+    uint8_t block[256];
+    size_t len = fromHex(hex, block);
+    fields[0] = '\0';
+    return (hpackDecode(hpack, block, len, addField, NULL)) ? NULL : fields;
+}
+
+static void
+hpackCreateAndDestroy(void **state)
+{
+    hpack_t *hpack = hpackCreate(4096);
+    assert_non_null(hpack);
+    hpackDestroy(&hpack);
+    assert_null(hpack);
+
+    // Don't crash
+    hpackDestroy(&hpack);
+    hpackDestroy(NULL);
+    assert_int_equal(hpackDecode(NULL, (uint8_t *)"\x82", 1, addField, NULL), -1);
+}
+
+// RFC 7541 Appendix C.2
+static void
+hpackDecodesLiterals(void **state)
+{
+    hpack_t *hpack = hpackCreate(4096);
+
+    // With indexing, then indexed
+    assert_string_equal(decode(hpack, "400a637573746f6d2d6b65790d637573746f6d2d686561646572"),
+                        "custom-key: custom-header\n");
+    assert_string_equal(decode(hpack, "be"), "custom-key: custom-header\n");
+
+    // Without indexing, and never indexed; neither is added to the table
+    assert_string_equal(decode(hpack, "040c2f73616d706c652f70617468"),
+                        ":path: /sample/path\n");
+    assert_string_equal(decode(hpack, "100870617373776f726406736563726574"),
+                        "password: secret\n");
+    assert_string_equal(decode(hpack, "be82"),
+                        "custom-key: custom-header\n:method: GET\n");
+    assert_null(decode(hpack, "bf"));
+
+    hpackDestroy(&hpack);
+}
+
+// RFC 7541 Appendix C.4; each request uses the table the last one left
+static void
+hpackDecodesRequestsWithHuffman(void **state)
+{
+    hpack_t *hpack = hpackCreate(4096);
+
+    assert_string_equal(decode(hpack, "828684418cf1e3c2e5f23a6ba0ab90f4ff"),
+        ":method: GET\n:scheme: http\n:path: /\n:authority: www.example.com\n");
+    assert_string_equal(decode(hpack, "828684be5886a8eb10649cbf"),
+        ":method: GET\n:scheme: http\n:path: /\n:authority: www.example.com\n"
+        "cache-control: no-cache\n");
+    assert_string_equal(decode(hpack, "828785bf408825a849e95ba97d7f8925a849e95bb8e8b4bf"),
+        ":method: GET\n:scheme: https\n:path: /index.html\n:authority: www.example.com\n"
+        "custom-key: custom-value\n");
+
+    hpackDestroy(&hpack);
+}
+
+// RFC 7541 Appendix C.6, where the table is 256 bytes and entries have to
+// be evicted to make room
+static void
+hpackDecodesResponsesWithEviction(void **state)
+{
+    hpack_t *hpack = hpackCreate(256);
+
+    assert_string_equal(decode(hpack,
+        "488264025885aec3771a4b6196d07abe941054d444a8200595040b8166e082a62d1bff"
+        "6e919d29ad171863c78f0b97c8e9ae82ae43d3"),
+        ":status: 302\ncache-control: private\ndate: Mon, 21 Oct 2013 20:13:21 GMT\n"
+        "location: https://www.example.com\n");
+    assert_string_equal(decode(hpack, "4883640effc1c0bf"),
+        ":status: 307\ncache-control: private\ndate: Mon, 21 Oct 2013 20:13:21 GMT\n"
+        "location: https://www.example.com\n");
+    assert_string_equal(decode(hpack,
+        "88c16196d07abe941054d444a8200595040b8166e084a62d1bffc05a839bd9ab77ad94e7"
+        "821dd7f2e6c7b335dfdfcd5b3960d5af27087f3672c1ab270fb5291f9587316065c003ed"
+        "4ee5b1063d5007"),
+        ":status: 200\ncache-control: private\ndate: Mon, 21 Oct 2013 20:13:22 GMT\n"
+        "location: https://www.example.com\ncontent-encoding: gzip\n"
+        "set-cookie: foo=ASDJKHQKBZXOQWEOPIUAXQWEOIU; max-age=3600; version=1\n");
+
+    // Only the last three fit; 302 and everything before were evicted
+    assert_string_equal(decode(hpack, "bebfc0"),
+        "set-cookie: foo=ASDJKHQKBZXOQWEOPIUAXQWEOIU; max-age=3600; version=1\n"
+        "content-encoding: gzip\ndate: Mon, 21 Oct 2013 20:13:22 GMT\n");
+    assert_null(decode(hpack, "c1"));
+
+    hpackDestroy(&hpack);
+}
+
+static void
+hpackHonorsSizeUpdates(void **state)
+{
+    hpack_t *hpack = hpackCreate(4096);
+
+    assert_non_null(decode(hpack, "400a637573746f6d2d6b65790d637573746f6d2d686561646572"));
+    // A size of 0 empties the table; then it can grow back to 4096
+    assert_string_equal(decode(hpack, "203fe11f82"), ":method: GET\n");
+    assert_null(decode(hpack, "be"));
+    hpackDestroy(&hpack);
+
+    // But no bigger than it was created with
+    hpack = hpackCreate(4096);
+    assert_null(decode(hpack, "3fe21f"));
+    hpackDestroy(&hpack);
+}
+
+static void
+hpackRejectsBadBlocks(void **state)
+{
+    const char *bad[] = {
+        "80",                       // index 0
+        "ff",                       // index that doesn't end
+        "ffffffffffff7f",           // index too big
+        "400a637573746f6d",         // string longer than the block
+        "4084ffffffff0161",         // Huffman string with EOS in it
+        "408200000161",             // Huffman padding that isn't all 1s
+        "4081ff0161",               // more than 7 bits of padding
+        "3fe21f",                   // size update over the limit
+    };
+
+    int i;
+    for (i = 0; i < sizeof(bad) / sizeof(bad[0]); i++) {
+        hpack_t *hpack = hpackCreate(4096);
+        assert_null(decode(hpack, bad[i]));
+        // It can't be used after that
+        assert_null(decode(hpack, "82"));
+        hpackDestroy(&hpack);
+    }
+}
+
+int
+main(int argc, char* argv[])
+{
+    printf("running %s\n", argv[0]);
+
+    const struct CMUnitTest tests[] = {
+        cmocka_unit_test(hpackCreateAndDestroy),
+        cmocka_unit_test(hpackDecodesLiterals),
+        cmocka_unit_test(hpackDecodesRequestsWithHuffman),
+        cmocka_unit_test(hpackDecodesResponsesWithEviction),
+        cmocka_unit_test(hpackHonorsSizeUpdates),
+        cmocka_unit_test(hpackRejectsBadBlocks),
+        cmocka_unit_test(dbgHasNoUnexpectedFailures),
+    };
+    return cmocka_run_group_tests(tests, groupSetup, groupTeardown);
+}
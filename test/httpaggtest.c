@@ -22,7 +22,7 @@ int cmdSendMetric(mtc_t *mtc, event_t *evt)
 static void
 httpAggCreateReturnsNonNull(void **state)
 {
-    http_agg_t *http_agg = httpAggCreate();
+    http_agg_t *http_agg = httpAggCreate(TRUE);
     assert_non_null(http_agg);
     httpAggDestroy(&http_agg);
     assert_null(http_agg);
@@ -45,7 +45,7 @@ httpAggAddMetricForNullDoesNotCrash(void **state)
 static void
 httpAggAddMetricHappyPath(void **state)
 {
-    http_agg_t *http_agg = httpAggCreate();
+    http_agg_t *http_agg = httpAggCreate(TRUE);
 
     event_field_t fields[] = {
         STRFIELD("http_target", "/", 4, FALSE),
@@ -91,7 +91,7 @@ httpAggAddMetricHappyPath(void **state)
 static void
 httpAggAddMetricWithQueryStringsAreAggregatedTogether(void **state)
 {
-    http_agg_t *http_agg = httpAggCreate();
+    http_agg_t *http_agg = httpAggCreate(TRUE);
 
     int previous_metric_count = 0;
 
@@ -126,7 +126,7 @@ httpAggAddMetricWithQueryStringsAreAggregatedTogether(void **state)
 static void
 httpAggAddMetricWithManyStatusCodesDoesNotCrash(void **state)
 {
-    http_agg_t *http_agg = httpAggCreate();
+    http_agg_t *http_agg = httpAggCreate(TRUE);
 
     // When this was written, MAX_CODE_ENTRIES was set to 64 in src/httpreport.c
     // 100 here is chosen to make sure we tolerate more than this.
@@ -148,10 +148,9 @@ httpAggAddMetricWithManyStatusCodesDoesNotCrash(void **state)
 static void
 httpAggAddMetricWithManyHttpTargetsDoesNotCrash(void **state)
 {
-    http_agg_t *http_agg = httpAggCreate();
+    http_agg_t *http_agg = httpAggCreate(TRUE);
 
-    // When this was written, DEFAULT_TARGET_LEN was set to 128 in 
-    // src/httpreport.c.  250 is used here to exercise a realloc case.
+    // 250 targets, to fill more than a few slots of the index.
     int i;
     for (i=0; i<250; i++) {
         char http_target[128];
@@ -181,6 +180,255 @@ httpAggResetForNullDoesNotCrash(void **state)
     httpAggReset(NULL);
 }
 
+static void
+httpAggScrapeHappyPath(void **state)
+{
+    http_agg_t *http_agg = httpAggCreate(TRUE);
+    scrape_out_t out = {0};
+
+    event_field_t fields[] = {
+        STRFIELD("http_target", "/a\"b?q=1", 4, FALSE),
+        NUMFIELD("http_status_code", 404, 1, FALSE),
+        FIELDEND
+    };
+    event_t event = INT_EVENT("http_client_duration", 1500, DELTA, fields);
+    httpAggAddMetric(http_agg, &event, -1, 10);
+    httpAggAddMetric(http_agg, &event, -1, 20);
+
+    httpAggScrape(http_agg, &out);
+    assert_false(out.err);
+    assert_non_null(strstr(out.data, "# TYPE http_requests counter\n"));
+    assert_non_null(strstr(out.data,
+        "http_requests_total{http_target=\"/a\\\"b\",http_status_code=\"404\","));
+    assert_non_null(strstr(out.data, "\"} 2\n"));
+    assert_non_null(strstr(out.data, "# TYPE http_client_duration_seconds summary\n"
+                                     "# UNIT http_client_duration_seconds seconds\n"
+                                     "http_client_duration_seconds_count{"));
+    assert_non_null(strstr(out.data, "} 3\n"));
+    assert_non_null(strstr(out.data, "http_response_content_length_bytes_sum{"));
+    assert_non_null(strstr(out.data, "} 30\n"));
+
+    // No requests were ever seen
+    assert_null(strstr(out.data, "http_server_duration_seconds_count"));
+    assert_null(strstr(out.data, "http_request_content_length_bytes_count"));
+
+    scrapeOutFree(&out);
+    httpAggScrape(NULL, &out);
+    httpAggScrape(http_agg, NULL);
+    assert_null(out.data);
+    httpAggDestroy(&http_agg);
+}
+
+static void
+httpAggKeysByMethodAndTarget(void **state)
+{
+    http_agg_t *http_agg = httpAggCreate(TRUE);
+    scrape_out_t out = {0};
+
+    const char *method[] = {"GET", "POST", "GET", NULL};
+    int i;
+    for (i=0; i<sizeof(method)/sizeof(method[0]); i++) {
+        event_field_t fields[] = {
+            STRFIELD("http_target", "/x", 4, FALSE),
+            NUMFIELD("http_status_code", 201, 1, FALSE),
+            STRFIELD("http_method", method[i], 4, FALSE),
+            FIELDEND
+        };
+        // No method at all, for the last one
+        if (!method[i]) fields[2] = (event_field_t)FIELDEND;
+        event_t event = INT_EVENT("http_server_duration", 2, DELTA, fields);
+        httpAggAddMetric(http_agg, &event, -1, -1);
+    }
+
+    httpAggScrape(http_agg, &out);
+    assert_false(out.err);
+    assert_non_null(strstr(out.data,
+        "http_requests_total{http_method=\"GET\",http_target=\"/x\","
+        "http_status_code=\"201\","));
+    assert_non_null(strstr(out.data,
+        "http_requests_total{http_method=\"POST\",http_target=\"/x\","));
+    assert_non_null(strstr(out.data,
+        "http_requests_total{http_target=\"/x\",http_status_code=\"201\","));
+    assert_non_null(strstr(out.data, "\"} 2\n"));
+    scrapeOutFree(&out);
+
+    g_send_metric_count = 0;
+    httpAggSendReport(http_agg, bogus_mtc_addr);
+    // http.requests, http.server.duration and its p50, p90, p99 and max,
+    // for each of the 3
+    assert_int_equal(g_send_metric_count, 3 * 6);
+
+    httpAggDestroy(&http_agg);
+}
+
+static void
+httpAggWithoutQuantilesReportsNoPercentiles(void **state)
+{
+    http_agg_t *with = httpAggCreate(TRUE);
+    http_agg_t *without = httpAggCreate(FALSE);
+    scrape_out_t with_out = {0};
+    scrape_out_t without_out = {0};
+
+    event_field_t fields[] = {
+        STRFIELD("http_target", "/", 4, FALSE),
+        NUMFIELD("http_status_code", 200, 1, FALSE),
+        FIELDEND
+    };
+    event_t event = INT_EVENT("http_server_duration", 2, DELTA, fields);
+    httpAggAddMetric(with, &event, -1, -1);
+    httpAggAddMetric(without, &event, -1, -1);
+
+    // http.requests, http.server.duration and its p50, p90, p99 and max
+    g_send_metric_count = 0;
+    httpAggSendReport(with, bogus_mtc_addr);
+    assert_int_equal(g_send_metric_count, 6);
+
+    // Without the percentiles
+    g_send_metric_count = 0;
+    httpAggSendReport(without, bogus_mtc_addr);
+    assert_int_equal(g_send_metric_count, 2);
+
+    // Scrape doesn't report them either way
+    httpAggScrape(with, &with_out);
+    httpAggScrape(without, &without_out);
+    assert_false(with_out.err);
+    assert_false(without_out.err);
+    assert_int_equal(with_out.len, without_out.len);
+    assert_memory_equal(with_out.data, without_out.data, with_out.len);
+    scrapeOutFree(&with_out);
+    scrapeOutFree(&without_out);
+
+    httpAggDestroy(&with);
+    httpAggDestroy(&without);
+}
+
+static void
+httpAggStatusCodesAreReportedInOrder(void **state)
+{
+    http_agg_t *http_agg = httpAggCreate(TRUE);
+    scrape_out_t out = {0};
+
+    int code[] = {503, 200, 999, 0, 1000, -1, 200};
+    int i;
+    for (i=0; i<sizeof(code)/sizeof(code[0]); i++) {
+        event_field_t fields[] = {
+            STRFIELD("http_target", "/", 4, FALSE),
+            NUMFIELD("http_status_code", code[i], 1, FALSE),
+            FIELDEND
+        };
+        event_t event = INT_EVENT("http_server_duration", 2, DELTA, fields);
+        httpAggAddMetric(http_agg, &event, -1, -1);
+    }
+
+    httpAggScrape(http_agg, &out);
+    assert_false(out.err);
+    char *c0 = strstr(out.data, "http_status_code=\"0\"");
+    char *c200 = strstr(out.data, "http_status_code=\"200\"");
+    char *c503 = strstr(out.data, "http_status_code=\"503\"");
+    char *c999 = strstr(out.data, "http_status_code=\"999\"");
+    assert_non_null(c0);
+    assert_true(c0 < c200);
+    assert_true(c200 < c503);
+    assert_true(c503 < c999);
+    assert_non_null(strstr(c200, "\"} 2\n"));
+    // Out of range
+    assert_null(strstr(out.data, "http_status_code=\"1000\""));
+    assert_null(strstr(out.data, "http_status_code=\"-1\""));
+    scrapeOutFree(&out);
+
+    httpAggDestroy(&http_agg);
+}
+
+static void
+httpAggTooManyTargetsAreCountedAsOther(void **state)
+{
+    http_agg_t *http_agg = httpAggCreate(TRUE);
+    scrape_out_t out = {0};
+
+    // Twice, to see that Reset starts over
+    int round;
+    for (round=0; round<2; round++) {
+        int i;
+        for (i=0; i<1024 + 10; i++) {
+            char http_target[128];
+            snprintf(http_target, sizeof(http_target), "/%d", i);
+            event_field_t fields[] = {
+                STRFIELD("http_target", http_target, 4, FALSE),
+                NUMFIELD("http_status_code", 200, 1, FALSE),
+                FIELDEND
+            };
+            event_t event = INT_EVENT("http_server_duration", 2, DELTA, fields);
+            httpAggAddMetric(http_agg, &event, -1, -1);
+            // Ones that were kept are still counted by themselves
+            if (i == 1024 + 9) {
+                fields[0] = (event_field_t)STRFIELD("http_target", "/1023", 4, FALSE);
+                httpAggAddMetric(http_agg, &event, -1, -1);
+            }
+        }
+
+        httpAggScrape(http_agg, &out);
+        assert_false(out.err);
+        assert_non_null(strstr(out.data,
+            "http_requests_total{http_target=\"/0\","));
+        char *last = strstr(out.data, "http_requests_total{http_target=\"/1023\",");
+        assert_non_null(last);
+        assert_non_null(strstr(last, "\"} 2\n"));
+        assert_null(strstr(out.data, "http_target=\"/1024\""));
+        char *other = strstr(out.data, "http_requests_total{http_target=\"other\",");
+        assert_non_null(other);
+        assert_non_null(strstr(other, "\"} 10\n"));
+        scrapeOutFree(&out);
+
+        g_send_metric_count = 0;
+        httpAggSendReport(http_agg, bogus_mtc_addr);
+        assert_int_equal(g_send_metric_count, 6 * (1024 + 1));
+        httpAggReset(http_agg);
+    }
+
+    httpAggDestroy(&http_agg);
+}
+
+static void
+httpAggNormalizesTargets(void **state)
+{
+    http_agg_t *http_agg = httpAggCreate(TRUE);
+    urinorm_t *norm = urinormCreate("/users/{id}/profile");
+    scrape_out_t out = {0};
+    httpAggNormalizerSet(http_agg, norm);
+
+    const char *target[] = {
+        "/users/81237/orders/991", "/users/5/orders/6?x=1",
+        "/users/alice/profile", "/users/bob/profile",
+    };
+    int i;
+    for (i=0; i<sizeof(target)/sizeof(target[0]); i++) {
+        event_field_t fields[] = {
+            STRFIELD("http_target", target[i], 4, FALSE),
+            NUMFIELD("http_status_code", 200, 1, FALSE),
+            FIELDEND
+        };
+        event_t event = INT_EVENT("http_server_duration", 2, DELTA, fields);
+        httpAggAddMetric(http_agg, &event, -1, -1);
+    }
+
+    httpAggScrape(http_agg, &out);
+    assert_false(out.err);
+    char *orders = strstr(out.data,
+        "http_requests_total{http_target=\"/users/{int}/orders/{int}\",");
+    assert_non_null(orders);
+    assert_non_null(strstr(orders, "\"} 2\n"));
+    char *profile = strstr(out.data,
+        "http_requests_total{http_target=\"/users/{id}/profile\",");
+    assert_non_null(profile);
+    assert_non_null(strstr(profile, "\"} 2\n"));
+    assert_null(strstr(out.data, "alice"));
+    scrapeOutFree(&out);
+
+    httpAggDestroy(&http_agg);
+    urinormDestroy(&norm);
+    httpAggNormalizerSet(NULL, NULL);
+}
+
 int
 main(int argc, char *argv[])
 {
@@ -195,7 +443,13 @@ main(int argc, char *argv[])
         cmocka_unit_test(httpAggAddMetricWithManyStatusCodesDoesNotCrash),
         cmocka_unit_test(httpAggAddMetricWithManyHttpTargetsDoesNotCrash),
         cmocka_unit_test(httpAggSendReportForNullDoesNotCrash),
-        cmocka_unit_test(httpAggResetForNullDoesNotCrash)
+        cmocka_unit_test(httpAggResetForNullDoesNotCrash),
+        cmocka_unit_test(httpAggScrapeHappyPath),
+        cmocka_unit_test(httpAggKeysByMethodAndTarget),
+        cmocka_unit_test(httpAggWithoutQuantilesReportsNoPercentiles),
+        cmocka_unit_test(httpAggStatusCodesAreReportedInOrder),
+        cmocka_unit_test(httpAggTooManyTargetsAreCountedAsOther),
+        cmocka_unit_test(httpAggNormalizesTargets),
     };
     return cmocka_run_group_tests(tests, NULL, NULL);
 }
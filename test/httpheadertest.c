@@ -276,6 +276,7 @@ userDefinedHeaderExtract(void **state)
     cfgEvtFormatHeaderSet(cfg, "(?i)x-myheader.*");
     g_ctl = initCtl(cfg);
     g_cfg.staticfg = cfg;
+    setHttpHeaderCapture(TRUE);
 
     net_info *net = getNet(3);
     assert_non_null(net);
@@ -287,6 +288,7 @@ userDefinedHeaderExtract(void **state)
         assert_non_null(strstr(header_event, result[i]));
     }
     free(header_event);
+    setHttpHeaderCapture(FALSE);
     cfgDestroy(&cfg);
 }
 
@@ -328,6 +330,163 @@ xAppScopeHeaderExtract(void **state)
     cfgDestroy(&cfg);
 }
 
+static void
+headerResponseChunked(void **state)
+{
+    char *response = "HTTP/1.1 200 OK\r\nTransfer-Encoding: chunked\r\n\r\n1b\r\n";
+    char *body = "now is the time for a body\n\r\n0\r\n\r\n";
+
+    net_info *net = getNet(5);
+    assert_non_null(net);
+    header_event = NULL;
+    assert_true(doHttp(0x12345, 5, net, response, strlen(response), TLSRX, BUF));
+    assert_null(header_event);
+
+    // The response is reported once its body has been counted
+    assert_false(doHttp(0x12345, 5, net, body, strlen(body), TLSRX, BUF));
+    assert_non_null(header_event);
+    assert_non_null(strstr(header_event, "\"http_status_code\":200"));
+    assert_non_null(strstr(header_event, "\"http_response_content_length\":27"));
+    free(header_event);
+}
+
+static void
+headerFieldsFromOnePass(void **state)
+{
+    char *request = "PUT /a/b?c=d HTTP/1.1\r\n"
+                    "X-Forwarded-Host: not.the.host\r\n"
+                    "host:example.com \t\r\n"
+                    "X-Trace:  abc 123\r\n"
+                    "content-length: 12\r\n\r\n";
+    char *response = "HTTP/1.1 204\r\nX-Trace: def\r\n\r\n";
+
+    config_t *cfg = cfgCreateDefault();
+    cfgEvtFormatSourceEnabledSet(cfg, CFG_SRC_HTTP, (unsigned)1);
+    // Patterns match against the whole line
+    cfgEvtFormatHeaderSet(cfg, "(?i)x-trace: +abc");
+    // The tests after this one still use these
+    ctl_t *prevctl = g_ctl;
+    config_t *prevcfg = g_cfg.staticfg;
+    g_ctl = initCtl(cfg);
+    g_cfg.staticfg = cfg;
+    setHttpHeaderCapture(TRUE);
+
+    net_info *net = getNet(6);
+    assert_non_null(net);
+    header_event = NULL;
+    assert_true(doHttp(0x12345, 6, net, request, strlen(request), TLSRX, BUF));
+    assert_non_null(header_event);
+    char *result[] = {
+        "\"http_method\":\"PUT\"",
+        "\"http_target\":\"/a/b?c=d\"",
+        "\"http_flavor\":\"1.1\"",
+        "\"http_host\":\"example.com\"",
+        "\"X-Trace\":\"abc 123\"",
+        "\"http_request_content_length\":12",
+    };
+    int i;
+    for (i=0; i<sizeof(result)/sizeof(result[0]); i++) {
+        assert_non_null(strstr(header_event, result[i]));
+    }
+    assert_null(strstr(header_event, "not.the.host"));
+    free(header_event);
+
+    // The request's fields are reported again with the response
+    header_event = NULL;
+    assert_true(doHttp(0x12345, 6, net, response, strlen(response), TLSTX, BUF));
+    assert_non_null(header_event);
+    char *resp_result[] = {
+        "\"http_status_code\":204",
+        "\"http_status_text\":\"\"",
+        "\"http_host\":\"example.com\"",
+        "\"X-Trace\":\"abc 123\"",
+        "\"http_request_content_length\":12",
+    };
+    for (i=0; i<sizeof(resp_result)/sizeof(resp_result[0]); i++) {
+        assert_non_null(strstr(header_event, resp_result[i]));
+    }
+    assert_null(strstr(header_event, "def"));
+    free(header_event);
+    setHttpHeaderCapture(FALSE);
+    ctlDestroy(&g_ctl);
+    g_ctl = prevctl;
+    g_cfg.staticfg = prevcfg;
+    cfgDestroy(&cfg);
+}
+
+// Sends a response, and returns the target of the request it was matched
+// to, or "" if it wasn't
+static const char *
+pipelinedTarget(net_info *net, char *target, size_t size)
+{
+    char *response = "HTTP/1.1 200 OK\r\n\r\n";
+    header_event = NULL;
+    assert_true(doHttp(0x12345, 8, net, response, strlen(response), NETRX, BUF));
+    assert_non_null(header_event);
+
+    target[0] = '\0';
+    char *found = strstr(header_event, "\"http_target\":\"");
+    if (found) sscanf(found, "\"http_target\":\"%[^\"]", target);
+    free(header_event);
+    return target;
+}
+
+static void
+headerPipelinedResponsesMatchRequests(void **state)
+{
+    char request[HTTP_MAX_PIPELINED + 1][64];
+    char expect[64];
+    char target[64];
+    config_t *cfg = cfgCreateDefault();
+    config_t *prevcfg = g_cfg.staticfg;
+    g_cfg.staticfg = cfg;
+    net_info *net = getNet(8);
+    assert_non_null(net);
+
+    int i;
+    for (i = 0; i < HTTP_MAX_PIPELINED + 1; i++) {
+        snprintf(request[i], sizeof(request[i]),
+                 "GET /r%d HTTP/1.1\r\nHost: example.com\r\n\r\n", i);
+    }
+
+    // Two requests are sent before either is answered; the responses
+    // answer them in order
+    for (i = 0; i < 2; i++) {
+        assert_true(doHttp(0x12345, 8, net, request[i], strlen(request[i]), NETTX, BUF));
+        free(header_event);
+    }
+    assert_string_equal(pipelinedTarget(net, target, sizeof(target)), "/r0");
+    assert_string_equal(pipelinedTarget(net, target, sizeof(target)), "/r1");
+    assert_string_equal(pipelinedTarget(net, target, sizeof(target)), "");
+
+    // More than fit in the map still answer the right ones
+    for (i = 0; i < HTTP_MAX_PENDING + 1; i++) {
+        assert_true(doHttp(0x12345, 8, net, request[i], strlen(request[i]), NETTX, BUF));
+        free(header_event);
+    }
+    for (i = 0; i < HTTP_MAX_PENDING + 1; i++) {
+        snprintf(expect, sizeof(expect), "/r%d", i);
+        assert_string_equal(pipelinedTarget(net, target, sizeof(target)), expect);
+    }
+    assert_string_equal(pipelinedTarget(net, target, sizeof(target)), "");
+
+    // Past the limit, the newest isn't waited for; the others still match
+    for (i = 0; i < HTTP_MAX_PIPELINED + 1; i++) {
+        header_event = NULL;
+        assert_true(doHttp(0x12345, 8, net, request[i], strlen(request[i]), NETTX, BUF));
+        assert_non_null(header_event);
+        free(header_event);
+    }
+    for (i = 0; i < HTTP_MAX_PIPELINED; i++) {
+        snprintf(expect, sizeof(expect), "/r%d", i);
+        assert_string_equal(pipelinedTarget(net, target, sizeof(target)), expect);
+    }
+    assert_string_equal(pipelinedTarget(net, target, sizeof(target)), "");
+    header_event = NULL;
+    g_cfg.staticfg = prevcfg;
+    cfgDestroy(&cfg);
+}
+
 int
 main(int argc, char *argv[])
 {
@@ -338,9 +497,12 @@ main(int argc, char *argv[])
         cmocka_unit_test(headerBasicResponse),
         cmocka_unit_test(headerRequestIP),
         cmocka_unit_test(headerResponseIP),
+        cmocka_unit_test(headerResponseChunked),
+        cmocka_unit_test(headerFieldsFromOnePass),
         cmocka_unit_test(headerRequestUnix),
         cmocka_unit_test(userDefinedHeaderExtract),
         cmocka_unit_test(xAppScopeHeaderExtract),
+        cmocka_unit_test(headerPipelinedResponsesMatchRequests),
     };
     return cmocka_run_group_tests(tests, needleTestSetup, groupTeardown);
 }
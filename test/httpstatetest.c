@@ -16,6 +16,7 @@ int g_http_guard_enabled = TRUE;
 uint64_t g_http_guard[1024];
 ctl_t *g_ctl = NULL;
 struct protocol_info_t* g_msg = NULL;
+int g_msg_count = 0;
 
 
 void
@@ -52,6 +53,7 @@ cmdPostEvent(ctl_t *ctl, char *event)
 {
     if (g_msg) freeMsg(&g_msg); // Don't leak
     g_msg = (struct protocol_info_t*)event;
+    g_msg_count++;
     return 0;
 }
 
@@ -87,7 +89,7 @@ doHttpWithSingleBufferWithNet(void** state)
     assert_non_null(post);
     char *header = post->hdr;
     assert_non_null(header);
-    assert_string_equal(post->hdr, "GET / HTTP/1.0\r\nHost: www.google.com\r\nConnection: close\r\n");
+    assert_string_equal(post->hdr, "GET / HTTP/1.0\r\nHost: www.google.com\r\n");
     freeMsg(&g_msg);
 }
 
@@ -107,7 +109,7 @@ doHttpWithSingleBufferWithoutNet(void** state)
     assert_non_null(post);
     char *header = post->hdr;
     assert_non_null(header);
-    assert_string_equal(header, "GET / HTTP/1.0\r\nHost: www.google.com\r\nConnection: close\r\n");
+    assert_string_equal(header, "GET / HTTP/1.0\r\nHost: www.google.com\r\n");
     freeMsg(&g_msg);
 }
 
@@ -153,7 +155,7 @@ doHttpWithConsecutiveHeaders(void** state)
         assert_non_null(post);
         char *header = post->hdr;
         assert_non_null(header);
-        assert_string_equal(header, "GET / HTTP/1.0\r\nHost: www.google.com\r\nConnection: close\r\n");
+        assert_string_equal(header, "GET / HTTP/1.0\r\nHost: www.google.com\r\n");
         freeMsg(&g_msg);
     }
 
@@ -164,7 +166,7 @@ doHttpWithConsecutiveHeaders(void** state)
         assert_non_null(post);
         char *header = post->hdr;
         assert_non_null(header);
-        assert_string_equal(header, "GET / HTTP/1.0\r\nHost: www.google.com\r\nConnection: close\r\n");
+        assert_string_equal(header, "GET / HTTP/1.0\r\nHost: www.google.com\r\n");
         freeMsg(&g_msg);
     }
 }
@@ -192,7 +194,7 @@ doHttpWithSplitHeader(void** state)
             assert_non_null(post);
             char *header = post->hdr;
             assert_non_null(header);
-            assert_string_equal(post->hdr, "GET / HTTP/1.0\r\nHost: www.google.com\r\nConnection: close\r\n");
+            assert_string_equal(post->hdr, "GET / HTTP/1.0\r\nHost: www.google.com\r\n");
             freeMsg(&g_msg);
         } else {
             assert_false(returnValue);
@@ -229,7 +231,7 @@ doHttpWithInterleavedEncryption(void** state)
             assert_non_null(post);
             char *header = post->hdr;
             assert_non_null(header);
-            assert_string_equal(post->hdr, "GET / HTTP/1.0\r\nHost: www.google.com\r\nConnection: close\r\n");
+            assert_string_equal(post->hdr, "GET / HTTP/1.0\r\nHost: www.google.com\r\n");
             freeMsg(&g_msg);
         } else {
             assert_false(returnValue);
@@ -239,18 +241,19 @@ doHttpWithInterleavedEncryption(void** state)
 }
 
 static void
-doHttpWhichRequiresRealloc(void** state)
+doHttpWithLongHeader(void** state)
 {
     char *buffers[] = {
         "GET / HTTP/1.0\r\n",
-        "0123456789ABCD\r\n", // <-- repeat this one a bunch, 16 bytes at a time
-        "X\r\n\r\n",
+        "X-Filler: 0123\r\n", // <-- repeat this one a bunch, 16 bytes at a time
+        "Host: a\r\n\r\n",
         NULL };
     net_info net = {0};
     net.type = SOCK_STREAM;
     int headersize = 0;
 
-    while (headersize < 4096) {
+    // Much more than is kept; only the fields that get reported are
+    while (headersize < 4*4096) {
         char *buffer = (!headersize) ? buffers[0] : buffers[1];
 
         size_t buflen = strlen(buffer);
@@ -258,41 +261,351 @@ doHttpWhichRequiresRealloc(void** state)
         assert_false(returnValue);
         headersize += buflen;
     }
+    assert_true(doHttp(13, 3, &net, (void*)buffers[2], strlen(buffers[2]), NETRX, BUF));
+    assert_non_null(g_msg);
+    struct http_post_t *post = (struct http_post_t*) g_msg->data;
+    assert_string_equal(post->hdr, "GET / HTTP/1.0\r\nHost: a\r\n");
+    freeMsg(&g_msg);
 
-    // buffers[2] takes us 3 bytes past the original 4096 limit.
+    // With patterns configured, other fields are kept too, but they
+    // leave room for the ones that get reported
+    setHttpHeaderCapture(TRUE);
+    headersize = 0;
+    while (headersize < 4*4096) {
+        char *buffer = (!headersize) ? buffers[0] : buffers[1];
+        assert_false(doHttp(13, 3, &net, (void*)buffer, strlen(buffer), NETRX, BUF));
+        headersize += strlen(buffer);
+    }
     assert_true(doHttp(13, 3, &net, (void*)buffers[2], strlen(buffers[2]), NETRX, BUF));
+    assert_non_null(g_msg);
+    post = (struct http_post_t*) g_msg->data;
+    size_t hdrlen = strlen(post->hdr);
+    assert_true(hdrlen < 4096);
+    assert_int_equal(strncmp(post->hdr, "GET / HTTP/1.0\r\nX-Filler: 0123\r\n", 32), 0);
+    assert_string_equal(&post->hdr[hdrlen - 9], "Host: a\r\n");
+    freeMsg(&g_msg);
+    setHttpHeaderCapture(FALSE);
+
+    assert_int_equal(dbgCountMatchingLines("src/httpstate.c"), 0);
 }
 
 static void
-doHttpWhichExceedsReallocSize(void** state)
+doHttpWithLongStartLine(void** state)
 {
+    char line[6000];
+    memset(line, 'a', sizeof(line));
+    memcpy(line, "GET /", 5);
+    strcpy(&line[sizeof(line) - 10], " HTTP/1.0");
+
     char *buffers[] = {
-        "GET / HTTP/1.0\r\n",
-        "0123456789ABCD\r\n", // <-- repeat this one a bunch, 16 bytes at a time
-        "X\r\n\r\n",
+        line,
+        "\r\nHost: a\r\n\r\n",
         NULL };
     net_info net = {0};
     net.type = SOCK_STREAM;
-    int headersize = 0;
 
-    while (headersize < 4*4096) {
-        char *buffer = (!headersize) ? buffers[0] : buffers[1];
+    assert_false(doHttp(13, 3, &net, buffers[0], strlen(buffers[0]), NETRX, BUF));
+    assert_true(doHttp(13, 3, &net, buffers[1], strlen(buffers[1]), NETRX, BUF));
 
-        size_t buflen = strlen(buffer);
-        bool returnValue = doHttp(13, 3, &net, (void*)buffer, buflen, NETRX, BUF);
-        assert_false(returnValue);
-        headersize += buflen;
+    // It's cut short to fill the slot, and still ends with a CRLF.
+    // There's no room left for the rest.
+    assert_non_null(g_msg);
+    struct http_post_t *post = (struct http_post_t*) g_msg->data;
+    size_t hdrlen = strlen(post->hdr);
+    assert_int_equal(hdrlen, 4095);
+    assert_int_equal(g_msg->len, 4096);
+    assert_int_equal(strncmp(post->hdr, "GET /aaaa", 9), 0);
+    assert_string_equal(&post->hdr[hdrlen - 4], "aa\r\n");
+    freeMsg(&g_msg);
+
+    assert_int_equal(dbgCountMatchingLines("src/httpstate.c"), 0);
+}
+
+static void
+doHttpWithChunkedResponse(void** state)
+{
+    char *buffers[] = {
+        "HTTP/1.1 200 OK\r\n"
+        "Transfer-Encoding: chunked\r\n"
+        "\r\n"
+        "5\r\nHTTP/",                       // looks like a header, isn't
+        "\r\n1",                            // chunk-size split across buffers
+        "a;ext=1\r\n",
+        "HTTP/1.1 404 Not Found\r\n\r\n\r\n", // 26 bytes of chunk data
+        "0\r\nTrailer: x\r\n\r\n",
+        "GET / HTTP/1.1\r\n\r\n",
+        NULL };
+    net_info net = {0};
+    net.type = SOCK_STREAM;
+    int i;
+    freeMsg(&g_msg);
+
+    for (i=0; buffers[i]; i++) {
+        size_t buflen = strlen(buffers[i]);
+        bool returnValue = doHttp(13, 3, &net, (void*)buffers[i], buflen, NETRX, BUF);
+        assert_int_equal(returnValue, (i == 0) || (i == 5));
+        if (i == 4) {
+            // The header was held until the body ended
+            assert_non_null(g_msg);
+            struct http_post_t *post = (struct http_post_t*) g_msg->data;
+            assert_string_equal(post->hdr, "HTTP/1.1 200 OK\r\nTransfer-Encoding: chunked\r\n");
+            assert_int_equal(post->clen, 5 + 26);
+            freeMsg(&g_msg);
+        } else if (i == 5) {
+            assert_non_null(g_msg);
+            struct http_post_t *post = (struct http_post_t*) g_msg->data;
+            assert_string_equal(post->hdr, "GET / HTTP/1.1\r\n");
+            assert_int_equal(post->clen, -1);
+            freeMsg(&g_msg);
+        } else {
+            assert_null(g_msg);
+        }
     }
+    assert_int_equal(net.http.state, HTTP_NONE);
+}
+
+static void
+doHttpWithChunkedRequest(void** state)
+{
+    char *request =
+        "POST / HTTP/1.1\r\n"
+        "transfer-encoding: gzip, Chunked \r\n"
+        "\r\n"
+        "10\r\n";
+    char *body = "GET / HTTP/1.1\r\n";
+    char *response = "HTTP/1.1 204 No Content\r\n\r\n";
+
+    net_info net = {0};
+    net.type = SOCK_STREAM;
+
+    // A request is reported right away
+    assert_true(doHttp(13, 3, &net, request, strlen(request), NETRX, BUF));
+    assert_non_null(g_msg);
+    struct http_post_t *post = (struct http_post_t*) g_msg->data;
+    assert_string_equal(post->hdr, "POST / HTTP/1.1\r\ntransfer-encoding: gzip, Chunked \r\n");
+    assert_int_equal(post->clen, -1);
+    freeMsg(&g_msg);
+
+    // and its body is skipped
+    assert_false(doHttp(13, 3, &net, body, strlen(body), NETRX, BUF));
+    assert_null(g_msg);
+    assert_int_equal(net.http.state, HTTP_CHUNKED);
+
+    // Until the other side answers
+    assert_true(doHttp(13, 3, &net, response, strlen(response), NETTX, BUF));
+    assert_non_null(g_msg);
+    post = (struct http_post_t*) g_msg->data;
+    assert_string_equal(post->hdr, "HTTP/1.1 204 No Content\r\n");
+    freeMsg(&g_msg);
+}
+
+static void
+doHttpWithBrokenChunkedBody(void** state)
+{
+    char *response =
+        "HTTP/1.1 200 OK\r\n"
+        "Transfer-Encoding: chunked\r\n"
+        "\r\n";
+    char *garbage = "not a chunk size\r\n";
 
-    // buffers[2] takes us 3 bytes past the max (4*4096) limit.
-    assert_false(doHttp(13, 3, &net, (void*)buffers[2], strlen(buffers[2]), NETRX, BUF));
+    net_info net = {0};
+    net.type = SOCK_STREAM;
 
-    // exceeding the limit leaves a breadcrumb in dbg.
-    assert_int_equal(dbgCountMatchingLines("src/httpstate.c"), 1);
-    dbgInit(); // reset dbg for the rest of the tests
+    assert_true(doHttp(13, 3, &net, response, strlen(response), NETRX, BUF));
+    assert_null(g_msg);
 
+    // The held header is reported without a length
+    assert_false(doHttp(13, 3, &net, garbage, strlen(garbage), NETRX, BUF));
+    assert_non_null(g_msg);
+    struct http_post_t *post = (struct http_post_t*) g_msg->data;
+    assert_string_equal(post->hdr, "HTTP/1.1 200 OK\r\nTransfer-Encoding: chunked\r\n");
+    assert_int_equal(post->clen, -1);
+    freeMsg(&g_msg);
+    assert_int_equal(net.http.state, HTTP_NONE);
+
+    // Same if the connection closes first
+    assert_true(doHttp(13, 3, &net, response, strlen(response), NETRX, BUF));
+    assert_null(g_msg);
+    resetHttp(&net.http);
+    assert_non_null(g_msg);
+    freeMsg(&g_msg);
+    assert_null(net.http.hdr);
+
+    // Or if there's no net to keep state in
+    char *whole =
+        "HTTP/1.1 200 OK\r\n"
+        "Transfer-Encoding: chunked\r\n"
+        "\r\n"
+        "3\r\nabc\r\n";
+    assert_true(doHttp(13, 3, NULL, whole, strlen(whole), NETRX, BUF));
+    assert_non_null(g_msg);
+    post = (struct http_post_t*) g_msg->data;
+    assert_int_equal(post->clen, -1);
+    freeMsg(&g_msg);
+}
+
+static void
+doHttpWithPipelinedRequests(void** state)
+{
+    char *buffer =
+        "POST /a HTTP/1.1\r\n"
+        "Content-Length: 5\r\n"
+        "\r\n"
+        "HTTP/"                             // the body; not a header
+        "GET /b HTTP/1.1\r\n"
+        "\r\n"
+        "GET /c HTTP/1.1\r\n"
+        "Content-Length: 10\r\n"
+        "\r\n"
+        "01234";
+    net_info net = {0};
+    net.type = SOCK_STREAM;
+    freeMsg(&g_msg);
+    g_msg_count = 0;
+
+    // Every header in the buffer is reported, in order
+    assert_true(doHttp(13, 3, &net, buffer, strlen(buffer), NETRX, BUF));
+    assert_int_equal(g_msg_count, 3);
+    assert_non_null(g_msg);
+    struct http_post_t *post = (struct http_post_t*) g_msg->data;
+    assert_string_equal(post->hdr, "GET /c HTTP/1.1\r\nContent-Length: 10\r\n");
+    freeMsg(&g_msg);
+
+    // and the last one's body is still skipped
+    assert_int_equal(net.http.state, HTTP_DATA);
+    assert_false(doHttp(13, 3, &net, "HTTP/", 5, NETRX, BUF));
+    assert_int_equal(g_msg_count, 3);
 }
 
+// Appends an http/2 frame to buf; payload is in hex.  Returns the new length.
+static size_t
+addFrame(char *buf, size_t len, int type, int flags, int stream, const char *payload)
+{
+    size_t plen = strlen(payload) / 2;
+    char *frame = &buf[len];
+    frame[0] = 0;
+    frame[1] = plen >> 8;
+    frame[2] = plen;
+    frame[3] = type;
+    frame[4] = flags;
+    frame[5] = stream >> 24;
+    frame[6] = stream >> 16;
+    frame[7] = stream >> 8;
+    frame[8] = stream;
+    size_t i;
+    for (i = 0; i < plen; i++) {
+        unsigned int byte;
+        sscanf(&payload[i * 2], "%2x", &byte);
+        frame[9 + i] = byte;
+    }
+    return len + 9 + plen;
+}
+
+#define H2_PREFACE "PRI * HTTP/2.0\r\n\r\nSM\r\n\r\n"
+
+static void
+doHttpWithHttp2(void** state)
+{
+    char buf[512];
+    size_t len;
+    struct http_post_t *post;
+    net_info net = {0};
+    net.type = SOCK_STREAM;
+
+    // Every field is kept, so that the whole block can be checked
+    setHttpHeaderCapture(TRUE);
+
+    // The client preface, SETTINGS, and a request (RFC 7541 C.4.1)
+    strcpy(buf, H2_PREFACE);
+    len = addFrame(buf, strlen(buf), 0x4, 0x0, 0, "");
+    len = addFrame(buf, len, 0x1, 0x5, 1, "828684418cf1e3c2e5f23a6ba0ab90f4ff");
+    assert_true(doHttp(13, 3, &net, buf, len, NETTX, BUF));
+    assert_int_equal(net.http.state, HTTP_2);
+    assert_non_null(g_msg);
+    assert_int_equal(g_msg->ptype, EVT_HREQ);
+    post = (struct http_post_t*) g_msg->data;
+    assert_string_equal(post->hdr, "GET / HTTP/2\r\nhost: www.example.com\r\n");
+    assert_int_equal(g_msg->len, strlen(post->hdr) + 1);
+    assert_int_equal(post->stream, 1);
+    freeMsg(&g_msg);
+
+    // SETTINGS and a response (RFC 7541 C.6.1), split mid frame header
+    len = addFrame(buf, 0, 0x4, 0x0, 0, "000300000064");
+    len = addFrame(buf, len, 0x1, 0x4, 1,
+        "488264025885aec3771a4b6196d07abe941054d444a8200595040b8166e082a62d1bff"
+        "6e919d29ad171863c78f0b97c8e9ae82ae43d3");
+    assert_false(doHttp(13, 3, &net, buf, 20, NETRX, BUF));
+    assert_null(g_msg);
+    assert_true(doHttp(13, 3, &net, &buf[20], len - 20, NETRX, BUF));
+    assert_non_null(g_msg);
+    assert_int_equal(g_msg->ptype, EVT_HRES);
+    assert_false(g_msg->isServer);
+    post = (struct http_post_t*) g_msg->data;
+    assert_string_equal(post->hdr, "HTTP/2 302\r\ncache-control: private\r\n"
+        "date: Mon, 21 Oct 2013 20:13:21 GMT\r\nlocation: https://www.example.com\r\n");
+    assert_int_equal(post->stream, 1);
+    freeMsg(&g_msg);
+
+    // DATA isn't looked at.  A padded, prioritized HEADERS and a
+    // CONTINUATION make up the next request (RFC 7541 C.4.2), which uses
+    // the table the first one left.
+    len = addFrame(buf, 0, 0x0, 0x0, 1, "485454502f312e3120323030204f4b0d0a0d0a");
+    len = addFrame(buf, len, 0x1, 0x28, 3, "02" "0000000010" "828684" "0000");
+    len = addFrame(buf, len, 0x9, 0x4, 3, "be5886a8eb10649cbf");
+    assert_true(doHttp(13, 3, &net, buf, len, NETTX, BUF));
+    assert_non_null(g_msg);
+    post = (struct http_post_t*) g_msg->data;
+    assert_string_equal(post->hdr,
+        "GET / HTTP/2\r\nhost: www.example.com\r\ncache-control: no-cache\r\n");
+    assert_int_equal(post->stream, 3);
+    freeMsg(&g_msg);
+
+    // Trailers and interim responses aren't reported
+    len = addFrame(buf, 0, 0x1, 0x5, 1, "0003666f6f03626172");
+    len = addFrame(buf, len, 0x1, 0x4, 3, "0803313030");
+    assert_false(doHttp(13, 3, &net, buf, len, NETRX, BUF));
+    assert_null(g_msg);
+
+    // A CONTINUATION out of nowhere loses track of what's received,
+    // but not of what's sent
+    len = addFrame(buf, 0, 0x9, 0x4, 3, "88");
+    len = addFrame(buf, len, 0x1, 0x4, 3, "88");
+    assert_false(doHttp(13, 3, &net, buf, len, NETRX, BUF));
+    assert_null(g_msg);
+    len = addFrame(buf, 0, 0x1, 0x5, 5, "828684be");
+    assert_true(doHttp(13, 3, &net, buf, len, NETTX, BUF));
+    assert_non_null(g_msg);
+    post = (struct http_post_t*) g_msg->data;
+    assert_string_equal(post->hdr, "GET / HTTP/2\r\ncache-control: no-cache\r\n");
+    freeMsg(&g_msg);
+
+    // A first line that doesn't fit is cut short, and the fields after it
+    // are dropped.  The path is a literal of 4090 bytes, "/aaa...".
+    char *hex = malloc(2 * 4200);
+    char *big = malloc(4200);
+    assert_non_null(hex);
+    assert_non_null(big);
+    strcpy(hex, "82" "047ffb1e2f");
+    int i;
+    for (i = 0; i < 4089; i++) strcat(&hex[10 + i * 2], "61");
+    strcat(hex, "5886a8eb10649cbf");
+    len = addFrame(big, 0, 0x1, 0x5, 7, hex);
+    assert_true(doHttp(13, 3, &net, big, len, NETTX, BUF));
+    assert_non_null(g_msg);
+    post = (struct http_post_t*) g_msg->data;
+    assert_int_equal(strlen(post->hdr), 4095);
+    assert_memory_equal(post->hdr, "GET /aaaa", 9);
+    assert_string_equal(&post->hdr[4089], "aaaa\r\n");
+    freeMsg(&g_msg);
+    free(hex);
+    free(big);
+
+    // This acts like a virtual doClose()
+    resetHttp(&net.http);
+    assert_int_equal(net.http.state, HTTP_NONE);
+    assert_null(net.http.h2);
+    setHttpHeaderCapture(FALSE);
+}
 
 int
 main(int argc, char* argv[])
@@ -306,8 +619,13 @@ main(int argc, char* argv[])
         cmocka_unit_test(doHttpWithConsecutiveHeaders),
         cmocka_unit_test(doHttpWithSplitHeader),
         cmocka_unit_test(doHttpWithInterleavedEncryption),
-        cmocka_unit_test(doHttpWhichRequiresRealloc),
-        cmocka_unit_test(doHttpWhichExceedsReallocSize),
+        cmocka_unit_test(doHttpWithLongHeader),
+        cmocka_unit_test(doHttpWithLongStartLine),
+        cmocka_unit_test(doHttpWithChunkedResponse),
+        cmocka_unit_test(doHttpWithChunkedRequest),
+        cmocka_unit_test(doHttpWithBrokenChunkedBody),
+        cmocka_unit_test(doHttpWithPipelinedRequests),
+        cmocka_unit_test(doHttpWithHttp2),
         cmocka_unit_test(dbgHasNoUnexpectedFailures),
     };
     return cmocka_run_group_tests(tests, needleTestSetup, groupTeardown);
@@ -0,0 +1,287 @@
+#define _GNU_SOURCE
+#include <float.h>
+#include <limits.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "cJSON.h"
+#include "dbg.h"
+#include "jsonbuf.h"
+#include "test.h"
+
+// Writes json with the jsbuf_t and checks that it's what cJSON prints
+static void
+assertMatchesCJson(cJSON *json)
+{
+    jsbuf_t js;
+    jsBufInit(&js, NULL, 0);
+    jsJson(&js, json);
+    assert_false(jsBufErr(&js));
+
+    char *expected = cJSON_PrintUnformatted(json);
+    assert_non_null(expected);
+    assert_string_equal(js.data, expected);
+    assert_int_equal(js.len, strlen(expected));
+
+    free(expected);
+    jsBufFree(&js);
+}
+
+static void
+jsNumMatchesCJson(void** state)
+{
+    double nums[] = {0, -0.0, 1, -1, 42, 1.25, -3.5, 0.1, 1.0/3, 2.0/3,
+                     1609459200.123, 1609459200.1234567, 123456789012345,
+                     999999999999999, 1000000000000000, 1e21, -1e21, 1e-7,
+                     5e-324, DBL_MAX, -DBL_MAX, DBL_MIN, 4294967296.5,
+                     NAN, INFINITY, -INFINITY};
+
+    int i;
+    for (i = 0; i < sizeof(nums)/sizeof(nums[0]); i++) {
+        cJSON *json = cJSON_CreateNumber(nums[i]);
+        assertMatchesCJson(json);
+        cJSON_Delete(json);
+    }
+
+    // jsInt() formats the way a double would be
+    long long ints[] = {0, 1, -1, 987654321, -987654321, 999999999999999,
+                        1000000000000000, -1000000000000001, LLONG_MAX,
+                        LLONG_MIN};
+    for (i = 0; i < sizeof(ints)/sizeof(ints[0]); i++) {
+        cJSON *json = cJSON_CreateNumber(ints[i]);
+        char *expected = cJSON_PrintUnformatted(json);
+
+        jsbuf_t js;
+        jsBufInit(&js, NULL, 0);
+        jsInt(&js, ints[i]);
+        assert_string_equal(js.data, expected);
+
+        jsBufFree(&js);
+        free(expected);
+        cJSON_Delete(json);
+    }
+}
+
+static void
+jsStrEscapesLikeCJson(void** state)
+{
+    const char *strs[] = {"", "plain", "quote\"d", "back\\slash",
+                          "\b\f\n\r\t", "\x01\x1f\x7f", "/slash/",
+                          "utf8 \xc3\xa9\xe2\x82\xac", "trailing\n"};
+
+    int i;
+    for (i = 0; i < sizeof(strs)/sizeof(strs[0]); i++) {
+        cJSON *json = cJSON_CreateObject();
+        cJSON_AddStringToObject(json, strs[i], strs[i]);
+        assertMatchesCJson(json);
+        cJSON_Delete(json);
+    }
+
+    // Embedded nuls are escaped when a length is given
+    jsbuf_t js;
+    jsBufInit(&js, NULL, 0);
+    jsStrLen(&js, "a\0b", 3);
+    assert_string_equal(js.data, "\"a\\u0000b\"");
+    jsBufFree(&js);
+}
+
+static void
+jsJsonMatchesCJson(void** state)
+{
+    const char *text =
+        "{\"type\":\"evt\",\"body\":{\"a\":[1,2.5,\"three\",[],{}],"
+        "\"b\":{\"c\":null,\"d\":true,\"e\":false},\"f\":\"tab\\there\","
+        "\"g\":[[[-1]]],\"h\":{\"i\":{\"j\":\"k\"}}}}";
+    cJSON *json = cJSON_Parse(text);
+    assert_non_null(json);
+    assertMatchesCJson(json);
+
+    // raw items are written as they are
+    cJSON_AddRawToObject(json, "raw", "{\"x\":1}");
+    cJSON_AddItemToArray(cJSON_GetObjectItem(json, "body"), cJSON_CreateRaw("7"));
+    assertMatchesCJson(json);
+    cJSON_Delete(json);
+
+    // as are arrays and top level values
+    json = cJSON_CreateArray();
+    assertMatchesCJson(json);
+    cJSON_AddItemToArray(json, cJSON_CreateString("x"));
+    cJSON_AddItemToArray(json, cJSON_CreateNull());
+    assertMatchesCJson(json);
+    cJSON_Delete(json);
+}
+
+static void
+jsCommasAndNesting(void** state)
+{
+    char storage[8];
+    jsbuf_t js;
+    jsBufInit(&js, storage, sizeof(storage));
+
+    jsObjStart(&js);
+    jsKey(&js, "a");
+    jsArrStart(&js);
+    jsInt(&js, 1);
+    jsObjStart(&js);
+    jsObjEnd(&js);
+    jsArrStart(&js);
+    jsArrEnd(&js);
+    jsNull(&js);
+    jsArrEnd(&js);
+    jsKey(&js, "b");
+    jsBool(&js, TRUE);
+    jsKey(&js, NULL);
+    jsRaw(&js, "[]");
+    jsObjEnd(&js);
+    jsNewline(&js);
+    jsObjStart(&js);
+    jsObjEnd(&js);
+
+    assert_false(jsBufErr(&js));
+    assert_string_equal(js.data, "{\"a\":[1,{},[],null],\"b\":true,\"\":[]}\n{}");
+
+    // outgrew the storage
+    assert_true(js.heap);
+    assert_ptr_not_equal(js.data, storage);
+    jsBufFree(&js);
+}
+
+static void
+jsMembersSplicesIntoObject(void** state)
+{
+    const char *members = "\"b\":2,\"c\":[3]";
+    jsbuf_t js;
+    jsBufInit(&js, NULL, 0);
+
+    jsObjStart(&js);
+    jsMembers(&js, members, strlen(members));
+    jsKey(&js, "d");
+    jsInt(&js, 4);
+    jsMembers(&js, "", 0);
+    jsObjEnd(&js);
+    jsObjStart(&js);
+    jsKey(&js, "a");
+    jsInt(&js, 1);
+    jsMembers(&js, members, strlen(members));
+    jsObjEnd(&js);
+    assert_false(jsBufErr(&js));
+    assert_string_equal(js.data, "{\"b\":2,\"c\":[3],\"d\":4},"
+                                 "{\"a\":1,\"b\":2,\"c\":[3]}");
+
+    jsMembers(&js, NULL, 0);
+    assert_true(jsBufErr(&js));
+    jsBufFree(&js);
+}
+
+static void
+jsBufStorageAndDetach(void** state)
+{
+    char storage[64];
+    jsbuf_t js;
+    jsBufInit(&js, storage, sizeof(storage));
+
+    jsStr(&js, "short");
+    assert_ptr_equal(js.data, storage);
+    assert_false(js.heap);
+
+    // detach copies out of caller storage
+    size_t len;
+    char *data = jsBufDetach(&js, &len);
+    assert_non_null(data);
+    assert_ptr_not_equal(data, storage);
+    assert_string_equal(data, "\"short\"");
+    assert_int_equal(len, 7);
+    free(data);
+    assert_null(js.data);
+
+    // reset keeps the storage for reuse
+    jsBufInit(&js, storage, sizeof(storage));
+    jsStr(&js, "one");
+    jsBufReset(&js);
+    jsStr(&js, "two");
+    assert_string_equal(js.data, "\"two\"");
+    assert_ptr_equal(js.data, storage);
+
+    // a big value moves to the heap; detach hands that over as is
+    char big[1000];
+    memset(big, 'x', sizeof(big) - 1);
+    big[sizeof(big) - 1] = '\0';
+    jsBufReset(&js);
+    jsStr(&js, big);
+    assert_true(js.heap);
+    char *heap = js.data;
+    data = jsBufDetach(&js, &len);
+    assert_ptr_equal(data, heap);
+    assert_int_equal(len, sizeof(big) + 1);
+    free(data);
+}
+
+static void
+jsErrorsAreSticky(void** state)
+{
+    jsbuf_t js;
+    jsBufInit(&js, NULL, 0);
+
+    jsObjStart(&js);
+    jsKey(&js, "a");
+    jsStr(&js, NULL);
+    assert_true(jsBufErr(&js));
+    jsKey(&js, "b");
+    jsInt(&js, 1);
+    jsObjEnd(&js);
+    assert_true(jsBufErr(&js));
+    assert_string_equal(js.data, "{\"a\":");
+
+    // nothing to detach after an error
+    size_t len = 1;
+    assert_null(jsBufDetach(&js, &len));
+    assert_int_equal(len, 0);
+
+    // items that cJSON refuses to print are errors too
+    cJSON *raw = cJSON_CreateRaw("1");
+    free(raw->valuestring);
+    raw->valuestring = NULL;
+    jsJson(&js, raw);
+    assert_true(jsBufErr(&js));
+    cJSON_Delete(raw);
+    jsBufFree(&js);
+}
+
+static void
+jsNullBufDoesNothing(void** state)
+{
+    jsBufInit(NULL, NULL, 0);
+    jsObjStart(NULL);
+    jsKey(NULL, "a");
+    jsStr(NULL, "b");
+    jsStr(NULL, NULL);
+    jsNum(NULL, 1.5);
+    jsJson(NULL, NULL);
+    jsObjEnd(NULL);
+    jsNewline(NULL);
+    assert_true(jsBufErr(NULL));
+    assert_null(jsBufDetach(NULL, NULL));
+    jsBufReset(NULL);
+    jsBufFree(NULL);
+}
+
+int
+main(int argc, char* argv[])
+{
+    printf("running %s\n", argv[0]);
+
+    const struct CMUnitTest tests[] = {
+        cmocka_unit_test(jsNumMatchesCJson),
+        cmocka_unit_test(jsStrEscapesLikeCJson),
+        cmocka_unit_test(jsJsonMatchesCJson),
+        cmocka_unit_test(jsCommasAndNesting),
+        cmocka_unit_test(jsMembersSplicesIntoObject),
+        cmocka_unit_test(jsBufStorageAndDetach),
+        cmocka_unit_test(jsErrorsAreSticky),
+        cmocka_unit_test(jsNullBufDoesNothing),
+        cmocka_unit_test(dbgHasNoUnexpectedFailures),
+    };
+    return cmocka_run_group_tests(tests, groupSetup, groupTeardown);
+}
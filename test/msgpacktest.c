@@ -0,0 +1,213 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "cJSON.h"
+#include "dbg.h"
+#include "fn.h"
+#include "msgpack.h"
+#include "test.h"
+
+static int
+msgpackTestSetup(void** state)
+{
+    initFn();
+
+    // Call the general groupSetup() too.
+    return groupSetup(state);
+}
+
+#define assert_bytes(mp, ...)                                              \
+    do {                                                                   \
+        const unsigned char expected[] = {__VA_ARGS__};                    \
+        assert_int_equal((mp)->len, sizeof(expected));                     \
+        assert_memory_equal((mp)->data, expected, sizeof(expected));       \
+    } while (0)
+
+static void
+mpIntEncodesSmallestForm(void** state)
+{
+    mpbuf_t mp;
+    mpBufInit(&mp);
+
+    mpInt(&mp, 0);
+    assert_bytes(&mp, 0x00);
+    mpBufReset(&mp);
+
+    mpInt(&mp, 127);
+    assert_bytes(&mp, 0x7f);
+    mpBufReset(&mp);
+
+    mpInt(&mp, -1);
+    assert_bytes(&mp, 0xff);
+    mpBufReset(&mp);
+
+    mpInt(&mp, -33);
+    assert_bytes(&mp, 0xd0, 0xdf);
+    mpBufReset(&mp);
+
+    mpInt(&mp, 200);
+    assert_bytes(&mp, 0xcc, 0xc8);
+    mpBufReset(&mp);
+
+    mpInt(&mp, 65535);
+    assert_bytes(&mp, 0xcd, 0xff, 0xff);
+    mpBufReset(&mp);
+
+    mpInt(&mp, -40000);
+    assert_bytes(&mp, 0xd2, 0xff, 0xff, 0x63, 0xc0);
+    mpBufReset(&mp);
+
+    mpUint(&mp, 0x100000000ULL);
+    assert_bytes(&mp, 0xcf, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x00);
+    mpBufReset(&mp);
+
+    mpDouble(&mp, 1.5);
+    assert_bytes(&mp, 0xcb, 0x3f, 0xf8, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00);
+
+    assert_false(mpBufErr(&mp));
+    mpBufFree(&mp);
+}
+
+static void
+mpStrEncodesLengthAndNil(void** state)
+{
+    mpbuf_t mp;
+    mpBufInit(&mp);
+
+    mpStr(&mp, "hey");
+    assert_bytes(&mp, 0xa3, 'h', 'e', 'y');
+    mpBufReset(&mp);
+
+    mpStr(&mp, NULL);
+    assert_bytes(&mp, 0xc0);
+    mpBufReset(&mp);
+
+    char big[300];
+    memset(big, 'x', sizeof(big));
+    mpStrLen(&mp, big, sizeof(big));
+    assert_int_equal(mp.len, 3 + sizeof(big));
+    assert_int_equal((unsigned char)mp.data[0], 0xda);
+    assert_int_equal((unsigned char)mp.data[1], 0x01);
+    assert_int_equal((unsigned char)mp.data[2], 0x2c);
+
+    mpBufFree(&mp);
+}
+
+static void
+mpMapStartEndPatchesCount(void** state)
+{
+    mpbuf_t mp;
+    mpBufInit(&mp);
+
+    size_t map = mpMapStart(&mp);
+    mpStr(&mp, "a");
+    mpInt(&mp, 1);
+    mpStr(&mp, "b");
+    mpBool(&mp, TRUE);
+    mpMapEnd(&mp, map, 2);
+
+    cJSON *json = msgpackToJson(mp.data, mp.len);
+    assert_non_null(json);
+    char *str = cJSON_PrintUnformatted(json);
+    assert_string_equal(str, "{\"a\":1,\"b\":true}");
+    free(str);
+    cJSON_Delete(json);
+
+    mpBufFree(&mp);
+}
+
+static void
+mpMsgFramesWithLength(void** state)
+{
+    mpbuf_t mp;
+    mpBufInit(&mp);
+
+    // Two messages back to back, as they'd appear on the wire
+    size_t msg = mpMsgStart(&mp);
+    mpStr(&mp, "first");
+    assert_int_equal(mpMsgEnd(&mp, msg), 0);
+
+    size_t msg2 = mpMsgStart(&mp);
+    mpArray(&mp, 2);
+    mpNil(&mp);
+    mpInt(&mp, 2);
+    assert_int_equal(mpMsgEnd(&mp, msg2), 0);
+
+    assert_int_equal(msg, 0);
+    assert_int_equal(msg2, MP_MSG_HDR_LEN + 6);
+    assert_int_equal(mpMsgLen(mp.data), MP_MSG_HDR_LEN + 6);
+    assert_int_equal(mpMsgLen(&mp.data[msg2]), MP_MSG_HDR_LEN + 3);
+    assert_int_equal(msg2 + mpMsgLen(&mp.data[msg2]), mp.len);
+    assert_memory_equal(mp.data, "\0\0\0\6", 4);
+
+    size_t len;
+    char *data = mpBufDetach(&mp, &len);
+    assert_non_null(data);
+    assert_int_equal(len, msg2 + MP_MSG_HDR_LEN + 3);
+    assert_null(mp.data);
+    assert_int_equal(mp.len, 0);
+    free(data);
+
+    // Without a mpMsgStart there's nothing to end
+    assert_int_equal(mpMsgEnd(&mp, 0), -1);
+    assert_int_equal(mpMsgEnd(NULL, 0), -1);
+}
+
+static void
+mpJsonMatchesJson(void** state)
+{
+    const char *text =
+        "{\"type\":\"evt\",\"body\":{\"_time\":1573058085.991,"
+        "\"pid\":4130,\"neg\":-70000,\"ok\":false,\"none\":null,"
+        "\"list\":[1,\"two\",3.25,[]],\"data\":{}}}";
+
+    cJSON *in = cJSON_Parse(text);
+    assert_non_null(in);
+
+    mpbuf_t mp;
+    mpBufInit(&mp);
+    mpJson(&mp, in);
+    assert_false(mpBufErr(&mp));
+
+    cJSON *out = msgpackToJson(mp.data, mp.len);
+    assert_non_null(out);
+    char *str = cJSON_PrintUnformatted(out);
+    assert_string_equal(str, text);
+    free(str);
+
+    cJSON_Delete(out);
+    cJSON_Delete(in);
+    mpBufFree(&mp);
+}
+
+static void
+mpNullBufDoesNothing(void** state)
+{
+    mpInt(NULL, 1);
+    mpStr(NULL, "x");
+    mpMap(NULL, 1);
+    mpJson(NULL, NULL);
+    mpBufFree(NULL);
+    assert_true(mpBufErr(NULL));
+    assert_null(mpBufDetach(NULL, NULL));
+    assert_int_equal(mpMsgLen(NULL), 0);
+}
+
+int
+main(int argc, char* argv[])
+{
+    printf("running %s\n", argv[0]);
+
+    const struct CMUnitTest tests[] = {
+        cmocka_unit_test(mpIntEncodesSmallestForm),
+        cmocka_unit_test(mpStrEncodesLengthAndNil),
+        cmocka_unit_test(mpMapStartEndPatchesCount),
+        cmocka_unit_test(mpMsgFramesWithLength),
+        cmocka_unit_test(mpJsonMatchesJson),
+        cmocka_unit_test(mpNullBufDoesNothing),
+        cmocka_unit_test(dbgHasNoUnexpectedFailures),
+    };
+    return cmocka_run_group_tests(tests, msgpackTestSetup, groupTeardown);
+}
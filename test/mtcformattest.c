@@ -5,6 +5,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <time.h>
 #include <unistd.h>
 #include "dbg.h"
 #include "mtcformat.h"
@@ -36,6 +37,7 @@ mtcFormatCreateReturnsNullPtrForBadFormat(void** state)
 void
 verifyDefaults(mtc_fmt_t* fmt)
 {
+    assert_int_equal(mtcFormatType(fmt), DEFAULT_MTC_FORMAT);
     assert_string_equal(mtcFormatStatsDPrefix(fmt), DEFAULT_STATSD_PREFIX);
     assert_int_equal(mtcFormatStatsDMaxLen(fmt), DEFAULT_STATSD_MAX_LEN);
     assert_int_equal(mtcFormatVerbosity(fmt), DEFAULT_MTC_VERBOSITY);
@@ -345,10 +347,10 @@ mtcFormatEventForOutputHappyPathFilteredFields(void** state)
     assert_non_null(fmt);
     mtcFormatVerbositySet(fmt, CFG_MAX_VERBOSITY);
 
-    regex_t re;
-    assert_int_equal(regcomp(&re, "^[p]", REG_EXTENDED), 0);
+    filter_t *re = filterCreate("^[p]");
+    assert_non_null(re);
 
-    char* msg = mtcFormatEventForOutput(fmt, &e, &re);
+    char* msg = mtcFormatEventForOutput(fmt, &e, re);
     assert_non_null(msg);
 
 
@@ -360,7 +362,7 @@ mtcFormatEventForOutputHappyPathFilteredFields(void** state)
     assert_string_equal(expected, msg);
     free(msg);
 
-    regfree(&re);
+    filterDestroy(&re);
     mtcFormatDestroy(&fmt);
     assert_null(fmt);
 }
@@ -675,6 +677,93 @@ fmtUrlDecodeToleratesBadData(void** state)
     }
 }
 
+static void
+mtcFormatStatsDToBufWritesInPlace(void** state)
+{
+    event_field_t fields[] = {
+        STRFIELD("proc",   "test",   2,  TRUE),
+        NUMFIELD("pid",    -666,     2,  TRUE),
+        NUMFIELD("fd",     0,        9,  TRUE),
+        FIELDEND
+    };
+    event_t e = INT_EVENT("fs.read", -3, CURRENT, fields);
+    mtc_fmt_t* fmt = mtcFormatCreate(CFG_FMT_STATSD);
+    custom_tag_t t1 = {"tag", "value"};
+    custom_tag_t* tags[] = { &t1, NULL };
+    mtcFormatCustomTagsSet(fmt, tags);
+
+    // Same output as the allocating version
+    char buf[DEFAULT_STATSD_MAX_LEN + 1];
+    const char *expected = "fs.read:-3|g|#tag:value,proc:test,pid:-666\n";
+    assert_int_equal(mtcFormatStatsDToBuf(fmt, &e, NULL, buf, sizeof(buf)), strlen(expected));
+    assert_string_equal(buf, expected);
+    char* msg = mtcFormatEventForOutput(fmt, &e, NULL);
+    assert_string_equal(msg, expected);
+    free(msg);
+
+    // The buffer has to have room for the biggest message allowed
+    assert_int_equal(mtcFormatStatsDToBuf(fmt, &e, NULL, buf, DEFAULT_STATSD_MAX_LEN), -1);
+    mtcFormatStatsDMaxLenSet(fmt, 24);
+    assert_int_equal(mtcFormatStatsDToBuf(fmt, &e, NULL, buf, 25), 24);
+    assert_string_equal(buf, "fs.read:-3|g|#tag:value\n");
+
+    // LLONG_MIN doesn't overflow
+    event_t big = INT_EVENT("A", LLONG_MIN, DELTA, NULL);
+    mtcFormatStatsDMaxLenSet(fmt, DEFAULT_STATSD_MAX_LEN);
+    assert_int_equal(mtcFormatStatsDToBuf(fmt, &big, NULL, buf, sizeof(buf)), 36);
+    assert_string_equal(buf, "A:-9223372036854775808|c|#tag:value\n");
+
+    // Only statsd is written this way
+    mtcFormatDestroy(&fmt);
+    fmt = mtcFormatCreate(CFG_FMT_NDJSON);
+    assert_int_equal(mtcFormatStatsDToBuf(fmt, &e, NULL, buf, sizeof(buf)), -1);
+    assert_int_equal(mtcFormatStatsDToBuf(NULL, &e, NULL, buf, sizeof(buf)), -1);
+    mtcFormatDestroy(&fmt);
+}
+
+// Not a pass/fail test; reports metrics/sec for each statsd formatter
+static void
+mtcFormatStatsDBenchmark(void** state)
+{
+    const int count = 200000;
+    event_field_t fields[] = {
+        STRFIELD("proc",   "evttest",        4,  TRUE),
+        NUMFIELD("pid",    4848,             4,  TRUE),
+        NUMFIELD("fd",     3,                7,  TRUE),
+        STRFIELD("file",   "/var/log/file",  7,  TRUE),
+        STRFIELD("op",     "read",           7,  TRUE),
+        FIELDEND
+    };
+    event_t e = INT_EVENT("fs.read", 4096, HISTOGRAM, fields);
+    mtc_fmt_t* fmt = mtcFormatCreate(CFG_FMT_STATSD);
+    mtcFormatVerbositySet(fmt, CFG_MAX_VERBOSITY);
+
+    struct timespec start, end;
+    int n;
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (n = 0; n < count; n++) {
+        char* msg = mtcFormatEventForOutput(fmt, &e, NULL);
+        assert_non_null(msg);
+        free(msg);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    double alloc = (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
+
+    char buf[DEFAULT_STATSD_MAX_LEN + 1];
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (n = 0; n < count; n++) {
+        assert_true(mtcFormatStatsDToBuf(fmt, &e, NULL, buf, sizeof(buf)) > 0);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    double inplace = (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
+
+    printf("    allocated: %.0f metrics/sec, in place: %.0f metrics/sec\n",
+           count / alloc, count / inplace);
+
+    mtcFormatDestroy(&fmt);
+}
+
 int
 main(int argc, char* argv[])
 {
@@ -703,6 +792,8 @@ main(int argc, char* argv[])
         cmocka_unit_test(mtcFormatEventForOutputVerifyEachStatsDType),
         cmocka_unit_test(mtcFormatEventForOutputOmitsFieldsIfSpaceIsInsufficient),
         cmocka_unit_test(mtcFormatEventForOutputHonorsCardinality),
+        cmocka_unit_test(mtcFormatStatsDToBufWritesInPlace),
+        cmocka_unit_test(mtcFormatStatsDBenchmark),
         cmocka_unit_test(fmtUrlEncodeDecodeRoundTrip),
         cmocka_unit_test(fmtUrlDecodeToleratesBadData),
         cmocka_unit_test(dbgHasNoUnexpectedFailures),
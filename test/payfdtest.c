@@ -0,0 +1,193 @@
+#define _GNU_SOURCE
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "dbg.h"
+#include "fn.h"
+#include "payfd.h"
+#include "scopetypes.h"
+#include "test.h"
+
+#define TEST_DIR "/tmp"
+
+static int
+payFdTestSetup(void** state)
+{
+    initFn();
+
+    // Call the general groupSetup() too.
+    return groupSetup(state);
+}
+
+static void
+testPath(char *path, size_t len, int n)
+{
+    snprintf(path, len, TEST_DIR "/payfdtest_%d_%d", getpid(), n);
+}
+
+static int
+fdIsOpen(int fd)
+{
+    return fcntl(fd, F_GETFD) != -1;
+}
+
+static void
+payFdCreateAndDestroy(void** state)
+{
+    assert_null(payFdCreate(0));
+
+    payfd_t *cache = payFdCreate(4);
+    assert_non_null(cache);
+    assert_int_equal(payFdCount(cache), 0);
+    payFdDestroy(&cache);
+    assert_null(cache);
+
+    // Shouldn't crash
+    payFdDestroy(&cache);
+    payFdDestroy(NULL);
+    assert_int_equal(payFdGet(NULL, 1, PAYFD_IN), -1);
+    assert_int_equal(payFdOpen(NULL, 1, PAYFD_IN, "/tmp/x"), -1);
+    payFdClose(NULL, 1);
+    payFdCloseAll(NULL);
+    payFdValidate(NULL, 1, TEST_DIR);
+    assert_int_equal(payFdCount(NULL), 0);
+}
+
+static void
+payFdOpenIsCachedByUidAndDir(void** state)
+{
+    payfd_t *cache = payFdCreate(4);
+    char in[PATH_MAX], out[PATH_MAX];
+    testPath(in, sizeof(in), 1);
+    testPath(out, sizeof(out), 2);
+
+    assert_int_equal(payFdGet(cache, 7, PAYFD_IN), -1);
+    int infd = payFdOpen(cache, 7, PAYFD_IN, in);
+    assert_true(infd >= DEFAULT_MIN_FD);
+    assert_int_equal(payFdGet(cache, 7, PAYFD_IN), infd);
+
+    // Same uid, other direction is a different entry
+    assert_int_equal(payFdGet(cache, 7, PAYFD_OUT), -1);
+    int outfd = payFdOpen(cache, 7, PAYFD_OUT, out);
+    assert_true(outfd != -1);
+    assert_int_not_equal(outfd, infd);
+    assert_int_equal(payFdCount(cache), 2);
+
+    // Close on exec
+    assert_true(fcntl(infd, F_GETFD) & FD_CLOEXEC);
+
+    // Writes append to the file
+    assert_int_equal(write(infd, "abc", 3), 3);
+    assert_int_equal(write(payFdGet(cache, 7, PAYFD_IN), "def", 3), 3);
+    char buf[16] = {0};
+    int fd = open(in, O_RDONLY);
+    assert_int_equal(read(fd, buf, sizeof(buf)), 6);
+    assert_string_equal(buf, "abcdef");
+    close(fd);
+
+    // Closing the connection closes both directions
+    payFdClose(cache, 7);
+    assert_int_equal(payFdCount(cache), 0);
+    assert_int_equal(payFdGet(cache, 7, PAYFD_IN), -1);
+    assert_int_equal(payFdGet(cache, 7, PAYFD_OUT), -1);
+    assert_false(fdIsOpen(infd));
+    assert_false(fdIsOpen(outfd));
+
+    payFdDestroy(&cache);
+    unlink(in);
+    unlink(out);
+}
+
+static void
+payFdEvictsLeastRecentlyUsed(void** state)
+{
+    payfd_t *cache = payFdCreate(3);
+    char path[PATH_MAX];
+    int fds[4];
+    int i;
+
+    for (i = 0; i < 3; i++) {
+        testPath(path, sizeof(path), i);
+        fds[i] = payFdOpen(cache, i + 1, PAYFD_IN, path);
+        assert_true(fds[i] != -1);
+    }
+    assert_int_equal(payFdCount(cache), 3);
+
+    // Use uid 1, so uid 2 becomes the least recently used
+    assert_int_equal(payFdGet(cache, 1, PAYFD_IN), fds[0]);
+
+    testPath(path, sizeof(path), 3);
+    fds[3] = payFdOpen(cache, 4, PAYFD_IN, path);
+    assert_true(fds[3] != -1);
+    assert_int_equal(payFdCount(cache), 3);
+
+    assert_int_equal(payFdGet(cache, 2, PAYFD_IN), -1);
+    assert_int_not_equal(payFdGet(cache, 1, PAYFD_IN), -1);
+    assert_int_not_equal(payFdGet(cache, 3, PAYFD_IN), -1);
+    assert_int_not_equal(payFdGet(cache, 4, PAYFD_IN), -1);
+
+    payFdDestroy(&cache);
+    for (i = 0; i < 4; i++) {
+        assert_false(fdIsOpen(fds[i]));
+        testPath(path, sizeof(path), i);
+        unlink(path);
+    }
+}
+
+static void
+payFdValidateClosesOnChange(void** state)
+{
+    payfd_t *cache = payFdCreate(4);
+    char path[PATH_MAX];
+    testPath(path, sizeof(path), 0);
+
+    payFdValidate(cache, 100, TEST_DIR);
+    assert_true(payFdOpen(cache, 1, PAYFD_NA, path) != -1);
+
+    // Nothing changed
+    payFdValidate(cache, 100, TEST_DIR);
+    assert_int_equal(payFdCount(cache), 1);
+
+    // A new pid (as after a fork)
+    payFdValidate(cache, 101, TEST_DIR);
+    assert_int_equal(payFdCount(cache), 0);
+
+    // A new directory
+    assert_true(payFdOpen(cache, 1, PAYFD_NA, path) != -1);
+    payFdValidate(cache, 101, "/var/tmp");
+    assert_int_equal(payFdCount(cache), 0);
+
+    payFdDestroy(&cache);
+    unlink(path);
+}
+
+static void
+payFdOpenFailureIsNotCached(void** state)
+{
+    payfd_t *cache = payFdCreate(4);
+
+    assert_int_equal(payFdOpen(cache, 1, PAYFD_IN, "/nonexistent/dir/file"), -1);
+    assert_int_equal(payFdGet(cache, 1, PAYFD_IN), -1);
+    assert_int_equal(payFdCount(cache), 0);
+
+    payFdDestroy(&cache);
+}
+
+int
+main(int argc, char* argv[])
+{
+    printf("running %s\n", argv[0]);
+
+    const struct CMUnitTest tests[] = {
+        cmocka_unit_test(payFdCreateAndDestroy),
+        cmocka_unit_test(payFdOpenIsCachedByUidAndDir),
+        cmocka_unit_test(payFdEvictsLeastRecentlyUsed),
+        cmocka_unit_test(payFdValidateClosesOnChange),
+        cmocka_unit_test(payFdOpenFailureIsNotCached),
+        cmocka_unit_test(dbgHasNoUnexpectedFailures),
+    };
+    return cmocka_run_group_tests(tests, payFdTestSetup, groupTeardown);
+}
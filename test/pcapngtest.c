@@ -0,0 +1,389 @@
+#define _GNU_SOURCE
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "dbg.h"
+#include "fn.h"
+#include "pcapng.h"
+#include "scopetypes.h"
+#include "test.h"
+
+#define TEST_DIR "/tmp/pcapngtest"
+
+#define SECTION_LEN (28 + 20)
+
+static int
+pcapngTestSetup(void** state)
+{
+    initFn();
+    mkdir(TEST_DIR, 0777);
+
+    // Call the general groupSetup() too.
+    return groupSetup(state);
+}
+
+static int
+pcapngTestTeardown(void** state)
+{
+    rmdir(TEST_DIR);
+    return groupTeardown(state);
+}
+
+static void
+testPath(char *path, size_t len, pid_t pid)
+{
+    snprintf(path, len, TEST_DIR "/%d.pcapng", pid);
+}
+
+// Reads the whole file, the caller frees it
+static char *
+readFile(pid_t pid, size_t *len)
+{
+    char path[PATH_MAX];
+    testPath(path, sizeof(path), pid);
+
+    int fd = open(path, O_RDONLY);
+    if (fd == -1) return NULL;
+
+    struct stat sb;
+    fstat(fd, &sb);
+    char *buf = malloc(sb.st_size);
+    *len = read(fd, buf, sb.st_size);
+    close(fd);
+    return buf;
+}
+
+static void
+removeFile(pid_t pid)
+{
+    char path[PATH_MAX];
+    testPath(path, sizeof(path), pid);
+    unlink(path);
+}
+
+static uint32_t
+get32(const char *p)
+{
+    uint32_t val;
+    memcpy(&val, p, sizeof(val));
+    return val;
+}
+
+static uint32_t
+getNet32(const char *p)
+{
+    return ntohl(get32(p));
+}
+
+static uint16_t
+getNet16(const char *p)
+{
+    uint16_t val;
+    memcpy(&val, p, sizeof(val));
+    return ntohs(val);
+}
+
+static void
+ipv4Addr(struct sockaddr_storage *ss, const char *ip, int port)
+{
+    struct sockaddr_in *sin = (struct sockaddr_in *)ss;
+    memset(ss, 0, sizeof(*ss));
+    sin->sin_family = AF_INET;
+    sin->sin_port = htons(port);
+    inet_pton(AF_INET, ip, &sin->sin_addr);
+}
+
+static void
+pcapngCreateAndDestroy(void** state)
+{
+    pcapng_t *pc = pcapngCreate(0);
+    assert_non_null(pc);
+    assert_int_equal(pcapngBuffered(pc), 0);
+    pcapngDestroy(&pc);
+    assert_null(pc);
+
+    // Shouldn't crash
+    pcapngDestroy(&pc);
+    pcapngDestroy(NULL);
+    assert_int_equal(pcapngWrite(NULL, NULL), -1);
+    assert_int_equal(pcapngFlush(NULL), -1);
+    pcapngConnClose(NULL, 1);
+    pcapngValidate(NULL, 1, TEST_DIR);
+    assert_int_equal(pcapngBuffered(NULL), 0);
+}
+
+static void
+pcapngWritesTcpStream(void** state)
+{
+    pid_t pid = 1001;
+    removeFile(pid);
+
+    pcapng_t *pc = pcapngCreate(0);
+    pcapngValidate(pc, pid, TEST_DIR);
+
+    struct sockaddr_storage local, remote;
+    ipv4Addr(&local, "10.0.0.1", 8080);
+    ipv4Addr(&remote, "10.0.0.2", 41000);
+
+    pcapng_pkt_t pkt = {
+        .uid = 5,
+        .sock_type = SOCK_STREAM,
+        .local = &local,
+        .remote = &remote,
+        .dir = PCAPNG_RX,
+        .ts = {.tv_sec = 1600000000, .tv_usec = 123456},
+        .data = "GET / HTTP/1.1\r\n\r\n",
+        .len = 18,
+    };
+    assert_int_equal(pcapngWrite(pc, &pkt), 0);
+
+    pkt.dir = PCAPNG_TX;
+    pkt.data = "HTTP/1.1 200 OK\r\n\r\n";
+    pkt.len = 19;
+    assert_int_equal(pcapngWrite(pc, &pkt), 0);
+
+    // Nothing is written until a flush
+    size_t len;
+    char *buf = readFile(pid, &len);
+    assert_null(buf);
+    assert_true(pcapngBuffered(pc) > 0);
+    assert_int_equal(pcapngFlush(pc), 0);
+    assert_int_equal(pcapngBuffered(pc), 0);
+
+    buf = readFile(pid, &len);
+    assert_non_null(buf);
+
+    // Section header and interface description
+    assert_int_equal(get32(buf), 0x0A0D0D0A);
+    assert_int_equal(get32(buf + 8), 0x1A2B3C4D);
+    assert_int_equal(get32(buf + 28), 1);
+    assert_int_equal(get32(buf + 28 + 8) & 0xffff, 101);
+
+    // First packet: received, so remote -> local
+    char *epb = buf + SECTION_LEN;
+    assert_int_equal(get32(epb), 6);
+    uint32_t blklen = get32(epb + 4);
+    assert_int_equal(blklen % 4, 0);
+    assert_int_equal(get32(epb + blklen - 4), blklen);
+    uint64_t usec = ((uint64_t)get32(epb + 12) << 32) | get32(epb + 16);
+    assert_int_equal(usec, 1600000000123456ULL);
+    assert_int_equal(get32(epb + 20), 20 + 20 + 18);
+
+    char *ip = epb + 28;
+    assert_int_equal((unsigned char)ip[0], 0x45);
+    assert_int_equal(getNet16(ip + 2), 20 + 20 + 18);
+    assert_int_equal(ip[9], IPPROTO_TCP);
+    assert_memory_equal(ip + 12, "\x0a\x00\x00\x02", 4);
+    assert_memory_equal(ip + 16, "\x0a\x00\x00\x01", 4);
+    char *tcp = ip + 20;
+    assert_int_equal(getNet16(tcp), 41000);
+    assert_int_equal(getNet16(tcp + 2), 8080);
+    assert_int_equal(getNet32(tcp + 4), 1);
+    assert_int_equal(getNet32(tcp + 8), 1);
+    assert_memory_equal(tcp + 20, "GET / HTTP/1.1\r\n\r\n", 18);
+
+    // Second packet: sent, acks what was received
+    epb += blklen;
+    assert_int_equal(get32(epb), 6);
+    ip = epb + 28;
+    assert_memory_equal(ip + 12, "\x0a\x00\x00\x01", 4);
+    tcp = ip + 20;
+    assert_int_equal(getNet16(tcp), 8080);
+    assert_int_equal(getNet32(tcp + 4), 1);
+    assert_int_equal(getNet32(tcp + 8), 1 + 18);
+    epb += get32(epb + 4);
+    assert_ptr_equal(epb, buf + len);
+    free(buf);
+
+    // The sequence numbers continue until the connection is closed
+    pkt.len = 4;
+    pkt.data = "more";
+    assert_int_equal(pcapngWrite(pc, &pkt), 0);
+    pcapngConnClose(pc, 5);
+    assert_int_equal(pcapngWrite(pc, &pkt), 0);
+    assert_int_equal(pcapngFlush(pc), 0);
+
+    size_t len2;
+    buf = readFile(pid, &len2);
+    epb = buf + len;
+    assert_int_equal(getNet32(epb + 28 + 20 + 4), 1 + 19);
+    epb += get32(epb + 4);
+    assert_int_equal(getNet32(epb + 28 + 20 + 4), 1);
+    free(buf);
+
+    pcapngDestroy(&pc);
+    removeFile(pid);
+}
+
+static void
+pcapngSplitsLargePayloads(void** state)
+{
+    pid_t pid = 1002;
+    removeFile(pid);
+
+    pcapng_t *pc = pcapngCreate(0);
+    pcapngValidate(pc, pid, TEST_DIR);
+
+    struct sockaddr_storage local, remote;
+    ipv4Addr(&local, "10.0.0.1", 1);
+    ipv4Addr(&remote, "10.0.0.2", 2);
+
+    size_t datalen = 150000;
+    char *data = calloc(1, datalen);
+    pcapng_pkt_t pkt = {
+        .uid = 1,
+        .sock_type = SOCK_STREAM,
+        .local = &local,
+        .remote = &remote,
+        .dir = PCAPNG_TX,
+        .data = data,
+        .len = datalen,
+    };
+    assert_int_equal(pcapngWrite(pc, &pkt), 0);
+    pcapngDestroy(&pc);
+    free(data);
+
+    size_t len;
+    char *buf = readFile(pid, &len);
+    assert_non_null(buf);
+
+    char *epb = buf + SECTION_LEN;
+    size_t total = 0;
+    uint32_t seq = 1;
+    int packets = 0;
+    while (epb < buf + len) {
+        assert_int_equal(get32(epb), 6);
+        size_t seg = get32(epb + 20) - 40;
+        assert_true(seg <= 65000);
+        assert_int_equal(getNet32(epb + 28 + 20 + 4), seq);
+        seq += seg;
+        total += seg;
+        packets++;
+        epb += get32(epb + 4);
+    }
+    assert_int_equal(total, datalen);
+    assert_int_equal(packets, 3);
+    free(buf);
+    removeFile(pid);
+}
+
+static void
+pcapngUdpAndNonIp(void** state)
+{
+    pid_t pid = 1003;
+    removeFile(pid);
+
+    pcapng_t *pc = pcapngCreate(0);
+    pcapngValidate(pc, pid, TEST_DIR);
+
+    struct sockaddr_storage local, remote;
+    ipv4Addr(&local, "10.0.0.1", 5000);
+    ipv4Addr(&remote, "10.0.0.2", 53);
+
+    pcapng_pkt_t pkt = {
+        .uid = 9,
+        .sock_type = SOCK_DGRAM,
+        .local = &local,
+        .remote = &remote,
+        .dir = PCAPNG_TX,
+        .data = "query",
+        .len = 5,
+    };
+    assert_int_equal(pcapngWrite(pc, &pkt), 0);
+
+    // A unix socket
+    struct sockaddr_storage unixaddr = {.ss_family = AF_UNIX};
+    pkt.sock_type = SOCK_STREAM;
+    pkt.local = &unixaddr;
+    pkt.remote = &unixaddr;
+    pkt.dir = PCAPNG_RX;
+    assert_int_equal(pcapngWrite(pc, &pkt), 0);
+    pcapngDestroy(&pc);
+
+    size_t len;
+    char *buf = readFile(pid, &len);
+    assert_non_null(buf);
+
+    char *epb = buf + SECTION_LEN;
+    char *ip = epb + 28;
+    assert_int_equal(ip[9], IPPROTO_UDP);
+    assert_int_equal(getNet16(ip + 20), 5000);
+    assert_int_equal(getNet16(ip + 22), 53);
+    assert_int_equal(getNet16(ip + 24), 8 + 5);
+    assert_memory_equal(ip + 28, "query", 5);
+
+    epb += get32(epb + 4);
+    ip = epb + 28;
+    assert_int_equal(ip[9], IPPROTO_TCP);
+    assert_memory_equal(ip + 12, "\x7f\x00\x00\x02", 4);
+    assert_memory_equal(ip + 16, "\x7f\x00\x00\x01", 4);
+    assert_int_equal(getNet16(ip + 20), 10);
+    free(buf);
+    removeFile(pid);
+}
+
+static void
+pcapngValidateDiscardsAfterFork(void** state)
+{
+    pid_t parent = 1004, child = 1005;
+    removeFile(parent);
+    removeFile(child);
+
+    pcapng_t *pc = pcapngCreate(0);
+    pcapngValidate(pc, parent, TEST_DIR);
+
+    struct sockaddr_storage local, remote;
+    ipv4Addr(&local, "10.0.0.1", 1);
+    ipv4Addr(&remote, "10.0.0.2", 2);
+    pcapng_pkt_t pkt = {
+        .uid = 1,
+        .sock_type = SOCK_STREAM,
+        .local = &local,
+        .remote = &remote,
+        .dir = PCAPNG_TX,
+        .data = "parent",
+        .len = 6,
+    };
+    assert_int_equal(pcapngWrite(pc, &pkt), 0);
+
+    // The buffered packet belongs to the parent, so it's not written
+    pcapngValidate(pc, child, TEST_DIR);
+    assert_int_equal(pcapngBuffered(pc), 0);
+
+    pkt.data = "child!";
+    assert_int_equal(pcapngWrite(pc, &pkt), 0);
+    pcapngDestroy(&pc);
+
+    size_t len;
+    char *buf = readFile(parent, &len);
+    assert_null(buf);
+    buf = readFile(child, &len);
+    assert_non_null(buf);
+    assert_int_equal(len, SECTION_LEN + 32 + 40 + 8);
+    assert_memory_equal(buf + SECTION_LEN + 28 + 40, "child!", 6);
+    free(buf);
+    removeFile(child);
+}
+
+int
+main(int argc, char* argv[])
+{
+    printf("running %s\n", argv[0]);
+
+    const struct CMUnitTest tests[] = {
+        cmocka_unit_test(pcapngCreateAndDestroy),
+        cmocka_unit_test(pcapngWritesTcpStream),
+        cmocka_unit_test(pcapngSplitsLargePayloads),
+        cmocka_unit_test(pcapngUdpAndNonIp),
+        cmocka_unit_test(pcapngValidateDiscardsAfterFork),
+        cmocka_unit_test(dbgHasNoUnexpectedFailures),
+    };
+    return cmocka_run_group_tests(tests, pcapngTestSetup, pcapngTestTeardown);
+}
@@ -0,0 +1,274 @@
+#define _GNU_SOURCE
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <arpa/inet.h>
+
+#include "dbg.h"
+#include "plattime.h"
+#include "runtimecfg.h"
+#include "fn.h"
+#include "ctl.h"
+#include "cfgutils.h"
+#include "state.h"
+#include "state_private.h"
+#include "test.h"
+
+#define MAX_DETECTED 16
+
+// Names of the protocols detected, in the order they were reported
+static char *detected[MAX_DETECTED];
+static int num_detected = 0;
+
+// When set, called once from inside a detection, while the set is walked
+static void (*during_detect)(void) = NULL;
+
+static config_t *test_cfg = NULL;
+static int next_fd = 10;
+
+static int
+protocolTestSetup(void** state)
+{
+    initTime();
+    initFn();
+    initState();
+
+    test_cfg = cfgCreateDefault();
+    cfgEvtFormatSourceEnabledSet(test_cfg, CFG_SRC_METRIC, 1);
+    g_ctl = initCtl(test_cfg);
+
+    // Call the general groupSetup() too.
+    return groupSetup(state);
+}
+
+static int
+protocolTestTeardown(void** state)
+{
+    ctlDestroy(&g_ctl);
+    cfgDestroy(&test_cfg);
+
+    // Call the general groupTeardown() too.
+    return groupTeardown(state);
+}
+
+#ifdef __LINUX__
+int __real_cmdPostEvent(ctl_t *, char *);
+int __wrap_cmdPostEvent(ctl_t *ctl, char *event)
+#endif // __LINUX__
+#ifdef __MACOS__
+int cmdPostEvent(ctl_t *ctl, char *event)
+#endif // __MACOS__
+{
+    protocol_info *proto = (protocol_info *)event;
+
+    // Only detections are of interest here
+    if (proto->evtype != EVT_PROTO) {
+        free(event);
+        return 0;
+    }
+
+    if ((proto->ptype == EVT_DETECT) && (num_detected < MAX_DETECTED)) {
+        detected[num_detected++] = proto->data;
+    } else {
+        free(proto->data);
+    }
+    free(event);
+
+    if (during_detect) {
+        void (*fn)(void) = during_detect;
+        during_detect = NULL;
+        fn();
+    }
+    return 0;
+}
+
+static void
+clearDetected(void)
+{
+    int i;
+    for (i = 0; i < num_detected; i++) {
+        free(detected[i]);
+        detected[i] = NULL;
+    }
+    num_detected = 0;
+}
+
+static bool
+add(const char *name, const char *regex)
+{
+    protocol_def_t *prot = calloc(1, sizeof(protocol_def_t));
+    assert_non_null(prot);
+    prot->protname = strdup(name);
+    prot->regex = strdup(regex);
+
+    request_t req = {.protocol = prot};
+    return addProtocol(&req);
+}
+
+static void
+del(const char *name)
+{
+    protocol_def_t *prot = calloc(1, sizeof(protocol_def_t));
+    assert_non_null(prot);
+    prot->protname = strdup(name);
+
+    request_t req = {.protocol = prot};
+    assert_true(delProtocol(&req));
+}
+
+// Runs detection on a new connection that first sees buf.  The names
+// detected are left in detected[], in order.
+static void
+detect(const char *buf)
+{
+    int fd = next_fd++;
+
+    clearDetected();
+
+    addSock(fd, SOCK_STREAM, AF_INET);
+    struct sockaddr_in sa = {0};
+    sa.sin_family = AF_INET;
+    sa.sin_port = htons(5555);
+    inet_pton(AF_INET, "127.0.0.1", &sa.sin_addr);
+    doSetConnection(fd, (struct sockaddr *)&sa, sizeof(sa), REMOTE);
+
+    doProtocol(1, fd, (void *)buf, strlen(buf), NETRX, BUF);
+    doClose(fd, "close");
+}
+
+static void
+assert_detected(int num, const char **names)
+{
+    int i;
+    assert_int_equal(num_detected, num);
+    for (i = 0; i < num; i++) {
+        assert_string_equal(detected[i], names[i]);
+    }
+}
+
+static void
+protocolDetectFollowsAddAndDel(void** state)
+{
+    // Every definition matches "FOOD", so each one in the set is reported
+    assert_true(add("ONE", "^F"));
+    detect("FOOD");
+    assert_detected(1, (const char *[]){"ONE"});
+
+    assert_true(add("TWO", "^FO"));
+    assert_true(add("THREE", "^FOO"));
+    detect("FOOD");
+    assert_detected(3, (const char *[]){"ONE", "TWO", "THREE"});
+
+    // Deleting keeps the order of those that are left
+    del("TWO");
+    detect("FOOD");
+    assert_detected(2, (const char *[]){"ONE", "THREE"});
+
+    // Adding it back puts it last
+    assert_true(add("TWO", "^FO"));
+    detect("FOOD");
+    assert_detected(3, (const char *[]){"ONE", "THREE", "TWO"});
+
+    del("ONE");
+    detect("FOOD");
+    assert_detected(2, (const char *[]){"THREE", "TWO"});
+
+    // Only those that match are reported
+    detect("FOX");
+    assert_detected(1, (const char *[]){"TWO"});
+
+    // A definition that won't compile isn't added
+    assert_false(add("BAD", "^(F"));
+    detect("FOOD");
+    assert_detected(2, (const char *[]){"THREE", "TWO"});
+
+    del("THREE");
+    del("TWO");
+    detect("FOOD");
+    assert_detected(0, NULL);
+
+    // Deleting what isn't there changes nothing
+    del("NONE");
+    detect("FOOD");
+    assert_detected(0, NULL);
+
+    clearDetected();
+}
+
+static void
+replaceDuringDetect(void)
+{
+    del("OLD1");
+    assert_true(add("NEW", "^F"));
+    del("OLD2");
+}
+
+static void
+protocolChangeDuringDetectKeepsSetBeingWalked(void** state)
+{
+    assert_true(add("OLD1", "^F"));
+    assert_true(add("OLD2", "^FO"));
+
+    // The definitions are deleted while detection is walking them.  They
+    // must not be freed before it's done (which ASAN would catch), so the
+    // walk still reports both of them.
+    during_detect = replaceDuringDetect;
+    detect("FOOD");
+    assert_null(during_detect);
+    assert_detected(2, (const char *[]){"OLD1", "OLD2"});
+
+    // A later walk sees only what was published
+    detect("FOOD");
+    assert_detected(1, (const char *[]){"NEW"});
+
+    // With nothing walking, this change frees what was deferred above
+    assert_true(add("OLD1", "^FOO"));
+    detect("FOOD");
+    assert_detected(2, (const char *[]){"NEW", "OLD1"});
+
+    // And a delete and re-add of the same name mid-walk
+    during_detect = replaceDuringDetect;
+    detect("FOOD");
+    assert_detected(2, (const char *[]){"NEW", "OLD1"});
+    detect("FOOD");
+    assert_detected(2, (const char *[]){"NEW", "NEW"});
+
+    del("NEW");
+    detect("FOOD");
+    assert_detected(0, NULL);
+
+    clearDetected();
+}
+
+static void
+protocolMatchWithMoreCapturesThanFitIsDetected(void** state)
+{
+    // The match data has room for the whole match only, so pcre2 returns
+    // 0 for a match with captures.  That's still a match.
+    assert_true(add("CAPS", "^(F)(O)(O)"));
+    detect("FOOD");
+    assert_detected(1, (const char *[]){"CAPS"});
+
+    detect("FOX");
+    assert_detected(0, NULL);
+
+    del("CAPS");
+    clearDetected();
+}
+
+int
+main(int argc, char *argv[])
+{
+    printf("running %s\n", argv[0]);
+
+    const struct CMUnitTest tests[] = {
+        cmocka_unit_test(protocolDetectFollowsAddAndDel),
+        cmocka_unit_test(protocolChangeDuringDetectKeepsSetBeingWalked),
+        cmocka_unit_test(protocolMatchWithMoreCapturesThanFitIsDetected),
+        cmocka_unit_test(dbgHasNoUnexpectedFailures),
+    };
+    return cmocka_run_group_tests(tests, protocolTestSetup, protocolTestTeardown);
+}
@@ -1549,6 +1549,46 @@ doStatErrNoSummarization(void** state)
     assert_int_equal(eventCalls(NULL), 0);
 }
 
+// The value of the only metric named str
+static long long
+metricValue(const char* str)
+{
+    assert_int_equal(metricCalls(str), 1);
+    return metricValues(str);
+}
+
+static void
+doTotalDurationReportsQuantiles(void** state)
+{
+    clearTestData();
+    setVerbosity(4);
+    doOpen(16, "/the/file/path", FD, "openFunc");
+
+    // Whatever earlier tests left
+    doTotalDuration(TOT_FS_DURATION);
+
+    // 1 to 100 microseconds, recorded in ns
+    int i;
+    for (i = 100; i >= 1; i--) {
+        doUpdateState(FS_DURATION, 16, i * 1000, "readFunc", "/the/file/path");
+    }
+
+    clearTestData();
+    doTotalDuration(TOT_FS_DURATION);
+    assert_in_range(metricValue("fs.duration.p50"), 50 - 50/16, 50 + 50/16);
+    assert_in_range(metricValue("fs.duration.p90"), 90 - 90/16, 90 + 90/16);
+    assert_in_range(metricValue("fs.duration.p99"), 99 - 99/16, 99 + 99/16);
+    assert_int_equal(metricValue("fs.duration.max"), 100);
+
+    // Each is only reported once
+    clearTestData();
+    doTotalDuration(TOT_FS_DURATION);
+    assert_int_equal(metricCalls(NULL), 0);
+
+    doClose(16, "closeFunc");
+    clearTestData();
+}
+
 static void
 doStatErrSummarization(void** state)
 {
@@ -1682,6 +1722,7 @@ main(int argc, char* argv[])
 #endif // __LINUX__
         cmocka_unit_test(doDNSErrNoSummarization),
         cmocka_unit_test(doDNSErrSummarization),
+        cmocka_unit_test(doTotalDurationReportsQuantiles),
         cmocka_unit_test(dbgHasNoUnexpectedFailures),
     };
     int test_errors = cmocka_run_group_tests(tests, countTestSetup, countTestTeardown);
@@ -0,0 +1,407 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "dbg.h"
+#include "fn.h"
+#include "scopetypes.h"
+#include "scrape.h"
+#include "test.h"
+
+#define TEST_DIR "/tmp"
+
+static int
+scrapeTestSetup(void** state)
+{
+    initFn();
+
+    // Call the general groupSetup() too.
+    return groupSetup(state);
+}
+
+static void
+testPath(char *path, size_t len)
+{
+    snprintf(path, len, TEST_DIR "/scrapetest_%d.sock", getpid());
+}
+
+static int g_renders = 0;
+
+static void
+testRender(scrape_out_t *out)
+{
+    const char *labels[] = {"class", "inet_tcp", NULL};
+    scrapeFamily(out, "net_rx_bytes", "counter", "bytes", "Bytes received");
+    scrapeInt(out, "net_rx_bytes", "_total", labels, 1234);
+    g_renders++;
+}
+
+static int
+clientConnect(const char *path)
+{
+    int sock = socket(AF_UNIX, SOCK_STREAM, 0);
+    assert_int_not_equal(sock, -1);
+
+    struct sockaddr_un addr = {.sun_family = AF_UNIX};
+    strncpy(addr.sun_path, path, sizeof(addr.sun_path) - 1);
+    assert_int_equal(connect(sock, (struct sockaddr *)&addr, sizeof(addr)), 0);
+    return sock;
+}
+
+// Sends a request, polls until it's answered, and returns the response
+static char *
+clientRequest(scrape_t *scrape, const char *path, const char *req)
+{
+    int sock = clientConnect(path);
+    assert_int_equal(send(sock, req, strlen(req), 0), strlen(req));
+
+    scrapePoll(scrape, testRender);
+
+    static char resp[4096];
+    size_t len = 0;
+    ssize_t rc;
+    while ((rc = recv(sock, &resp[len], sizeof(resp) - 1 - len, 0)) > 0) {
+        len += rc;
+    }
+    resp[len] = '\0';
+    close(sock);
+    return resp;
+}
+
+static void
+scrapeCreateAcceptsLocalAddressesOnly(void** state)
+{
+    const char *good[] = {
+        "unix:///tmp/scrape.sock",
+        "tcp://127.0.0.1:9190",
+        "tcp://127.0.0.2:9190",
+        "tcp://localhost:9190",
+        "tcp://::1:9190",
+        "tcp://[::1]:9190",
+    };
+    const char *bad[] = {
+        "tcp://10.0.0.1:9190",
+        "tcp://0.0.0.0:9190",
+        "tcp://127.0.0.1",
+        "tcp://127.0.0.1:0",
+        "tcp://127.0.0.1:http",
+        "udp://127.0.0.1:9190",
+        "unix://",
+        "/tmp/scrape.sock",
+        "",
+    };
+
+    int i;
+    for (i = 0; i < sizeof(good) / sizeof(good[0]); i++) {
+        scrape_t *scrape = scrapeCreate(good[i]);
+        assert_non_null(scrape);
+        scrapeDestroy(&scrape);
+        assert_null(scrape);
+    }
+    for (i = 0; i < sizeof(bad) / sizeof(bad[0]); i++) {
+        assert_null(scrapeCreate(bad[i]));
+    }
+    assert_null(scrapeCreate(NULL));
+
+    // Doesn't crash
+    scrapeDestroy(NULL);
+    scrapePoll(NULL, testRender);
+}
+
+static void
+scrapeFormatsFamiliesAndSamples(void** state)
+{
+    scrape_out_t out = {0};
+
+    scrapeFamily(&out, "fs_duration_seconds", "summary", "seconds",
+                 "Time spent\nin \"file\" operations");
+    const char *labels[] = {"file", "C:\\tmp\\\"a\"\nb", "fd", "3", NULL};
+    scrapeInt(&out, "fs_duration_seconds", "_count", labels, 18446744073709551615ULL);
+    scrapeNum(&out, "fs_duration_seconds", "_sum", NULL, 0.25);
+    scrapeFamily(&out, "net_tcp", "gauge", NULL, NULL);
+    scrapeInt(&out, "net_tcp", NULL, NULL, 0);
+    scrapeFamily(&out, NULL, NULL, NULL, NULL);
+
+    const char *expected =
+        "# TYPE fs_duration_seconds summary\n"
+        "# UNIT fs_duration_seconds seconds\n"
+        "# HELP fs_duration_seconds Time spent\\nin \"file\" operations\n"
+        "fs_duration_seconds_count{file=\"C:\\\\tmp\\\\\\\"a\\\"\\nb\",fd=\"3\"} 18446744073709551615\n"
+        "fs_duration_seconds_sum 0.25\n"
+        "# TYPE net_tcp gauge\n"
+        "net_tcp 0\n"
+        "# EOF\n";
+    assert_string_equal(out.data, expected);
+    assert_int_equal(out.len, strlen(expected));
+    assert_false(out.err);
+
+    scrapeOutFree(&out);
+    assert_null(out.data);
+    assert_int_equal(out.len, 0);
+}
+
+static void
+scrapeGrowsItsOutput(void** state)
+{
+    scrape_out_t out = {0};
+
+    char name[32];
+    int i;
+    for (i = 0; i < 1000; i++) {
+        snprintf(name, sizeof(name), "metric_%d", i);
+        scrapeInt(&out, name, "_total", NULL, i);
+    }
+    assert_false(out.err);
+    assert_true(out.size > out.len);
+    assert_int_equal(strlen(out.data), out.len);
+    assert_non_null(strstr(out.data, "metric_0_total 0\n"));
+    assert_non_null(strstr(out.data, "metric_999_total 999\n"));
+
+    scrapeOutFree(&out);
+}
+
+static void
+scrapeAnswersOverUnixSocket(void** state)
+{
+    char path[108];
+    char listen[128];
+    testPath(path, sizeof(path));
+    snprintf(listen, sizeof(listen), "unix://%s", path);
+    unlink(path);
+
+    scrape_t *scrape = scrapeCreate(listen);
+    assert_non_null(scrape);
+
+    // It listens the first time it's polled
+    assert_int_equal(access(path, F_OK), -1);
+    scrapePoll(scrape, testRender);
+    assert_int_equal(access(path, F_OK), 0);
+
+    g_renders = 0;
+    char *resp = clientRequest(scrape, path,
+                 "GET /metrics?name[]=net_rx HTTP/1.1\r\nHost: x\r\n\r\n");
+    assert_int_equal(g_renders, 1);
+    assert_true(resp == strstr(resp, "HTTP/1.1 200 OK\r\n"));
+    assert_non_null(strstr(resp, "Content-Type: application/openmetrics-text; "
+                                 "version=1.0.0; charset=utf-8\r\n"));
+    assert_non_null(strstr(resp, "Connection: close\r\n"));
+    const char *body =
+        "# TYPE net_rx_bytes counter\n"
+        "# UNIT net_rx_bytes bytes\n"
+        "# HELP net_rx_bytes Bytes received\n"
+        "net_rx_bytes_total{class=\"inet_tcp\"} 1234\n"
+        "# EOF\n";
+    char length[64];
+    snprintf(length, sizeof(length), "Content-Length: %zu\r\n", strlen(body));
+    assert_non_null(strstr(resp, length));
+    char *content = strstr(resp, "\r\n\r\n");
+    assert_non_null(content);
+    assert_string_equal(content + 4, body);
+
+    // Anything else isn't rendered
+    resp = clientRequest(scrape, path, "GET /other HTTP/1.1\r\n\r\n");
+    assert_true(resp == strstr(resp, "HTTP/1.1 404 Not Found\r\n"));
+    assert_non_null(strstr(resp, "Content-Length: 0\r\n"));
+    resp = clientRequest(scrape, path, "GET /metricsx HTTP/1.1\r\n\r\n");
+    assert_true(resp == strstr(resp, "HTTP/1.1 404 Not Found\r\n"));
+    resp = clientRequest(scrape, path, "POST /metrics HTTP/1.1\r\n\r\n");
+    assert_true(resp == strstr(resp, "HTTP/1.1 405 Method Not Allowed\r\n"));
+    assert_int_equal(g_renders, 1);
+
+    // HEAD gets the headers only
+    resp = clientRequest(scrape, path, "HEAD /metrics HTTP/1.1\r\n\r\n");
+    assert_true(resp == strstr(resp, "HTTP/1.1 200 OK\r\n"));
+    assert_non_null(strstr(resp, length));
+    assert_string_equal(strstr(resp, "\r\n\r\n"), "\r\n\r\n");
+    assert_int_equal(g_renders, 2);
+
+    scrapeDestroy(&scrape);
+    assert_int_equal(access(path, F_OK), -1);
+}
+
+static void
+scrapeWaitsForWholeRequest(void** state)
+{
+    char path[108];
+    char listen[128];
+    testPath(path, sizeof(path));
+    snprintf(listen, sizeof(listen), "unix://%s", path);
+
+    scrape_t *scrape = scrapeCreate(listen);
+    assert_non_null(scrape);
+    scrapePoll(scrape, testRender);
+
+    g_renders = 0;
+    int sock = clientConnect(path);
+    const char *part1 = "GET /metrics HTTP/1.1\r\n";
+    const char *part2 = "Host: x\r\n\r\n";
+    assert_int_equal(send(sock, part1, strlen(part1), 0), strlen(part1));
+    scrapePoll(scrape, testRender);
+    assert_int_equal(g_renders, 0);
+
+    // Nothing is sent until the request is complete
+    char resp[4096];
+    assert_int_equal(recv(sock, resp, sizeof(resp), MSG_DONTWAIT), -1);
+
+    assert_int_equal(send(sock, part2, strlen(part2), 0), strlen(part2));
+    scrapePoll(scrape, testRender);
+    assert_int_equal(g_renders, 1);
+    assert_true(recv(sock, resp, sizeof(resp), 0) > 0);
+    close(sock);
+
+    scrapeDestroy(&scrape);
+}
+
+static void
+scrapeReplacesStaleUnixSocket(void** state)
+{
+    char path[108];
+    char listen[128];
+    testPath(path, sizeof(path));
+    snprintf(listen, sizeof(listen), "unix://%s", path);
+
+    // Left behind by a process that's gone
+    int stale = socket(AF_UNIX, SOCK_STREAM, 0);
+    struct sockaddr_un addr = {.sun_family = AF_UNIX};
+    strncpy(addr.sun_path, path, sizeof(addr.sun_path) - 1);
+    unlink(path);
+    assert_int_equal(bind(stale, (struct sockaddr *)&addr, sizeof(addr)), 0);
+    close(stale);
+    assert_int_equal(access(path, F_OK), 0);
+
+    scrape_t *scrape = scrapeCreate(listen);
+    scrapePoll(scrape, testRender);
+
+    g_renders = 0;
+    char *resp = clientRequest(scrape, path, "GET /metrics HTTP/1.1\r\n\r\n");
+    assert_true(resp == strstr(resp, "HTTP/1.1 200 OK\r\n"));
+    assert_int_equal(g_renders, 1);
+
+    // But one that's in use is left alone
+    scrape_t *other = scrapeCreate(listen);
+    scrapePoll(other, testRender);
+    resp = clientRequest(scrape, path, "GET /metrics HTTP/1.1\r\n\r\n");
+    assert_true(resp == strstr(resp, "HTTP/1.1 200 OK\r\n"));
+    assert_int_equal(g_renders, 2);
+    scrapeDestroy(&other);
+    assert_int_equal(access(path, F_OK), 0);
+
+    scrapeDestroy(&scrape);
+    assert_int_equal(access(path, F_OK), -1);
+}
+
+// Far more than a unix socket buffers
+static void
+bigRender(scrape_out_t *out)
+{
+    const char *labels[] = {"class", "inet_tcp", NULL};
+    scrapeFamily(out, "net_rx_bytes", "counter", "bytes", "Bytes received");
+    int i;
+    for (i = 0; i < 200000; i++) {
+        scrapeInt(out, "net_rx_bytes", "_total", labels, i);
+    }
+    g_renders++;
+}
+
+static double
+secsSince(struct timespec *start)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (now.tv_sec - start->tv_sec) + (now.tv_nsec - start->tv_nsec) / 1e9;
+}
+
+// Reads what's there without waiting.  Returns the bytes read, or -1 once
+// the connection has been closed.
+static ssize_t
+clientDrain(int sock)
+{
+    char buf[65536];
+    ssize_t total = 0;
+    ssize_t rc;
+    while ((rc = recv(sock, buf, sizeof(buf), MSG_DONTWAIT)) > 0) total += rc;
+    return (rc == 0) ? -1 : total;
+}
+
+static void
+scrapeDoesntWaitForStalledClient(void** state)
+{
+    char path[108];
+    char listen[128];
+    testPath(path, sizeof(path));
+    snprintf(listen, sizeof(listen), "unix://%s", path);
+
+    scrape_t *scrape = scrapeCreate(listen);
+    assert_non_null(scrape);
+    scrapePoll(scrape, bigRender);
+
+    // Asks for metrics, then doesn't read them
+    g_renders = 0;
+    const char *req = "GET /metrics HTTP/1.1\r\n\r\n";
+    int stalled = clientConnect(path);
+    assert_int_equal(send(stalled, req, strlen(req), 0), strlen(req));
+
+    struct timespec start;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    scrapePoll(scrape, bigRender);
+    assert_true(secsSince(&start) < 0.5);
+    assert_int_equal(g_renders, 1);
+
+    // Another client is answered in full meanwhile, over several polls
+    int reader = clientConnect(path);
+    assert_int_equal(send(reader, req, strlen(req), 0), strlen(req));
+    size_t got = 0;
+    ssize_t rc;
+    int polls = 0;
+    while ((rc = clientDrain(reader)) != -1) {
+        got += rc;
+        scrapePoll(scrape, bigRender);
+        polls++;
+        assert_true(secsSince(&start) < 1.5);
+    }
+    close(reader);
+    assert_int_equal(g_renders, 2);
+    assert_true(polls > 1);
+
+    // The one that stalled is dropped once its time is up, without all
+    // of its response
+    size_t stalledgot = 0;
+    while (secsSince(&start) < 2.5) {
+        scrapePoll(scrape, bigRender);
+        usleep(10000);
+    }
+    scrapePoll(scrape, bigRender);
+    int i;
+    for (i = 0; (i < 1000) && ((rc = clientDrain(stalled)) != -1); i++) {
+        stalledgot += rc;
+    }
+    assert_int_equal(rc, -1);
+    assert_true(stalledgot < got);
+    close(stalled);
+    assert_int_equal(g_renders, 2);
+
+    scrapeDestroy(&scrape);
+}
+
+int
+main(int argc, char* argv[])
+{
+    printf("running %s\n", argv[0]);
+
+    const struct CMUnitTest tests[] = {
+        cmocka_unit_test(scrapeCreateAcceptsLocalAddressesOnly),
+        cmocka_unit_test(scrapeFormatsFamiliesAndSamples),
+        cmocka_unit_test(scrapeGrowsItsOutput),
+        cmocka_unit_test(scrapeAnswersOverUnixSocket),
+        cmocka_unit_test(scrapeWaitsForWholeRequest),
+        cmocka_unit_test(scrapeReplacesStaleUnixSocket),
+        cmocka_unit_test(scrapeDoesntWaitForStalledClient),
+        cmocka_unit_test(dbgHasNoUnexpectedFailures),
+    };
+    return cmocka_run_group_tests(tests, scrapeTestSetup, groupTeardown);
+}
@@ -0,0 +1,307 @@
+#define _GNU_SOURCE
+#include <dirent.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "dbg.h"
+#include "fn.h"
+#include "spill.h"
+#include "test.h"
+
+#define SPILL_TEST_DIR "/tmp"
+
+typedef struct {
+    int fail;                  // when set, the send function fails
+    int num;
+    char msgs[64][64];
+} sent_t;
+
+static int
+sendFn(void *ctx, const char *msg, size_t len)
+{
+    sent_t *sent = ctx;
+    if (sent->fail) return -1;
+    if (sent->num >= 64 || len >= sizeof(sent->msgs[0])) return -1;
+
+    memcpy(sent->msgs[sent->num], msg, len);
+    sent->msgs[sent->num][len] = '\0';
+    sent->num++;
+    return 0;
+}
+
+static int
+spillFileCount(void)
+{
+    char prefix[64];
+    snprintf(prefix, sizeof(prefix), "scope_spill_%d.", getpid());
+
+    DIR *d = opendir(SPILL_TEST_DIR);
+    if (!d) return -1;
+
+    int count = 0;
+    struct dirent *ent;
+    while ((ent = readdir(d))) {
+        if (!strncmp(ent->d_name, prefix, strlen(prefix))) count++;
+    }
+    closedir(d);
+    return count;
+}
+
+static int
+spillTestSetup(void** state)
+{
+    initFn();
+
+    // Call the general groupSetup() too.
+    return groupSetup(state);
+}
+
+static void
+spillCreateAndDestroy(void** state)
+{
+    // No directory or size means no spill
+    assert_null(spillCreate(NULL, 1024));
+    assert_null(spillCreate("", 1024));
+    assert_null(spillCreate(SPILL_TEST_DIR, 0));
+
+    spill_t *spill = spillCreate(SPILL_TEST_DIR, 1024);
+    assert_non_null(spill);
+    assert_true(spillEmpty(spill));
+    assert_int_equal(spillBytes(spill), 0);
+
+    spillDestroy(&spill);
+    assert_null(spill);
+
+    // Don't crash
+    spillDestroy(&spill);
+    spillDestroy(NULL);
+}
+
+static void
+spillNullSpillDoesNothing(void** state)
+{
+    sent_t sent = {0};
+    assert_int_equal(spillWrite(NULL, "hey", 3), -1);
+    assert_int_equal(spillReplay(NULL, sendFn, &sent, 10), 0);
+    assert_true(spillEmpty(NULL));
+    assert_int_equal(spillBytes(NULL), 0);
+
+    spill_counters_t ctrs;
+    spillCountersGet(NULL, &ctrs);
+    assert_int_equal(ctrs.spilled, 0);
+    assert_int_equal(ctrs.replayed, 0);
+    assert_int_equal(ctrs.dropped, 0);
+}
+
+static void
+spillWriteThenReplayInOrder(void** state)
+{
+    spill_t *spill = spillCreate(SPILL_TEST_DIR, 64 * 1024);
+    assert_non_null(spill);
+
+    assert_int_equal(spillWrite(spill, "one", 3), 0);
+    assert_int_equal(spillWrite(spill, "two", 3), 0);
+    assert_int_equal(spillWrite(spill, "three", 5), 0);
+    assert_false(spillEmpty(spill));
+    assert_int_equal(spillBytes(spill), 3 * sizeof(uint32_t) + 11);
+    assert_int_equal(spillFileCount(), 1);
+
+    sent_t sent = {0};
+    assert_int_equal(spillReplay(spill, sendFn, &sent, 10), 3);
+    assert_int_equal(sent.num, 3);
+    assert_string_equal(sent.msgs[0], "one");
+    assert_string_equal(sent.msgs[1], "two");
+    assert_string_equal(sent.msgs[2], "three");
+
+    // Segments are removed once they've been replayed
+    assert_true(spillEmpty(spill));
+    assert_int_equal(spillReplay(spill, sendFn, &sent, 10), 0);
+    assert_int_equal(spillFileCount(), 0);
+
+    spill_counters_t ctrs;
+    spillCountersGet(spill, &ctrs);
+    assert_int_equal(ctrs.spilled, 3);
+    assert_int_equal(ctrs.replayed, 3);
+    assert_int_equal(ctrs.dropped, 0);
+
+    // Counters are reset when they're read
+    spillCountersGet(spill, &ctrs);
+    assert_int_equal(ctrs.spilled, 0);
+    assert_int_equal(ctrs.replayed, 0);
+
+    spillDestroy(&spill);
+}
+
+static void
+spillReplayHonorsMaxAndSendFailures(void** state)
+{
+    spill_t *spill = spillCreate(SPILL_TEST_DIR, 64 * 1024);
+    assert_non_null(spill);
+
+    int i;
+    char msg[16];
+    for (i = 0; i < 5; i++) {
+        int len = snprintf(msg, sizeof(msg), "msg%d", i);
+        assert_int_equal(spillWrite(spill, msg, len), 0);
+    }
+
+    sent_t sent = {0};
+    assert_int_equal(spillReplay(spill, sendFn, &sent, 2), 2);
+    assert_false(spillEmpty(spill));
+
+    // A failed send leaves the message in place to retry later
+    sent.fail = TRUE;
+    assert_int_equal(spillReplay(spill, sendFn, &sent, 10), 0);
+    assert_false(spillEmpty(spill));
+
+    // Messages written after a partial replay still come out in order
+    assert_int_equal(spillWrite(spill, "msg5", 4), 0);
+
+    sent.fail = FALSE;
+    assert_int_equal(spillReplay(spill, sendFn, &sent, 10), 4);
+    assert_true(spillEmpty(spill));
+    for (i = 0; i < 6; i++) {
+        snprintf(msg, sizeof(msg), "msg%d", i);
+        assert_string_equal(sent.msgs[i], msg);
+    }
+
+    spillDestroy(&spill);
+}
+
+static void
+spillEvictsOldestWhenFull(void** state)
+{
+    // Each record is 4 + 28 = 32 bytes; segments hold 32 bytes
+    const size_t max = 256;
+    spill_t *spill = spillCreate(SPILL_TEST_DIR, max);
+    assert_non_null(spill);
+
+    int i;
+    char msg[32];
+    for (i = 0; i < 12; i++) {
+        snprintf(msg, sizeof(msg), "message-%020d", i);
+        assert_int_equal(spillWrite(spill, msg, 28), 0);
+        assert_true(spillBytes(spill) <= max);
+    }
+
+    spill_counters_t ctrs;
+    spillCountersGet(spill, &ctrs);
+    assert_int_equal(ctrs.spilled, 12);
+    assert_int_equal(ctrs.dropped, 4);
+
+    // The newest messages survive
+    sent_t sent = {0};
+    assert_int_equal(spillReplay(spill, sendFn, &sent, 64), 8);
+    for (i = 0; i < 8; i++) {
+        snprintf(msg, sizeof(msg), "message-%020d", i + 4);
+        assert_string_equal(sent.msgs[i], msg);
+    }
+
+    // A message that can never fit is dropped
+    char big[300];
+    memset(big, 'x', sizeof(big));
+    assert_int_equal(spillWrite(spill, big, sizeof(big)), -1);
+    spillCountersGet(spill, &ctrs);
+    assert_int_equal(ctrs.dropped, 1);
+
+    spillDestroy(&spill);
+}
+
+static void
+spillDestroyRemovesFiles(void** state)
+{
+    spill_t *spill = spillCreate(SPILL_TEST_DIR, 1024);
+    assert_non_null(spill);
+
+    assert_int_equal(spillWrite(spill, "unsent", 6), 0);
+    assert_int_equal(spillFileCount(), 1);
+
+    spillDestroy(&spill);
+    assert_int_equal(spillFileCount(), 0);
+}
+
+static void
+spillResetAfterFork(void** state)
+{
+    spill_t *spill = spillCreate(SPILL_TEST_DIR, 64 * 1024);
+    assert_non_null(spill);
+    assert_int_equal(spillWrite(spill, "parent", 6), 0);
+
+    pid_t pid = fork();
+    assert_true(pid != -1);
+    if (!pid) {
+        // The child starts with nothing spilled, and its own segments
+        sent_t sent = {0};
+        spillReset(spill);
+        int ok = spillEmpty(spill) && (spillBytes(spill) == 0) &&
+            (spillWrite(spill, "child", 5) == 0) &&
+            (spillFileCount() == 1) &&
+            (spillReplay(spill, sendFn, &sent, 10) == 1) &&
+            !strcmp(sent.msgs[0], "child") &&
+            (spillFileCount() == 0);
+        spillDestroy(&spill);
+        _exit(ok ? 0 : 1);
+    }
+
+    int status;
+    assert_int_equal(waitpid(pid, &status, 0), pid);
+    assert_true(WIFEXITED(status));
+    assert_int_equal(WEXITSTATUS(status), 0);
+
+    // The child didn't write to, or remove, the parent's segment
+    assert_int_equal(spillFileCount(), 1);
+    assert_int_equal(spillBytes(spill), sizeof(uint32_t) + 6);
+    sent_t sent = {0};
+    assert_int_equal(spillReplay(spill, sendFn, &sent, 10), 1);
+    assert_string_equal(sent.msgs[0], "parent");
+
+    spill_counters_t ctrs;
+    spillCountersGet(spill, &ctrs);
+    assert_int_equal(ctrs.dropped, 0);
+
+    spillDestroy(&spill);
+    assert_int_equal(spillFileCount(), 0);
+}
+
+static void
+spillBadDirectoryDrops(void** state)
+{
+    spill_t *spill = spillCreate("/this/dir/does/not/exist", 1024);
+    assert_non_null(spill);
+
+    assert_int_equal(spillWrite(spill, "lost", 4), -1);
+    assert_true(spillEmpty(spill));
+
+    spill_counters_t ctrs;
+    spillCountersGet(spill, &ctrs);
+    assert_int_equal(ctrs.spilled, 0);
+    assert_int_equal(ctrs.dropped, 1);
+
+    spillDestroy(&spill);
+
+    // The failed open is reported by a DBG
+    assert_int_equal(dbgCountMatchingLines("src/spill.c"), 1);
+    dbgInit(); // reset dbg for the rest of the tests
+}
+
+int
+main(int argc, char* argv[])
+{
+    printf("running %s\n", argv[0]);
+
+    const struct CMUnitTest tests[] = {
+        cmocka_unit_test(spillCreateAndDestroy),
+        cmocka_unit_test(spillNullSpillDoesNothing),
+        cmocka_unit_test(spillWriteThenReplayInOrder),
+        cmocka_unit_test(spillReplayHonorsMaxAndSendFailures),
+        cmocka_unit_test(spillEvictsOldestWhenFull),
+        cmocka_unit_test(spillDestroyRemovesFiles),
+        cmocka_unit_test(spillResetAfterFork),
+        cmocka_unit_test(spillBadDirectoryDrops),
+        cmocka_unit_test(dbgHasNoUnexpectedFailures),
+    };
+    return cmocka_run_group_tests(tests, spillTestSetup, groupTeardown);
+}
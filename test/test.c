@@ -1,6 +1,9 @@
+#define _GNU_SOURCE
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 #include <unistd.h>
+#include "cJSON.h"
 #include "dbg.h"
 #include "test.h"
 
@@ -83,3 +86,124 @@ fileEndPosition(const char* path)
     }
     return -1;
 }
+
+static uint64_t
+mpGetBE(const uint8_t** p, const uint8_t* end, int n, int* err)
+{
+    uint64_t val = 0;
+    if (end - *p < n) {
+        *err = 1;
+        return 0;
+    }
+    while (n--) val = (val << 8) | *(*p)++;
+    return val;
+}
+
+static cJSON*
+mpDecode(const uint8_t** p, const uint8_t* end, int* err)
+{
+    if (*p >= end) {
+        *err = 1;
+        return NULL;
+    }
+
+    uint8_t type = *(*p)++;
+    uint64_t n = 0;
+    cJSON* item = NULL;
+
+    if (type <= 0x7f) return cJSON_CreateNumber(type);
+    if (type >= 0xe0) return cJSON_CreateNumber((int8_t)type);
+
+    if ((type & 0xe0) == 0xa0) {
+        n = type & 0x1f;
+        goto str;
+    }
+    if ((type & 0xf0) == 0x90) {
+        n = type & 0x0f;
+        goto array;
+    }
+    if ((type & 0xf0) == 0x80) {
+        n = type & 0x0f;
+        goto map;
+    }
+
+    switch (type) {
+        case 0xc0: return cJSON_CreateNull();
+        case 0xc2: return cJSON_CreateFalse();
+        case 0xc3: return cJSON_CreateTrue();
+        case 0xcc: return cJSON_CreateNumber(mpGetBE(p, end, 1, err));
+        case 0xcd: return cJSON_CreateNumber(mpGetBE(p, end, 2, err));
+        case 0xce: return cJSON_CreateNumber(mpGetBE(p, end, 4, err));
+        case 0xcf: return cJSON_CreateNumber(mpGetBE(p, end, 8, err));
+        case 0xd0: return cJSON_CreateNumber((int8_t)mpGetBE(p, end, 1, err));
+        case 0xd1: return cJSON_CreateNumber((int16_t)mpGetBE(p, end, 2, err));
+        case 0xd2: return cJSON_CreateNumber((int32_t)mpGetBE(p, end, 4, err));
+        case 0xd3: return cJSON_CreateNumber((int64_t)mpGetBE(p, end, 8, err));
+        case 0xcb:
+        {
+            uint64_t bits = mpGetBE(p, end, 8, err);
+            double d;
+            memcpy(&d, &bits, sizeof(d));
+            return cJSON_CreateNumber(d);
+        }
+        case 0xd9: n = mpGetBE(p, end, 1, err); goto str;
+        case 0xda: n = mpGetBE(p, end, 2, err); goto str;
+        case 0xdb: n = mpGetBE(p, end, 4, err); goto str;
+        case 0xdc: n = mpGetBE(p, end, 2, err); goto array;
+        case 0xdd: n = mpGetBE(p, end, 4, err); goto array;
+        case 0xde: n = mpGetBE(p, end, 2, err); goto map;
+        case 0xdf: n = mpGetBE(p, end, 4, err); goto map;
+        default:
+            *err = 1;
+            return NULL;
+    }
+
+str:
+    if (*err || end - *p < n) {
+        *err = 1;
+        return NULL;
+    }
+    {
+        char* str = strndup((const char*)*p, n);
+        item = cJSON_CreateString(str);
+        free(str);
+    }
+    *p += n;
+    return item;
+
+array:
+    item = cJSON_CreateArray();
+    while (!*err && n--) {
+        cJSON_AddItemToArray(item, mpDecode(p, end, err));
+    }
+    return item;
+
+map:
+    item = cJSON_CreateObject();
+    while (!*err && n--) {
+        cJSON* key = mpDecode(p, end, err);
+        cJSON* val = mpDecode(p, end, err);
+        if (!*err && cJSON_IsString(key)) {
+            cJSON_AddItemToObject(item, key->valuestring, val);
+        } else {
+            *err = 1;
+            cJSON_Delete(val);
+        }
+        cJSON_Delete(key);
+    }
+    return item;
+}
+
+cJSON*
+msgpackToJson(const char* buf, size_t len)
+{
+    const uint8_t* p = (const uint8_t*)buf;
+    int err = 0;
+
+    cJSON* json = mpDecode(&p, p + len, &err);
+    if (err || p != (const uint8_t*)buf + len) {
+        cJSON_Delete(json);
+        return NULL;
+    }
+    return json;
+}
@@ -27,6 +27,10 @@ int writeFile(const char* path, const char* text);
 int deleteFile(const char* path);
 long fileEndPosition(const char* path);
 
+// Decodes one msgpack value into a cJSON tree; NULL if it's malformed
+struct cJSON;
+struct cJSON* msgpackToJson(const char* buf, size_t len);
+
 
 
 #endif //__TEST_H__
@@ -5,8 +5,10 @@
 #include <string.h>
 #include <sys/stat.h>
 #include <sys/types.h>
+#include <time.h>
 #include <unistd.h>
 #include "dbg.h"
+#include "lz4s.h"
 #include "transport.h"
 
 #include "test.h"
@@ -391,6 +393,310 @@ transportSendForFileWritesToFileImmediatelyWhenLineBuffered(void** state)
 }
 
 
+static int
+tcpListen(const char *portname)
+{
+    struct addrinfo hints = {0};
+    hints.ai_family=AF_INET;
+    hints.ai_socktype=SOCK_STREAM;
+    hints.ai_flags=AI_PASSIVE;
+    struct addrinfo* res = NULL;
+    if (getaddrinfo("127.0.0.1", portname, &hints, &res)) {
+        fail_msg("Couldn't create address for socket");
+    }
+    int sd = socket(res->ai_family, res->ai_socktype, res->ai_protocol);
+    if (sd == -1) {
+        fail_msg("Couldn't create socket");
+    }
+    int on = 1;
+    setsockopt(sd, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+    if (bind(sd, res->ai_addr, res->ai_addrlen) == -1) {
+        fail_msg("Couldn't bind socket");
+    }
+    freeaddrinfo(res);
+    if (listen(sd, 1) == -1) {
+        fail_msg("Couldn't listen on socket");
+    }
+    return sd;
+}
+
+static void
+transportConnectTcp(transport_t *t)
+{
+    int i;
+    for (i=0; i<1000 && transportNeedsConnection(t); i++) {
+        transportConnect(t);
+        usleep(1000);
+    }
+    assert_false(transportNeedsConnection(t));
+}
+
+static void
+transportSendForTcpCompressesWhenConfigured(void** state)
+{
+    int sd = tcpListen("9877");
+
+    transport_t* t = transportCreateTCP("127.0.0.1", "9877");
+    assert_non_null(t);
+    transportConfigureCompression(t, CFG_COMPRESS_LZ4);
+    transportConnectTcp(t);
+    int rd = accept(sd, NULL, NULL);
+    assert_int_not_equal(rd, -1);
+
+    // Enough to fill more than one block, and a flush in the middle
+    char *expected = malloc(256 * 1024);
+    assert_non_null(expected);
+    size_t exp_len = 0;
+    int i;
+    for (i=0; i<2000; i++) {
+        char msg[128];
+        int len = snprintf(msg, sizeof(msg),
+            "{\"type\":\"evt\",\"body\":{\"sourcetype\":\"net\",\"pid\":%d}}\n", i);
+        assert_int_equal(transportSend(t, msg, len), 0);
+        memcpy(&expected[exp_len], msg, len);
+        exp_len += len;
+        if (i == 1000) assert_int_equal(transportFlush(t), 0);
+    }
+    assert_int_equal(transportFlush(t), 0);
+
+    // Destroying the transport ends the frame and closes the connection
+    transportDestroy(&t);
+
+    uint8_t *received = malloc(256 * 1024);
+    assert_non_null(received);
+    size_t rx_len = 0;
+    ssize_t rc;
+    while ((rc = recv(rd, &received[rx_len], 256 * 1024 - rx_len, 0)) > 0) {
+        rx_len += rc;
+    }
+
+    // It's an lz4 frame, it's smaller, and it decodes to what was sent
+    assert_true(rx_len > 4);
+    assert_memory_equal(received, "\x04\x22\x4d\x18", 4);
+    assert_true(rx_len < exp_len / 4);
+
+    char *decoded = malloc(256 * 1024);
+    assert_non_null(decoded);
+    assert_int_equal(lz4s_decode(received, rx_len, (uint8_t *)decoded, 256 * 1024), exp_len);
+    assert_memory_equal(decoded, expected, exp_len);
+
+    free(decoded);
+    free(received);
+    free(expected);
+    close(rd);
+    close(sd);
+}
+
+static void
+transportCompressedKeepsUnsentDataAcrossReconnect(void** state)
+{
+    int sd = tcpListen("9878");
+
+    transport_t* t = transportCreateTCP("127.0.0.1", "9878");
+    assert_non_null(t);
+    transportConfigureCompression(t, CFG_COMPRESS_LZ4);
+    transportConnectTcp(t);
+    int rd = accept(sd, NULL, NULL);
+    assert_int_not_equal(rd, -1);
+
+    // Accepted, but only buffered when the connection goes away
+    const char *first = "{\"type\":\"evt\",\"body\":\"first\"}\n";
+    assert_int_equal(transportSend(t, first, strlen(first)), 0);
+    transportDisconnect(t);
+    close(rd);
+
+    // Not accepted while there's no connection, and not lost either
+    const char *second = "{\"type\":\"evt\",\"body\":\"second\"}\n";
+    assert_int_equal(transportSend(t, second, strlen(second)), -1);
+    assert_int_equal(transportFlush(t), -1);
+
+    // The buffered message starts the frame on the next connection
+    transportConnectTcp(t);
+    rd = accept(sd, NULL, NULL);
+    assert_int_not_equal(rd, -1);
+    assert_int_equal(transportSend(t, second, strlen(second)), 0);
+    assert_int_equal(transportFlush(t), 0);
+    transportDestroy(&t);
+
+    uint8_t received[1024];
+    size_t rx_len = 0;
+    ssize_t rc;
+    while ((rc = recv(rd, &received[rx_len], sizeof(received) - rx_len, 0)) > 0) {
+        rx_len += rc;
+    }
+
+    char expected[128];
+    int exp_len = snprintf(expected, sizeof(expected), "%s%s", first, second);
+    char decoded[1024];
+    assert_int_equal(lz4s_decode(received, rx_len, (uint8_t *)decoded, sizeof(decoded)), exp_len);
+    assert_memory_equal(decoded, expected, exp_len);
+
+    close(rd);
+    close(sd);
+}
+
+static void
+transportCompressedSendsTheRestOfAPartlySentMessage(void** state)
+{
+    int sd = tcpListen("9879");
+
+    transport_t* t = transportCreateTCP("127.0.0.1", "9879");
+    assert_non_null(t);
+    transportConfigureCompression(t, CFG_COMPRESS_LZ4);
+    transportConnectTcp(t);
+    int rd = accept(sd, NULL, NULL);
+    assert_int_not_equal(rd, -1);
+
+    // Big enough for three blocks
+    size_t len = 2 * LZ4S_BLOCK_MAX + 1000;
+    char *msg = malloc(len);
+    assert_non_null(msg);
+    size_t i;
+    for (i = 0; i < len; i++) msg[i] = 'a' + (random() % 26);
+    msg[len - 1] = '\n';
+
+    // With nobody on the other end, the first block is sent but the
+    // second fails.  The start is gone, so the message is taken.
+    close(rd);
+    close(sd);
+    assert_int_equal(transportSend(t, msg, len), 0);
+    assert_true(transportNeedsConnection(t));
+
+    // The rest of it, and only the rest, starts the next connection
+    sd = tcpListen("9879");
+    transportConnectTcp(t);
+    rd = accept(sd, NULL, NULL);
+    assert_int_not_equal(rd, -1);
+    const char *next = "{\"type\":\"evt\",\"body\":\"next\"}\n";
+    assert_int_equal(transportSend(t, next, strlen(next)), 0);
+    assert_int_equal(transportFlush(t), 0);
+    transportDestroy(&t);
+
+    size_t rx_size = LZ4S_FRAME_HEADER_LEN + 4 * LZ4S_BLOCK_BOUND(LZ4S_BLOCK_MAX);
+    uint8_t *received = malloc(rx_size);
+    assert_non_null(received);
+    size_t rx_len = 0;
+    ssize_t rc;
+    while ((rc = recv(rd, &received[rx_len], rx_size - rx_len, 0)) > 0) {
+        rx_len += rc;
+    }
+
+    size_t exp_len = len - LZ4S_BLOCK_MAX + strlen(next);
+    char *decoded = malloc(exp_len + 1);
+    assert_non_null(decoded);
+    assert_int_equal(lz4s_decode(received, rx_len, (uint8_t *)decoded, exp_len + 1), exp_len);
+    assert_memory_equal(decoded, &msg[LZ4S_BLOCK_MAX], len - LZ4S_BLOCK_MAX);
+    assert_memory_equal(&decoded[len - LZ4S_BLOCK_MAX], next, strlen(next));
+
+    free(decoded);
+    free(received);
+    free(msg);
+    close(rd);
+    close(sd);
+
+    // The failed send is expected to complain
+    dbgInit();
+}
+
+/*
+ * Runs an event stream through the lz4 codec as the compressed tcp
+ * transport would, and reports the compression ratio and cpu cost.
+ * The stream is a capture of what libscope emitted for one curl
+ * process, with the host, pids and paths anonymized.
+ */
+#define EVENT_CAPTURE "./test/data/curl_events.ndjson"
+
+static char *
+readCapture(const char *path, size_t *len)
+{
+    struct stat sb;
+    if (stat(path, &sb) || (sb.st_size <= 0)) return NULL;
+
+    FILE *f = fopen(path, "r");
+    if (!f) return NULL;
+
+    char *buf = malloc(sb.st_size);
+    if (buf && (fread(buf, 1, sb.st_size, f) != sb.st_size)) {
+        free(buf);
+        buf = NULL;
+    }
+    fclose(f);
+
+    *len = sb.st_size;
+    return buf;
+}
+
+static double
+elapsedSec(struct timespec *start, struct timespec *end)
+{
+    return (end->tv_sec - start->tv_sec) +
+           (end->tv_nsec - start->tv_nsec) / 1e9;
+}
+
+static void
+transportCompressionBenchmark(void** state)
+{
+    size_t len = 0;
+    char *stream = readCapture(EVENT_CAPTURE, &len);
+    assert_non_null(stream);
+
+    // The capture fits in lz4's 64KB window, so back to back copies would
+    // compress against each other.  Each pass is a new stream instead.
+    const int passes = 256;
+
+    uint8_t *out = malloc(LZ4S_FRAME_HEADER_LEN + LZ4S_BLOCK_BOUND(LZ4S_BLOCK_MAX));
+    uint8_t *check = malloc(len);
+    uint8_t *all = malloc(len + len / 255 + 1024);
+    assert_non_null(out);
+    assert_non_null(check);
+    assert_non_null(all);
+
+    // Small blocks are what a lightly loaded process flushes each cycle
+    size_t blocksizes[] = {1024, 4 * 1024, LZ4S_BLOCK_MAX};
+    int b;
+    for (b=0; b < sizeof(blocksizes)/sizeof(blocksizes[0]); b++) {
+        size_t alllen = 0;
+        struct timespec start, end;
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        int p;
+        for (p=0; p < passes; p++) {
+            lz4s_stream_t *lz4 = lz4s_create();
+            assert_non_null(lz4);
+
+            alllen = lz4s_frame_header(all);
+            size_t pos;
+            for (pos=0; pos < len; pos += blocksizes[b]) {
+                size_t n = (len - pos < blocksizes[b]) ? len - pos : blocksizes[b];
+                size_t clen = lz4s_compress_block(lz4, (uint8_t *)&stream[pos], n,
+                                                  out, LZ4S_BLOCK_BOUND(n));
+                assert_int_not_equal(clen, 0);
+                memcpy(&all[alllen], out, clen);
+                alllen += clen;
+            }
+            lz4s_destroy(&lz4);
+        }
+        clock_gettime(CLOCK_MONOTONIC, &end);
+        alllen += lz4s_end_mark(&all[alllen]);
+
+        double secs = elapsedSec(&start, &end);
+        double ratio = (double)len / alllen;
+        size_t total = len * passes;
+        printf("    lz4s %6zu byte blocks: %zu -> %zu bytes, ratio %.1f:1, "
+               "%.0f MB/s, %.2f ns/byte\n", blocksizes[b], len, alllen, ratio,
+               (total / (1024.0 * 1024.0)) / secs, secs * 1e9 / total);
+
+        assert_true(ratio > 4.0);
+        assert_int_equal(lz4s_decode(all, alllen, check, len), len);
+        assert_memory_equal(check, stream, len);
+    }
+
+    free(all);
+    free(check);
+    free(out);
+    free(stream);
+}
+
+
 int
 main(int argc, char* argv[])
 {
@@ -420,6 +726,10 @@ main(int argc, char* argv[])
         cmocka_unit_test(transportSendForUdpTransmitsMsg),
         cmocka_unit_test(transportSendForFileWritesToFileAfterFlushWhenFullyBuffered),
         cmocka_unit_test(transportSendForFileWritesToFileImmediatelyWhenLineBuffered),
+        cmocka_unit_test(transportSendForTcpCompressesWhenConfigured),
+        cmocka_unit_test(transportCompressedKeepsUnsentDataAcrossReconnect),
+        cmocka_unit_test(transportCompressedSendsTheRestOfAPartlySentMessage),
+        cmocka_unit_test(transportCompressionBenchmark),
         cmocka_unit_test(dbgHasNoUnexpectedFailures),
     };
     return cmocka_run_group_tests(tests, groupSetup, groupTeardown);
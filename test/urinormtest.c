@@ -0,0 +1,172 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "dbg.h"
+#include "urinorm.h"
+#include "test.h"
+
+// Returns what uri normalizes to
+static const char *
+normalize(urinorm_t *norm, const char *uri)
+{
+    static char buf[256];
+    size_t len = urinormApply(norm, uri, buf, sizeof(buf));
+    assert_int_equal(len, strlen(buf));
+    return buf;
+}
+
+static void
+urinormCreateAndDestroy(void **state)
+{
+    urinorm_t *norm = urinormCreate(NULL);
+    assert_non_null(norm);
+    urinormDestroy(&norm);
+    assert_null(norm);
+
+    norm = urinormCreate(" /a/{b} ,, nope, /c ");
+    assert_non_null(norm);
+    urinormDestroy(&norm);
+
+    // Don't crash
+    urinormDestroy(&norm);
+    urinormDestroy(NULL);
+    char buf[8] = "x";
+    assert_int_equal(urinormApply(NULL, "/1", buf, sizeof(buf)), 0);
+    assert_string_equal(buf, "");
+    assert_int_equal(urinormApply(NULL, "/1", NULL, 0), 0);
+}
+
+static void
+urinormCollapsesIdSegments(void **state)
+{
+    urinorm_t *norm = urinormCreate(NULL);
+
+    const char *test[][2] = {
+        {"/",                                   "/"},
+        {"",                                    ""},
+        {"*",                                   "*"},
+        {"/users",                              "/users"},
+        {"/users/81237/orders/991",             "/users/{int}/orders/{int}"},
+        {"/users/81237/",                       "/users/{int}/"},
+        {"/users//5",                           "/users//{int}"},
+        {"/v1/items/0?page=2&size=10",          "/v1/items/{int}"},
+        {"/v1/items/7#top",                     "/v1/items/{int}"},
+        {"/o/123e4567-e89b-12d3-a456-426614174000/x",
+                                                "/o/{uuid}/x"},
+        {"/o/123E4567-E89B-12D3-A456-426614174000",
+                                                "/o/{uuid}"},
+        // Not quite UUIDs
+        {"/o/123e4567-e89b-12d3-a456-42661417400",
+                                                "/o/123e4567-e89b-12d3-a456-42661417400"},
+        {"/o/123e4567xe89b-12d3-a456-426614174000",
+                                                "/o/123e4567xe89b-12d3-a456-426614174000"},
+        {"/commit/9fceb02d0ae598e95dc970b74767f19372d61af8",
+                                                "/commit/{hex}"},
+        {"/obj/507f1f77bcf86cd799439011",       "/obj/{hex}"},
+        // Too short, no digits, or not all hex
+        {"/obj/507f1f7",                        "/obj/507f1f7"},
+        {"/obj/deadbeefcafe",                   "/obj/deadbeefcafe"},
+        {"/obj/507f1f77bcf86cd79943901z",       "/obj/507f1f77bcf86cd79943901z"},
+        {"/v2/api",                             "/v2/api"},
+        {"/files/report-2023.pdf",              "/files/report-2023.pdf"},
+    };
+
+    int i;
+    for (i = 0; i < sizeof(test) / sizeof(test[0]); i++) {
+        assert_string_equal(normalize(norm, test[i][0]), test[i][1]);
+    }
+
+    urinormDestroy(&norm);
+}
+
+static void
+urinormUsesFirstMatchingTemplate(void **state)
+{
+    urinorm_t *norm = urinormCreate(
+        "/users/{id}/orders/{order}, /users/{id}/profile, "
+        "/files/{name},/files/{name}/{version},/users/me/profile,/");
+
+    const char *test[][2] = {
+        {"/users/81237/orders/991",             "/users/{id}/orders/{order}"},
+        {"/users/alice/orders/991?x=1",         "/users/{id}/orders/{order}"},
+        {"/users/alice/profile",                "/users/{id}/profile"},
+        {"/users/me/profile",                   "/users/{id}/profile"},
+        {"/files/notes.txt",                    "/files/{name}"},
+        {"/files/notes.txt/3",                  "/files/{name}/{version}"},
+        {"/",                                   "/"},
+        // Braces match only segments that aren't empty
+        {"/files/",                             "/files/"},
+        // Segment counts have to be the same
+        {"/users/alice/orders",                 "/users/alice/orders"},
+        {"/users/5/orders/6/items",             "/users/{int}/orders/{int}/items"},
+        {"/files/a/b/c",                        "/files/a/b/c"},
+        // Other segments have to be the same
+        {"/users/5/order/6",                    "/users/{int}/order/{int}"},
+        {"/Users/5/orders/6",                   "/Users/{int}/orders/{int}"},
+    };
+
+    int i;
+    for (i = 0; i < sizeof(test) / sizeof(test[0]); i++) {
+        assert_string_equal(normalize(norm, test[i][0]), test[i][1]);
+    }
+
+    urinormDestroy(&norm);
+}
+
+static void
+urinormIgnoresBadTemplates(void **state)
+{
+    // Every template has to start with a '/'
+    urinorm_t *norm = urinormCreate("users/{id}, ,{id}");
+    assert_string_equal(normalize(norm, "/users/alice"), "/users/alice");
+    urinormDestroy(&norm);
+
+    // Only the first 64 are used
+    char templates[64 * 16 + 32] = "";
+    int i;
+    for (i = 0; i < 65; i++) {
+        char t[16];
+        snprintf(t, sizeof(t), "/t%d/{x},", i);
+        strcat(templates, t);
+    }
+    norm = urinormCreate(templates);
+    assert_string_equal(normalize(norm, "/t0/a"), "/t0/{x}");
+    assert_string_equal(normalize(norm, "/t63/a"), "/t63/{x}");
+    assert_string_equal(normalize(norm, "/t64/a"), "/t64/a");
+    urinormDestroy(&norm);
+}
+
+static void
+urinormTruncatesToBuffer(void **state)
+{
+    urinorm_t *norm = urinormCreate("/a/{b}");
+    char buf[8];
+
+    assert_int_equal(urinormApply(norm, "/abcdefghij", buf, sizeof(buf)), 7);
+    assert_string_equal(buf, "/abcdef");
+    assert_int_equal(urinormApply(norm, "/x/123456", buf, sizeof(buf)), 7);
+    assert_string_equal(buf, "/x/{int");
+    assert_int_equal(urinormApply(norm, "/a/b", buf, 1), 0);
+    assert_string_equal(buf, "");
+    assert_int_equal(urinormApply(norm, "/a/b", buf, 4), 3);
+    assert_string_equal(buf, "/a/");
+
+    urinormDestroy(&norm);
+}
+
+int
+main(int argc, char* argv[])
+{
+    printf("running %s\n", argv[0]);
+
+    const struct CMUnitTest tests[] = {
+        cmocka_unit_test(urinormCreateAndDestroy),
+        cmocka_unit_test(urinormCollapsesIdSegments),
+        cmocka_unit_test(urinormUsesFirstMatchingTemplate),
+        cmocka_unit_test(urinormIgnoresBadTemplates),
+        cmocka_unit_test(urinormTruncatesToBuffer),
+        cmocka_unit_test(dbgHasNoUnexpectedFailures),
+    };
+    return cmocka_run_group_tests(tests, groupSetup, groupTeardown);
+}